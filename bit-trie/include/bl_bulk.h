@@ -0,0 +1,97 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ * 
+ *
+ * Description:
+ * Bulk load of a bit-level trie from sorted names, by a pool of threads which
+ * steal subtrees from each other.
+ */
+
+#include <pthread.h>
+
+#include "bt_trie.h"
+
+#ifndef BL_BULK_H
+#define BL_BULK_H
+
+#ifndef BL_MAX_THREADS
+#define BL_MAX_THREADS 64
+#endif
+#ifndef BL_GRAIN
+#define BL_GRAIN 256             // -- a subtree of less names is built by the thread which finds it -- //
+#endif
+#define BL_NODE_BATCH 256        // -- nodes which a thread takes from the pool at once -- //
+
+/* ----------------------------------------------------------------------------------------
+ * How it works:
+ *
+ *    - Names of a subtree share the bits before the start of its top node. Since they
+ *      are sorted, the content of the top node ends at the first bit in which the first
+ *      and the last names differ (or at the end of the first name, which is EON then).
+ *      Names from the next bit ZERO and ONE on are two ranges, i.e. the subtrees of the
+ *      children. So the trie is the same as the one which bt_insert builds.
+ *    - A task is a range of names, and the link (a child of a parent) of its subtree.
+ *      A thread builds the top node of a task, pushes the task of one child to the
+ *      bottom of its deque, and goes on with the other. An idle thread steals a task
+ *      from the top of the deque of another thread (i.e. a large subtree).
+ *    - Threads take nodes from the pool in batches, under a lock (the rest of the
+ *      batches is released at the end), and room for spilled contents under it.
+ * ---------------------------------------------------------------------------------------- */
+
+// -- a subtree to build -- //
+struct bl_task_t {
+    int lo;                  // -- first name -- //
+    int hi;                  // -- after the last name -- //
+    int start;               // -- first bit of the top node -- //
+    unsigned int parent;     // -- link of the top node -- //
+    int child;
+};
+
+// -- a thread of the loader -- //
+struct bl_worker_t {
+    struct bl_loader_t* loader;
+    pthread_t thread;
+    pthread_mutex_t lock;                  // -- of the deque -- //
+    struct bl_task_t* tasks;               // -- deque of tasks [top, bottom) -- //
+    int top;
+    int bottom;
+    int size_of_tasks;
+    unsigned int nodes[BL_NODE_BATCH];     // -- nodes taken, not used yet -- //
+    int num_of_nodes;
+    long long steals;                      // -- tasks stolen from others -- //
+};
+
+struct bl_loader_t {
+    struct bt_instance* bt;
+    const char** names;                    // -- sorted, without duplicates -- //
+    int* lens;                             // -- length of the names (bit) -- //
+    int num_of_names;
+    struct bl_worker_t* workers;
+    int num_of_workers;
+    pthread_mutex_t pool_lock;             // -- of the pools of the trie -- //
+    long pending;                          // -- tasks pushed and not done yet -- //
+    int error;
+    long long steals;                      // -- tasks stolen by all threads -- //
+};
+
+int bl_load (struct bt_instance*, char** /*sorted names*/, int /*number of names*/, int /*number of threads*/, long long* /*steals, or NULL*/);
+int bl_compare (const void*, const void*);   // -- order of names for bl_load (see qsort) -- //
+
+#endif /* BL_BULK_H */
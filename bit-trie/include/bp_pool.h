@@ -0,0 +1,106 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ * 
+ *
+ * Description:
+ * Pools of a bit-level trie instance. Nodes and spilled contents live in large chunks,
+ * and refer to each other by 32-bit indices (resp. offsets) instead of pointers.
+ */
+
+#ifndef BP_POOL_H
+#define BP_POOL_H
+
+#ifndef BP_NODE_CHUNK_BITS
+#define BP_NODE_CHUNK_BITS 16     // -- 2^16 nodes per chunk -- //
+#endif
+#ifndef BP_BYTE_CHUNK_BITS
+#define BP_BYTE_CHUNK_BITS 20     // -- 1 MB of contents per chunk -- //
+#endif
+#define BP_NODE_CHUNK_SIZE (1u << BP_NODE_CHUNK_BITS)
+#define BP_BYTE_CHUNK_SIZE (1u << BP_BYTE_CHUNK_BITS)
+#define BP_MAX_NODE_CHUNKS (1u << (32 - BP_NODE_CHUNK_BITS))   // -- chunks which 32-bit indices address -- //
+#define BP_MAX_BYTE_CHUNKS (1u << (32 - BP_BYTE_CHUNK_BITS))
+#define BP_NULL 0                 // -- no node has this index (and no content this offset) -- //
+
+// -- size classes of contents: multiples of BP_BYTE_ALIGN up to BP_SMALL_BYTES, then powers of two up to a chunk -- //
+#define BP_BYTE_ALIGN 8
+#define BP_SMALL_BYTES 256
+#define BP_SMALL_BITS 8           // -- log2 (BP_SMALL_BYTES) -- //
+#define BP_NUM_OF_SMALL (BP_SMALL_BYTES / BP_BYTE_ALIGN)
+#define BP_NUM_OF_CLASSES (BP_NUM_OF_SMALL + BP_BYTE_CHUNK_BITS - BP_SMALL_BITS)
+
+// -- a node by its index, and a content by its offset -- //
+#define BP_NODE(pool, i)    ( (pool)->node_chunks[(i) >> BP_NODE_CHUNK_BITS] + ((i) & (BP_NODE_CHUNK_SIZE - 1)) )
+#define BP_BYTES(pool, off) ( (pool)->byte_chunks[(off) >> BP_BYTE_CHUNK_BITS] + ((off) & (BP_BYTE_CHUNK_SIZE - 1)) )
+
+/* ----------------------------------------------------------------------------------------
+ * How it works:
+ *
+ *    - An index is the number of its chunk (high bits) and the slot in it (low bits).
+ *      Chunks never move, so a node (or a content) stays where it is as long as the
+ *      pool lives. The arrays of chunks are taken at once (for all chunks which 32-bit
+ *      indices address), so that readers can resolve an index while the writer adds a
+ *      chunk; a chunk is in the array before any index in it is published.
+ *    - Index (resp. offset) ZERO is taken at init, so that it means NULL.
+ *    - A released node (resp. content) goes to a free list, and is taken again before
+ *      the pools grow. Nodes are released only when no reader can hold them (see
+ *      bt_reclaim_node), so a free node keeps the index of the next one in its child_0,
+ *      and a free content the offset of the next one in its first bytes.
+ *    - Contents are rounded up to their size class, with one free list per class, so
+ *      that a released content fits any other content of its class.
+ *    - All chunks are given back at once by bp_destroy.
+ *    - A content never crosses a chunk (MAX_NAME_LEN is much less than a chunk).
+ * ---------------------------------------------------------------------------------------- */
+
+struct node_t;
+
+struct bp_pool_t {
+    struct node_t** node_chunks;
+    unsigned int num_of_node_chunks;
+    long long next_node;              // -- the first index which is never taken -- //
+    char** byte_chunks;
+    unsigned int num_of_byte_chunks;
+    long long next_byte;              // -- the first offset which is never taken -- //
+    long long num_of_nodes;           // -- nodes in use -- //
+    long long bytes;                  // -- bytes of contents in use (rounded up to their class) -- //
+    unsigned int free_node;           // -- head of the free list of nodes -- //
+    unsigned int free_bytes[BP_NUM_OF_CLASSES];   // -- heads of the free lists of contents -- //
+    long long num_of_free_nodes;
+    long long num_of_free_bytes;
+    // -- counters -- //
+    long long node_allocs;            // -- nodes taken -- //
+    long long node_frees;             // -- nodes released -- //
+    long long node_recycled;          // -- nodes taken from the free list -- //
+    long long byte_allocs;            // -- contents taken -- //
+    long long byte_frees;             // -- contents released -- //
+    long long byte_recycled;          // -- contents taken from the free lists -- //
+};
+
+int bp_init (struct bp_pool_t*);
+void bp_destroy (struct bp_pool_t*);   // -- release all chunks at once -- //
+unsigned int bp_new_node (struct bp_pool_t*);   // -- BP_NULL if there is no memory -- //
+void bp_release_node (struct bp_pool_t*, unsigned int /*index*/);
+unsigned int bp_alloc_bytes (struct bp_pool_t*, int /*number of bytes*/);   // -- BP_NULL if there is no memory -- //
+void bp_release_bytes (struct bp_pool_t*, unsigned int /*offset*/, int /*number of bytes*/);
+long long bp_reserved (struct bp_pool_t*);   // -- bytes of all chunks -- //
+int bp_class (int /*number of bytes*/);       // -- size class of a content -- //
+int bp_class_size (int /*class*/);            // -- bytes of a content of a class -- //
+
+#endif /* -- end of BP_POOL_H -- */
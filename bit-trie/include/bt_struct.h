@@ -60,6 +60,16 @@ typedef int bool;
 #define BIT_SLIDER_LAST(a, i, current_bit)  ( BIT_SHIFT_UP(a, i, (BYTE_LEN - (current_bit+1))) & BIT_MASK_LOW_ZERO(BYTE_LEN - (current_bit + 1)) )
 #define CURRENT_BIT(n)              ( BYTE_LEN-((n)%BYTE_LEN)-1 )
 #define CURRENT_BYTE(n)             ( (n)/BYTE_LEN )
+#define NUM_OF_BYTES(n)             ( ((n)+BYTE_LEN-1)/BYTE_LEN )   // -- bytes which hold n bits -- //
+
+// -- word-at-a-time comparison (see bt_bit_compare) -- //
+#define WORD_LEN 64
+#define WORD_BYTES (WORD_LEN/BYTE_LEN)
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define WORD_TO_BE(w)               ( __builtin_bswap64(w) )
+#else
+#define WORD_TO_BE(w)               ( w )
+#endif
 
 /**
  * EXAMPLE:
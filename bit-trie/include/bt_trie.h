@@ -22,7 +22,11 @@
  * Defintition of main structures and functions of bit-level trie
  */
 
+#include <string.h>
+
 #include "bt_struct.h"
+#include "bp_pool.h"
+#include "ep_epoch.h"
 #include "db_debug_struct.h"
 
 #ifndef BT_TRIE_H
@@ -45,48 +49,89 @@
 /* ---------------------------------------------------------
  * structure of a node in bit-based trie
  *
- *                 [ N O D E ] --> bytes[]
+ *                 [ N O D E | bytes ]
  *                  |       |
  *    1st_child (node)     2nd_child (node)
+ *
+ * Nodes live in the node pool of the instance, and refer to
+ * each other by 32-bit indices (see bp_pool.h). A node which
+ * readers may reach is never modified in place, except its
+ * children (published by EP_PUBLISH) and its parent (which
+ * only the writer reads). Up to
+ * NODE_INLINE_BYTES of its content are kept in the node
+ * itself; longer contents spill to the byte pool, whose
+ * offset is kept in the same place (see bt_node_bytes).
  * --------------------------------------------------------- */
+#ifndef NODE_ALIGN
+#define NODE_ALIGN 32       // -- two nodes per cache line -- //
+#endif
+#define NODE_INLINE_BYTES (NODE_ALIGN - 4*sizeof(unsigned int))
+#define NODE_IS_INLINE(len) ( NUM_OF_BYTES(len) <= NODE_INLINE_BYTES )
+
 struct node_t {
-    char* bytes;       // -- content of a node -- //
+    unsigned int child_0;     // -- index of the first child (i.e. 0-based child) -- //
+    unsigned int child_1;     // -- index of the second child (i.e. 1-based child) -- //
+    unsigned int parent;      // -- index of the parent of the current node -- //
     /**
      * length of node's content, in terms of "BIT"
      * E.g. the node may contain 2 bytes, but the
      * length be 6. It means just 6 bits of these
      * 2 bytes (i.e. 8 bits) should be checked. 
      */
-    int len;                  
-    struct node_t* child_0;   // -- the first child (i.e. 0-based child) -- //
-    struct node_t* child_1;   // -- the second child (i.e. 1-based child) -- //
-    struct node_t* parent;    // -- the parent of the current node -- //
-    bool EON_flag;            // -- whether this is node is the end of a name -- //
-    /**
-     * Optional fields
-     *    ...
-     */
-};
+    unsigned int len : 31;
+    unsigned int EON_flag : 1;   // -- whether this is node is the end of a name -- //
+    char content[NODE_INLINE_BYTES];   // -- inline bytes, or offset of the spilled bytes -- //
+} __attribute__ ((aligned (NODE_ALIGN)));
 
 struct bt_instance {
-    struct node_t root;
+    struct bp_pool_t pool;     // -- nodes and spilled contents -- //
+    unsigned int root;         // -- index of the root -- //
+    struct ep_domain_t epoch;  // -- replaced nodes are retired here (see ep_epoch.h) -- //
+    unsigned long long* jump;  // -- jump table, or NULL (see jt_jump.h) -- //
+    int jump_bits;             // -- number of bits of its key -- //
     struct t_stat* trie_stat;
 };
 
+// -- a node of an instance by its index -- //
+#define BT_NODE(bt, i)  BP_NODE(&(bt)->pool, i)
+#define BT_ROOT(bt)     BT_NODE(bt, (bt)->root)
+
+/* ---------------------------------------------------------
+ * Method: bt_node_bytes (..)
+ *
+ * Description:
+ * Content of a node. The offset of a spilled content is
+ * not aligned, so it is read by memcpy.
+ * --------------------------------------------------------- */
+static inline char*
+bt_node_bytes (struct bt_instance* bt, const struct node_t* node)
+{
+    unsigned int offset;
+
+    if (NODE_IS_INLINE(node->len))
+        return (char*)node->content;
+    memcpy (&offset, node->content, sizeof(unsigned int));
+    return BP_BYTES(&bt->pool, offset);
+}
+
 /* -------------- main functions ---------------*/
+int bt_init (struct bt_instance*);      // -- pools and the root -- //
+void bt_destroy (struct bt_instance*);  // -- release the pools (i.e. all nodes) at once -- //
 struct node_t* bt_insert (struct bt_instance*, const char*, bool);   // -- insert a name if it is not already there -- //
-struct node_t* bt_do_insert (struct bt_instance*, struct node_t* /*parent*/, int /*which child?*/, const char*, int /*node_bit_walker*/, int /*bit_walker*/, bool);
-struct node_t* bt_node_partition (struct bt_instance*, struct node_t*, int /*which child*/, const char*, int /*node_bit_walker*/, int /*bit_walker*/, bool);
+struct node_t* bt_do_insert (struct bt_instance*, unsigned int /*parent*/, int /*which child?*/, const char*, int /*node_bit_walker*/, int /*bit_walker*/, bool);
+struct node_t* bt_node_partition (struct bt_instance*, unsigned int /*node*/, const char*, int /*node_bit_walker*/, int /*bit_walker*/, bool);
 
-//struct node_t* bt_node_merge (struct bt_instance*, struct child_t* /*child which points to the parent*/);
 struct node_t* bt_lookup (struct bt_instance*, const char*, bool /*printf_flag*/, bool /*exact_match*/);   // -- lookup a given name -- //
+bool bt_read_lookup (struct bt_instance*, struct ep_record_t* /*reader*/, const char*);   // -- lookup, concurrent with the writer -- //
 int bt_remove (struct bt_instance*, const char*, bool);   // -- remove a given name -- //
-struct node_t* bt_node_merge (struct bt_instance*, struct node_t* /*parent*/, int /*child*/, bool);
+struct node_t* bt_node_merge (struct bt_instance*, unsigned int /*parent*/, int /*child*/, bool);
 signed int bt_byte_compare (char, char, int /*number of bits to compare (NON-ZERO-based)*/);
-int bt_byte_cpy (const char* /*src*/, struct node_t* /*dst node*/, int /*start index (ZERO_Based)*/, int /*end index ZERO-Based*/);
-int bt_byte_cpy_index (const char* /*src*/, struct node_t* /*dst node*/, int /*dst start index (ZERO-based)*/, int /*src start index (ZERO_Based)*/, int /*end index ZERO-Based*/);    // -- accept start index for dst -- //
+int bt_bit_compare (const char*, int /*len (bit)*/, int /*start (bit)*/, const char*, int /*len (bit)*/, int /*start (bit)*/);   // -- number of matched bits -- //
+int bt_byte_cpy (const char* /*src*/, char* /*dst*/, int /*start index (ZERO_Based)*/, int /*end index ZERO-Based*/);
+int bt_byte_cpy_index (const char* /*src*/, char* /*dst*/, int /*dst start index (ZERO-based)*/, int /*src start index (ZERO_Based)*/, int /*end index ZERO-Based*/);    // -- accept start index for dst -- //
 
-void bt_free_node (struct node_t*);
-void bt_do_free_node (struct node_t*);
+char* bt_node_alloc_bytes (struct bt_instance*, struct node_t*, int /*len (bit)*/);   // -- set the length and take room for the content -- //
+void bt_node_free_bytes (struct bt_instance*, struct node_t*);
+void bt_reclaim_node (void* /*instance*/, void* /*index*/);   // -- see ep_retire -- //
  
 #endif /* bt_TRIE_H */
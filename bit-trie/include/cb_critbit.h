@@ -0,0 +1,70 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ * 
+ *
+ * Description:
+ * Crit-bit tree: the other bit-level engine. An internal node holds only the critical
+ * bit (i.e. the first bit in which its two subtrees differ) and two children; whole
+ * names are kept only at the leaves.
+ */
+
+#ifndef CB_CRITBIT_H
+#define CB_CRITBIT_H
+
+#include "bt_struct.h"
+
+/* ---------------------------------------------------------
+ * structure of an internal node of crit-bit tree
+ *
+ *             [ byte | otherbits ]
+ *              |              |
+ *     child[0] (node/leaf)   child[1] (node/leaf)
+ *
+ * A child is either a leaf (i.e. a name) or an internal
+ * node, tagged by the lowest bit of the pointer.
+ * --------------------------------------------------------- */
+struct cb_node_t {
+    void* child[2];
+    unsigned int byte;         // -- index of the critical byte -- //
+    unsigned char otherbits;   // -- all bits, except the critical one, are ON -- //
+};
+
+#define CB_IS_NODE(p)     ( (unsigned long)(p) & 1 )
+#define CB_NODE(p)        ( (struct cb_node_t*)((char*)(p) - 1) )
+#define CB_TAG(node)      ( (void*)((char*)(node) + 1) )
+
+// -- direction of a name at a node (bytes after the end of the name are ZERO) -- //
+#define CB_DIRECTION(node, name, name_len) \
+    ( (1 + ((node)->otherbits | ((node)->byte < (name_len) ? (unsigned char)(name)[(node)->byte] : 0))) >> BYTE_LEN )
+
+struct cb_instance {
+    void* root;                  // -- a leaf, or a tagged internal node (NULL if empty) -- //
+    long long num_of_names;
+    long long num_of_nodes;      // -- internal nodes -- //
+    long long bytes;             // -- memory of the internal nodes and leaves -- //
+};
+
+/* -------------- main functions ---------------*/
+const char* cb_insert (struct cb_instance*, const char*, bool);   // -- insert a name if it is not already there -- //
+const char* cb_lookup (struct cb_instance*, const char*, bool);   // -- lookup a given name -- //
+int cb_remove (struct cb_instance*, const char*, bool);           // -- remove a given name (same return as bt_remove) -- //
+void cb_free (struct cb_instance*);                               // -- free all nodes and leaves -- //
+
+#endif /* -- end of CB_CRITBIT_H -- */
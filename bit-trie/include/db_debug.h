@@ -27,9 +27,18 @@
 #ifndef DB_DEBUG_H
 #define DB_DEBUG_H
 
-void db_print_node (struct node_t*);
+// -- a node with pointers (i.e. before 32-bit indices): three pointers, length and inline bytes -- //
+#define DB_PTR_NODE_SIZE 64
+#define DB_PTR_INLINE_BYTES (DB_PTR_NODE_SIZE - 3*sizeof(void*) - sizeof(unsigned int))
+
+void db_print_node (struct bt_instance*, struct node_t*);
 void db_dfs (struct bt_instance*, bool);
 int db_do_dfs (struct bt_instance*, struct node_t* /*next_node*/, struct node_t* /*parent node*/, int /*height*/, struct t_stat*, signed int/*p_id*/, int /*child number*/, bool);
-void db_print_node_to_file (struct node_t* /*next_node*/, struct node_t* /*parent_node*/, signed int /*next_node id*/, int /*child number*/, signed int /*parent id*/);
+long long db_memory (struct bt_instance*, struct node_t*, long long* /*number of names*/);   // -- memory of a subtree -- //
+long long db_memory_pointers (struct bt_instance*, struct node_t*);   // -- memory of a subtree, with pointers -- //
+bool db_same (struct bt_instance*, struct node_t*, struct bt_instance*, struct node_t*);   // -- two subtrees are the same -- //
+void db_jump_levels (struct bt_instance*, struct node_t*, int /*depth*/, int /*start (bit)*/, unsigned long long /*path*/,
+                     int /*skipped*/, long long* /*number of names*/, long long* /*levels*/, long long* /*skipped levels*/);   // -- levels which the jump table skips -- //
+void db_print_node_to_file (struct bt_instance*, struct node_t* /*next_node*/, struct node_t* /*parent_node*/, signed int /*next_node id*/, int /*child number*/, signed int /*parent id*/);
 
 #endif /* -- db_DEBUG_H -- */
@@ -41,6 +41,7 @@ struct t_stat {
     struct linkedList_t* node;
     signed int id;     // -- dot_node id (increase by one after visiting a node) -- //
     int* width;        // -- number of nodes at each level -- //
+    int spilled;       // -- number of nodes whose content does not fit in the node -- //
 };
 
 struct linkedList_t {
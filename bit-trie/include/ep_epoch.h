@@ -0,0 +1,94 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ *
+ * Description:
+ * Epoch-based reclamation. Readers look up names without any lock, while
+ * writers retire what they unlink from the trie; it is freed once no reader
+ * can hold a reference to it.
+ *
+ * NOTE:
+ *     The module is shared by the tries. This copy (comp-trie) is the canonical
+ *     one; the copies of the other tries are kept byte-identical to it.
+ */
+
+#ifndef EP_EPOCH_H
+#define EP_EPOCH_H
+
+#include <pthread.h>
+
+#ifndef EP_MAX_READERS
+#define EP_MAX_READERS 256     // -- max number of registered readers -- //
+#endif
+#ifndef EP_ADVANCE_PERIOD
+#define EP_ADVANCE_PERIOD 64   // -- try to advance the epoch after this number of retirements -- //
+#endif
+#define EP_NUM_OF_LISTS 3      // -- retired objects of the current and two previous epochs -- //
+
+// -- readers load, and writers publish, shared pointers (or indices) with these -- //
+#define EP_LOAD(ptr) __atomic_load_n (&(ptr), __ATOMIC_ACQUIRE)
+#define EP_PUBLISH(ptr, val) __atomic_store_n (&(ptr), (val), __ATOMIC_RELEASE)
+
+/* ----------------------------------------------------------------------------------------
+ * How it works:
+ *
+ *    - A writer never frees what readers may reach. It unlinks it first (e.g. it builds a
+ *      new node, or table, aside and publishes it with a single store of its pointer, or
+ *      its index: EP_PUBLISH), and retires it.
+ *    - A reader announces the global epoch in its record when it enters a read section.
+ *      A writer which walks the trie among other writers is a reader as well.
+ *    - The global epoch advances only when all active readers have announced it. Objects
+ *      retired two epochs ago cannot be reached by any reader then, so they are freed.
+ *    - Retiring (and advancing the epoch) is serialized by the lock of the domain, so
+ *      that many writers can retire objects at once. Objects are freed out of the lock,
+ *      so a reclaim function may retire other objects.
+ * ---------------------------------------------------------------------------------------- */
+
+struct ep_record_t {
+    unsigned long state;  // -- (epoch << 1) | 1 inside a read section, 0 otherwise -- //
+    int used;             // -- the record is taken by a reader -- //
+    char pad[64 - sizeof(unsigned long) - sizeof(int)];  // -- one record per cache line -- //
+};
+
+struct ep_retired_t {
+    void* ptr;
+    void (*reclaim) (void* /*arg*/, void* /*ptr*/);
+};
+
+struct ep_domain_t {
+    unsigned long epoch;                               // -- global epoch -- //
+    struct ep_record_t* records;                       // -- EP_MAX_READERS records -- //
+    struct ep_retired_t* retired[EP_NUM_OF_LISTS];     // -- retired objects of each epoch -- //
+    int num_of_retired[EP_NUM_OF_LISTS];
+    int size_of_retired[EP_NUM_OF_LISTS];
+    int since_advance;                                 // -- retirements since the last try -- //
+    void* arg;                                         // -- passed to every reclaim function (e.g. the trie) -- //
+    pthread_mutex_t lock;                              // -- taken to retire objects, and to advance the epoch -- //
+};
+
+void ep_init (struct ep_domain_t*, void* /*arg of reclaim functions*/);
+void ep_destroy (struct ep_domain_t*);
+struct ep_record_t* ep_register (struct ep_domain_t*);
+void ep_unregister (struct ep_record_t*);
+void ep_enter (struct ep_domain_t*, struct ep_record_t*);
+void ep_exit (struct ep_record_t*);
+void ep_retire (struct ep_domain_t*, void*, void (* /*reclaim*/) (void*, void*));
+int ep_advance (struct ep_domain_t*);
+
+#endif /* -- end of EP_EPOCH_H -- */
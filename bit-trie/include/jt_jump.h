@@ -0,0 +1,95 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ * 
+ *
+ * Description:
+ * Direct-indexed jump table of a bit-level trie. It maps the first bits of a name
+ * (after "/") to the deepest node of the trie which covers them, so that a lookup
+ * skips the first levels of the trie (as DIR-24-8 does for IP prefixes).
+ */
+
+#include "bt_trie.h"
+
+#ifndef JT_JUMP_H
+#define JT_JUMP_H
+
+#define JT_PREFIX_BITS BYTE_LEN   // -- the first byte of every name (i.e. "/") is not in the key -- //
+#ifndef JT_MAX_BITS
+#define JT_MAX_BITS 24            // -- 2^24 entries (128 MB) at most -- //
+#endif
+
+// -- an entry: index of a node, and the end of its path in a name (bit) -- //
+#define JT_ENTRY(index, end) ( ((unsigned long long)(index) << 32) | (unsigned int)(end) )
+#define JT_INDEX(entry)      ( (unsigned int)((entry) >> 32) )
+#define JT_END(entry)        ( (int)((entry) & 0xFFFFFFFF) )
+// -- whether a lookup of a name (len in bits) may start by the table of an instance -- //
+#define JT_COVERS(bt, name, len) ( (bt)->jump && (name)[0] == SLASH && (len) > JT_PREFIX_BITS + (bt)->jump_bits )
+
+/* ----------------------------------------------------------------------------------------
+ * How it works:
+ *
+ *    - A table of K bits has 2^K entries, one per K bits after "/" (i.e. bits [8, 8+K)
+ *      of a name). An entry holds the deepest node whose whole path is a prefix of
+ *      those bits, and the end of the path; the root (end 0) if there is no such node.
+ *      A lookup of a name longer than 8+K bits starts at the child of that node.
+ *    - An entry changes only when a link to a node whose path ends in the first 8+K
+ *      bits changes (i.e. near the root). The writer then fills the entries under the
+ *      link again (see jt_link); other updates do not touch the table.
+ *    - An entry is a single 64-bit word, published by EP_PUBLISH before the old node
+ *      is retired. A reader may start at a replaced node, which is still there until
+ *      it leaves its read section (see ep_epoch.h).
+ * ---------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------
+ * Method: jt_bits (..)
+ *
+ * Description:
+ * The first given number (at most 32) of bits of a content,
+ * as an integer.
+ * --------------------------------------------------------- */
+static inline unsigned int
+jt_bits (const char* bytes, int len)
+{
+    unsigned long long value = 0;
+
+    for (int i = 0; i < NUM_OF_BYTES(len); i++)
+        value = (value << BYTE_LEN) | (unsigned char)bytes[i];
+    return (unsigned int)(value >> (NUM_OF_BYTES(len) * BYTE_LEN - len));
+}
+
+/* ---------------------------------------------------------
+ * Method: jt_key (..)
+ *
+ * Description:
+ * Entry of a name in a table of given bits. The name should
+ * be longer than JT_PREFIX_BITS + bits.
+ * --------------------------------------------------------- */
+static inline unsigned int
+jt_key (const char* name, int bits)
+{
+    return jt_bits (name + JT_PREFIX_BITS / BYTE_LEN, bits);
+}
+
+int jt_init (struct bt_instance*, int /*bits*/);   // -- build the table of an instance -- //
+void jt_destroy (struct bt_instance*);
+void jt_refill (struct bt_instance*);   // -- fill all entries again -- //
+void jt_link (struct bt_instance*, unsigned int /*parent*/, int /*child*/, int /*len of the former node (bit) or ZERO*/);   // -- a link has changed -- //
+
+#endif /* JT_JUMP_H */
@@ -19,6 +19,8 @@
  * For list of authors, please see AUTHORS.md file.
  */
 
+#include <time.h>
+
 #include "bt_trie.h"
 #ifndef MAIN_H
 #define MAIN_H
@@ -26,10 +28,65 @@
 #ifndef MAX_NAME_LEN
 #define MAX_NAME_LEN 10000 // set a upper bound for name length
 #endif
+#ifndef BENCH_ROUNDS
+#define BENCH_ROUNDS 20    // -- rounds of the compare benchmark -- //
+#endif
 
 void print_inst (char*);     // -- program help -- //
 void print_summary (struct bt_instance*, double, double, double, bool, bool);   // -- summary of program after running -- //
+void print_pool (struct bt_instance*);   // -- memory and counters of the pools -- //
 void warmup (struct bt_instance*, bool, bool, bool);   // -- a group of test cases -- //
 
+int slider_compare (const char*, int /*name len (byte)*/, int /*start (bit)*/, const char* /*node bytes*/, int /*node len (bit)*/);  // -- former compare path -- //
+void bench_compare (char**, int);   // -- compare benchmark -- //
+void bench_stride (char**, int, bool, bool /*remove_flag*/);   // -- tree-bitmap mode -- //
+
+const void* name_insert (struct bt_instance*, const char*, bool);   // -- by the engine in use (see [-c]) -- //
+const void* name_lookup (struct bt_instance*, const char*, bool);
+int name_remove (struct bt_instance*, const char*, bool);
+long long engine_memory (struct bt_instance*, long long* /*number of names*/);
+void print_engine (long long /*memory*/, long long /*number of names*/, int /*number of lookups*/, double /*lookup time*/);   // -- memory and lookup cost of the engine -- //
+
 void free_bt (struct bt_instance*);
+
+// -- reader/writer stress benchmark (see [-W]) -- //
+#ifndef RW_DURATION_MS
+#define RW_DURATION_MS 1000     // -- duration of each run -- //
+#endif
+#define RW_BUCKET_NS 8          // -- width of a latency bucket (ns) -- //
+#define RW_NUM_OF_BUCKETS 8192  // -- the last bucket keeps all longer latencies -- //
+#define RW_OFF -1               // -- no writer -- //
+#define RW_UNLIMITED 0          // -- the writer runs as fast as it can -- //
+#define RW_RATES { RW_OFF, 1000, 10000, 100000, RW_UNLIMITED }   // -- writer rates (updates/sec) of the runs -- //
+
+// -- work of a reader (or the writer) in the reader/writer benchmark -- //
+struct rw_arg_t {
+    struct bt_instance* bt;
+    char** names;
+    int num_of_names;
+    int first;              // -- index of the first name to look up -- //
+    long rate;              // -- updates/sec of the writer (or RW_UNLIMITED) -- //
+    long long found;        // -- number of found names (reader) -- //
+    long long lookups;      // -- number of lookups (reader) -- //
+    long long updates;      // -- number of removals and insertions (writer) -- //
+    unsigned long long* hist;   // -- latency histogram (reader) -- //
+    volatile int* stop;     // -- set when all readers are done (writer) -- //
+};
+
+long long rw_elapsed_ns (const struct timespec*);
+void* rw_reader (void*);
+void* rw_writer (void*);
+long long rw_percentile (unsigned long long* /*histogram*/, unsigned long long /*total*/, double /*percentile*/);
+void eval_rw (struct bt_instance*, char** /*names*/, int /*number of names*/, int /*number of readers*/);
+
+// -- load mode (see [-L]) -- //
+#define BL_THREADS { 1, 2, 4, 8, 16, 32, 64 }   // -- threads of the bulk load runs -- //
+void bench_load (struct bt_instance*, char** /*names*/, int /*number of names*/);
+
+// -- churn benchmark (see [-u]) -- //
+#ifndef CHURN_ROUNDS
+#define CHURN_ROUNDS 10
+#endif
+#define CHURN_SEED 7            // -- the same names are churned in every run -- //
+void bench_churn (struct bt_instance*, char** /*names*/, int /*number of names*/, int /*percent*/);
 #endif /* MAIN_H */
@@ -0,0 +1,78 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ * 
+ *
+ * Description:
+ * Multi-bit stride variant of the bit-level trie (tree bitmap). Each node consumes
+ * TB_STRIDE bits of a name: an internal bitmap marks the names which end inside the
+ * node, and an external bitmap marks its children, which are packed contiguously and
+ * indexed by popcount.
+ */
+
+#ifndef TB_BITMAP_H
+#define TB_BITMAP_H
+
+#include "bt_struct.h"
+
+#ifndef TB_STRIDE
+#define TB_STRIDE 4        // -- bits per level (4 to 8), see the stride target of Makefile -- //
+#endif
+#if TB_STRIDE < 1 || TB_STRIDE > 8
+#error "TB_STRIDE should be between 1 and 8"
+#endif
+#define TB_FANOUT (1 << TB_STRIDE)
+#define TB_WORDS ((TB_FANOUT + 63) / 64)      // -- 64-bit words of a bitmap -- //
+
+#define TB_TEST(map, i)    ( (map)[(i) >> 6] & (1ULL << ((i) & 63)) )
+#define TB_SET(map, i)     ( (map)[(i) >> 6] |= (1ULL << ((i) & 63)) )
+#define TB_CLEAR(map, i)   ( (map)[(i) >> 6] &= ~(1ULL << ((i) & 63)) )
+
+// -- position of the l-bit prefix (l < TB_STRIDE) of value v in the internal bitmap -- //
+#define TB_INTERNAL_POS(l, v)   ( (1 << (l)) - 1 + (v) )
+
+/* ---------------------------------------------------------
+ * structure of a node in tree-bitmap trie
+ *
+ *     [ internal | external | children ] --> [ c0 | c1 | .. ]
+ *
+ * The i-th child (in the order of chunks) belongs to the
+ * i-th ON bit of the external bitmap.
+ * --------------------------------------------------------- */
+struct tb_node_t {
+    unsigned long long internal[TB_WORDS];   // -- names which end inside the node (2^stride - 1 bits) -- //
+    unsigned long long external[TB_WORDS];   // -- chunks (of stride bits) which have a child -- //
+    struct tb_node_t* children;              // -- packed children (NULL if there is none) -- //
+};
+
+struct tb_instance {
+    struct tb_node_t root;
+    long long num_of_names;
+    long long num_of_nodes;      // -- except the root -- //
+    long long bytes;             // -- memory of all nodes, except the root -- //
+};
+
+/* -------------- main functions ---------------*/
+struct tb_node_t* tb_insert (struct tb_instance*, const char*, bool);   // -- insert a name if it is not already there -- //
+struct tb_node_t* tb_lookup (struct tb_instance*, const char*, bool);   // -- lookup a given name -- //
+int tb_remove (struct tb_instance*, const char*, bool);                 // -- remove a given name (same return as bt_remove) -- //
+void tb_depth (struct tb_instance*, int* /*max*/, double* /*average*/);    // -- depth of names (in nodes) -- //
+void tb_free (struct tb_instance*);                                     // -- free all nodes -- //
+
+#endif /* -- end of TB_BITMAP_H -- */
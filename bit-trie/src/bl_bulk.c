@@ -0,0 +1,442 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * For list of authors, please see AUTHORS.md file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <sched.h>
+
+#include "bl_bulk.h"
+#include "bt_struct.h"
+#include "jt_jump.h"
+
+/* -----------------------------------------------------------------
+ * Method: bl_compare (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Compare two names (i.e. char* elements of an array) in the order
+ * of their bits, to sort names for bl_load by qsort.
+ * ------------------------------------------------------------------ */
+int
+bl_compare (const void* a, const void* b)
+{
+    return strcmp (*(const char**)a, *(const char**)b);
+} /* -- end of bl_compare (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bl_lcp (..)
+ * Scope: Private
+ *
+ * Description:
+ * The first bit in which two names differ, or the length of the
+ * shorter one (i.e. it is a prefix of the other). Both of them share
+ * the bits before the start.
+ * ------------------------------------------------------------------ */
+static int
+bl_lcp (const char* a, int a_len, const char* b, int b_len, int start)
+{
+    int len = ((a_len < b_len) ? a_len : b_len) / BYTE_LEN;
+    int i = start / BYTE_LEN;
+
+    while (i < len && a[i] == b[i])
+        i++;
+    if (i == len)
+        return len * BYTE_LEN;
+    return i * BYTE_LEN + __builtin_clz ((unsigned int)(unsigned char)(a[i] ^ b[i])) - (int)(sizeof(unsigned int) - 1) * BYTE_LEN;
+} /* -- end of bl_lcp (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bl_split (..)
+ * Scope: Private
+ *
+ * Description:
+ * The first name of a range whose given bit is ONE (or the end of
+ * the range). Names of the range share the bits before it, and are
+ * longer than it.
+ * ------------------------------------------------------------------ */
+static int
+bl_split (struct bl_loader_t* loader, int lo, int hi, int bit)
+{
+    int mid;
+
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        if (BIT(loader->names[mid][CURRENT_BYTE(bit)], CURRENT_BIT(bit)) == ZERO)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+} /* -- end of bl_split (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bl_new_node (..)
+ * Scope: Private
+ *
+ * Description:
+ * Take an empty node from the batch of a thread. An empty batch is
+ * filled from the node pool, under the lock of the pools.
+ *
+ * RETURN:
+ *    index of the node, or BP_NULL if there is no memory
+ * ------------------------------------------------------------------ */
+static unsigned int
+bl_new_node (struct bl_worker_t* worker)
+{
+    struct bl_loader_t* loader = worker->loader;
+    unsigned int index;
+
+    if (!worker->num_of_nodes)
+    {
+        pthread_mutex_lock (&loader->pool_lock);
+        while (worker->num_of_nodes < BL_NODE_BATCH &&
+               (index = bp_new_node (&loader->bt->pool)))
+            worker->nodes[worker->num_of_nodes++] = index;
+        pthread_mutex_unlock (&loader->pool_lock);
+        if (!worker->num_of_nodes)
+            return BP_NULL;
+    }
+    return worker->nodes[--worker->num_of_nodes];
+} /* -- end of bl_new_node (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bl_node_alloc_bytes (..)
+ * Scope: Private
+ *
+ * Description:
+ * Same as bt_node_alloc_bytes, under the lock of the pools if the
+ * content spills.
+ *
+ * RETURN:
+ *    content of the node, or NULL if there is no memory
+ * ------------------------------------------------------------------ */
+static char*
+bl_node_alloc_bytes (struct bl_worker_t* worker, struct node_t* node, int len)
+{
+    struct bl_loader_t* loader = worker->loader;
+    char* bytes;
+
+    if (NODE_IS_INLINE(len))
+        return bt_node_alloc_bytes (loader->bt, node, len);
+    pthread_mutex_lock (&loader->pool_lock);
+    bytes = bt_node_alloc_bytes (loader->bt, node, len);
+    pthread_mutex_unlock (&loader->pool_lock);
+    return bytes;
+} /* -- end of bl_node_alloc_bytes (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bl_push (..)
+ * Scope: Private
+ *
+ * Description:
+ * Push a task to the bottom of the deque of a thread.
+ *
+ * RETURN:
+ *    0: DONE!
+ *    1: ERROR (no memory)
+ * ------------------------------------------------------------------ */
+static int
+bl_push (struct bl_worker_t* worker, int lo, int hi, int start, unsigned int parent, int child)
+{
+    struct bl_task_t* tasks;
+    int ret = 0;
+
+    __atomic_add_fetch (&worker->loader->pending, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_lock (&worker->lock);
+    if (worker->bottom == worker->size_of_tasks)
+    {
+        if (worker->top > 0)
+        {
+            // -- tasks at the top are stolen already, take their room -- //
+            memmove (worker->tasks, worker->tasks + worker->top, (worker->bottom - worker->top) * sizeof(struct bl_task_t));
+            worker->bottom -= worker->top;
+            worker->top = 0;
+        }
+        else if ((tasks = (struct bl_task_t*)realloc (worker->tasks, 2 * worker->size_of_tasks * sizeof(struct bl_task_t))))
+        {
+            worker->tasks = tasks;
+            worker->size_of_tasks *= 2;
+        }
+        else
+            ret = 1;
+    }
+    if (!ret)
+    {
+        worker->tasks[worker->bottom].lo = lo;
+        worker->tasks[worker->bottom].hi = hi;
+        worker->tasks[worker->bottom].start = start;
+        worker->tasks[worker->bottom].parent = parent;
+        worker->tasks[worker->bottom].child = child;
+        worker->bottom++;
+    }
+    pthread_mutex_unlock (&worker->lock);
+    if (ret)
+        __atomic_sub_fetch (&worker->loader->pending, 1, __ATOMIC_SEQ_CST);
+    return ret;
+} /* -- end of bl_push (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bl_take (..)
+ * Scope: Private
+ *
+ * Description:
+ * Take a task from the deque of a thread: the bottom one (i.e. the
+ * last pushed) by the thread itself, or the top one by a thief.
+ *
+ * RETURN:
+ *    whether there was a task
+ * ------------------------------------------------------------------ */
+static bool
+bl_take (struct bl_worker_t* worker, struct bl_task_t* task, bool steal)
+{
+    bool found = false;
+
+    pthread_mutex_lock (&worker->lock);
+    if (worker->top < worker->bottom)
+    {
+        *task = steal ? worker->tasks[worker->top++] : worker->tasks[--worker->bottom];
+        found = true;
+    }
+    pthread_mutex_unlock (&worker->lock);
+    return found;
+} /* -- end of bl_take (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bl_build (..)
+ * Scope: Private
+ *
+ * Description:
+ * Build the subtree of a task and link it. Of the two children of a
+ * node, a large one (i.e. BL_GRAIN names or more) is pushed as a new
+ * task; otherwise, the thread builds both of them.
+ * ------------------------------------------------------------------ */
+static void
+bl_build (struct bl_worker_t* worker, int lo, int hi, int start, unsigned int parent, int child)
+{
+    struct bl_loader_t* loader = worker->loader;
+    struct node_t* node;
+    unsigned int index;
+    char* bytes;
+    int end;       // -- end of the content of the node (bit) -- //
+    int rest;      // -- the first name after the node -- //
+    int mid;       // -- the first name of the ONE child -- //
+
+    while (lo < hi && !__atomic_load_n (&loader->error, __ATOMIC_RELAXED))
+    {
+        if (hi - lo == 1)
+            end = loader->lens[lo];
+        else
+            end = bl_lcp (loader->names[lo], loader->lens[lo], loader->names[hi-1], loader->lens[hi-1], start);
+        if (!(index = bl_new_node (worker)) ||
+            !(bytes = bl_node_alloc_bytes (worker, (node = BT_NODE(loader->bt, index)), end - start)) ||
+            bt_byte_cpy (loader->names[lo], bytes, start, end-1))
+        {
+            fprintf (stderr, "[bl_build] ERROR: Memory allocation has been failed.\n");
+            __atomic_store_n (&loader->error, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        // -- the first name may end here -- //
+        rest = lo;
+        if (end == loader->lens[lo])
+        {
+            node->EON_flag = true;
+            rest++;
+        }
+        node->parent = parent;
+        if (!child)
+            BT_NODE(loader->bt, parent)->child_0 = index;
+        else
+            BT_NODE(loader->bt, parent)->child_1 = index;
+
+        // -- children -- //
+        mid = bl_split (loader, rest, hi, end);
+        if (hi - mid >= BL_GRAIN && mid > rest && !bl_push (worker, mid, hi, end, index, 1))
+            hi = mid;
+        else if (mid > rest && hi > mid)
+            bl_build (worker, mid, hi, end, index, 1);   // -- a small subtree -- //
+        else if (hi > mid)
+        {
+            lo = mid;   // -- only the ONE child -- //
+            start = end;
+            parent = index;
+            child = 1;
+            continue;
+        }
+        lo = rest;
+        hi = mid;
+        start = end;
+        parent = index;
+        child = 0;
+    }
+} /* -- end of bl_build (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bl_run (..)
+ * Scope: Private
+ *
+ * Description:
+ * A thread of the loader: build tasks of its own deque, or steal
+ * them from others, until all of them are done.
+ * ------------------------------------------------------------------ */
+static void*
+bl_run (void* arg)
+{
+    struct bl_worker_t* worker = (struct bl_worker_t*)arg;
+    struct bl_loader_t* loader = worker->loader;
+    int id = worker - loader->workers;
+    struct bl_task_t task;
+    bool found;
+
+    while (__atomic_load_n (&loader->pending, __ATOMIC_SEQ_CST) > 0)
+    {
+        found = bl_take (worker, &task, false);
+        for (int i = 1; !found && i < loader->num_of_workers; i++)
+            if ((found = bl_take (&loader->workers[(id + i) % loader->num_of_workers], &task, true)))
+                worker->steals++;
+        if (!found)
+        {
+            sched_yield ();
+            continue;
+        }
+        bl_build (worker, task.lo, task.hi, task.start, task.parent, task.child);
+        __atomic_sub_fetch (&loader->pending, 1, __ATOMIC_SEQ_CST);
+    }
+    return 0;
+} /* -- end of bl_run (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bl_load (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Load sorted names (see bl_compare) into an empty trie, by a given
+ * number of threads. Duplicates and empty names are skipped. The trie
+ * is the same as the one which bt_insert builds from the names (in
+ * any order). No reader should look up the trie meanwhile.
+ *
+ * RETURN:
+ *    0: DONE!
+ *    1: ERROR (bad input, or the trie is not empty)
+ *    2: ERROR (no memory; the trie is partly built, destroy it)
+ * ------------------------------------------------------------------ */
+int
+bl_load (struct bt_instance* bt, char** names, int num_of_names, int num_of_threads, long long* steals)
+{
+    assert (bt);
+    assert (names);
+    struct bl_loader_t loader;
+    struct bl_worker_t* worker;
+    int mid;
+    int ret = 0;
+
+    if (num_of_threads < 1 || num_of_threads > BL_MAX_THREADS)
+    {
+        fprintf (stderr, "[bl_load] ERROR: Number of threads should be between 1 and %d.\n", BL_MAX_THREADS);
+        return 1;
+    }
+    if (BT_ROOT(bt)->child_0 || BT_ROOT(bt)->child_1)
+    {
+        fprintf (stderr, "[bl_load] ERROR: The trie is not empty.\n");
+        return 1;
+    }
+    memset (&loader, 0, sizeof(struct bl_loader_t));
+    loader.bt = bt;
+    loader.num_of_workers = num_of_threads;
+    loader.names = (const char**)malloc (sizeof(char*) * (num_of_names + 1));
+    loader.lens = (int*)malloc (sizeof(int) * (num_of_names + 1));
+    loader.workers = (struct bl_worker_t*)calloc (num_of_threads, sizeof(struct bl_worker_t));
+    if (!loader.names || !loader.lens || !loader.workers)
+    {
+        fprintf (stderr, "[bl_load] ERROR: Memory allocation has been failed.\n");
+        free (loader.names);
+        free (loader.lens);
+        free (loader.workers);
+        return 2;
+    }
+    // -- sorted names, without duplicates -- //
+    for (int i = 0; i < num_of_names && !ret; i++)
+    {
+        if (!names[i][0] || (loader.num_of_names && !strcmp (loader.names[loader.num_of_names-1], names[i])))
+            continue;
+        if (loader.num_of_names && strcmp (loader.names[loader.num_of_names-1], names[i]) > 0)
+        {
+            fprintf (stderr, "[bl_load] ERROR: Names are not sorted (%s).\n", names[i]);
+            ret = 1;
+        }
+        loader.names[loader.num_of_names] = names[i];
+        loader.lens[loader.num_of_names++] = strlen (names[i]) * BYTE_LEN;
+    }
+
+    pthread_mutex_init (&loader.pool_lock, 0);
+    for (int i = 0; i < num_of_threads; i++)
+    {
+        worker = &loader.workers[i];
+        worker->loader = &loader;
+        pthread_mutex_init (&worker->lock, 0);
+        worker->size_of_tasks = BL_NODE_BATCH;
+        if (!(worker->tasks = (struct bl_task_t*)malloc (sizeof(struct bl_task_t) * worker->size_of_tasks)) && !ret)
+            ret = 2;
+    }
+
+    // -- the children of the root, by the first bit -- //
+    if (!ret)
+    {
+        mid = bl_split (&loader, 0, loader.num_of_names, 0);
+        if ((mid > 0 && bl_push (&loader.workers[0], 0, mid, 0, bt->root, 0)) ||
+            (mid < loader.num_of_names && bl_push (&loader.workers[0], mid, loader.num_of_names, 0, bt->root, 1)))
+            loader.error = 1;
+        for (int i = 1; i < num_of_threads; i++)
+            if (pthread_create (&loader.workers[i].thread, 0, bl_run, &loader.workers[i]))
+            {
+                fprintf (stderr, "[bl_load] WARNING: Could not create thread %d, go on with less threads.\n", i);
+                loader.workers[i].thread = 0;
+            }
+        bl_run (&loader.workers[0]);
+        for (int i = 1; i < num_of_threads; i++)
+            if (loader.workers[i].thread)
+                pthread_join (loader.workers[i].thread, 0);
+        if (loader.error)
+            ret = 2;
+    }
+
+    // -- give the rest of the batches back -- //
+    for (int i = 0; i < num_of_threads; i++)
+    {
+        worker = &loader.workers[i];
+        while (worker->num_of_nodes)
+            bp_release_node (&bt->pool, worker->nodes[--worker->num_of_nodes]);
+        loader.steals += worker->steals;
+        pthread_mutex_destroy (&worker->lock);
+        free (worker->tasks);
+    }
+    pthread_mutex_destroy (&loader.pool_lock);
+    if (steals)
+        *steals = loader.steals;
+    free (loader.names);
+    free (loader.lens);
+    free (loader.workers);
+    if (!ret && bt->jump)
+        jt_refill (bt);
+    return ret;
+} /* -- end of bl_load (..) -- */
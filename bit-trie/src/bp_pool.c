@@ -0,0 +1,287 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * For list of authors, please see AUTHORS.md file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#include "bt_trie.h"
+#include "bp_pool.h"
+
+/* ---------------------------------------------------------------------
+ * Method: bp_init (..)
+ * Scope: Global
+ *
+ * Description:
+ * Initialize (empty) pools, and take index ZERO as NULL. The arrays of
+ * chunks are mostly untouched memory, until the chunks are added.
+ *
+ * RETURN:
+ *    0: DONE!
+ *    1: ERROR (no memory)
+ * --------------------------------------------------------------------- */
+int
+bp_init (struct bp_pool_t* pool)
+{
+    assert (pool);
+
+    memset (pool, 0, sizeof(struct bp_pool_t));
+    pool->node_chunks = (struct node_t**)calloc(BP_MAX_NODE_CHUNKS, sizeof(struct node_t*));
+    pool->byte_chunks = (char**)calloc(BP_MAX_BYTE_CHUNKS, sizeof(char*));
+    if (pool->node_chunks && pool->byte_chunks)
+        bp_new_node (pool);
+    if (!pool->num_of_node_chunks)
+    {
+        bp_destroy (pool);
+        return 1;
+    }
+    pool->num_of_nodes = 0;    // -- NULL is not a node in use -- //
+    pool->node_allocs = 0;
+    return 0;
+} /* -- end of bp_init (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: bp_destroy (..)
+ * Scope: Global
+ *
+ * Description:
+ * Release all chunks of the pools at once. Every node (and content)
+ * of the trie is gone then.
+ * --------------------------------------------------------------------- */
+void
+bp_destroy (struct bp_pool_t* pool)
+{
+    assert (pool);
+
+    for (unsigned int i=0; i<pool->num_of_node_chunks; i++)
+        free (pool->node_chunks[i]);
+    for (unsigned int i=0; i<pool->num_of_byte_chunks; i++)
+        free (pool->byte_chunks[i]);
+    free (pool->node_chunks);
+    free (pool->byte_chunks);
+    memset (pool, 0, sizeof(struct bp_pool_t));
+} /* -- end of bp_destroy (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: bp_new_node (..)
+ * Scope: Global
+ *
+ * Description:
+ * Take an empty node (no content, no children) from the free list of
+ * nodes, or from the node pool if the list is empty.
+ *
+ * RETURN:
+ *    index of the node, or BP_NULL if there is no memory
+ * --------------------------------------------------------------------- */
+unsigned int
+bp_new_node (struct bp_pool_t* pool)
+{
+    assert (pool);
+    unsigned int index;
+    struct node_t* chunk;
+
+    if (pool->free_node)
+    {
+        index = pool->free_node;
+        pool->free_node = BP_NODE(pool, index)->child_0;
+        pool->num_of_free_nodes--;
+        pool->node_recycled++;
+    }
+    else
+    {
+        if ((pool->next_node >> BP_NODE_CHUNK_BITS) >= pool->num_of_node_chunks)
+        {
+            // -- the last chunk is full -- //
+            if (pool->num_of_node_chunks == BP_MAX_NODE_CHUNKS)
+            {
+                fprintf (stderr, "[bp_new_node] ERROR: Out of 32-bit indices.\n");
+                return BP_NULL;
+            }
+            if (posix_memalign ((void**)&chunk, NODE_ALIGN, sizeof(struct node_t) * BP_NODE_CHUNK_SIZE))
+            {
+                fprintf (stderr, "[bp_new_node] ERROR: Memory allocation has been failed.\n");
+                return BP_NULL;
+            }
+            pool->node_chunks[pool->num_of_node_chunks++] = chunk;
+        }
+        index = (unsigned int)pool->next_node++;
+    }
+    memset (BP_NODE(pool, index), 0, sizeof(struct node_t));
+    pool->num_of_nodes++;
+    pool->node_allocs++;
+    return index;
+} /* -- end of bp_new_node (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: bp_release_node (..)
+ * Scope: Global
+ *
+ * Description:
+ * Give a node back to the pool, i.e. to the free list of nodes. No
+ * reader should hold the node anymore.
+ * --------------------------------------------------------------------- */
+void
+bp_release_node (struct bp_pool_t* pool, unsigned int index)
+{
+    assert (pool);
+
+    if (index == BP_NULL)
+        return;
+    BP_NODE(pool, index)->child_0 = pool->free_node;
+    pool->free_node = index;
+    pool->num_of_free_nodes++;
+    pool->num_of_nodes--;
+    pool->node_frees++;
+} /* -- end of bp_release_node (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: bp_class (..)
+ * Scope: Global
+ *
+ * Description:
+ * Size class of a content of a given number of bytes (at most a
+ * chunk).
+ * --------------------------------------------------------------------- */
+int
+bp_class (int num_of_bytes)
+{
+    if (num_of_bytes <= BP_SMALL_BYTES)
+        return (num_of_bytes + BP_BYTE_ALIGN - 1) / BP_BYTE_ALIGN - 1;
+    // -- the power of two which is not less than the number of bytes -- //
+    return BP_NUM_OF_SMALL + (32 - __builtin_clz ((unsigned int)num_of_bytes - 1)) - (BP_SMALL_BITS + 1);
+} /* -- end of bp_class (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: bp_class_size (..)
+ * Scope: Global
+ * --------------------------------------------------------------------- */
+int
+bp_class_size (int class)
+{
+    if (class < BP_NUM_OF_SMALL)
+        return (class + 1) * BP_BYTE_ALIGN;
+    return 1 << (class - BP_NUM_OF_SMALL + BP_SMALL_BITS + 1);
+} /* -- end of bp_class_size (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: bp_alloc_bytes (..)
+ * Scope: Global
+ *
+ * Description:
+ * Take room for a content of a given number of bytes, rounded up to
+ * its size class: from the free list of the class, or from the byte
+ * pool if the list is empty. The rest of the last chunk is left
+ * unused, if the content does not fit in it.
+ *
+ * RETURN:
+ *    offset of the content, or BP_NULL if there is no memory
+ * --------------------------------------------------------------------- */
+unsigned int
+bp_alloc_bytes (struct bp_pool_t* pool, int num_of_bytes)
+{
+    assert (pool);
+    unsigned int offset;
+    char* chunk;
+    int class, size;
+
+    if (num_of_bytes <= 0 || num_of_bytes > BP_BYTE_CHUNK_SIZE)
+    {
+        fprintf (stderr, "[bp_alloc_bytes] ERROR: Bad size of content (%d bytes).\n", num_of_bytes);
+        return BP_NULL;
+    }
+    class = bp_class (num_of_bytes);
+    size = bp_class_size (class);
+    if (pool->free_bytes[class])
+    {
+        offset = pool->free_bytes[class];
+        memcpy (&pool->free_bytes[class], BP_BYTES(pool, offset), sizeof(unsigned int));
+        pool->num_of_free_bytes -= size;
+        pool->byte_recycled++;
+    }
+    else
+    {
+        if ((pool->next_byte >> BP_BYTE_CHUNK_BITS) >= pool->num_of_byte_chunks ||
+            (pool->next_byte & (BP_BYTE_CHUNK_SIZE - 1)) + size > BP_BYTE_CHUNK_SIZE)
+        {
+            if (pool->num_of_byte_chunks == BP_MAX_BYTE_CHUNKS)
+            {
+                fprintf (stderr, "[bp_alloc_bytes] ERROR: Out of 32-bit offsets.\n");
+                return BP_NULL;
+            }
+            if (!(chunk = (char*)malloc(BP_BYTE_CHUNK_SIZE)))
+            {
+                fprintf (stderr, "[bp_alloc_bytes] ERROR: Memory allocation has been failed.\n");
+                return BP_NULL;
+            }
+            pool->byte_chunks[pool->num_of_byte_chunks] = chunk;
+            pool->next_byte = (long long)pool->num_of_byte_chunks++ << BP_BYTE_CHUNK_BITS;
+            if (pool->next_byte == BP_NULL)
+                pool->next_byte = BP_BYTE_ALIGN;   // -- offset ZERO is NULL -- //
+        }
+        offset = (unsigned int)pool->next_byte;
+        pool->next_byte += size;
+    }
+    pool->bytes += size;
+    pool->byte_allocs++;
+    return offset;
+} /* -- end of bp_alloc_bytes (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: bp_release_bytes (..)
+ * Scope: Global
+ *
+ * Description:
+ * Give a content (of the number of bytes it was taken by) back to the
+ * pool, i.e. to the free list of its class. No reader should hold the
+ * content anymore.
+ * --------------------------------------------------------------------- */
+void
+bp_release_bytes (struct bp_pool_t* pool, unsigned int offset, int num_of_bytes)
+{
+    assert (pool);
+    int class;
+
+    if (offset == BP_NULL)
+        return;
+    class = bp_class (num_of_bytes);
+    memcpy (BP_BYTES(pool, offset), &pool->free_bytes[class], sizeof(unsigned int));
+    pool->free_bytes[class] = offset;
+    pool->num_of_free_bytes += bp_class_size (class);
+    pool->bytes -= bp_class_size (class);
+    pool->byte_frees++;
+} /* -- end of bp_release_bytes (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: bp_reserved (..)
+ * Scope: Global
+ *
+ * Description:
+ * Bytes which the pools take from the system (i.e. all chunks).
+ * --------------------------------------------------------------------- */
+long long
+bp_reserved (struct bp_pool_t* pool)
+{
+    assert (pool);
+
+    return (long long)pool->num_of_node_chunks * BP_NODE_CHUNK_SIZE * sizeof(struct node_t) +
+           (long long)pool->num_of_byte_chunks * BP_BYTE_CHUNK_SIZE;
+} /* -- end of bp_reserved (..) -- */
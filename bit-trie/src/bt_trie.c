@@ -26,6 +26,166 @@
 
 #include "bt_trie.h"
 #include "bt_struct.h"
+#include "bp_pool.h"
+#include "ep_epoch.h"
+#include "jt_jump.h"
+
+/* -----------------------------------------------------------------
+ * Method: bt_set_child (..)
+ * Scope: Private
+ *
+ * Description:
+ * Link a node (may be NULL) to a given child of a parent. The link
+ * is published to readers by a single store.
+ * ------------------------------------------------------------------ */
+static inline void
+bt_set_child (struct bt_instance* bt, unsigned int parent, int child, unsigned int node)
+{
+    if (node)
+        BT_NODE(bt, node)->parent = parent;
+    if (!child)
+        EP_PUBLISH(BT_NODE(bt, parent)->child_0, node);
+    else
+        EP_PUBLISH(BT_NODE(bt, parent)->child_1, node);
+} /* -- end of bt_set_child (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bt_node_replace (..)
+ * Scope: Private
+ *
+ * Description:
+ * Publish a new node in the place of an old one (i.e. as the same
+ * child of the same parent), and retire the old one. The children of
+ * the new node should be linked already. The jump table (if any) stops
+ * referring to the old node before it is retired.
+ * ------------------------------------------------------------------ */
+static void
+bt_node_replace (struct bt_instance* bt, unsigned int old, unsigned int node)
+{
+    unsigned int parent = BT_NODE(bt, old)->parent;
+    struct node_t* new_node = BT_NODE(bt, node);
+    int child = (BT_NODE(bt, parent)->child_0 == old) ? 0 : 1;
+
+    bt_set_child (bt, parent, child, node);
+    // -- the parent is read only by the writer, so it is updated in place -- //
+    if (new_node->child_0)
+        BT_NODE(bt, new_node->child_0)->parent = node;
+    if (new_node->child_1)
+        BT_NODE(bt, new_node->child_1)->parent = node;
+    jt_link (bt, parent, child, BT_NODE(bt, old)->len);
+    ep_retire (&bt->epoch, (void*)(unsigned long)old, bt_reclaim_node);
+} /* -- end of bt_node_replace (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bt_node_copy (..)
+ * Scope: Private
+ *
+ * Description:
+ * Build a copy of a node (its content and children) with a given
+ * EON flag, aside (i.e. not linked to its parent).
+ *
+ * RETURN:
+ *    index of the copy, or BP_NULL if there is no memory
+ * ------------------------------------------------------------------ */
+static unsigned int
+bt_node_copy (struct bt_instance* bt, unsigned int index, bool EON_flag)
+{
+    struct node_t* node = BT_NODE(bt, index);
+    unsigned int copy;
+    char* bytes;
+
+    if (!(copy = bp_new_node (&bt->pool)))
+        return BP_NULL;
+    if (!(bytes = bt_node_alloc_bytes (bt, BT_NODE(bt, copy), node->len)))
+    {
+        bt_reclaim_node (bt, (void*)(unsigned long)copy);
+        return BP_NULL;
+    }
+    memcpy (bytes, bt_node_bytes (bt, node), NUM_OF_BYTES(node->len));
+    BT_NODE(bt, copy)->EON_flag = EON_flag;
+    BT_NODE(bt, copy)->child_0 = node->child_0;
+    BT_NODE(bt, copy)->child_1 = node->child_1;
+    return copy;
+} /* -- end of bt_node_copy (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bt_node_fill (..)
+ * Scope: Private
+ *
+ * Description:
+ * Set the content of a new node to the given bits of a source (i.e.
+ * a name or content of another node).
+ *
+ * RETURN:
+ *    0: DONE!
+ *    1: ERROR
+ * ------------------------------------------------------------------ */
+static int
+bt_node_fill (struct bt_instance* bt, unsigned int index, const char* src, int src_start, int src_end)
+{
+    char* bytes;
+
+    if (!(bytes = bt_node_alloc_bytes (bt, BT_NODE(bt, index), src_end - src_start + 1)))
+        return 1;
+    return bt_byte_cpy (src, bytes, src_start, src_end);
+} /* -- end of bt_node_fill (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bt_init (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Initialize the pools of an instance, and add the root (i.e. "/"
+ * which is not EON) to it.
+ *
+ * RETURN:
+ *    0: DONE!
+ *    1: ERROR (no memory)
+ * ------------------------------------------------------------------ */
+int
+bt_init (struct bt_instance* bt)
+{
+    assert (bt);
+    char* bytes;
+
+    if (bp_init (&bt->pool))
+    {
+        fprintf (stderr, "[bt_init] ERROR: Memory allocation has been failed.\n");
+        return 1;
+    }
+    if (!(bt->root = bp_new_node (&bt->pool)) ||
+        !(bytes = bt_node_alloc_bytes (bt, BT_ROOT(bt), 8 /*in terms of bit*/)))
+    {
+        bp_destroy (&bt->pool);
+        return 1;
+    }
+    bytes[0] = (char)SLASH;
+    BT_ROOT(bt)->EON_flag = false;    // -- this is not EON -- //
+    bt->jump = 0;                     // -- no jump table (see jt_init) -- //
+    bt->jump_bits = 0;
+    ep_init (&bt->epoch, bt);
+    return 0;
+} /* -- end of bt_init (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bt_destroy (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Release all nodes and contents of an instance at once, by giving
+ * its pools back. The instance is empty (even without the root) then.
+ * No reader should be in a read section anymore.
+ * ------------------------------------------------------------------ */
+void
+bt_destroy (struct bt_instance* bt)
+{
+    assert (bt);
+
+    ep_destroy (&bt->epoch);   // -- reclaim retired nodes first -- //
+    jt_destroy (bt);
+    bp_destroy (&bt->pool);
+    bt->root = BP_NULL;
+} /* -- end of bt_destroy (..) -- */
 
 /* -----------------------------------------------------------------
  * Method: bt_insert (..)
@@ -42,147 +202,74 @@ bt_insert (struct bt_instance* bt, const char* name, bool print_flag)
 {
     int bit_walker = 0;       // -- index of the input name (in terms of bit) -- //
     int node_bit_walker = 0;  // -- index of content of the current node (in terms of bit) -- //
-    char slider;              // -- extracted byte of the input byte (i.e. slider) -- //
-    int ret_compare;          // -- result of byte comparison -- //
-    int name_len = strlen(name);
+    int name_len = strlen(name) * BYTE_LEN;   // -- in terms of bit -- //
     int child;                // -- 0 or 1 -- //
-    int num_of_bits;          // -- number of compared bits at each step -- //
+    unsigned int walker;      // -- index of the current node -- //
+    unsigned int parent;      // -- index of the parent of the current node -- //
+    unsigned int copy;        // -- index of a copy of the current node -- //
     struct node_t* node_walker;    // -- node traverser -- //
-    struct node_t* parent;         // -- parent of the current node -- //
 
-    // -- check the MSB of the first byte of the name -- //
-    if (BIT(name[0],7) == ZERO)
+    // -- skip the first levels by the jump table (if any), otherwise start at the root -- //
+    parent = bt->root; 
+    if (JT_COVERS(bt, name, name_len))
     {
-        node_walker = bt->root.child_0;
+        unsigned long long entry = bt->jump[jt_key (name, bt->jump_bits)];
+        parent = JT_INDEX(entry);
+        bit_walker = JT_END(entry);
+    }
+    // -- check the next bit of the name -- //
+    if (BIT(name[CURRENT_BYTE(bit_walker)], CURRENT_BIT(bit_walker)) == ZERO)
+    {
+        walker = BT_NODE(bt, parent)->child_0;
         child = 0;
     }
     else
     {
-        node_walker = bt->root.child_1;
+        walker = BT_NODE(bt, parent)->child_1;
         child = 1;
     }
-    parent = &(bt->root); 
 
     // -- welcome to loop party! -- //
-    while (node_walker) 
+    while (walker) 
     {
-        node_bit_walker = 0;
-        // -- slide the slider over the name -- //
-        while (CURRENT_BYTE(bit_walker) < name_len)
+        node_walker = BT_NODE(bt, walker);
+        // -- compare the whole content of the node with the rest of the name -- //
+        node_bit_walker = bt_bit_compare (name, name_len, bit_walker, bt_node_bytes (bt, node_walker), node_walker->len, 0);
+        bit_walker += node_bit_walker;
+        if (node_bit_walker < node_walker->len)
         {
-            if ( (CURRENT_BYTE(bit_walker) < name_len - 1) )
-            {
-                // -- middle byte -- //
-                slider = (char)BIT_SLIDER(name, CURRENT_BYTE(bit_walker), CURRENT_BIT(bit_walker));
-                if (node_walker->len - node_bit_walker >= BYTE_LEN)
-                    num_of_bits = BYTE_LEN;
-                else
-                    num_of_bits = node_walker->len - node_bit_walker;
-                if (num_of_bits <= 0)
-                    break; // -- end of the noed, search its child -- //
-                if ((ret_compare=(bt_byte_compare(slider, node_walker->bytes[CURRENT_BYTE(node_bit_walker)], num_of_bits))) == -1)
-                {
-                    bit_walker+=num_of_bits;
-                    node_bit_walker+=num_of_bits;
-                    continue;  // -- go to while -- //
-                }
-                else
-                {
-                    bit_walker+=ret_compare;
-                    node_bit_walker+=ret_compare;
-                    // -- if this is the end of the node, search its children -- //
-                    if (node_bit_walker == node_walker->len)
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        // -- partition the node -- //
-                        return (bt_node_partition (bt, node_walker, child, name, node_bit_walker, bit_walker, print_flag));
-                    }
-                } 
-            }
-            else
-            {
-                // -- the last byte -- //            
-                slider = BIT_SLIDER_LAST(name, CURRENT_BYTE(bit_walker), CURRENT_BIT(bit_walker)); 
-                if (node_walker->len - node_bit_walker >= BYTE_LEN)
-                    num_of_bits = BYTE_LEN;
-                else
-                    num_of_bits = node_walker->len - node_bit_walker;
-                if (num_of_bits <= 0)
-                    break; // -- end of the noed, search its child -- //
-                if ((ret_compare=(bt_byte_compare(slider, node_walker->bytes[CURRENT_BYTE(node_bit_walker)], num_of_bits))) == -1)
-                {
-                    int min = (num_of_bits < ((CURRENT_BIT(bit_walker) + 1))) ? num_of_bits : (CURRENT_BIT(bit_walker) + 1); 
-                    node_bit_walker += min;
-                    bit_walker += min;
-                    continue;  // -- go to while -- //
-                }
-                else
-                {
-                    node_bit_walker+=ret_compare;
-                    bit_walker+=ret_compare;
-                    // -- if this is the end of the node, search its children -- //
-                    if (node_bit_walker == node_walker->len)
-                    {
-                        break;
-                    }
-                    // -- if this is the end of the name -- //
-                    if (CURRENT_BYTE(bit_walker) >= name_len)
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        // -- partition the name -- //
-                        return (bt_node_partition (bt, node_walker, child, name, node_bit_walker, bit_walker, print_flag));
-                    }
-                } 
-            }   
+            /**
+             * Either a bit of the node does not match, or the
+             * name ends in the middle of the node.
+             */
+            return (bt_node_partition (bt, walker, name, node_bit_walker, bit_walker, print_flag));
         }
-        // -- if this is not the end of the name, go to the next node -- //
-        if (CURRENT_BYTE(bit_walker) >= name_len)
+        if (bit_walker >= name_len)
         {
             /**
-             * Possible cases:
-             *     1- End of the node + EON ON  => Do nothing
-             *     2- End of the node + EON OFF => Turn ON EON
-             *     3- NOT end of name + EON ON  => Partition the node
-             *     4- NOT end of name + EON OFF => Partition the node
+             * End of the node and the name:
+             *     1- EON ON  => Do nothing
+             *     2- EON OFF => Turn ON EON (on a copy of the node)
              */
-            if (node_bit_walker >= node_walker->len)
+            if (!node_walker->EON_flag)
             {
-                // -- end of the node and name -- //
-                if (node_walker->EON_flag)
-                {
-                    // -- do nothing -- //
-                    return node_walker;
-                }
-                else
-                {
-                    // -- Turn ON EON -- //
-                    node_walker->EON_flag = true;
-                    return node_walker;
-                }
-            }
-            else
-            {
-                // -- middle of the name -- //
-                return (bt_node_partition (bt, node_walker, child, name, node_bit_walker, bit_walker, print_flag));
+                if (!(copy = bt_node_copy (bt, walker, true)))
+                    return 0;
+                bt_node_replace (bt, walker, copy);
+                node_walker = BT_NODE(bt, copy);
             }
+            return node_walker;
         }
         // -- name is NOT found, use the current bit to find the next child -- //
+        parent = walker;
         if (BIT(name[CURRENT_BYTE(bit_walker)], CURRENT_BIT(bit_walker)) == ZERO)
         {
-            parent = node_walker;
-            node_walker = node_walker->child_0;
+            walker = node_walker->child_0;
             child = 0;
         }
         else 
         {
-            parent = node_walker;
-            node_walker = node_walker->child_1;
+            walker = node_walker->child_1;
             child = 1;
         }
     }
@@ -196,298 +283,116 @@ bt_insert (struct bt_instance* bt, const char* name, bool print_flag)
  * Scope: Protected
  * ------------------------------------------------------------------ */
 struct node_t*
-bt_do_insert (struct bt_instance* bt, struct node_t* parent, int child, const char* name, int node_bit_walker, int bit_walker, bool print_flag)
+bt_do_insert (struct bt_instance* bt, unsigned int parent, int child, const char* name, int node_bit_walker, int bit_walker, bool print_flag)
 {
     assert (bt);
     assert (name);
    
     int name_len = strlen(name);
-    struct node_t* node;
-    if (!child)
-        node = parent->child_0; 
-    else
-        node = parent->child_1;
+    unsigned int index;
 
     // -- if node is null, just add the rest of the name -- //
-    if (!node)
-    {
-        if (!child)
-        {
-            parent->child_0 = (struct node_t*)malloc(sizeof(struct node_t));
-            node = parent->child_0;
-        }
-        else
-        {        
-            parent->child_1 = (struct node_t*)malloc(sizeof(struct node_t));
-            node = parent->child_1;
-        }
-        node->child_0 = 0;
-        node->child_1 = 0;
-        node->len = (name_len*BYTE_LEN) - bit_walker;
-        node->EON_flag = true;
-        node->bytes = (char*)malloc(node->len/BYTE_LEN + 1);
-        node_bit_walker = 0;
-        // -- add remaining bits -- //
-        if (bt_byte_cpy (name, node, bit_walker, (name_len*BYTE_LEN)-1))
-        {
-            fprintf (stderr, "[bt_do_insert] ERROR: An error occured while copying bytes.\n");
-            return 0;
-        }
-
-        // -- add parent -- //
-        node->parent = parent;
-    }
-    else
+    if ((!child && BT_NODE(bt, parent)->child_0) || (child && BT_NODE(bt, parent)->child_1))
     {
         // -- we should not be here -- //
         fprintf (stderr, "[bt_do_insert] ERROR: There is a problem in do_insertion.\n");
         return 0;
     }
+    if (!(index = bp_new_node (&bt->pool)))
+        return 0;
+    BT_NODE(bt, index)->EON_flag = true;
+    // -- add remaining bits -- //
+    if (bt_node_fill (bt, index, name, bit_walker, (name_len*BYTE_LEN)-1))
+    {
+        fprintf (stderr, "[bt_do_insert] ERROR: An error occured while copying bytes.\n");
+        bt_reclaim_node (bt, (void*)(unsigned long)index);
+        return 0;
+    }
+
+    // -- add parent (i.e. publish the node) -- //
+    bt_set_child (bt, parent, child, index);
+    jt_link (bt, parent, child, 0);
 
     // -- insertion is done -- //
-    return node;
+    return BT_NODE(bt, index);
 } /* -- end of bt_do_insert (..) -- */
 
-
 /* -----------------------------------------------------------------
  * Method: bt_node_partition (..)
  * Scope: Protected
  *
  * Description:
  * Parition a name from a given bit number. The content of the current
- * node will be splitted. So that, the upper part will remain in the same
- * node, while the lower part will shifted to a new node.
- * Moreover, a new node will be added to the current node which contains 
+ * node will be splitted. So that, the upper part will go to a new node
+ * which takes the place of the current node, while the lower part will
+ * shifted to a new child of it.
+ * Moreover, a new node will be added to the upper node which contains 
  * all remaining bits of the current name.
+ *
+ * NOTE:
+ *     All new nodes are built aside, and published at once by linking
+ *     the upper node to the parent. The current node is retired.
  * ------------------------------------------------------------------ */
 struct node_t*
-bt_node_partition (struct bt_instance* bt, struct node_t* node, int child, const char* name, int node_bit_walker, int bit_walker, bool print_flag)
+bt_node_partition (struct bt_instance* bt, unsigned int index, const char* name, int node_bit_walker, int bit_walker, bool print_flag)
 {
     assert (bt);
     assert (name);
 
     // -- split the current node -- //
-    if (!node)
+    if (!index)
     {
         // -- something is wrong -- //
         fprintf (stderr, "[bt_node_parition] ERROR: A NULL node.\n");  
         return 0;
     }
     int name_len = strlen(name);
-    int org_EON_flag = node->EON_flag;  // -- before paritioning the node, remember its flag -- //
-    // -- the parent will point to this child at the end -- //
-    struct node_t* new_node;
-    struct node_t* parent;
-    // -- make a copy of the current node -- //
-    struct node_t* node_tmp = (struct node_t*)malloc(sizeof(struct node_t));
-    *node_tmp = *node;
-    parent = (node->parent);
-
-    // -- now remove the node -- //
-    if (!child) 
-    {
-        if (!parent || !parent->child_0)
-        {
-            // -- something is wrong -- //
-            fprintf (stderr, "[bt_node_partition] ERROR: An error occured while partitioning the node.\n");
-            free (node_tmp->bytes);
-            free (node_tmp);
-            return 0;
-        }
-        parent->child_0->parent = 0;
-        free(parent->child_0);
-        parent->child_0 = (struct node_t*)malloc(sizeof(struct node_t));
-        new_node = parent->child_0;  
-    }
-    else
-    {
-        if (!parent || !parent->child_1)
-        {
-            // -- something is wrong -- //
-            fprintf (stderr, "[bt_node_partition] ERROR: An error occured while partitioning the node.\n");
-            free (node_tmp->bytes);
-            free (node_tmp);
-            return 0;
-        }
-        parent->child_1->parent = 0;
-        free(parent->child_1);
-        parent->child_1 = (struct node_t*)malloc(sizeof(struct node_t));
-        new_node = parent->child_1;
-    }
-
-    // -- allocate two children for the future two nodes -- //
-    new_node->child_0 = 0;
-    new_node->child_1 = 0;
-  
-    // -- set the parent -- //
-    new_node->parent = node_tmp->parent; 
+    struct node_t* node = BT_NODE(bt, index);
+    unsigned int upper = bp_new_node (&bt->pool);   // -- the upper part of the content -- //
+    unsigned int lower = bp_new_node (&bt->pool);   // -- the lower part, with the children and flag of the node -- //
+    unsigned int rest = BP_NULL;                    // -- the remaining of the name -- //
+    char which_child;
 
+    // -- ONLY if there is some bit of the input name to insert, build this node -- //
     if (CURRENT_BYTE(bit_walker) < name_len)
-        new_node->EON_flag = false;
-    else
-        new_node->EON_flag = true;
- 
-    // -- allocate the bytes -- //
-    new_node->len = node_bit_walker;
-    new_node->bytes = (char*)malloc(node_bit_walker/BYTE_LEN + 1); 
-
-    // -- copy the upper part of the content, byte-by-byte -- //
-    if (bt_byte_cpy ((const char*)node_tmp->bytes, new_node, 0, node_bit_walker-1 /*zero-based*/))
+        rest = bp_new_node (&bt->pool);
+    if (!upper || !lower || (CURRENT_BYTE(bit_walker) < name_len && !rest) ||
+        bt_node_fill (bt, upper, (const char*)bt_node_bytes (bt, node), 0, node_bit_walker-1 /*zero-based*/) ||
+        bt_node_fill (bt, lower, (const char*)bt_node_bytes (bt, node), node_bit_walker, node->len-1) ||
+        (rest && bt_node_fill (bt, rest, name, bit_walker, (name_len*BYTE_LEN)-1)))
     {
         fprintf (stderr, "[bt_node_partition] ERROR: An error occured while copying bytes.\n");
-        free (node_tmp->bytes);
-        free (node_tmp);
+        bt_reclaim_node (bt, (void*)(unsigned long)upper);
+        bt_reclaim_node (bt, (void*)(unsigned long)lower);
+        bt_reclaim_node (bt, (void*)(unsigned long)rest);
         return 0;
     }
+    BT_NODE(bt, upper)->EON_flag = (rest == BP_NULL);
+    BT_NODE(bt, lower)->EON_flag = node->EON_flag;
+    if (rest)
+        BT_NODE(bt, rest)->EON_flag = true;
 
     // -- build children -- //
-    char which_child;
-    if (CURRENT_BYTE(bit_walker) < name_len)
+    if (rest)
         which_child = BIT(name[CURRENT_BYTE(bit_walker)], CURRENT_BIT(bit_walker));
     else
-        which_child = !(BIT(node_tmp->bytes[CURRENT_BYTE(node_bit_walker)], CURRENT_BIT(node_bit_walker)));
-    
-
+        which_child = !(BIT(bt_node_bytes (bt, BT_NODE(bt, lower))[0], 7));
+    bt_set_child (bt, lower, 0, node->child_0);
+    bt_set_child (bt, lower, 1, node->child_1);
     if (which_child == ZERO)
     {
-        // -- ONLY if there is some bit of the input name to insert, build this node -- //
-        if (CURRENT_BYTE(bit_walker) < name_len)
-        {
-            // -- build child_0 -- //
-            new_node->child_0 = (struct node_t*)malloc(sizeof(struct node_t));
-            new_node->child_0->EON_flag = true;
-            new_node->child_0->len = (name_len*BYTE_LEN) - bit_walker;
-            new_node->child_0->child_0 = 0;
-            new_node->child_0->child_1 = 0;
-            new_node->child_0->bytes = (char*)malloc(new_node->child_0->len/BYTE_LEN + 1);
-            new_node->child_0->parent = new_node;
-            // -- copy the remainig of the name -- //
-            if (bt_byte_cpy (name, new_node->child_0, bit_walker, (name_len*BYTE_LEN)-1))
-            {
-                fprintf (stderr, "[bt_node_partition] ERROR: An error occured while copying bytes.\n");
-                free (node_tmp->bytes);
-                free (node_tmp);
-                return 0;
-            } 
-        }
-        else
-        {
-            // -- do NOT initialize it -- //
-            new_node->child_0 = 0;
-        }
-        // -- now build child_1 -- //
-        new_node->child_1 = (struct node_t*)malloc(sizeof(struct node_t));
-        if (org_EON_flag)
-            new_node->child_1->EON_flag = true;
-        else
-            new_node->child_1->EON_flag = false;
-        new_node->child_1->len = node_tmp->len - node_bit_walker;
-        new_node->child_1->child_0 = 0;
-        new_node->child_1->child_1 = 0;
-        new_node->child_1->bytes = (char*)malloc(new_node->child_1->len/BYTE_LEN + 1);
-        new_node->child_1->parent = new_node;
-        // -- copy the remainig of node's content -- //
-        if (bt_byte_cpy ((const char*)node_tmp->bytes, new_node->child_1, node_bit_walker, node_tmp->len-1))
-        {
-            fprintf (stderr, "[bt_node_partition] ERROR: An error occured while copying bytes.\n");
-            free (node_tmp->bytes);
-            free (node_tmp);
-            return 0;
-        }
-        // -- copy children -- //
-        if (node_tmp->child_0 != 0)
-        {
-            new_node->child_1->child_0 = node_tmp->child_0;
-            new_node->child_1->child_0->parent = new_node->child_1;
-            // -- make the children of this child to point to the new child -- //
-            if (new_node->child_1->child_0->child_1 != 0)
-                new_node->child_1->child_0->child_1->parent = new_node->child_1->child_0;
-            if (new_node->child_1->child_0->child_0 != 0)
-                new_node->child_1->child_0->child_0->parent = new_node->child_1->child_0;
-        }
-        if (node_tmp->child_1 != 0)
-        {            
-            new_node->child_1->child_1 = node_tmp->child_1;
-            new_node->child_1->child_1->parent = new_node->child_1;
-            // -- make the children of this child to point to the new child -- //
-            if (new_node->child_1->child_1->child_1 != 0)
-                new_node->child_1->child_1->child_1->parent = new_node->child_1->child_1;
-            if (new_node->child_1->child_1->child_0 != 0)
-                new_node->child_1->child_1->child_0->parent = new_node->child_1->child_1;
-        }
+        bt_set_child (bt, upper, 0, rest);
+        bt_set_child (bt, upper, 1, lower);
     }
     else
     {
-        if (CURRENT_BYTE(bit_walker) < name_len)
-        {
-            // -- build child_1 -- //  
-            new_node->child_1 = (struct node_t*)malloc(sizeof(struct node_t));
-            new_node->child_1->EON_flag = true;
-            new_node->child_1->len = (name_len*BYTE_LEN) - bit_walker;
-            new_node->child_1->child_0 = 0;
-            new_node->child_1->child_1 = 0;
-            new_node->child_1->bytes = (char*)malloc(new_node->child_1->len/BYTE_LEN + 1);
-            new_node->child_1->parent = new_node;
-        
-            // -- copy the remainig of the name -- //
-            if (bt_byte_cpy (name, new_node->child_1, bit_walker, (name_len*BYTE_LEN)-1))
-            {
-                fprintf (stderr, "[bt_node_partition] ERROR: An error occured while copying bytes.\n");
-                free (node_tmp->bytes);
-                free (node_tmp);
-                return 0;
-            } 
-        }
-        else
-        {
-            // -- do NOT initialize it -- //
-            new_node->child_1 = 0;
-        }
-        // -- now build child_0 -- //
-        new_node->child_0 = (struct node_t*)malloc(sizeof(struct node_t));
-        if (org_EON_flag)
-            new_node->child_0->EON_flag = true;
-        else
-            new_node->child_0->EON_flag = false;
-        new_node->child_0->len = node_tmp->len - node_bit_walker;
-        new_node->child_0->child_0 = 0;
-        new_node->child_0->child_1 = 0;
-        new_node->child_0->bytes = (char*)malloc(new_node->child_0->len/BYTE_LEN + 1);
-        new_node->child_0->parent = new_node;
-
-        // -- copy the remainig of node's content -- //
-        if (bt_byte_cpy ((const char*)node_tmp->bytes, new_node->child_0, node_bit_walker, node_tmp->len-1))
-        {
-            fprintf (stderr, "[bt_node_partition] ERROR: An error occured while copying bytes.\n");
-            free (node_tmp->bytes);
-            free (node_tmp);
-            return 0;
-        } 
-        // -- copy children -- //
-        if (node_tmp->child_0 != 0)
-        {
-            new_node->child_0->child_0 = node_tmp->child_0;
-            new_node->child_0->child_0->parent = new_node->child_0;
-            // -- make the children of this child to point to the new child -- //
-            if (new_node->child_0->child_0->child_1 != 0)
-                new_node->child_0->child_0->child_1->parent = new_node->child_0->child_0;
-            if (new_node->child_0->child_0->child_0 != 0)
-                new_node->child_0->child_0->child_0->parent = new_node->child_0->child_0;
-        }
-        if (node_tmp->child_1 != 0)
-        {            
-            new_node->child_0->child_1 = node_tmp->child_1;
-            new_node->child_0->child_1->parent = new_node->child_0;
-            // -- make the children of this child to point to the new child -- //
-            if (new_node->child_0->child_1->child_1 != 0)
-                new_node->child_0->child_1->child_1->parent = new_node->child_0->child_1;
-            if (new_node->child_0->child_1->child_0 != 0)
-                new_node->child_0->child_1->child_0->parent = new_node->child_0->child_1;
-        }
+        bt_set_child (bt, upper, 1, rest);
+        bt_set_child (bt, upper, 0, lower);
     }
-    free (node_tmp->bytes);
-    free (node_tmp);
-    return new_node;
+
+    // -- publish -- //
+    bt_node_replace (bt, index, upper);
+    return BT_NODE(bt, upper);
 } /* -- end of bt_node_partition(..) -- */
 
 
@@ -505,7 +410,7 @@ bt_node_partition (struct bt_instance* bt, struct node_t* node, int child, const
  *    1: ERROR
  * ------------------------------------------------------------------ */
 int
-bt_byte_cpy (const char* src, struct node_t* dst_node, int src_start, int src_end)
+bt_byte_cpy (const char* src, char* dst, int src_start, int src_end)
 {
 
     int src_bit_walker = src_start;
@@ -513,7 +418,7 @@ bt_byte_cpy (const char* src, struct node_t* dst_node, int src_start, int src_en
     char slider;
     int rem_bits;   // -- number of bits of the last extracted byte -- // 
 
-    if (!src || !dst_node)
+    if (!src || !dst)
     {
         // -- bad input -- //
         fprintf (stderr, "[bt_byte_cpy] ERROR: Bad input.\n");
@@ -527,7 +432,7 @@ bt_byte_cpy (const char* src, struct node_t* dst_node, int src_start, int src_en
         {
             // -- middle byte -- //
             slider = (char)BIT_SLIDER(src, CURRENT_BYTE(src_bit_walker), CURRENT_BIT(src_bit_walker));
-            memcpy (dst_node->bytes + CURRENT_BYTE(dst_bit_walker), &slider, 1);
+            memcpy (dst + CURRENT_BYTE(dst_bit_walker), &slider, 1);
             src_bit_walker+=BYTE_LEN;
             dst_bit_walker+=BYTE_LEN;
         }
@@ -562,7 +467,7 @@ bt_byte_cpy (const char* src, struct node_t* dst_node, int src_start, int src_en
                 mask = (char)BIT_MASK_LOW_ZERO(BYTE_LEN-rem_bits);
             }
             slider &= mask;
-            memcpy (dst_node->bytes + CURRENT_BYTE(dst_bit_walker), &slider, 1);
+            memcpy (dst + CURRENT_BYTE(dst_bit_walker), &slider, 1);
             src_bit_walker += rem_bits;
             dst_bit_walker += rem_bits;
         }
@@ -586,7 +491,7 @@ bt_byte_cpy (const char* src, struct node_t* dst_node, int src_start, int src_en
  *    1: ERROR
  * ------------------------------------------------------------------ */
 int
-bt_byte_cpy_index (const char* src, struct node_t* dst_node, int dst_start, int src_start, int src_end)
+bt_byte_cpy_index (const char* src, char* dst, int dst_start, int src_start, int src_end)
 {
 
     int src_bit_walker = src_start;
@@ -594,7 +499,7 @@ bt_byte_cpy_index (const char* src, struct node_t* dst_node, int dst_start, int
     char slider;
     int rem_bits;   // -- number of bits of the last extracted byte from src -- // 
     int pad;        // -- number of free bits of the first byte of dst -- //
-    if (!src || !dst_node)
+    if (!src || !dst)
     {
         // -- bad input -- //
         fprintf (stderr, "[bt_byte_cpy] ERROR: Bad input.\n");
@@ -612,7 +517,7 @@ bt_byte_cpy_index (const char* src, struct node_t* dst_node, int dst_start, int
                 pad = BYTE_LEN - (dst_start%BYTE_LEN);
                 slider = (char)BIT_SLIDER(src, CURRENT_BYTE(src_bit_walker), CURRENT_BIT(src_bit_walker));
                 slider = slider>>(BYTE_LEN - pad);
-                dst_node->bytes[CURRENT_BYTE(dst_bit_walker)] |= slider;
+                dst[CURRENT_BYTE(dst_bit_walker)] |= slider;
                 src_bit_walker+=pad;
                 dst_bit_walker+=pad; 
             }
@@ -649,7 +554,7 @@ bt_byte_cpy_index (const char* src, struct node_t* dst_node, int dst_start, int
                 }
                 slider &= mask;
                 slider = slider>>(BYTE_LEN - pad);
-                dst_node->bytes[CURRENT_BYTE(dst_bit_walker)] |= slider;
+                dst[CURRENT_BYTE(dst_bit_walker)] |= slider;
                 src_bit_walker+= (pad < rem_bits) ? pad : rem_bits;
                 dst_bit_walker+= (pad < rem_bits) ? pad : rem_bits;
             }
@@ -667,7 +572,7 @@ bt_byte_cpy_index (const char* src, struct node_t* dst_node, int dst_start, int
         {
             // -- middle byte -- //
             slider = (char)BIT_SLIDER(src, CURRENT_BYTE(src_bit_walker), CURRENT_BIT(src_bit_walker));
-            memcpy (dst_node->bytes + CURRENT_BYTE(dst_bit_walker), &slider, 1);
+            memcpy (dst + CURRENT_BYTE(dst_bit_walker), &slider, 1);
             src_bit_walker+=BYTE_LEN;
             dst_bit_walker+=BYTE_LEN;
         }
@@ -701,7 +606,7 @@ bt_byte_cpy_index (const char* src, struct node_t* dst_node, int dst_start, int
                 mask = (char)BIT_MASK_LOW_ZERO(BYTE_LEN-rem_bits);
             }
             slider &= mask;
-            memcpy (dst_node->bytes + CURRENT_BYTE(dst_bit_walker), &slider, 1);
+            memcpy (dst + CURRENT_BYTE(dst_bit_walker), &slider, 1);
             src_bit_walker += rem_bits;
             dst_bit_walker += rem_bits;
         }
@@ -740,7 +645,10 @@ bt_remove (struct bt_instance* bt, const char* name, bool print_flag)
     assert (name);
 
     struct node_t* node;            // -- working node -- //
-    struct node_t* parent;          // -- parent of the working node -- //
+    struct node_t* parent_node;     // -- parent of the working node -- //
+    unsigned int index;             // -- index of the working node -- //
+    unsigned int parent;
+    unsigned int copy;
     int child;
 
     // -- start exact name lookup -- //
@@ -754,18 +662,20 @@ bt_remove (struct bt_instance* bt, const char* name, bool print_flag)
 
     // ======= start removing procedure ====== //
     parent = node->parent; 
+    parent_node = BT_NODE(bt, parent);
     // -- which child -- //
-    if (parent->child_0 == node)
+    if (parent_node->child_0 && BT_NODE(bt, parent_node->child_0) == node)
         child = 0;
     else
     {
-        if (parent->child_1 != node)
+        if (!parent_node->child_1 || BT_NODE(bt, parent_node->child_1) != node)
         {
             fprintf (stderr, "[bt_remove] ERROR: An error has been occured while removeing.\n");
             return 2;
         }
         child = 1;
     }
+    index = child ? parent_node->child_1 : parent_node->child_0;
     // -- some pre-checks -- //
     if (!node->EON_flag)
     {
@@ -775,8 +685,8 @@ bt_remove (struct bt_instance* bt, const char* name, bool print_flag)
     }
     /**
      * Cases:
-     *     1- node has two children -> Set EON to OFF
-     *     2- node has one child    -> Set EON to OFF + Merge
+     *     1- node has two children -> Set EON to OFF (on a copy of the node)
+     *     2- node has one child    -> Merge (EON of the child is kept)
      *     3- node has no child     -> Remove node + Check parent
      *     4- parent is EON         -> Do nothing
      *     5- parent is NOT EON     -> Merge 
@@ -787,31 +697,25 @@ bt_remove (struct bt_instance* bt, const char* name, bool print_flag)
     // -- check children of this node -- //
     if (node->child_0 !=0 && node->child_1 != 0)
     {            
-        node->EON_flag = false;
+        if (!(copy = bt_node_copy (bt, index, false)))
+            return 2;
+        bt_node_replace (bt, index, copy);
         return 0;
     }
 
     if (!node->child_0 && !node->child_1)
     {
         // -- This is a LEAF, remove it -- //
-        if (!child)
-        {
-            bt_free_node (parent->child_0);
-            free (parent->child_0);
-            parent->child_0 = 0;
-        }
-        else
-        {
-            bt_free_node (parent->child_1);
-            parent->child_1 = 0;
-        }
+        bt_set_child (bt, parent, child, BP_NULL);
+        jt_link (bt, parent, child, node->len);
+        ep_retire (&bt->epoch, (void*)(unsigned long)index, bt_reclaim_node);
         // -- check the parent -- //
-        if (parent == &(bt->root))
+        if (parent == bt->root)
         {
             // -- do not merge the root -- //
             return 0;
         }
-        if (parent->EON_flag)
+        if (parent_node->EON_flag)
         {
             return 0;
         }
@@ -828,12 +732,11 @@ bt_remove (struct bt_instance* bt, const char* name, bool print_flag)
     }
     else // -- node with one child -- //
     {
-        node->EON_flag = false;
         if (!node->child_0)
             child = 1;
         else 
             child = 0;
-        if (!bt_node_merge(bt, node, child, print_flag))
+        if (!bt_node_merge(bt, index, child, print_flag))
         {
             fprintf (stderr, "[bt_remove] ERROR: An error occured while merging.\n");
             return 2;
@@ -849,16 +752,20 @@ bt_remove (struct bt_instance* bt, const char* name, bool print_flag)
  * Scope: Protected
  *
  * Description:
- * Merge a node with one of its leaves.
+ * Merge a node with one of its leaves. The merged node is built aside
+ * and takes the place of the node; both of them are retired.
  * ------------------------------------------------------------------ */
 struct node_t*
-bt_node_merge (struct bt_instance* bt, struct node_t* parent, int child, bool print_flag)
+bt_node_merge (struct bt_instance* bt, unsigned int parent, int child, bool print_flag)
 {
     assert (bt);
     
-    struct node_t* tmp_node = (struct node_t*)malloc(sizeof(struct node_t));
-    struct node_t* child_node = (struct node_t*)malloc(sizeof(struct node_t));
+    struct node_t* parent_node;
+    struct node_t* child_node;
+    unsigned int child_index;
+    unsigned int merged;
     int dst_start = 0;
+    char* bytes;
 
     // -- some pre-checks -- //
     if (!parent)
@@ -866,87 +773,46 @@ bt_node_merge (struct bt_instance* bt, struct node_t* parent, int child, bool pr
         fprintf (stderr, "[bt_node_merge] ERROR: Parent is NULL.\n");
         return 0;
     } 
-    // -- start merging -- //
-    if (!child)
-        *child_node = *parent->child_0; 
-    else
-        *child_node = *parent->child_1; 
-    tmp_node->len = parent->len + child_node->len;
-    tmp_node->bytes = (char*)malloc((tmp_node->len/BYTE_LEN)+1);
-
-    // -- just initialize to make sure node_remove works properly -- //
-    tmp_node->child_0 = 0;
-    tmp_node->child_1 = 0;
-    tmp_node->parent = 0;
-
-    if (bt_byte_cpy_index ((const char*)parent->bytes, tmp_node, dst_start, 0, (parent->len-1)))
+    parent_node = BT_NODE(bt, parent);
+    child_index = child ? parent_node->child_1 : parent_node->child_0;
+    if (!child_index)
     {
-        fprintf (stderr, "[bt_node_merge] ERROR: An error has been occured while copying parent bytes.\n");
-        bt_free_node(tmp_node);
-        free(tmp_node);
-        free(child_node->bytes);
-        free(child_node);
-        return 0;
-    }
-    dst_start += parent->len;
-    if (bt_byte_cpy_index ((const char*)child_node->bytes, tmp_node, dst_start, 0, (child_node->len-1)))
-    {
-        fprintf (stderr, "[bt_node_merge] ERROR: An error has been occured while copying child bytes.\n");
-        bt_free_node(tmp_node);
-        free(tmp_node);
-        free(child_node->bytes);
-        free(child_node);
+        fprintf (stderr, "[bt_node_merge] ERROR: Child is NULL.\n");
         return 0;
     }
-    // -- update the parent -- //
-    parent->len = tmp_node->len;
-    parent->bytes = realloc(parent->bytes, (((parent->len)/BYTE_LEN) + 1));
-    memcpy (parent->bytes, tmp_node->bytes, (((parent->len)/BYTE_LEN) + 1)); 
+    child_node = BT_NODE(bt, child_index);
 
-    // -- copy children -- //
-    if (child_node->child_0 != 0)
-    {
-        if (parent->child_0 != 0)
-            free (parent->child_0);
-        parent->child_0 = child_node->child_0;
-        parent->child_0->parent = parent; 
-    }
-    else
+    // -- start merging -- //
+    if (!(merged = bp_new_node (&bt->pool)))
+        return 0;
+    if (!(bytes = bt_node_alloc_bytes (bt, BT_NODE(bt, merged), parent_node->len + child_node->len)))
     {
-        if (parent->child_0)
-        {
-            //bt_free_node (parent->child_0);
-            parent->child_0->parent = 0;
-            free(parent->child_0);
-        }
-        parent->child_0 = 0;
+        bt_reclaim_node (bt, (void*)(unsigned long)merged);
+        return 0;
     }
-    if (child_node->child_1 != 0)
+    if (bt_byte_cpy_index ((const char*)bt_node_bytes (bt, parent_node), bytes, dst_start, 0, (parent_node->len-1)))
     {
-        if (parent->child_1 != 0)
-            free (parent->child_1);
-        parent->child_1 = child_node->child_1;
-        parent->child_1->parent = parent;
+        fprintf (stderr, "[bt_node_merge] ERROR: An error has been occured while copying parent bytes.\n");
+        bt_reclaim_node (bt, (void*)(unsigned long)merged);
+        return 0;
     }
-    else
+    dst_start += parent_node->len;
+    if (bt_byte_cpy_index ((const char*)bt_node_bytes (bt, child_node), bytes, dst_start, 0, (child_node->len-1)))
     {
-        if (parent->child_1)
-        {
-            //bt_free_node (parent->child_1);
-            parent->child_1->parent = 0; 
-            free(parent->child_1);
-        }
-        parent->child_1 = 0;
+        fprintf (stderr, "[bt_node_merge] ERROR: An error has been occured while copying child bytes.\n");
+        bt_reclaim_node (bt, (void*)(unsigned long)merged);
+        return 0;
     }
-    if (child_node->EON_flag)
-        parent->EON_flag = true;
-    else
-        parent->EON_flag = false;
-    bt_free_node(tmp_node);
-    free(tmp_node);
-    free (child_node->bytes);
-    free(child_node);
-    return parent;
+
+    // -- copy children and flag of the child -- //
+    BT_NODE(bt, merged)->child_0 = child_node->child_0;
+    BT_NODE(bt, merged)->child_1 = child_node->child_1;
+    BT_NODE(bt, merged)->EON_flag = child_node->EON_flag;
+
+    // -- publish -- //
+    bt_node_replace (bt, parent, merged);
+    ep_retire (&bt->epoch, (void*)(unsigned long)child_index, bt_reclaim_node);
+    return BT_NODE(bt, merged);
 } /* -- end of bt_node_merge(..) -- */
 
 /* -----------------------------------------------------------------
@@ -955,6 +821,10 @@ bt_node_merge (struct bt_instance* bt, struct node_t* parent, int child, bool pr
  *
  * Description:
  * Compare two bytes with each other. Comparison starts from MSB.
+ *
+ * NOTE:
+ *     The trie uses bt_bit_compare; this one is kept as the baseline
+ *     of the compare benchmark (see bench_compare in main.c).
  * RETURN:
  *    -1: Matched
  *     #: number of matched bits (between 1 to 7-one bit matches at least)
@@ -975,45 +845,128 @@ bt_byte_compare (char byte_1, char byte_2, int len)
     return -1;
 } /* -- end of bt_byte_compare(..) -- */
 
+/* -----------------------------------------------------------------
+ * Method: bt_load_word (..)
+ * Scope: Private
+ *
+ * Description:
+ * Load 64 bits of a bit string, starting from a given bit, into a
+ * word. The first bit goes to the MSB of the word, and the bits after
+ * the end of the string are ZERO.
+ * ------------------------------------------------------------------ */
+static inline unsigned long long
+bt_load_word (const char* bytes, int num_of_bytes, int bit)
+{
+    int byte = CURRENT_BYTE(bit);
+    int shift = bit % BYTE_LEN;
+    unsigned long long word = 0;
+
+    if (byte + WORD_BYTES <= num_of_bytes)
+    {
+        memcpy (&word, bytes + byte, WORD_BYTES);
+        word = WORD_TO_BE(word);
+    }
+    else
+    {
+        for (int i=0; byte + i < num_of_bytes; i++)
+            word |= (unsigned long long)(unsigned char)bytes[byte + i] << (WORD_LEN - (i+1)*BYTE_LEN);
+    }
+    if (shift)
+    {
+        word <<= shift;
+        // -- fill the low bits from the next byte -- //
+        if (byte + WORD_BYTES < num_of_bytes)
+            word |= (unsigned char)bytes[byte + WORD_BYTES] >> (BYTE_LEN - shift);
+    }
+    return word;
+} /* -- end of bt_load_word (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bt_bit_compare (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Compare two bit strings, word by word, from given bits of them. The
+ * words are XOR'ed and the first differing bit is the number of leading
+ * zeros of the result. The comparison stops at the end of the shorter
+ * string.
+ *
+ * RETURN:
+ *    number of matched bits
+ * ------------------------------------------------------------------ */
+int
+bt_bit_compare (const char* a, int a_len, int a_start, const char* b, int b_len, int b_start)
+{
+    int num_of_bits = a_len - a_start;
+    int matched = 0;
+    int step;
+    unsigned long long diff;
+
+    if (b_len - b_start < num_of_bits)
+        num_of_bits = b_len - b_start;
+
+    while (matched < num_of_bits)
+    {
+        diff = bt_load_word (a, NUM_OF_BYTES(a_len), a_start + matched) ^
+               bt_load_word (b, NUM_OF_BYTES(b_len), b_start + matched);
+        step = num_of_bits - matched;
+        if (step < WORD_LEN)
+            diff &= ~0ULL << (WORD_LEN - step);   // -- ignore bits after the end -- //
+        else
+            step = WORD_LEN;
+        if (diff)
+            return (matched + __builtin_clzll (diff));
+        matched += step;
+    }
+    return matched;
+} /* -- end of bt_bit_compare(..) -- */
+
 
 /* -----------------------------------------------------------------
  * Method: bt_lookup (..)
  * Scope: Protected
  *
  * Description:
- * Lookup a given name in the bit-level trie
+ * Lookup a given name in the bit-level trie. Children are loaded by
+ * EP_LOAD, so that a reader may run it while the writer modifies the
+ * trie (see bt_read_lookup).
  * ------------------------------------------------------------------ */
-struct node_t* bt_lookup (struct bt_instance* bt, const char* name, bool print_flag, bool exact)
+struct node_t*
+bt_lookup (struct bt_instance* bt, const char* name, bool print_flag, bool exact)
 {
     int bit_walker = 0;       // -- index of the input name (in terms of bit) -- //
     int node_bit_walker = 0;  // -- index of content of the current node (in terms of bit) -- //
-    char slider;              // -- extracted byte of the input byte (i.e. slider) -- //
-    int ret_compare;          // -- result of byte comparison -- //
-    int name_len = strlen(name);
-    int num_of_bits;            // -- number of compared bits at each step -- //
+    int name_len = strlen(name) * BYTE_LEN;   // -- in terms of bit -- //
+    unsigned int walker;             // -- index of the current node -- //
     struct node_t* node_walker;      // -- node traverser -- //
     int visited_walker;              // -- index of visitedNodes array -- //
-    struct node_t* lastVisitedNode = 0;  // -- if exact flag is ON -- //
+    unsigned int parent = bt->root;  // -- node before the first one to visit -- //
 
-    // -- check the MSB of the first byte of the name -- //
-    if (BIT(name[0],7) == ZERO)
+    // -- skip the first levels by the jump table (if any), otherwise start at the root -- //
+    if (JT_COVERS(bt, name, name_len))
+    {
+        unsigned long long entry = EP_LOAD(bt->jump[jt_key (name, bt->jump_bits)]);
+        parent = JT_INDEX(entry);
+        bit_walker = JT_END(entry);
+    }
+    // -- check the next bit of the name -- //
+    if (BIT(name[CURRENT_BYTE(bit_walker)], CURRENT_BIT(bit_walker)) == ZERO)
     {
-        node_walker = bt->root.child_0;
+        walker = EP_LOAD(BT_NODE(bt, parent)->child_0);
     }
     else
     {
-        node_walker = bt->root.child_1;
+        walker = EP_LOAD(BT_NODE(bt, parent)->child_1);
     }
 
     visited_walker = 0;
 
     // -- welcome to loop party! -- //
-    while (node_walker) 
+    while (walker) 
     {
+        node_walker = BT_NODE(bt, walker);
         if (exact)
         {
-            // -- remember this node -- //
-            lastVisitedNode = node_walker;
             visited_walker++;
             if (visited_walker == MAX_HEIGHT)
             {
@@ -1022,133 +975,41 @@ struct node_t* bt_lookup (struct bt_instance* bt, const char* name, bool print_f
             }
         }
 
-        node_bit_walker = 0;
-        // -- slide the slider over the name -- //
-        while (CURRENT_BYTE(bit_walker) < name_len)
+        // -- compare the whole content of the node with the rest of the name -- //
+        node_bit_walker = bt_bit_compare (name, name_len, bit_walker, bt_node_bytes (bt, node_walker), node_walker->len, 0);
+        bit_walker += node_bit_walker;
+        if (node_bit_walker < node_walker->len)
         {
-            if (CURRENT_BYTE(bit_walker) < name_len - 1)
-            {
-                // -- middle byte -- //
-                slider = (char)BIT_SLIDER(name, CURRENT_BYTE(bit_walker), CURRENT_BIT(bit_walker));
-                if (node_walker->len - node_bit_walker >= BYTE_LEN)
-                    num_of_bits = BYTE_LEN;
-                else
-                    num_of_bits = node_walker->len - node_bit_walker;
-                if (num_of_bits <= 0)
-                    break; // -- end of the node, search its child -- //
-                if ((ret_compare=(bt_byte_compare(slider, node_walker->bytes[CURRENT_BYTE(node_bit_walker)], num_of_bits))) == -1)
-                {
-                    bit_walker+=num_of_bits;
-                    node_bit_walker+=num_of_bits;
-                    continue;  // -- go to while -- //
-                }
-                else
-                {
-                    bit_walker+=ret_compare;
-                    node_bit_walker+=ret_compare;
-                    // -- if this is the end of the node, search its children -- //
-                    if (num_of_bits <= 0)
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        // -- name is not found -- //
-                        if (print_flag)
-                            printf ("Name is NOT found.\n"); 
-                        return 0;
-                    }
-                } 
-            }
-            else
-            {
-                // -- the last byte -- //            
-                slider = BIT_SLIDER_LAST(name, CURRENT_BYTE(bit_walker), CURRENT_BIT(bit_walker)); 
-                if (node_walker->len - node_bit_walker >= BYTE_LEN)
-                    num_of_bits = BYTE_LEN;
-                else
-                    num_of_bits = node_walker->len - node_bit_walker;
-                if (num_of_bits <= 0)
-                    break; // -- end of the node, search its children -- //
-                if ((ret_compare=(bt_byte_compare(slider, node_walker->bytes[CURRENT_BYTE(node_bit_walker)], num_of_bits))) == -1)
-                {
-                    int min = (num_of_bits < ((CURRENT_BIT(bit_walker) + 1))) ? num_of_bits : (CURRENT_BIT(bit_walker) + 1); 
-                    node_bit_walker += min;
-                    bit_walker += min;
-                    continue;  // -- go to while -- //
-                }
-                else
-                {
-                    node_bit_walker+=ret_compare;
-                    bit_walker+=ret_compare;
-                    // -- if this is the end of the node, search its children -- //
-                    if (num_of_bits <= 0)
-                    {
-                        break;
-                    }
-                    // -- if this is the end of the name -- //
-                    if (CURRENT_BYTE(bit_walker) >= name_len)
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        // -- name is not found -- //
-                        if (print_flag)
-                            printf ("Name is NOT found.\n");
-                        return 0;
-                    }
-                } 
-            } 
+            // -- a bit does not match, or the name ends in the middle of the node -- //
+            if (print_flag)
+                printf ("Name is NOT found.\n");
+            return 0;
         }
-        // -- if this is not the end of the name, go to the next node -- //
-        if (CURRENT_BYTE(bit_walker) >= name_len)
+        if (bit_walker >= name_len)
         {
             /**
-             * Possible cases:
-             *     1- End of the node + EON ON  => Name is found 
-             *     2- End of the node + EON OFF => Name is NOT found 
-             *     3- NOT end of name + EON ON  => Name is NOT found
-             *     4- NOT end of name + EON OFF => Name is NOT found
+             * End of the node and the name:
+             *     1- EON ON  => Name is found 
+             *     2- EON OFF => Name is NOT found 
              */
-            if (node_bit_walker >= node_walker->len)
+            if (node_walker->EON_flag)
             {
-                // -- end of the name -- //
-                if (node_walker->EON_flag)
-                {
-                    // -- do nothing -- //
-                    if (print_flag)                  
-                        //printf ("Name is found.\n");
-                    if (exact)
-                    {
-                        if (print_flag)
-                            printf ("Number of visited nodes:  %u\n", visited_walker);
-                        return lastVisitedNode;
-                    }
-                    return node_walker;
-                }
-                else
-                { 
-                    if (print_flag)
-                        printf ("Name is NOT found.\n");                   
-                    return 0;
-                }
-            }
-            else
-            {
-                if (print_flag)
-                    printf ("Name is NOT found.\n");                   
-                return 0;
+                if (exact && print_flag)
+                    printf ("Number of visited nodes:  %u\n", visited_walker);
+                return node_walker;
             }
+            if (print_flag)
+                printf ("Name is NOT found.\n");                   
+            return 0;
         }
         // -- name is NOT found, use the current bit to find the next child -- //
         if (BIT(name[CURRENT_BYTE(bit_walker)], CURRENT_BIT(bit_walker)) == ZERO)
         {
-            node_walker = node_walker->child_0;
+            walker = EP_LOAD(node_walker->child_0);
         }
         else 
         {
-            node_walker = node_walker->child_1;
+            walker = EP_LOAD(node_walker->child_1);
         }
     }
     if (print_flag)
@@ -1157,53 +1018,102 @@ struct node_t* bt_lookup (struct bt_instance* bt, const char* name, bool print_f
 } /* -- end of bt_lookup(..) -- */
 
 /* -----------------------------------------------------------------
- * Method: bt_free_node (..)
+ * Method: bt_read_lookup (..)
  * Scope: Protected
  *
  * Description:
- * Free a node and its subtree (do not touch the parent). 
+ * Lookup a given name by a reader (i.e. a thread other than the
+ * writer), in a read section of the given record of the reader. The
+ * reader never blocks; nodes it may reach are not reclaimed before
+ * it leaves the section.
+ *
+ * RETURN:
+ *    whether the name is found
  * ------------------------------------------------------------------ */
-void
-bt_free_node (struct node_t* node)
+bool
+bt_read_lookup (struct bt_instance* bt, struct ep_record_t* reader, const char* name)
+{
+    assert (bt);
+    assert (reader);
+    bool found;
+
+    ep_enter (&bt->epoch, reader);
+    found = (bt_lookup (bt, name, false, false) != 0);
+    ep_exit (reader);
+    return found;
+} /* -- end of bt_read_lookup (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bt_node_alloc_bytes (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Set the length of a node, and take room for its content: inside
+ * the node if it fits, otherwise from the byte pool. The node should
+ * not hold a spilled content already.
+ *
+ * RETURN:
+ *    content of the node, or NULL if there is no memory
+ * ------------------------------------------------------------------ */
+char*
+bt_node_alloc_bytes (struct bt_instance* bt, struct node_t* node, int len)
 {
     assert (node);
-    if (node->child_0)
-    {
-        bt_free_node (node->child_0);
-        free(node->child_0);
-        node->child_0 = 0;
-    }
-    if (node->child_1)
+    unsigned int offset;
+
+    node->len = len;
+    if (NODE_IS_INLINE(len))
+        return node->content;
+    if (!(offset = bp_alloc_bytes (&bt->pool, NUM_OF_BYTES(len))))
     {
-        bt_free_node (node->child_1);
-        free(node->child_1);
-        node->child_1 = 0;
+        fprintf (stderr, "[bt_node_alloc_bytes] ERROR: Memory allocation has been failed.\n");
+        node->len = 0;
+        return 0;
     }
-    bt_do_free_node (node);
-} /* -- end of bt_free_node (..) -- */
+    memcpy (node->content, &offset, sizeof(unsigned int));
+    return BP_BYTES(&bt->pool, offset);
+} /* -- end of bt_node_alloc_bytes (..) -- */
 
 /* -----------------------------------------------------------------
- * Method: bt_do_free_node (..)
+ * Method: bt_node_free_bytes (..)
  * Scope: Protected
  *
  * Description:
- * Free all allocated memories to a node.  
+ * Give the spilled content of a node (if any) back to the byte pool.
+ * The node is empty then.
  * ------------------------------------------------------------------ */
 void
-bt_do_free_node (struct node_t* node)
+bt_node_free_bytes (struct bt_instance* bt, struct node_t* node)
 {
     assert (node);
+    unsigned int offset;
 
-    free (node->bytes);
-    if (node->child_0)
-        free (node->child_0);
-    if (node->child_1)
-        free (node->child_1);
-    node->bytes = 0; 
-    node->child_0 = 0;
-    node->child_1 = 0;
-    node->parent = 0;
-    node->EON_flag = false;
+    if (!NODE_IS_INLINE(node->len))
+    {
+        memcpy (&offset, node->content, sizeof(unsigned int));
+        bp_release_bytes (&bt->pool, offset, NUM_OF_BYTES(node->len));
+    }
     node->len = 0;
-    return;
-} /* -- end of bt_do_free_node (..) -- */
+} /* -- end of bt_node_free_bytes (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: bt_reclaim_node (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Give a node (and its spilled content) back to the pools. Nodes
+ * which readers may reach are not reclaimed directly, but retired
+ * (see ep_retire), and this function is called when no reader can
+ * hold them anymore.
+ * ------------------------------------------------------------------ */
+void
+bt_reclaim_node (void* arg, void* ptr)
+{
+    struct bt_instance* bt = (struct bt_instance*)arg;
+    unsigned int index = (unsigned int)(unsigned long)ptr;
+
+    if (index == BP_NULL)
+        return;
+    bt_node_free_bytes (bt, BT_NODE(bt, index));
+    bp_release_node (&bt->pool, index);
+} /* -- end of bt_reclaim_node (..) -- */
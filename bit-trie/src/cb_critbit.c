@@ -0,0 +1,300 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * For list of authors, please see AUTHORS.md file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#include "cb_critbit.h"
+
+/* -----------------------------------------------------------------
+ * Method: cb_new_leaf (..)
+ * Scope: Private
+ *
+ * Description:
+ * Make a leaf (i.e. a copy of a name).
+ * ------------------------------------------------------------------ */
+static char*
+cb_new_leaf (struct cb_instance* cb, const char* name, size_t name_len)
+{
+    char* leaf = (char*)malloc(name_len + 1);
+
+    if (!leaf)
+    {
+        fprintf (stderr, "[cb_new_leaf] ERROR: Memory allocation has been failed.\n");
+        return 0;
+    }
+    memcpy (leaf, name, name_len + 1);
+    cb->num_of_names++;
+    cb->bytes += name_len + 1;
+    return leaf;
+} /* -- end of cb_new_leaf (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: cb_insert (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Insert a name into the crit-bit tree. First, walk down to the leaf
+ * which is the closest one to the name, and find the first bit in
+ * which they differ (i.e. the critical bit). Then, a new internal node
+ * for this bit is put above the first node with a later critical bit.
+ *
+ * RETURN:
+ *    the leaf of the name (it is not inserted if it is already there)
+ *    NULL: ERROR
+ * ------------------------------------------------------------------ */
+const char*
+cb_insert (struct cb_instance* cb, const char* name, bool print_flag)
+{
+    assert (cb);
+    assert (name);
+
+    const unsigned char* ubytes = (const unsigned char*)name;
+    size_t name_len = strlen(name);
+    void* p = cb->root;
+    struct cb_node_t* q;
+    const unsigned char* leaf;
+    unsigned int new_byte;
+    unsigned int new_otherbits;
+    int new_direction;
+    struct cb_node_t* new_node;
+    char* new_leaf;
+    void** wherep;
+
+    // -- an empty tree -- //
+    if (!p)
+    {
+        cb->root = cb_new_leaf (cb, name, name_len);
+        return cb->root;
+    }
+
+    // -- walk down to the closest leaf -- //
+    while (CB_IS_NODE(p))
+    {
+        q = CB_NODE(p);
+        p = q->child[CB_DIRECTION(q, ubytes, name_len)];
+    }
+    leaf = (const unsigned char*)p;
+
+    // -- find the critical byte (the null byte of the names counts) -- //
+    for (new_byte = 0; new_byte < name_len; new_byte++)
+    {
+        if (leaf[new_byte] != ubytes[new_byte])
+        {
+            new_otherbits = leaf[new_byte] ^ ubytes[new_byte];
+            break;
+        }
+    }
+    if (new_byte == name_len)
+    {
+        if (!leaf[new_byte])
+        {
+            // -- the name is already there -- //
+            return (const char*)leaf;
+        }
+        new_otherbits = leaf[new_byte];
+    }
+
+    // -- keep the MSB of the different bits, and turn ON the rest -- //
+    new_otherbits |= new_otherbits >> 1;
+    new_otherbits |= new_otherbits >> 2;
+    new_otherbits |= new_otherbits >> 4;
+    new_otherbits = (new_otherbits & ~(new_otherbits >> 1)) ^ 0xFF;
+    new_direction = (1 + (new_otherbits | leaf[new_byte])) >> BYTE_LEN;   // -- side of the closest leaf -- //
+
+    new_node = (struct cb_node_t*)malloc(sizeof(struct cb_node_t));
+    if (!new_node)
+    {
+        fprintf (stderr, "[cb_insert] ERROR: Memory allocation has been failed.\n");
+        return 0;
+    }
+    if (!(new_leaf = cb_new_leaf (cb, name, name_len)))
+    {
+        free (new_node);
+        return 0;
+    }
+    new_node->byte = new_byte;
+    new_node->otherbits = new_otherbits;
+    new_node->child[1 - new_direction] = new_leaf;
+    cb->num_of_nodes++;
+    cb->bytes += sizeof(struct cb_node_t);
+
+    // -- find the place of the new node (critical bits grow from the root down) -- //
+    wherep = &(cb->root);
+    while (1)
+    {
+        p = *wherep;
+        if (!CB_IS_NODE(p))
+            break;
+        q = CB_NODE(p);
+        if (q->byte > new_byte)
+            break;
+        if (q->byte == new_byte && q->otherbits > new_otherbits)
+            break;
+        wherep = q->child + CB_DIRECTION(q, ubytes, name_len);
+    }
+    new_node->child[new_direction] = *wherep;
+    *wherep = CB_TAG(new_node);
+    return new_leaf;
+} /* -- end of cb_insert (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: cb_lookup (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Lookup a given name in the crit-bit tree. Only the critical bits
+ * are checked on the way down, so the leaf is compared with the name
+ * at the end.
+ * ------------------------------------------------------------------ */
+const char*
+cb_lookup (struct cb_instance* cb, const char* name, bool print_flag)
+{
+    assert (cb);
+    assert (name);
+
+    const unsigned char* ubytes = (const unsigned char*)name;
+    size_t name_len = strlen(name);
+    void* p = cb->root;
+    struct cb_node_t* q;
+
+    if (p)
+    {
+        while (CB_IS_NODE(p))
+        {
+            q = CB_NODE(p);
+            p = q->child[CB_DIRECTION(q, ubytes, name_len)];
+        }
+        if (!strcmp ((const char*)p, name))
+            return (const char*)p;
+    }
+    if (print_flag)
+        printf ("Name is NOT found.\n");
+    return 0;
+} /* -- end of cb_lookup (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: cb_remove (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Remove a given name from the crit-bit tree. The leaf and its parent
+ * are removed, and the sibling of the leaf takes the place of the
+ * parent.
+ *
+ * Return:
+ *     1: name is not found (Not removed)
+ *     0: DONE! (removed)
+ * ------------------------------------------------------------------ */
+int
+cb_remove (struct cb_instance* cb, const char* name, bool print_flag)
+{
+    assert (cb);
+    assert (name);
+
+    const unsigned char* ubytes = (const unsigned char*)name;
+    size_t name_len = strlen(name);
+    void* p = cb->root;
+    void** wherep = &(cb->root);
+    void** whereq = 0;             // -- place of the parent of the leaf -- //
+    struct cb_node_t* q = 0;
+    int direction = 0;
+
+    if (!p)
+    {
+        if (print_flag)
+            fprintf (stderr, "[cb_remove] ERROR: Name lookup failed.\n");
+        return 1;
+    }
+    while (CB_IS_NODE(p))
+    {
+        whereq = wherep;
+        q = CB_NODE(p);
+        direction = CB_DIRECTION(q, ubytes, name_len);
+        wherep = q->child + direction;
+        p = *wherep;
+    }
+    if (strcmp ((const char*)p, name))
+    {
+        // -- name is NOT found -- //
+        if (print_flag)
+            fprintf (stderr, "[cb_remove] ERROR: Name lookup failed.\n");
+        return 1;
+    }
+
+    free (p);
+    cb->num_of_names--;
+    cb->bytes -= name_len + 1;
+    if (!whereq)
+    {
+        // -- this was the last name -- //
+        cb->root = 0;
+        return 0;
+    }
+    *whereq = q->child[1 - direction];
+    free (q);
+    cb->num_of_nodes--;
+    cb->bytes -= sizeof(struct cb_node_t);
+    return 0;
+} /* -- end of cb_remove (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: cb_do_free (..)
+ * Scope: Private
+ *
+ * Description:
+ * Free a subtree.
+ * ------------------------------------------------------------------ */
+static void
+cb_do_free (void* p)
+{
+    struct cb_node_t* q;
+
+    if (CB_IS_NODE(p))
+    {
+        q = CB_NODE(p);
+        cb_do_free (q->child[0]);
+        cb_do_free (q->child[1]);
+        free (q);
+    }
+    else
+        free (p);
+} /* -- end of cb_do_free (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: cb_free (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Free all internal nodes and leaves of the tree. The tree is empty
+ * then.
+ * ------------------------------------------------------------------ */
+void
+cb_free (struct cb_instance* cb)
+{
+    assert (cb);
+
+    if (cb->root)
+        cb_do_free (cb->root);
+    memset (cb, 0, sizeof(struct cb_instance));
+} /* -- end of cb_free (..) -- */
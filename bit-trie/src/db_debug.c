@@ -30,6 +30,7 @@
 #include <sys/stat.h>
 
 #include "bt_trie.h"
+#include "jt_jump.h"
 #include "db_debug.h"
 
 
@@ -48,9 +49,10 @@ db_dfs (struct bt_instance* bt, bool print_flag)
     bt->trie_stat->sum = 0;
     bt->trie_stat->num = 0;
     bt->trie_stat->id = 0;
+    bt->trie_stat->spilled = 0;
 
     // -- take the root and start -- //
-    if (!bt->root.child_0 && !bt->root.child_1)
+    if (!BT_ROOT(bt)->child_0 && !BT_ROOT(bt)->child_1)
     {
         // -- the trie is empty -- //
         fprintf (stderr, "[db_dfs] WARNING: The trie is empty.\n");
@@ -79,7 +81,7 @@ db_dfs (struct bt_instance* bt, bool print_flag)
 
     if (print_flag)
         printf ("----------- DFS ----------\n");
-    db_do_dfs (bt, &(bt->root), 0, 0, bt->trie_stat, -1, 0 /*useless here*/, print_flag);
+    db_do_dfs (bt, BT_ROOT(bt), 0, 0, bt->trie_stat, -1, 0 /*useless here*/, print_flag);
 
     dot = fopen(DOT_FILE_PATH, "a");
     fprintf (dot, "}");
@@ -128,14 +130,14 @@ db_do_dfs (struct bt_instance* bt, struct node_t* node, struct node_t* parent, i
     {
         if (!node->child_0 && !node->child_1)
         {
-           fprintf (dot, "\t{\"<%u><%02x>\" [label=\"<%02x>\"]};", p_id, node->bytes[0], node->bytes[0]);
+           fprintf (dot, "\t{\"<%u><%02x>\" [label=\"<%02x>\"]};", p_id, bt_node_bytes (bt, node)[0], bt_node_bytes (bt, node)[0]);
            fclose (dot);
            return 0;
         } 
     }
     else
     {
-        db_print_node_to_file (node, parent, trie_stat->id, child, p_id);
+        db_print_node_to_file (bt, node, parent, trie_stat->id, child, p_id);
     }
     fclose(dot);
     if (height > MAX_HEIGHT)
@@ -146,6 +148,8 @@ db_do_dfs (struct bt_instance* bt, struct node_t* node, struct node_t* parent, i
     trie_stat->width[height] = trie_stat->width[height] + 1;
     if (node->EON_flag)
         trie_stat->num += 1;   // -- a node with EON_flag ON is a leaf -- //
+    if (!NODE_IS_INLINE(node->len))
+        trie_stat->spilled += 1;
     if (!node->child_0 && !node->child_1)
     {
         // -- this is a leaf -- //
@@ -157,19 +161,15 @@ db_do_dfs (struct bt_instance* bt, struct node_t* node, struct node_t* parent, i
     // -- travese the children -- //
     for (int i=0; i<2; i++)
     {
-        if (i==0)
-            node_walker = node->child_0;
-        if (i==1)
-            node_walker = node->child_1;
-
-        if (!node_walker)
+        if ((i==0 && !node->child_0) || (i==1 && !node->child_1))
             continue;
-        if (!(node_walker->bytes))
+        node_walker = BT_NODE(bt, i==0 ? node->child_0 : node->child_1);
+        if (!(node_walker->len))
         {
             fprintf (stderr, "[db_do_dfs] WARNING: A null active node.\n");
             return 0;
         } 
-        db_do_dfs (bt, node_walker, node_walker->parent, height + 1, trie_stat, id, i, print_flag); 
+        db_do_dfs (bt, node_walker, BT_NODE(bt, node_walker->parent), height + 1, trie_stat, id, i, print_flag); 
         if (print_flag)
         {
             printf ("H:%u   ",height);
@@ -188,7 +188,7 @@ db_do_dfs (struct bt_instance* bt, struct node_t* node, struct node_t* parent, i
  * Print byte(s) of node to dot file.
  * ----------------------------------------------------------------------------------- */
 void
-db_print_node_to_file (struct node_t* node, struct node_t* parent, signed int id, int child, signed int p_id)
+db_print_node_to_file (struct bt_instance* bt, struct node_t* node, struct node_t* parent, signed int id, int child, signed int p_id)
 {
     FILE* dot = fopen(DOT_FILE_PATH, "a");
     int bit_walker;
@@ -198,7 +198,7 @@ db_print_node_to_file (struct node_t* node, struct node_t* parent, signed int id
     bit_walker=0;
     while (bit_walker < parent->len)
     {
-        fprintf (dot, "<%02x>", parent->bytes[CURRENT_BYTE(bit_walker)]);
+        fprintf (dot, "<%02x>", bt_node_bytes (bt, parent)[CURRENT_BYTE(bit_walker)]);
         bit_walker+=BYTE_LEN;
     }
     fprintf (dot, "\" ");
@@ -206,7 +206,7 @@ db_print_node_to_file (struct node_t* node, struct node_t* parent, signed int id
     bit_walker=0;
     while (bit_walker < parent->len)
     {
-        fprintf (dot, "<%02x>", parent->bytes[CURRENT_BYTE(bit_walker)]);
+        fprintf (dot, "<%02x>", bt_node_bytes (bt, parent)[CURRENT_BYTE(bit_walker)]);
         bit_walker+=BYTE_LEN;
     }
     fprintf (dot, ":[%u]\"]", parent->len); 
@@ -219,7 +219,7 @@ db_print_node_to_file (struct node_t* node, struct node_t* parent, signed int id
     bit_walker=0;
     while (bit_walker < node->len)
     {
-        fprintf (dot, "<%02x>", node->bytes[CURRENT_BYTE(bit_walker)]);
+        fprintf (dot, "<%02x>", bt_node_bytes (bt, node)[CURRENT_BYTE(bit_walker)]);
         bit_walker+=BYTE_LEN;
     }
     fprintf (dot, "\" ");
@@ -227,7 +227,7 @@ db_print_node_to_file (struct node_t* node, struct node_t* parent, signed int id
     bit_walker=0;
     while (bit_walker < node->len)
     {
-        fprintf (dot, "<%02x>", node->bytes[CURRENT_BYTE(bit_walker)]);
+        fprintf (dot, "<%02x>", bt_node_bytes (bt, node)[CURRENT_BYTE(bit_walker)]);
         bit_walker+=BYTE_LEN;
     }
     fprintf (dot, ":[%u]\"] \n", node->len);
@@ -250,17 +250,125 @@ db_print_node_to_file (struct node_t* node, struct node_t* parent, signed int id
  * Print component(s) of node.
  * ----------------------------------------------------------------------------------- */
 void
-db_print_node (struct node_t* node)
+db_print_node (struct bt_instance* bt, struct node_t* node)
 {
     int bit_walker = 0;
     int node_len = node->len;
 
     while (bit_walker < node_len)
     {
-        printf ("<%02x>", node->bytes[CURRENT_BYTE(bit_walker)]); 
+        printf ("<%02x>", bt_node_bytes (bt, node)[CURRENT_BYTE(bit_walker)]); 
         bit_walker += (node_len - bit_walker < BYTE_LEN) ? node_len-bit_walker : BYTE_LEN;
     }
     printf (":[%u]\n", node_len);
     return;
 } /* -- end of db_print_node (..) -- */
 
+
+
+/* -----------------------------------------------------------------------------------
+ * Method: db_memory (..)
+ * Scope: private
+ * 
+ * Description:
+ * Memory of a subtree (i.e. its nodes and spilled contents, rounded up to their size
+ * class), and the number of names in it.
+ * ----------------------------------------------------------------------------------- */
+long long
+db_memory (struct bt_instance* bt, struct node_t* node, long long* num_of_names)
+{
+    long long memory = sizeof(struct node_t);
+
+    if (!NODE_IS_INLINE(node->len))
+        memory += bp_class_size (bp_class (NUM_OF_BYTES(node->len)));
+    if (node->EON_flag)
+        (*num_of_names)++;
+    if (node->child_0)
+        memory += db_memory (bt, BT_NODE(bt, node->child_0), num_of_names);
+    if (node->child_1)
+        memory += db_memory (bt, BT_NODE(bt, node->child_1), num_of_names);
+    return memory;
+} /* -- end of db_memory (..) -- */
+
+/* -----------------------------------------------------------------------------------
+ * Method: db_jump_levels (..)
+ * Scope: private
+ * 
+ * Description:
+ * Levels (i.e. nodes) which lookups of the names of a subtree visit, and those of them
+ * which the jump table skips: the ancestors of a name whose path ends in the covered
+ * bits. The first bits of the path (in the covered width) and the number of such
+ * ancestors are passed down.
+ * ----------------------------------------------------------------------------------- */
+void
+db_jump_levels (struct bt_instance* bt, struct node_t* node, int depth, int start, unsigned long long path,
+                int skipped, long long* num_of_names, long long* levels, long long* skipped_levels)
+{
+    int width = JT_PREFIX_BITS + bt->jump_bits;
+    int end = start + node->len;
+    int len;
+
+    if (start < width)
+    {
+        len = (end < width) ? (int)node->len : width - start;
+        path |= (unsigned long long)jt_bits (bt_node_bytes (bt, node), len) << (width - start - len);
+    }
+    if (node->EON_flag)
+    {
+        (*num_of_names)++;
+        *levels += depth;
+        if (end > width && (path >> bt->jump_bits) == SLASH)
+            *skipped_levels += skipped;
+    }
+    if (end <= width)
+        skipped++;
+    if (node->child_0)
+        db_jump_levels (bt, BT_NODE(bt, node->child_0), depth+1, end, path, skipped, num_of_names, levels, skipped_levels);
+    if (node->child_1)
+        db_jump_levels (bt, BT_NODE(bt, node->child_1), depth+1, end, path, skipped, num_of_names, levels, skipped_levels);
+} /* -- end of db_jump_levels (..) -- */
+
+/* -----------------------------------------------------------------------------------
+ * Method: db_same (..)
+ * Scope: private
+ * 
+ * Description:
+ * Whether two subtrees (may be of two instances) are the same: the same contents, EON
+ * flags and children, regardless of the indices of the nodes.
+ * ----------------------------------------------------------------------------------- */
+bool
+db_same (struct bt_instance* bt_a, struct node_t* a, struct bt_instance* bt_b, struct node_t* b)
+{
+    if (a->len != b->len || a->EON_flag != b->EON_flag ||
+        !a->child_0 != !b->child_0 || !a->child_1 != !b->child_1 ||
+        bt_bit_compare (bt_node_bytes (bt_a, a), a->len, 0, bt_node_bytes (bt_b, b), b->len, 0) != (int)a->len)
+        return false;
+    if (a->child_0 && !db_same (bt_a, BT_NODE(bt_a, a->child_0), bt_b, BT_NODE(bt_b, b->child_0)))
+        return false;
+    if (a->child_1 && !db_same (bt_a, BT_NODE(bt_a, a->child_1), bt_b, BT_NODE(bt_b, b->child_1)))
+        return false;
+    return true;
+} /* -- end of db_same (..) -- */
+
+/* -----------------------------------------------------------------------------------
+ * Method: db_memory_pointers (..)
+ * Scope: private
+ * 
+ * Description:
+ * Memory which a subtree would take with pointers instead of indices (i.e. a node of
+ * a cache line with three pointers, and contents longer than DB_PTR_INLINE_BYTES in
+ * separate buffers). It is the "before" of the memory report.
+ * ----------------------------------------------------------------------------------- */
+long long
+db_memory_pointers (struct bt_instance* bt, struct node_t* node)
+{
+    long long memory = DB_PTR_NODE_SIZE;
+
+    if (NUM_OF_BYTES(node->len) > DB_PTR_INLINE_BYTES)
+        memory += NUM_OF_BYTES(node->len);
+    if (node->child_0)
+        memory += db_memory_pointers (bt, BT_NODE(bt, node->child_0));
+    if (node->child_1)
+        memory += db_memory_pointers (bt, BT_NODE(bt, node->child_1));
+    return memory;
+} /* -- end of db_memory_pointers (..) -- */
@@ -0,0 +1,237 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * For list of authors, please see AUTHORS.md file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "jt_jump.h"
+#include "bt_struct.h"
+#include "ep_epoch.h"
+
+// -- width of the covered bits of a name (i.e. "/" and the key), and the first covered entry -- //
+#define JT_WIDTH(bt) ( JT_PREFIX_BITS + (bt)->jump_bits )
+#define JT_BASE(bt)  ( (unsigned long long)SLASH << (bt)->jump_bits )
+
+/* -----------------------------------------------------------------
+ * Method: jt_end (..)
+ * Scope: Private
+ *
+ * Description:
+ * End of the path of a node in a name (i.e. the lengths of the node
+ * and its ancestors, except the root), or the covered width if it is
+ * longer. Parents are read only by the writer.
+ * ------------------------------------------------------------------ */
+static int
+jt_end (struct bt_instance* bt, unsigned int index)
+{
+    int end = 0;
+
+    for (; index != bt->root; index = BT_NODE(bt, index)->parent)
+    {
+        end += BT_NODE(bt, index)->len;
+        if (end >= JT_WIDTH(bt))
+            return JT_WIDTH(bt);
+    }
+    return end;
+} /* -- end of jt_end (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: jt_path (..)
+ * Scope: Private
+ *
+ * Description:
+ * Bits of the path of a node (which ends at the given bit, in the
+ * covered width), as the high bits of a covered-width integer.
+ * ------------------------------------------------------------------ */
+static unsigned long long
+jt_path (struct bt_instance* bt, unsigned int index, int end)
+{
+    unsigned long long path = 0;
+    struct node_t* node;
+
+    for (; index != bt->root; index = node->parent)
+    {
+        node = BT_NODE(bt, index);
+        path |= (unsigned long long)jt_bits (bt_node_bytes (bt, node), node->len) << (JT_WIDTH(bt) - end);
+        end -= node->len;
+    }
+    return path;
+} /* -- end of jt_path (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: jt_set (..)
+ * Scope: Private
+ *
+ * Description:
+ * Set the entries of a range [lo, hi) of the covered width (i.e.
+ * only those which start with "/" are in the table).
+ * ------------------------------------------------------------------ */
+static void
+jt_set (struct bt_instance* bt, unsigned long long lo, unsigned long long hi, unsigned long long entry)
+{
+    unsigned long long base = JT_BASE(bt);
+    unsigned long long top = base + (1ull << bt->jump_bits);
+
+    if (lo < base)
+        lo = base;
+    if (hi > top)
+        hi = top;
+    for (; lo < hi; lo++)
+        EP_PUBLISH(bt->jump[lo - base], entry);
+} /* -- end of jt_set (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: jt_fill (..)
+ * Scope: Private
+ *
+ * Description:
+ * Fill the entries of a range under a link, i.e. a given child (may
+ * be NULL) of a parent whose path ends at the given bit. Names which
+ * go through the whole content of the child (within the covered
+ * width) go on to its children; others stop at the parent. Each
+ * entry is written once.
+ * ------------------------------------------------------------------ */
+static void
+jt_fill (struct bt_instance* bt, unsigned int parent, int end, unsigned long long lo, unsigned long long size, unsigned int index)
+{
+    struct node_t* node = index ? BT_NODE(bt, index) : 0;
+    unsigned long long base = JT_BASE(bt);
+    unsigned long long sub_lo, sub_size;
+    int node_end;
+
+    // -- nothing of the range is in the table -- //
+    if (lo + size <= base || lo >= base + (1ull << bt->jump_bits))
+        return;
+    if (!node || end + (int)node->len > JT_WIDTH(bt))
+    {
+        jt_set (bt, lo, lo + size, JT_ENTRY(parent, end));
+        return;
+    }
+    // -- names which match the content of the node -- //
+    node_end = end + node->len;
+    sub_size = 1ull << (JT_WIDTH(bt) - node_end);
+    sub_lo = ((lo >> (JT_WIDTH(bt) - end)) << (JT_WIDTH(bt) - end)) |
+             ((unsigned long long)jt_bits (bt_node_bytes (bt, node), node->len) << (JT_WIDTH(bt) - node_end));
+    jt_set (bt, lo, sub_lo, JT_ENTRY(parent, end));
+    jt_set (bt, sub_lo + sub_size, lo + size, JT_ENTRY(parent, end));
+    if (node_end == JT_WIDTH(bt))
+    {
+        jt_set (bt, sub_lo, sub_lo + 1, JT_ENTRY(index, node_end));
+        return;
+    }
+    jt_fill (bt, index, node_end, sub_lo, sub_size / 2, node->child_0);
+    jt_fill (bt, index, node_end, sub_lo + sub_size / 2, sub_size / 2, node->child_1);
+} /* -- end of jt_fill (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: jt_init (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Build the jump table of an instance, over the given number of bits
+ * after "/". The instance may have names already. It should be built
+ * before any reader starts.
+ *
+ * RETURN:
+ *    0: DONE!
+ *    1: ERROR
+ * ------------------------------------------------------------------ */
+int
+jt_init (struct bt_instance* bt, int bits)
+{
+    assert (bt);
+
+    if (bits < 1 || bits > JT_MAX_BITS)
+    {
+        fprintf (stderr, "[jt_init] ERROR: Number of bits should be between 1 and %d.\n", JT_MAX_BITS);
+        return 1;
+    }
+    if (!(bt->jump = (unsigned long long*)malloc (sizeof(unsigned long long) << bits)))
+    {
+        fprintf (stderr, "[jt_init] ERROR: Memory allocation has been failed.\n");
+        return 1;
+    }
+    bt->jump_bits = bits;
+    jt_refill (bt);
+    return 0;
+} /* -- end of jt_init (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: jt_refill (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Fill all entries of the table again, e.g. after the trie is built
+ * by other means than bt_insert (see bl_load).
+ * ------------------------------------------------------------------ */
+void
+jt_refill (struct bt_instance* bt)
+{
+    assert (bt);
+    unsigned long long half = 1ull << (JT_WIDTH(bt) - 1);   // -- entries under a child of the root -- //
+
+    jt_fill (bt, bt->root, 0, 0, half, BT_ROOT(bt)->child_0);
+    jt_fill (bt, bt->root, 0, half, half, BT_ROOT(bt)->child_1);
+} /* -- end of jt_refill (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: jt_destroy (..)
+ * Scope: Protected
+ * ------------------------------------------------------------------ */
+void
+jt_destroy (struct bt_instance* bt)
+{
+    assert (bt);
+
+    free (bt->jump);
+    bt->jump = 0;
+    bt->jump_bits = 0;
+} /* -- end of jt_destroy (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: jt_link (..)
+ * Scope: Protected
+ *
+ * Description:
+ * A child of a parent has been published (a new node, a copy, or
+ * NULL). If the former or the new node ends in the covered width,
+ * fill the entries under the link again. It should be called before
+ * the former node is retired.
+ * ------------------------------------------------------------------ */
+void
+jt_link (struct bt_instance* bt, unsigned int parent, int child, int old_len)
+{
+    assert (bt);
+    unsigned int index;
+    int end;
+
+    if (!bt->jump || (end = jt_end (bt, parent)) >= JT_WIDTH(bt))
+        return;
+    index = child ? BT_NODE(bt, parent)->child_1 : BT_NODE(bt, parent)->child_0;
+    // -- entries under the link stop at the parent, both before and after -- //
+    if ((!old_len || end + old_len > JT_WIDTH(bt)) &&
+        (!index || end + (int)BT_NODE(bt, index)->len > JT_WIDTH(bt)))
+        return;
+    jt_fill (bt, parent, end,
+             jt_path (bt, parent, end) | ((unsigned long long)child << (JT_WIDTH(bt) - end - 1)),
+             1ull << (JT_WIDTH(bt) - end - 1), index);
+} /* -- end of jt_link (..) -- */
@@ -29,13 +29,19 @@
 #include <unistd.h>
 #include <ctype.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "bt_trie.h"
 #include "bt_struct.h"
+#include "cb_critbit.h"
+#include "tb_bitmap.h"
 #include "db_debug.h"
+#include "jt_jump.h"
+#include "bl_bulk.h"
 #include "main.h"
 
-char* _args = "intprxRhe";
+char* _args = "intprxRhemcsWjLu";
+struct cb_instance* cb = 0;   // -- crit-bit tree, if it is the engine in use (i.e. [-c]) -- //
 /* --------------------------------------
  * Method: print_inst()
  * Scope: Public 
@@ -55,9 +61,37 @@ print_inst (char* prg)
     printf ("\t-x:   copy names in memory before any task (more memory, less delay) \n");
     printf ("\t-R:   generate trie statistical information and its final graph \n");
     printf ("\t-e:   speed evaluation mode (enter random names file) \n");
+    printf ("\t-m:   compare benchmark, per-bit vs. word-at-a-time (use with -i and -n) \n");
+    printf ("\t-c:   use the crit-bit tree instead of the Patricia trie \n");
+    printf ("\t-s:   tree-bitmap mode, depth/memory/lookup of stride %d (use with -i and -n) \n", TB_STRIDE);
+    printf ("\t-W:   stress benchmark, concurrent lookup by a given number of readers and one writer (use with -i and -n) \n");
+    printf ("\t-L:   load mode, build time of bt_insert vs. the bulk load of sorted names by 1 to %d threads (use with -i and -n) \n", BL_MAX_THREADS);
+    printf ("\t-u:   churn benchmark, remove and insert back a given percent of the names in each of %d rounds (use with -i and -n) \n", CHURN_ROUNDS);
+    printf ("\t-j:   jump table over a given number of bits after \"/\" (1 to %d), to skip the first levels of the trie \n", JT_MAX_BITS);
     printf ("\t-h:   Print help \n");
 } /* -- end of print_inst () -- */
 
+/* ------------------------------------------------
+ * Method: print_pool
+ * Scope: Public 
+ * 
+ * Description:
+ * To print the memory which the pools reserve, and
+ * the allocation counters of nodes and contents.
+ * ------------------------------------------------- */
+void
+print_pool (struct bt_instance* bt)
+{
+    struct bp_pool_t* pool = &bt->pool;
+
+    printf ("Pools reserved:    %lld bytes  (free: %lld nodes, %lld bytes of contents)\n",
+            bp_reserved (pool), pool->num_of_free_nodes, pool->num_of_free_bytes);
+    printf ("Node allocs:       %lld  (recycled: %lld, frees: %lld)\n",
+            pool->node_allocs, pool->node_recycled, pool->node_frees);
+    printf ("Content allocs:    %lld  (recycled: %lld, frees: %lld)\n",
+            pool->byte_allocs, pool->byte_recycled, pool->byte_frees);
+} /* -- end of print_pool (..) -- */
+
 /* ------------------------------------------------
  * Method: print_summary
  * Scope: Public 
@@ -78,6 +112,43 @@ print_summary (struct bt_instance* bt, double insert_time, double  lookup_time,
         printf (ANSI_COLOR_RED "\nTo see more statistical info of the final trie use [-R] tag\n");
         printf (ANSI_COLOR_RESET "\n");
     }
+    // -- memory of the trie, with pointers (before) and with 32-bit indices (after) -- //
+    if (!cb && bt->root)
+    {
+        long long num_of_names = 0;
+        long long ptr_memory = db_memory_pointers (bt, BT_ROOT(bt));
+        long long memory = db_memory (bt, BT_ROOT(bt), &num_of_names);
+
+        printf ("------------ MEMORY ------------\n");
+        printf ("Nodes:             %lld  (%lld names, retired nodes not reclaimed yet included)\n", bt->pool.num_of_nodes, num_of_names);
+        printf ("Before (pointers): %lld bytes  (%d-byte nodes, spilled contents > %d bytes)\n",
+                ptr_memory, DB_PTR_NODE_SIZE, (int)DB_PTR_INLINE_BYTES);
+        printf ("After (indices):   %lld bytes  (%d-byte nodes, spilled contents > %d bytes)\n",
+                memory, (int)sizeof(struct node_t), (int)NODE_INLINE_BYTES);
+        if (ptr_memory)
+            printf ("After/Before:      %.2f\n", (double)memory / ptr_memory);
+        print_pool (bt);
+    }
+    // -- levels of the trie which lookups skip by the jump table (see [-j]) -- //
+    if (!cb && bt->jump && bt->root)
+    {
+        long long num_of_names = 0;
+        long long levels = 0;
+        long long skipped = 0;
+        struct node_t* root = BT_ROOT(bt);
+
+        if (root->child_0)
+            db_jump_levels (bt, BT_NODE(bt, root->child_0), 1, 0, 0, 0, &num_of_names, &levels, &skipped);
+        if (root->child_1)
+            db_jump_levels (bt, BT_NODE(bt, root->child_1), 1, 0, 0, 0, &num_of_names, &levels, &skipped);
+        printf ("---------- JUMP TABLE ----------\n");
+        printf ("Key:               %d bits after \"/\"  (%lld entries, %lld bytes)\n",
+                bt->jump_bits, 1ll << bt->jump_bits, (long long)sizeof(unsigned long long) << bt->jump_bits);
+        if (num_of_names)
+            printf ("Levels per lookup: %.2f without the table, %.2f with it  (%.1f%% skipped)\n",
+                    (double)levels / num_of_names, (double)(levels - skipped) / num_of_names,
+                    levels ? 100.0 * skipped / levels : 0.0);
+    }
     // -- some statistical info -- //
     if (dfs_flag)
     {
@@ -97,6 +168,7 @@ print_summary (struct bt_instance* bt, double insert_time, double  lookup_time,
                 all_nodes += bt->trie_stat->width[i];
             printf ("\tALL Nodes=     %d\n", all_nodes);
             printf ("\tAVE Width=     %f\n", (float)((float)(all_nodes-1)/(all_nodes-bt->trie_stat->num)));
+            printf ("\tSPILLED Nodes= %d (content longer than %d bytes)\n", bt->trie_stat->spilled, (int)NODE_INLINE_BYTES);
         }
         
         printf (ANSI_COLOR_RED "\nTo see the final Patricia Trie run below command:\n");
@@ -106,6 +178,94 @@ print_summary (struct bt_instance* bt, double insert_time, double  lookup_time,
 } /* -- end of print_summary (..) -- */
 
 
+/* ------------------------------------------------
+ * Method: name_insert
+ * Scope: Public 
+ * 
+ * Description:
+ * Insert a name by the engine in use: the bit-level
+ * Patricia trie, or the crit-bit tree (i.e. [-c]).
+ * ------------------------------------------------- */
+const void*
+name_insert (struct bt_instance* bt, const char* name, bool print_flag)
+{
+    if (cb)
+        return cb_insert (cb, name, print_flag);
+    return bt_insert (bt, name, print_flag);
+} /* -- end of name_insert (..) -- */
+
+/* ------------------------------------------------
+ * Method: name_lookup
+ * Scope: Public 
+ * 
+ * Description:
+ * Lookup a name by the engine in use.
+ * ------------------------------------------------- */
+const void*
+name_lookup (struct bt_instance* bt, const char* name, bool print_flag)
+{
+    if (cb)
+        return cb_lookup (cb, name, print_flag);
+    return bt_lookup (bt, name, print_flag, 0);
+} /* -- end of name_lookup (..) -- */
+
+/* ------------------------------------------------
+ * Method: name_remove
+ * Scope: Public 
+ * 
+ * Description:
+ * Remove a name by the engine in use.
+ * ------------------------------------------------- */
+int
+name_remove (struct bt_instance* bt, const char* name, bool print_flag)
+{
+    if (cb)
+        return cb_remove (cb, name, print_flag);
+    return bt_remove (bt, name, print_flag);
+} /* -- end of name_remove (..) -- */
+
+/* ------------------------------------------------
+ * Method: engine_memory
+ * Scope: Public 
+ * 
+ * Description:
+ * Memory of the engine in use (i.e. its nodes and
+ * their contents), and the number of names in it.
+ * ------------------------------------------------- */
+long long
+engine_memory (struct bt_instance* bt, long long* num_of_names)
+{
+    if (cb)
+    {
+        *num_of_names = cb->num_of_names;
+        return cb->bytes;
+    }
+    *num_of_names = 0;
+    return db_memory (bt, BT_ROOT(bt), num_of_names);
+} /* -- end of engine_memory (..) -- */
+
+/* ------------------------------------------------
+ * Method: print_engine
+ * Scope: Public 
+ * 
+ * Description:
+ * To print the memory and lookup cost of the engine
+ * in use, after running.
+ * ------------------------------------------------- */
+void
+print_engine (long long memory, long long num_of_names, int num_of_lookups, double lookup_time)
+{
+    printf ("------------ ENGINE ------------\n");
+    printf ("Engine:            %s\n", cb ? "crit-bit tree" : "Patricia trie");
+    printf ("Names:             %lld\n", num_of_names);
+    printf ("Memory:            %lld bytes", memory);
+    if (num_of_names)
+        printf ("  (%.1f bytes/name)", (double)memory / num_of_names);
+    printf ("\n");
+    if (num_of_lookups)
+        printf ("Lookup:            %.1f ns/op\n", lookup_time * 1e9 / num_of_lookups);
+} /* -- end of print_engine (..) -- */
+
 /* --------------------------------------
  * Method: warmup()
  * Scope: public 
@@ -121,6 +281,8 @@ warmup (struct bt_instance* bt, bool print_flag, bool remove_flag, bool dfs_flag
     double insert_cpu_used = 0;
     double lookup_cpu_used = 0;
     double remove_cpu_used = 0;
+    long long memory;           // -- memory of the engine after lookups -- //
+    long long num_of_stored;    // -- number of names in the engine -- //
  
     char* names[] = {"/ndn/uofa/cs/department/pub","/ndn/uofa/cs/department","/ndn/uofa/ece/department","/ndn/uofa/cs/department/pub/icn/","/ndn/uofa/cs/icn/"};
     int num_of_names = 5;    
@@ -129,7 +291,7 @@ warmup (struct bt_instance* bt, bool print_flag, bool remove_flag, bool dfs_flag
     for (int i=0; i<num_of_names; i++)
     {
         // -- insert some names -- //
-        bt_insert (bt, (const char*)names[i], print_flag);
+        name_insert (bt, (const char*)names[i], print_flag);
     }
     end = clock();
     insert_cpu_used = ((double) (end - start)) / CLOCKS_PER_SEC;
@@ -138,7 +300,7 @@ warmup (struct bt_instance* bt, bool print_flag, bool remove_flag, bool dfs_flag
     for (int i=0; i<num_of_names; i++)
     {
         // -- lookup some names -- //
-        if (bt_lookup(bt, (const char*)names[i], print_flag, 0))
+        if (name_lookup (bt, (const char*)names[i], print_flag))
         {
             if (print_flag)
                 printf ("Name is found:   %s\n", names[i]);
@@ -151,6 +313,7 @@ warmup (struct bt_instance* bt, bool print_flag, bool remove_flag, bool dfs_flag
     }
     end = clock();
     lookup_cpu_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+    memory = engine_memory (bt, &num_of_stored);
 
     start = clock();
     if (remove_flag)
@@ -158,7 +321,7 @@ warmup (struct bt_instance* bt, bool print_flag, bool remove_flag, bool dfs_flag
         for (int i=0; i<num_of_names; i++)
         {
             // -- remove some names -- // 
-            if (bt_remove(bt, (const char*)names[i], print_flag) == 0)
+            if (name_remove (bt, (const char*)names[i], print_flag) == 0)
             {
                 if (print_flag)
                     printf ("Name is removed:   %s\n", names[i]);
@@ -180,9 +343,561 @@ warmup (struct bt_instance* bt, bool print_flag, bool remove_flag, bool dfs_flag
     }
     // -- summary -- //    
     print_summary (bt, insert_cpu_used, lookup_cpu_used, remove_cpu_used, print_flag, dfs_flag);
+    print_engine (memory, num_of_stored, num_of_names, lookup_cpu_used);
     return;
 } /* -- end of warmup(..) function -- */
 
+/* ------------------------------------------------------------
+ * Method: slider_compare()
+ * Scope: Public 
+ * 
+ * Description:
+ * The former compare path of the trie: slide a byte over the
+ * name and compare it with a byte of the node, bit by bit (see
+ * bt_byte_compare).
+ *
+ * RETURN:
+ *    number of matched bits
+ * ------------------------------------------------------------ */
+int
+slider_compare (const char* name, int name_len, int bit_walker, const char* bytes, int len)
+{
+    int node_bit_walker = 0;
+    int num_of_bits;
+    int ret_compare;
+    char slider;
+
+    while (CURRENT_BYTE(bit_walker) < name_len)
+    {
+        if (len - node_bit_walker >= BYTE_LEN)
+            num_of_bits = BYTE_LEN;
+        else
+            num_of_bits = len - node_bit_walker;
+        if (num_of_bits <= 0)
+            break;
+        if (CURRENT_BYTE(bit_walker) < name_len - 1)
+        {
+            // -- middle byte -- //
+            slider = (char)BIT_SLIDER(name, CURRENT_BYTE(bit_walker), CURRENT_BIT(bit_walker));
+        }
+        else
+        {
+            // -- the last byte -- //
+            slider = (char)BIT_SLIDER_LAST(name, CURRENT_BYTE(bit_walker), CURRENT_BIT(bit_walker));
+            if (num_of_bits > CURRENT_BIT(bit_walker) + 1)
+                num_of_bits = CURRENT_BIT(bit_walker) + 1;
+        }
+        if ((ret_compare = bt_byte_compare (slider, bytes[CURRENT_BYTE(node_bit_walker)], num_of_bits)) != -1)
+            return node_bit_walker + ret_compare;
+        bit_walker += num_of_bits;
+        node_bit_walker += num_of_bits;
+    }
+    return node_bit_walker;
+} /* -- end of slider_compare(..) -- */
+
+/* ------------------------------------------------------------
+ * Method: bench_compare()
+ * Scope: Public 
+ * 
+ * Description:
+ * Microbenchmark of the compare path. Each name is compared,
+ * from a bit in its first bytes, with a node which holds the
+ * bits of the previous name from the same bit (i.e. what the
+ * trie does at each node). Both paths must agree on all names.
+ * ------------------------------------------------------------ */
+void
+bench_compare (char** names, int num_of_names)
+{
+    clock_t start, end;
+    double slider_cpu_used;
+    double word_cpu_used;
+    long long slider_bits = 0;
+    long long word_bits = 0;
+    int* lens = (int*)malloc(sizeof(int) * num_of_names);
+    int* starts = (int*)malloc(sizeof(int) * num_of_names);
+    int* node_lens = (int*)malloc(sizeof(int) * num_of_names);
+    char** bytes = (char**)calloc(num_of_names, sizeof(char*));
+
+    assert (lens && starts && node_lens && bytes);
+    // -- build the content of one node per name (out of the timed part) -- //
+    for (int i=1; i<num_of_names; i++)
+    {
+        int prev_len = strlen(names[i-1]) * BYTE_LEN;
+        lens[i] = strlen(names[i]);
+        starts[i] = (i % 3) * BYTE_LEN + (i % BYTE_LEN);
+        if (starts[i] >= prev_len || starts[i] >= lens[i] * BYTE_LEN)
+            starts[i] = 0;
+        node_lens[i] = prev_len - starts[i];
+        bytes[i] = (char*)calloc(NUM_OF_BYTES(node_lens[i]), 1);
+        assert (bytes[i]);
+        bt_byte_cpy (names[i-1], bytes[i], starts[i], prev_len-1);
+    }
+
+    start = clock();
+    for (int r=0; r<BENCH_ROUNDS; r++)
+        for (int i=1; i<num_of_names; i++)
+            slider_bits += slider_compare (names[i], lens[i], starts[i], bytes[i], node_lens[i]);
+    end = clock();
+    slider_cpu_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int r=0; r<BENCH_ROUNDS; r++)
+        for (int i=1; i<num_of_names; i++)
+            word_bits += bt_bit_compare (names[i], lens[i] * BYTE_LEN, starts[i], bytes[i], node_lens[i], 0);
+    end = clock();
+    word_cpu_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+
+    // -- both paths must match the same number of bits -- //
+    for (int i=1; i<num_of_names; i++)
+    {
+        if (slider_compare (names[i], lens[i], starts[i], bytes[i], node_lens[i]) !=
+            bt_bit_compare (names[i], lens[i] * BYTE_LEN, starts[i], bytes[i], node_lens[i], 0))
+            fprintf (stderr, "[bench_compare] ERROR: Compare paths do not agree on:  %s\n", names[i]);
+    }
+
+    printf ("\n======= COMPARE BENCHMARK =======\n");
+    printf ("Compares:             %d x %d\n", num_of_names - 1, BENCH_ROUNDS);
+    printf ("Matched bits:         %lld\n", word_bits / BENCH_ROUNDS);
+    printf ("Per-bit time:         %f  (%.1f M compares/s)\n", slider_cpu_used,
+            (double)(num_of_names - 1) * BENCH_ROUNDS / slider_cpu_used / 1e6);
+    printf ("Word-at-a-time time:  %f  (%.1f M compares/s)\n", word_cpu_used,
+            (double)(num_of_names - 1) * BENCH_ROUNDS / word_cpu_used / 1e6);
+    if (word_cpu_used > 0)
+        printf ("Speedup:              %.2fx\n", slider_cpu_used / word_cpu_used);
+    if (slider_bits != word_bits)
+        fprintf (stderr, "[bench_compare] ERROR: Compare paths do not agree.\n");
+
+    for (int i=1; i<num_of_names; i++)
+        free (bytes[i]);
+    free (node_lens);
+    free (bytes);
+    free (starts);
+    free (lens);
+} /* -- end of bench_compare(..) -- */
+
+/* ------------------------------------------------------------
+ * Method: bench_stride()
+ * Scope: Public 
+ * 
+ * Description:
+ * Load the names into the tree-bitmap trie (of stride TB_STRIDE),
+ * and report its depth, memory and lookup throughput. To sweep
+ * the stride, see the stride target of Makefile.
+ * ------------------------------------------------------------ */
+void
+bench_stride (char** names, int num_of_names, bool print_flag, bool remove_flag)
+{
+    clock_t start, end;
+    double insert_cpu_used;
+    double lookup_cpu_used;
+    double remove_cpu_used = 0;
+    int found = 0;
+    int max_depth;
+    double ave_depth;
+    long long memory;
+    struct tb_instance* tb = (struct tb_instance*)calloc(1, sizeof(struct tb_instance));
+
+    assert (tb);
+    start = clock();
+    for (int i=0; i<num_of_names; i++)
+    {
+        if (!tb_insert (tb, (const char*)names[i], print_flag) && print_flag)
+            printf ("Insertion error:\t%s\n", names[i]);
+    }
+    end = clock();
+    insert_cpu_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int i=0; i<num_of_names; i++)
+    {
+        if (tb_lookup (tb, (const char*)names[i], print_flag))
+            found++;
+    }
+    end = clock();
+    lookup_cpu_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+    tb_depth (tb, &max_depth, &ave_depth);
+    memory = sizeof(struct tb_instance) + tb->bytes;
+
+    printf ("\n====== TREE BITMAP (stride %d) ======\n", TB_STRIDE);
+    printf ("Names:             %lld\n", tb->num_of_names);
+    printf ("Nodes:             %lld  (%d bytes/node)\n", tb->num_of_nodes + 1, (int)sizeof(struct tb_node_t));
+    printf ("MAX Depth=         %d\n", max_depth);
+    printf ("AVE Depth=         %f\n", ave_depth);
+    printf ("Memory:            %lld bytes", memory);
+    if (tb->num_of_names)
+        printf ("  (%.1f bytes/name)", (double)memory / tb->num_of_names);
+    printf ("\n");
+    printf ("Insertion time:    %f\n", insert_cpu_used);
+    printf ("Lookup time:       %f", lookup_cpu_used);
+    if (num_of_names && lookup_cpu_used > 0)
+        printf ("  (%.2f M lookups/s, %.1f ns/op)", num_of_names / lookup_cpu_used / 1e6, lookup_cpu_used * 1e9 / num_of_names);
+    printf ("\n");
+    printf ("Found:             %d/%d\n", found, num_of_names);
+
+    if (remove_flag)
+    {
+        start = clock();
+        for (int i=0; i<num_of_names; i++)
+            tb_remove (tb, (const char*)names[i], print_flag);
+        end = clock();
+        remove_cpu_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+        printf ("Removal time:      %f  (%lld names, %lld nodes left)\n", remove_cpu_used, tb->num_of_names, tb->num_of_nodes);
+    }
+
+    tb_free (tb);
+    free (tb);
+} /* -- end of bench_stride(..) -- */
+
+/* ---------------------------------------------------
+ * Method: rw_elapsed_ns()
+ * Scope: Public 
+ * 
+ * Description:
+ * Wall-clock time (ns) since a given time.
+ * --------------------------------------------------- */
+long long
+rw_elapsed_ns (const struct timespec* since)
+{
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since->tv_sec) * 1000000000LL + (now.tv_nsec - since->tv_nsec);
+} /* -- end of rw_elapsed_ns (..) -- */
+
+/* ---------------------------------------------------
+ * Method: rw_reader()
+ * Scope: Public 
+ * 
+ * Description:
+ * Body of a reader thread in the reader/writer stress
+ * benchmark. The reader registers a record, and looks
+ * up the names (from its first one, round robin) for
+ * RW_DURATION_MS. Latency of each lookup is recorded.
+ * --------------------------------------------------- */
+void*
+rw_reader (void* arg)
+{
+    struct rw_arg_t* rw = (struct rw_arg_t*)arg;
+    struct ep_record_t* reader;
+    struct timespec start;
+    long long before, now;    // -- ns since the start -- //
+    long long ns;
+    int i = rw->first;
+
+    if (!(reader = ep_register (&rw->bt->epoch)))
+        return 0;
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    do
+    {
+        before = rw_elapsed_ns (&start);
+        if (bt_read_lookup (rw->bt, reader, (const char*)rw->names[i]))
+            rw->found++;
+        now = rw_elapsed_ns (&start);
+        ns = (now - before) / RW_BUCKET_NS;
+        rw->hist[(ns < RW_NUM_OF_BUCKETS) ? ns : RW_NUM_OF_BUCKETS - 1]++;
+        rw->lookups++;
+        i = (i + 1) % rw->num_of_names;
+    } while (now < RW_DURATION_MS * 1000000LL);
+    ep_unregister (reader);
+    return 0;
+} /* -- end of rw_reader (..) -- */
+
+/* ---------------------------------------------------
+ * Method: rw_writer()
+ * Scope: Public 
+ * 
+ * Description:
+ * Body of the (single) writer thread in the reader/
+ * writer stress benchmark. The writer removes a name
+ * and inserts it back (two updates), at most at the
+ * given rate (updates/sec, or RW_UNLIMITED), until the
+ * readers are done.
+ * --------------------------------------------------- */
+void*
+rw_writer (void* arg)
+{
+    struct rw_arg_t* rw = (struct rw_arg_t*)arg;
+    struct timespec start, pause;
+    long long due;      // -- when the next update is due (ns) -- //
+    long long ns;
+    int i = 0;
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    while (!__atomic_load_n (rw->stop, __ATOMIC_ACQUIRE))
+    {
+        if (rw->rate != RW_UNLIMITED)
+        {
+            due = rw->updates * 1000000000LL / rw->rate;
+            if ((ns = due - rw_elapsed_ns (&start)) > 0)
+            {
+                pause.tv_sec = ns / 1000000000LL;
+                pause.tv_nsec = ns % 1000000000LL;
+                nanosleep (&pause, 0);
+                continue;
+            }
+        }
+        if (!bt_remove (rw->bt, (const char*)rw->names[i], false))
+            rw->updates++;
+        if (bt_insert (rw->bt, (const char*)rw->names[i], false))
+            rw->updates++;
+        i = (i + 1) % rw->num_of_names;
+    }
+    return 0;
+} /* -- end of rw_writer (..) -- */
+
+/* ---------------------------------------------------
+ * Method: rw_percentile()
+ * Scope: Public 
+ * 
+ * Description:
+ * Return the given percentile (in ns) of a latency
+ * histogram with a total number of samples.
+ * --------------------------------------------------- */
+long long
+rw_percentile (unsigned long long* hist, unsigned long long total, double percentile)
+{
+    unsigned long long rank = (unsigned long long)(total * percentile);
+    unsigned long long seen = 0;
+
+    for (int i=0; i<RW_NUM_OF_BUCKETS; i++)
+    {
+        seen += hist[i];
+        if (seen > rank)
+            return (long long)(i + 1) * RW_BUCKET_NS;
+    }
+    return (long long)RW_NUM_OF_BUCKETS * RW_BUCKET_NS;
+} /* -- end of rw_percentile (..) -- */
+
+/* ---------------------------------------------------
+ * Method: eval_rw()
+ * Scope: Public 
+ * 
+ * Description:
+ * Stress benchmark of concurrent readers. The names
+ * are inserted, then a number of reader threads look
+ * them up while a single writer removes and inserts
+ * them back, at increasing rates (no writer, fixed
+ * rates, and as fast as it can). Report reader
+ * throughput, latency percentiles and the achieved
+ * writer rate of each run.
+ * NOTE:
+ *     Time is wall-clock time (not CPU time), and the
+ *     latency includes the cost of reading the clock.
+ * --------------------------------------------------- */
+void
+eval_rw (struct bt_instance* bt, char** names, int num_of_names, int num_of_readers)
+{
+    assert (bt);
+    long rates[] = RW_RATES;
+    int num_of_rates = sizeof(rates) / sizeof(long);
+    pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t) * (num_of_readers + 1));
+    struct rw_arg_t* args = (struct rw_arg_t*)malloc(sizeof(struct rw_arg_t) * (num_of_readers + 1));
+    unsigned long long* hist = (unsigned long long*)malloc(sizeof(unsigned long long) * RW_NUM_OF_BUCKETS);
+    struct timespec start;
+    double elapsed;
+    unsigned long long total;
+    long long found;
+    volatile int stop;
+    int num_of_threads;
+    bool with_writer;
+
+    assert (threads && args && hist);
+    for (int i=0; i<num_of_names; i++)
+        bt_insert (bt, (const char*)names[i], false);
+
+    printf ("\n------- CONCURRENT LOOKUP (%d readers, %d names, %d ms per run) -------\n", num_of_readers, num_of_names, RW_DURATION_MS);
+    for (int r=0; r<num_of_rates; r++)
+    {
+        with_writer = (rates[r] != RW_OFF);
+        stop = 0;
+        for (int i=0; i<=num_of_readers; i++)
+        {
+            args[i].bt = bt;
+            args[i].names = names;
+            args[i].num_of_names = num_of_names;
+            args[i].first = (int)((long long)num_of_names * i / num_of_readers) % num_of_names;
+            args[i].rate = rates[r];
+            args[i].found = 0;
+            args[i].lookups = 0;
+            args[i].updates = 0;
+            args[i].hist = (unsigned long long*)calloc(RW_NUM_OF_BUCKETS, sizeof(unsigned long long));
+            args[i].stop = &stop;
+        }
+        num_of_threads = 0;
+        clock_gettime (CLOCK_MONOTONIC, &start);
+        if (with_writer && pthread_create (&threads[num_of_readers], 0, rw_writer, &args[num_of_readers]))
+        {
+            fprintf (stderr, "[eval_rw] ERROR: Failed to create the writer.\n");
+            with_writer = false;
+        }
+        for (int i=0; i<num_of_readers; i++)
+        {
+            if (pthread_create (&threads[i], 0, rw_reader, &args[i]))
+            {
+                fprintf (stderr, "[eval_rw] ERROR: Failed to create thread %d.\n", i);
+                break;
+            }
+            num_of_threads++;
+        }
+        for (int i=0; i<num_of_threads; i++)
+            pthread_join (threads[i], 0);
+        elapsed = rw_elapsed_ns (&start) / 1e9;
+        __atomic_store_n (&stop, 1, __ATOMIC_RELEASE);
+        if (with_writer)
+            pthread_join (threads[num_of_readers], 0);
+
+        found = 0;
+        total = 0;
+        for (int b=0; b<RW_NUM_OF_BUCKETS; b++)
+            hist[b] = 0;
+        for (int i=0; i<num_of_threads; i++)
+        {
+            found += args[i].found;
+            total += args[i].lookups;
+            for (int b=0; b<RW_NUM_OF_BUCKETS; b++)
+                hist[b] += args[i].hist[b];
+        }
+
+        if (!with_writer)
+            printf ("Writer: OFF\n");
+        else if (rates[r] == RW_UNLIMITED)
+            printf ("Writer: MAX        Updates/sec: %14.2f\n", (double)args[num_of_readers].updates / elapsed);
+        else
+            printf ("Writer: %-9ld  Updates/sec: %14.2f\n", rates[r], (double)args[num_of_readers].updates / elapsed);
+        printf ("\tLookups/sec:   %14.2f   Found: %lld/%lld\n", (double)total / elapsed, found, (long long)total);
+        if (total)
+            printf ("\tLatency (ns):  p50= %lld   p99= %lld   p99.9= %lld\n", rw_percentile (hist, total, 0.5),
+                    rw_percentile (hist, total, 0.99), rw_percentile (hist, total, 0.999));
+        for (int i=0; i<=num_of_readers; i++)
+            free(args[i].hist);
+    }
+    free(hist);
+    free(args);
+    free(threads);
+} /* -- end of eval_rw (..) -- */
+
+/* ------------------------------------------------
+ * Method: bench_load
+ * Scope: Public 
+ * 
+ * Description:
+ * Load mode: build the trie by bt_insert (one name
+ * after another), and by the bulk load of the sorted
+ * names with different numbers of threads. Report the
+ * build times, and whether each bulk-loaded trie is
+ * the same as the inserted one.
+ * ------------------------------------------------- */
+void
+bench_load (struct bt_instance* bt, char** names, int num_of_names)
+{
+    assert (bt);
+    int threads[] = BL_THREADS;
+    int num_of_runs = sizeof(threads) / sizeof(int);
+    char** sorted = (char**)malloc(sizeof(char*) * num_of_names);
+    struct bt_instance* loaded;
+    struct timespec start;
+    double insert_time, sort_time, load_time;
+    long long steals;
+    int ret;
+
+    assert (sorted);
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    for (int i=0; i<num_of_names; i++)
+        bt_insert (bt, (const char*)names[i], false);
+    insert_time = rw_elapsed_ns (&start) / 1e6;
+
+    memcpy (sorted, names, sizeof(char*) * num_of_names);
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    qsort (sorted, num_of_names, sizeof(char*), bl_compare);
+    sort_time = rw_elapsed_ns (&start) / 1e6;
+
+    printf ("\n------- LOAD (%d names) -------\n", num_of_names);
+    printf ("bt_insert:          %10.2f ms\n", insert_time);
+    printf ("Sort (not in load): %10.2f ms\n", sort_time);
+    printf ("Threads   Load (ms)   Speedup   Steals   Same trie\n");
+    for (int r=0; r<num_of_runs; r++)
+    {
+        loaded = (struct bt_instance*)malloc(sizeof(struct bt_instance));
+        assert (loaded);
+        if (bt_init (loaded) || (bt->jump && jt_init (loaded, bt->jump_bits)))
+        {
+            fprintf (stderr, "[bench_load] ERROR: Could not initialize the trie.\n");
+            free (loaded);
+            break;
+        }
+        clock_gettime (CLOCK_MONOTONIC, &start);
+        ret = bl_load (loaded, sorted, num_of_names, threads[r], &steals);
+        load_time = rw_elapsed_ns (&start) / 1e6;
+        if (ret)
+            fprintf (stderr, "[bench_load] ERROR: Bulk load by %d threads has been failed.\n", threads[r]);
+        else
+            printf ("%7d   %9.2f   %6.2fx   %6lld   %s\n", threads[r], load_time, insert_time / load_time, steals,
+                    db_same (bt, BT_ROOT(bt), loaded, BT_ROOT(loaded)) ? "yes" : "NO");
+        bt_destroy (loaded);
+        free (loaded);
+    }
+    free (sorted);
+} /* -- end of bench_load (..) -- */
+
+/* ------------------------------------------------
+ * Method: bench_churn
+ * Scope: Public 
+ * 
+ * Description:
+ * Churn benchmark: insert all names, then in each
+ * round remove a random percent of them and insert
+ * them back. Report the updates/sec of each round,
+ * the sustained rate, and the pools (i.e. how many
+ * nodes and contents are recycled).
+ * ------------------------------------------------- */
+void
+bench_churn (struct bt_instance* bt, char** names, int num_of_names, int percent)
+{
+    assert (bt);
+    char** churn = (char**)malloc(sizeof(char*) * num_of_names);
+    int num_of_churn = (int)((long long)num_of_names * percent / 100);
+    struct timespec start;
+    long long round_ns, total_ns = 0;
+    long long updates, total_updates = 0;
+    char* tmp;
+    int j;
+
+    assert (churn);
+    for (int i=0; i<num_of_names; i++)
+        bt_insert (bt, (const char*)names[i], false);
+    memcpy (churn, names, sizeof(char*) * num_of_names);
+    srand (CHURN_SEED);
+
+    printf ("\n------- CHURN (%d names, %d%% of them per round) -------\n", num_of_names, percent);
+    printf ("Round   Updates   Updates/sec   Pools reserved (bytes)\n");
+    for (int r=0; r<CHURN_ROUNDS; r++)
+    {
+        // -- a random subset: the first names of a partial shuffle -- //
+        for (int i=0; i<num_of_churn; i++)
+        {
+            j = i + rand() % (num_of_names - i);
+            tmp = churn[i];
+            churn[i] = churn[j];
+            churn[j] = tmp;
+        }
+        updates = 0;
+        clock_gettime (CLOCK_MONOTONIC, &start);
+        for (int i=0; i<num_of_churn; i++)
+            if (!bt_remove (bt, (const char*)churn[i], false))
+                updates++;
+        for (int i=0; i<num_of_churn; i++)
+            if (bt_insert (bt, (const char*)churn[i], false))
+                updates++;
+        round_ns = rw_elapsed_ns (&start);
+        total_ns += round_ns;
+        total_updates += updates;
+        printf ("%5d   %7lld   %11.0f   %lld\n", r+1, updates, round_ns ? updates * 1e9 / round_ns : 0.0, bp_reserved (&bt->pool));
+    }
+    printf ("Sustained:         %.0f updates/sec\n", total_ns ? total_updates * 1e9 / total_ns : 0.0);
+    print_pool (bt);
+    free (churn);
+} /* -- end of bench_churn (..) -- */
+
 /* --------------------------------------------------------
  * Method: free_bt()
  * Scope: Public 
@@ -197,14 +912,15 @@ free_bt (struct bt_instance* bt)
     assert (bt);
     
     // -- unchained Django! -- //
-    free (bt->root.child_0);
-    free (bt->root.child_1);
+    if (cb)
+    {
+        cb_free (cb);
+        free (cb);
+        cb = 0;
+    }
+    bt_destroy (bt);   // -- all nodes at once -- //
     free (bt->trie_stat->width);
     free (bt->trie_stat);
-    free (bt->root.bytes);
-    bt->root.parent = 0;
-    bt->root.child_0 = 0;
-    bt->root.child_1 = 0;
     bt->trie_stat = 0;
     free (bt); 
 } /* end of free_bt(..) -- */
@@ -236,9 +952,16 @@ main (int argc, char** argv)
     bool dfs_flag = false;
     bool help_flag = false;
     bool eval_flag = false;
+    bool bench_flag = false;
+    bool critbit_flag = false;
+    bool stride_flag = false;
+    int num_of_readers = 0;
+    int jump_bits = 0;
+    bool load_flag = false;
+    int churn_percent = 0;
     char* rand_file = NULL;
 
-    while ((sw = getopt (argc, argv, "ri:n:tpxRhe:")) != -1)
+    while ((sw = getopt (argc, argv, "ri:n:tpxRhe:mcsW:j:Lu:")) != -1)
     switch (sw)
     {
         case 'i':
@@ -275,8 +998,47 @@ main (int argc, char** argv)
             eval_flag = true;
             rand_file = optarg;
             break;
+        case 'm':
+            bench_flag = true;
+            break;
+        case 'c':
+            critbit_flag = true;
+            break;
+        case 's':
+            stride_flag = true;
+            break;
+        case 'W':
+            ret = strtol (optarg, &rem, 10); 
+            if (ret < 1 || ret >= EP_MAX_READERS)
+            {
+                fprintf (stderr, "[main] ERROR: Option -%c requires an integer argument, greater than ZERO and less than %d.\n", sw, EP_MAX_READERS);
+                return 1;
+            }
+            num_of_readers = (int)ret;
+            break;
+        case 'j':
+            ret = strtol (optarg, &rem, 10); 
+            if (ret < 1 || ret > JT_MAX_BITS)
+            {
+                fprintf (stderr, "[main] ERROR: Option -%c requires an integer argument, between 1 and %d.\n", sw, JT_MAX_BITS);
+                return 1;
+            }
+            jump_bits = (int)ret;
+            break;
+        case 'L':
+            load_flag = true;
+            break;
+        case 'u':
+            ret = strtol (optarg, &rem, 10); 
+            if (ret < 1 || ret > 100)
+            {
+                fprintf (stderr, "[main] ERROR: Option -%c requires an integer argument, between 1 and 100.\n", sw);
+                return 1;
+            }
+            churn_percent = (int)ret;
+            break;
         case '?':
-            if (optopt=='i' || optopt=='n' || optopt=='p' || optopt=='t' || optopt=='r' || optopt=='x' || optopt=='R' || optopt=='h' || optopt=='e')
+            if (optopt=='i' || optopt=='n' || optopt=='p' || optopt=='t' || optopt=='r' || optopt=='x' || optopt=='R' || optopt=='h' || optopt=='e' || optopt=='m' || optopt=='c' || optopt=='s' || optopt=='W' || optopt=='j' || optopt=='L' || optopt=='u')
                 fprintf (stderr, "[main] ERROR: Option -%c requires an argument.\n", optopt);
             else if (isprint (optopt))
             {
@@ -309,25 +1071,58 @@ main (int argc, char** argv)
     } 
 
     /* --------------------------- Begin Initialize ------------------------ */
-    struct bt_instance* bt;
-    bt = (struct bt_instance*)malloc(sizeof(struct bt_instance));
+    struct bt_instance* bt = (struct bt_instance*)malloc(sizeof(struct bt_instance));
     assert (bt);
-    bt->root.bytes = (char*)malloc(2);
-    bt->root.bytes[0] = (char)SLASH;
-    bt->root.bytes[1] = '\0';
-    bt->root.len = 8;   // -- in terms of bit -- //
-    bt->root.child_0 = 0;
-    bt->root.child_1 = 0;
-    bt->root.parent = 0;
-    bt->root.EON_flag = false;    // -- this is not EON -- //
+    if (bt_init (bt))
+    {
+        fprintf (stderr, "[main] ERROR: Could not initialize the trie.\n");
+        free (bt);
+        return 1;
+    }
     bt->trie_stat = (struct t_stat*)malloc(sizeof(struct t_stat));
     bt->trie_stat->max = 0;
     bt->trie_stat->sum = 0;
     bt->trie_stat->num = 0;
     bt->trie_stat->id = 0;
+    bt->trie_stat->spilled = 0;
     bt->trie_stat->width = (int*)malloc(MAX_HEIGHT * sizeof(int));
     for (int i=0; i<MAX_HEIGHT; i++)
         bt->trie_stat->width[i] = 0;
+    if (critbit_flag)
+    {
+        cb = (struct cb_instance*)calloc(1, sizeof(struct cb_instance));
+        assert (cb);
+        if (dfs_flag)
+        {
+            fprintf (stderr, "[main] WARNING: [-R] is not supported by the crit-bit tree, ignored.\n");
+            dfs_flag = false;
+        }
+        if (num_of_readers)
+        {
+            fprintf (stderr, "[main] WARNING: [-W] is not supported by the crit-bit tree, the Patricia trie is used.\n");
+            cb_free (cb);
+            free (cb);
+            cb = 0;
+        }
+        if ((load_flag || churn_percent) && cb)
+        {
+            fprintf (stderr, "[main] WARNING: [-L] and [-u] are not supported by the crit-bit tree, the Patricia trie is used.\n");
+            cb_free (cb);
+            free (cb);
+            cb = 0;
+        }
+    }
+    if (jump_bits)
+    {
+        if (cb)
+            fprintf (stderr, "[main] WARNING: [-j] is not supported by the crit-bit tree, ignored.\n");
+        else if (jt_init (bt, jump_bits))
+        {
+            fprintf (stderr, "[main] ERROR: Could not build the jump table.\n");
+            free_bt (bt);
+            return 1;
+        }
+    }
     /* --------------------------- END Initialize ------------------------ */
 
 
@@ -339,7 +1134,7 @@ main (int argc, char** argv)
     printf ("__%02x\n", (char)BIT_SHIFT_UP(nn, 0, 8));
     const char* na = "/mp/ll_432/ds$/mpold%25_arm/index_file/home.php";
     if ((ret_insert=(bt_insert (bt, na, print_flag))))
-        db_print_node (ret_insert);
+        db_print_node (bt, ret_insert);
 
 
     const char* na = "abcd";
@@ -349,17 +1144,17 @@ main (int argc, char** argv)
     const char* ne = "abc";
     const char* nf = "ab";
     if ((ret_insert=(bt_insert (bt, na, print_flag))))
-        db_print_node (ret_insert);
+        db_print_node (bt, ret_insert);
     if ((ret_insert=(bt_insert (bt, nb, print_flag))))
-        db_print_node (ret_insert);
+        db_print_node (bt, ret_insert);
     if ((ret_insert=(bt_insert (bt, nc, print_flag))))
-        db_print_node (ret_insert);
+        db_print_node (bt, ret_insert);
     if ((ret_insert=(bt_insert (bt, nd, print_flag))))
-        db_print_node (ret_insert);
+        db_print_node (bt, ret_insert);
     if ((ret_insert=(bt_insert (bt, ne, print_flag))))
-        db_print_node (ret_insert);
+        db_print_node (bt, ret_insert);
     if ((ret_insert=(bt_insert (bt, nf, print_flag))))
-        db_print_node (ret_insert);
+        db_print_node (bt, ret_insert);
 
     db_dfs(bt, print_flag);
 */
@@ -380,7 +1175,9 @@ main (int argc, char** argv)
         return 0;
 
     // -- mass insertion -- //
-    struct node_t* ret_insert = 0;
+    const void* ret_insert = 0;
+    long long memory = 0;           // -- memory of the engine after lookups -- //
+    long long num_of_stored = 0;    // -- number of names in the engine -- //
     char* str = malloc (MAX_NAME_LEN);
     FILE* input = fopen(input_file, "r");
     if (input == NULL)
@@ -394,6 +1191,36 @@ main (int argc, char** argv)
     double remove_cpu_used = 0;
 
 
+    if (bench_flag || stride_flag || num_of_readers || load_flag || churn_percent)
+    {
+        int num_of_names = 0;
+        char** all_input = (char**)malloc((sizeof(char*) * num_of_rec)); 
+        while (num_of_names < num_of_rec && fscanf(input, "%s", str) != EOF)
+        {
+            all_input[num_of_names] = (char*)malloc(strlen(str) + 1);
+            strcpy (all_input[num_of_names++], str);
+        }
+        fclose(input);
+
+        if (bench_flag)
+            bench_compare (all_input, num_of_names);
+        if (stride_flag)
+            bench_stride (all_input, num_of_names, print_flag, remove_flag);
+        if (num_of_readers)
+            eval_rw (bt, all_input, num_of_names, num_of_readers);
+        else if (load_flag)
+            bench_load (bt, all_input, num_of_names);
+        else if (churn_percent)
+            bench_churn (bt, all_input, num_of_names, churn_percent);
+
+        for (int i=0; i<num_of_names; i++)
+            free(all_input[i]);
+        free(all_input);
+        free(str);
+        free_bt(bt);
+        return 0;
+    }
+
     if (eval_flag)
     {
         int rand_size = 0;
@@ -432,7 +1259,10 @@ main (int argc, char** argv)
                 strcpy (rand_input[i], str);
             }
             else 
+            {
+                rand_size = i;  // -- the file has less names -- //
                 break;
+            }
         } 
         fclose(rand_file_input);
 
@@ -442,7 +1272,7 @@ main (int argc, char** argv)
         printf ("MASS INSERTION:\n");
         for (int i = 0; i < num_of_rec-rand_size; i++)
         {
-            if (!bt_insert (bt, (const char*)all_input[i], print_flag))
+            if (!name_insert (bt, (const char*)all_input[i], print_flag))
             {
                 if (print_flag)
                     printf ("Duplicate name OR Insertion error.\n");
@@ -457,7 +1287,7 @@ main (int argc, char** argv)
         printf ("EVAL LOOKUP:\n");
         for (int i = 0; i < rand_size; i++)
         {
-            if (!bt_lookup (bt, (const char*)rand_input[i], print_flag, 0)) 
+            if (!name_lookup (bt, (const char*)rand_input[i], print_flag)) 
             {
                 if (print_flag)
                     printf ("Name is NOT found:\t%s\n", rand_input[i]);                 
@@ -470,13 +1300,14 @@ main (int argc, char** argv)
         }
         end = clock();
         lookup_cpu_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+        memory = engine_memory (bt, &num_of_stored);
 
         // -- eval insertion speed -- //
         start = clock();
         printf ("EVAL INSERTION:\n");
         for (int i = 0; i < rand_size; i++)
         {
-            if (!bt_insert (bt, (const char*)rand_input[i], print_flag))
+            if (!name_insert (bt, (const char*)rand_input[i], print_flag))
             {
                 if (print_flag)
                     printf ("Duplicate name OR Insertion error.\n");
@@ -495,7 +1326,7 @@ main (int argc, char** argv)
         printf ("EVAL REMOVE:\n");
         for (int i = 0; i < rand_size; i++)
         { 
-            if (!bt_remove (bt, (const char*)rand_input[i], print_flag)) 
+            if (!name_remove (bt, (const char*)rand_input[i], print_flag)) 
             {
                 if (print_flag)
                     printf ("Name is removed:\t%s\n", rand_input[i]);                 
@@ -518,6 +1349,7 @@ main (int argc, char** argv)
 
         // -- summary -- //
         print_summary (bt, insert_cpu_used, lookup_cpu_used, remove_cpu_used, print_flag, dfs_flag);
+        print_engine (memory, num_of_stored, rand_size, lookup_cpu_used);
         free(str);
         for (int i=0; i<num_of_rec; i++)
             free(all_input[i]);
@@ -548,7 +1380,7 @@ main (int argc, char** argv)
         start = clock();
         for (int i = 0; i < num_of_rec; i++)
         {
-            if ((ret_insert=(bt_insert (bt, (const char*)all_input[i], print_flag))))
+            if ((ret_insert=(name_insert (bt, (const char*)all_input[i], print_flag))))
             {
                 //db_print_node(ret_insert); 
                 continue;
@@ -562,7 +1394,7 @@ main (int argc, char** argv)
         printf ("MASS LOOKUP:\n");
         for (int i = 0; i < num_of_rec; i++)
         {
-            if (!bt_lookup (bt, (const char*)all_input[i], print_flag, 0)) 
+            if (!name_lookup (bt, (const char*)all_input[i], print_flag)) 
             {
                 if (print_flag)
                     printf ("Name is NOT found:\t%s\n", all_input[i]);                 
@@ -575,6 +1407,7 @@ main (int argc, char** argv)
         }
         end = clock();
         lookup_cpu_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+        memory = engine_memory (bt, &num_of_stored);
 
         // -- mass remove -- //
         start = clock();
@@ -583,7 +1416,7 @@ main (int argc, char** argv)
             printf ("MASS REMOVE:\n");
             for (int i = 0; i < num_of_rec; i++)
             {
-                if (!bt_remove (bt, (const char*)all_input[i], print_flag)) 
+                if (!name_remove (bt, (const char*)all_input[i], print_flag)) 
                 {
                     if (print_flag)
                         printf ("Name is removed:\t%s\n", all_input[i]);                 
@@ -605,6 +1438,7 @@ main (int argc, char** argv)
         }
         // -- summary -- //    
         print_summary (bt, insert_cpu_used, lookup_cpu_used, remove_cpu_used, print_flag, dfs_flag);
+        print_engine (memory, num_of_stored, num_of_rec, lookup_cpu_used);
 
         // -- END OF MASS PART -- //
         for (int i=0; i<num_of_rec; i++)
@@ -624,7 +1458,7 @@ main (int argc, char** argv)
         if (fscanf (input, "%s", str) != EOF)
         {
             //printf ("Insert name:  %s\n", str);
-            if ((ret_insert=(bt_insert (bt, (const char*)str, print_flag))))
+            if ((ret_insert=(name_insert (bt, (const char*)str, print_flag))))
             {
                 //db_print_node(ret_insert); 
                 continue;
@@ -648,7 +1482,7 @@ main (int argc, char** argv)
     {
         if (fscanf (input, "%s", str) != EOF)
         {
-            if (!bt_lookup (bt, (const char*)str, print_flag, 0)) 
+            if (!name_lookup (bt, (const char*)str, print_flag)) 
             {
                 if (print_flag)
                     printf ("Name is NOT found:\t%s\n", str);                 
@@ -668,6 +1502,7 @@ main (int argc, char** argv)
     end = clock();
     lookup_cpu_used = ((double) (end - start)) / CLOCKS_PER_SEC;
     fclose(input);
+    memory = engine_memory (bt, &num_of_stored);
 
     // -- mass remove -- //
     input = fopen(input_file, "r");
@@ -680,7 +1515,7 @@ main (int argc, char** argv)
             //printf ("Remove number:  %u\n", i);
             if (fscanf (input, "%s", str) != EOF)
             {
-                if (!bt_remove (bt, (const char*)str, print_flag)) 
+                if (!name_remove (bt, (const char*)str, print_flag)) 
                 {
                     if (print_flag)
                         printf ("Name is removed:\t%s\n", str);                 
@@ -709,6 +1544,7 @@ main (int argc, char** argv)
     }
     // -- summary -- //    
     print_summary (bt, insert_cpu_used, lookup_cpu_used, remove_cpu_used, print_flag, dfs_flag);
+    print_engine (memory, num_of_stored, num_of_rec, lookup_cpu_used);
  
     /* ---------------------------  END Mass part ------------------------- */
     free(str);
@@ -0,0 +1,348 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * For list of authors, please see AUTHORS.md file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#include "tb_bitmap.h"
+
+/* -----------------------------------------------------------------
+ * Method: tb_chunk (..)
+ * Scope: Private
+ *
+ * Description:
+ * Extract n bits (n <= 8) of a name, starting from a given bit.
+ * ------------------------------------------------------------------ */
+static inline unsigned int
+tb_chunk (const char* name, int name_len, int bit, int n)
+{
+    int byte = CURRENT_BYTE(bit);
+    unsigned int window;
+
+    if (!n)
+        return 0;
+    window = (unsigned char)name[byte] << BYTE_LEN;
+    if (byte + 1 < name_len)
+        window |= (unsigned char)name[byte + 1];
+    return (window >> (2*BYTE_LEN - (bit % BYTE_LEN) - n)) & ((1u << n) - 1);
+} /* -- end of tb_chunk (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: tb_rank (..)
+ * Scope: Private
+ *
+ * Description:
+ * Number of ON bits of a bitmap before a given bit (i.e. index of
+ * the child of a chunk).
+ * ------------------------------------------------------------------ */
+static inline int
+tb_rank (const unsigned long long* map, unsigned int bit)
+{
+    int rank = 0;
+
+    for (unsigned int i=0; i < (bit >> 6); i++)
+        rank += __builtin_popcountll (map[i]);
+    return rank + __builtin_popcountll (map[bit >> 6] & ((1ULL << (bit & 63)) - 1));
+} /* -- end of tb_rank (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: tb_num_of_children (..)
+ * Scope: Private
+ * ------------------------------------------------------------------ */
+static inline int
+tb_num_of_children (const struct tb_node_t* node)
+{
+    int num = 0;
+
+    for (int i=0; i<TB_WORDS; i++)
+        num += __builtin_popcountll (node->external[i]);
+    return num;
+} /* -- end of tb_num_of_children (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: tb_insert (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Insert a name into the tree-bitmap trie. Each level consumes a
+ * chunk of TB_STRIDE bits; a missing child is added to the packed
+ * children of the node. The rest of the name (less than a stride)
+ * is marked in the internal bitmap of the last node.
+ *
+ * RETURN:
+ *    the node in which the name ends (valid until the next change)
+ *    NULL: ERROR
+ * ------------------------------------------------------------------ */
+struct tb_node_t*
+tb_insert (struct tb_instance* tb, const char* name, bool print_flag)
+{
+    assert (tb);
+    assert (name);
+
+    int name_len = strlen(name);
+    int bit_len = name_len * BYTE_LEN;
+    int bit_walker = 0;
+    struct tb_node_t* node = &(tb->root);
+    struct tb_node_t* children;
+    unsigned int chunk;
+    int index;
+    int num;
+
+    while (bit_len - bit_walker >= TB_STRIDE)
+    {
+        chunk = tb_chunk (name, name_len, bit_walker, TB_STRIDE);
+        index = tb_rank (node->external, chunk);
+        if (!TB_TEST(node->external, chunk))
+        {
+            // -- add the child to its place among the packed children -- //
+            num = tb_num_of_children (node);
+            children = (struct tb_node_t*)realloc(node->children, (num + 1) * sizeof(struct tb_node_t));
+            if (!children)
+            {
+                fprintf (stderr, "[tb_insert] ERROR: Memory allocation has been failed.\n");
+                return 0;
+            }
+            memmove (children + index + 1, children + index, (num - index) * sizeof(struct tb_node_t));
+            memset (children + index, 0, sizeof(struct tb_node_t));
+            node->children = children;
+            TB_SET(node->external, chunk);
+            tb->num_of_nodes++;
+            tb->bytes += sizeof(struct tb_node_t);
+        }
+        node = node->children + index;
+        bit_walker += TB_STRIDE;
+    }
+
+    // -- the name ends inside this node -- //
+    chunk = TB_INTERNAL_POS(bit_len - bit_walker, tb_chunk (name, name_len, bit_walker, bit_len - bit_walker));
+    if (!TB_TEST(node->internal, chunk))
+    {
+        TB_SET(node->internal, chunk);
+        tb->num_of_names++;
+    }
+    return node;
+} /* -- end of tb_insert (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: tb_lookup (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Lookup a given name in the tree-bitmap trie.
+ * ------------------------------------------------------------------ */
+struct tb_node_t*
+tb_lookup (struct tb_instance* tb, const char* name, bool print_flag)
+{
+    assert (tb);
+    assert (name);
+
+    int name_len = strlen(name);
+    int bit_len = name_len * BYTE_LEN;
+    int bit_walker = 0;
+    struct tb_node_t* node = &(tb->root);
+    unsigned int chunk;
+
+    while (bit_len - bit_walker >= TB_STRIDE)
+    {
+        chunk = tb_chunk (name, name_len, bit_walker, TB_STRIDE);
+        if (!TB_TEST(node->external, chunk))
+        {
+            if (print_flag)
+                printf ("Name is NOT found.\n");
+            return 0;
+        }
+        node = node->children + tb_rank (node->external, chunk);
+        bit_walker += TB_STRIDE;
+    }
+    chunk = TB_INTERNAL_POS(bit_len - bit_walker, tb_chunk (name, name_len, bit_walker, bit_len - bit_walker));
+    if (TB_TEST(node->internal, chunk))
+        return node;
+    if (print_flag)
+        printf ("Name is NOT found.\n");
+    return 0;
+} /* -- end of tb_lookup (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: tb_do_remove (..)
+ * Scope: Private
+ *
+ * Description:
+ * Remove a name from a subtree. On the way back, a child with no
+ * name and no child is removed from the packed children.
+ *
+ * RETURN:
+ *     1: name is not found
+ *     0: DONE!
+ * ------------------------------------------------------------------ */
+static int
+tb_do_remove (struct tb_instance* tb, struct tb_node_t* node, const char* name, int name_len, int bit_walker)
+{
+    int bit_len = name_len * BYTE_LEN;
+    unsigned int chunk;
+    int index;
+    int num;
+    struct tb_node_t* child;
+
+    if (bit_len - bit_walker < TB_STRIDE)
+    {
+        chunk = TB_INTERNAL_POS(bit_len - bit_walker, tb_chunk (name, name_len, bit_walker, bit_len - bit_walker));
+        if (!TB_TEST(node->internal, chunk))
+            return 1;
+        TB_CLEAR(node->internal, chunk);
+        tb->num_of_names--;
+        return 0;
+    }
+
+    chunk = tb_chunk (name, name_len, bit_walker, TB_STRIDE);
+    if (!TB_TEST(node->external, chunk))
+        return 1;
+    index = tb_rank (node->external, chunk);
+    child = node->children + index;
+    if (tb_do_remove (tb, child, name, name_len, bit_walker + TB_STRIDE))
+        return 1;
+
+    // -- remove the child if it is empty now -- //
+    if (child->children)
+        return 0;
+    for (int i=0; i<TB_WORDS; i++)
+        if (child->internal[i])
+            return 0;
+    num = tb_num_of_children (node);
+    memmove (child, child + 1, (num - index - 1) * sizeof(struct tb_node_t));
+    TB_CLEAR(node->external, chunk);
+    tb->num_of_nodes--;
+    tb->bytes -= sizeof(struct tb_node_t);
+    if (num == 1)
+    {
+        free (node->children);
+        node->children = 0;
+    }
+    else
+    {
+        // -- shrinking cannot fail; keep the old block if it does -- //
+        child = (struct tb_node_t*)realloc(node->children, (num - 1) * sizeof(struct tb_node_t));
+        if (child)
+            node->children = child;
+    }
+    return 0;
+} /* -- end of tb_do_remove (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: tb_remove (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Remove a given name from the tree-bitmap trie.
+ *
+ * Return:
+ *     1: name is not found (Not removed)
+ *     0: DONE! (removed)
+ * ------------------------------------------------------------------ */
+int
+tb_remove (struct tb_instance* tb, const char* name, bool print_flag)
+{
+    assert (tb);
+    assert (name);
+
+    if (tb_do_remove (tb, &(tb->root), name, strlen(name), 0))
+    {
+        if (print_flag)
+            fprintf (stderr, "[tb_remove] ERROR: Name lookup failed.\n");
+        return 1;
+    }
+    return 0;
+} /* -- end of tb_remove (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: tb_do_depth (..)
+ * Scope: Private
+ *
+ * Description:
+ * Visit a subtree, and sum the depth of its names.
+ * ------------------------------------------------------------------ */
+static void
+tb_do_depth (struct tb_node_t* node, int depth, int* max, long long* sum)
+{
+    int names = 0;
+    int num = tb_num_of_children (node);
+
+    for (int i=0; i<TB_WORDS; i++)
+        names += __builtin_popcountll (node->internal[i]);
+    if (names)
+    {
+        *sum += (long long)names * depth;
+        if (depth > *max)
+            *max = depth;
+    }
+    for (int i=0; i<num; i++)
+        tb_do_depth (node->children + i, depth + 1, max, sum);
+} /* -- end of tb_do_depth (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: tb_depth (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Maximum and average depth of names, in terms of visited nodes (the
+ * root is the first one).
+ * ------------------------------------------------------------------ */
+void
+tb_depth (struct tb_instance* tb, int* max, double* average)
+{
+    assert (tb);
+    long long sum = 0;
+
+    *max = 0;
+    tb_do_depth (&(tb->root), 1, max, &sum);
+    *average = tb->num_of_names ? (double)sum / tb->num_of_names : 0;
+} /* -- end of tb_depth (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: tb_do_free (..)
+ * Scope: Private
+ * ------------------------------------------------------------------ */
+static void
+tb_do_free (struct tb_node_t* node)
+{
+    int num = tb_num_of_children (node);
+
+    for (int i=0; i<num; i++)
+        tb_do_free (node->children + i);
+    free (node->children);
+} /* -- end of tb_do_free (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: tb_free (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Free all nodes of the trie. The trie is empty then.
+ * ------------------------------------------------------------------ */
+void
+tb_free (struct tb_instance* tb)
+{
+    assert (tb);
+
+    tb_do_free (&(tb->root));
+    memset (tb, 0, sizeof(struct tb_instance));
+} /* -- end of tb_free (..) -- */
@@ -20,18 +20,22 @@
  */
 
 #include "db_debug_struct.h"
+#include "ep_epoch.h"
 #ifndef BT_TRIE_H
 #define BT_TRIE_H
 
 #ifndef SLASH
 #define SLASH 0x2F
 #endif
-#ifndef EON
-#define EON 0x01  // -- end of each name -- //
-#endif
 #ifndef MAX_HEIGHT
 #define MAX_HEIGHT 100
 #endif
+#ifndef BT_PREFIX_BYTES
+#define BT_PREFIX_BYTES 8   // -- bytes of content kept in a node in optimistic mode -- //
+#endif
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
 #define ANSI_COLOR_RED     "\x1b[31m"
 #define ANSI_COLOR_GREEN   "\x1b[32m"
 #define ANSI_COLOR_YELLOW  "\x1b[33m"
@@ -49,50 +53,105 @@ typedef int bool;
  *
  *    [NODE] --> bytestream | len
  *    |
- *    hash_table (children) --> buckets | size
+ *    children (adaptive node) --> kind | used
  *    |
- *    bucket--> first_byte 
+ *    first_byte --> next_node
  *    |
  *    [Next_Node] ..
+ *
+ * Children are kept in the smallest kind which holds them:
+ *    Node4, Node16:  sorted first bytes, a child per byte
+ *    Node48:         index of 256 bytes (slot + 1) into 48 children
+ *    Node256:        a child per byte, indexed directly
  * --------------------------------------------------------- */
-struct ht_t {
-    struct bucket_t* buckets;   // -- buckets of the hash table -- //
-    int size;
-    int used;  // -- number of used buckets -- //
+#define AN_NODE4   0
+#define AN_NODE16  1
+#define AN_NODE48  2
+#define AN_NODE256 3
+#ifndef AN_NUM_OF_KINDS
+#define AN_NUM_OF_KINDS 4
+#endif
+
+struct an_node_t {
+    unsigned char kind;    // -- AN_NODE4 .. AN_NODE256 -- //
+    unsigned short used;   // -- number of children -- //
+};
+
+struct an_node4_t {
+    struct an_node_t header;
+    unsigned char keys[4];   // -- a child stores only the first byte of the next node -- //
+    struct node_t* next_nodes[4];
 };
 
-struct bucket_t {
-    char first_byte;  // -- a child stores only the first byte of the next node -- //
-    struct node_t* next_node;
+struct an_node16_t {
+    struct an_node_t header;
+    unsigned char keys[16];
+    struct node_t* next_nodes[16];
 };
 
+struct an_node48_t {
+    struct an_node_t header;
+    unsigned char index[256];   // -- slot of each first byte plus one (ZERO: no child) -- //
+    struct node_t* next_nodes[48];
+};
+
+struct an_node256_t {
+    struct an_node_t header;
+    struct node_t* next_nodes[256];
+};
+
+/* ---------------------------------------------------------
+ * In optimistic mode (i.e. optimistic path compression) a
+ * node keeps just the first BT_PREFIX_BYTES of its content
+ * in prefix, and "bytes" is the whole name of an EON node
+ * (NULL otherwise). A lookup skips the bytes which are not
+ * kept, then verifies the name at the EON node, at once.
+ * --------------------------------------------------------- */
 struct node_t {
-    struct ht_t* hash_table;   // -- each node has a hash_table to store the children -- //
-    char* bytes;   // -- contet of the node -- // 
+    struct an_node_t* children;   // -- each node keeps its children in an adaptive node (NULL: leaf) -- //
+    char* bytes;   // -- contet of the node (optimistic mode: name of an EON node) -- // 
     int len;       // -- len of content -- //
+    bool EON_flag; // -- whether this node is the end of a name -- //
     struct node_t* parent;  
+    char prefix[BT_PREFIX_BYTES];   // -- first bytes of content (optimistic mode) -- //
+    unsigned long version;          // -- version word (concurrent mode, see ol_lock.h) -- //
 };
 
+/* ---------------------------------------------------------
+ * In concurrent mode many threads insert, look up and remove
+ * names at the same time (by optimistic lock coupling, see
+ * ol_lock.h). Every thread registers a record in the epoch
+ * domain of the instance, and calls the main functions in a
+ * read section (ep_enter .. ep_exit). Nodes, contents and
+ * children which are unlinked are retired to the domain, and
+ * a node returned by Bt_lookup is valid until ep_exit.
+ * Concurrent mode keeps the whole content in each node (i.e.
+ * it does not work with optimistic mode).
+ * --------------------------------------------------------- */
 struct Bt_instance {
     struct node_t root;
     struct t_stat* trie_stat;
-    struct node_t** visitedNodes;  // -- used by remove function -- //
-    int ht_init_size;              // -- initial size of hash table at each node -- //
+    struct node_t** visitedNodes;  // -- used by remove function (not in concurrent mode) -- //
+    bool optimistic;               // -- optimistic path compression (see node_t) -- //
+    bool concurrent;               // -- optimistic lock coupling (see above) -- //
+    struct ep_domain_t epoch;      // -- unlinked objects are retired here in concurrent mode -- //
 };
 
 /* -------------- main functions ---------------*/
-char* Bt_en_name (const char*, char** /*output*/);
 struct node_t* Bt_insert (struct Bt_instance*, const char*, bool);   // -- insert a name if it is not already there -- //
-struct node_t* Bt_do_insert (struct Bt_instance*, struct node_t*, const char* /*name*/, int/*byte_walker*/, bool);
-struct node_t* Bt_node_partition (struct Bt_instance*, struct bucket_t*, const char* /*name*/, char /*first_byte*/, int /*byte_walker*/, int /*node_byte_walker*/, bool);
+struct node_t* Bt_do_insert (struct Bt_instance*, struct node_t*, const char* /*name*/, int /*len*/, int/*byte_walker*/, bool);
+struct node_t* Bt_node_partition (struct Bt_instance*, struct node_t** /*child*/, const char* /*name*/, int /*len*/, int /*byte_walker*/, int /*node_byte_walker*/, bool);
 
+const char* Bt_node_content (struct Bt_instance*, struct node_t*, int /*depth*/);   // -- whole content of a node -- //
 struct node_t* Bt_lookup (struct Bt_instance*, const char*, bool /*printf_flag*/, bool /*exact_match*/, struct node_t** /*visitedChildren*/);   // -- lookup a given name -- //
 
 int Bt_remove (struct Bt_instance*, const char*, bool);   // -- remove a given name -- //
-struct node_t* Bt_node_merge (struct Bt_instance*, struct node_t* /*parent of node to remove*/);
+struct node_t* Bt_node_merge (struct Bt_instance*, struct node_t* /*node with one child*/);
 
 void Bt_free_node (struct node_t*);
 void Bt_do_free_node (struct node_t*);
+void Bt_release (struct Bt_instance*, void*);        // -- free, or retire in concurrent mode -- //
+void Bt_reclaim_node (void* /*instance*/, void* /*node*/);   // -- see ep_retire -- //
 #endif /* bt_TRIE_H */
 
 
@@ -0,0 +1,51 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ * 
+ * Description:
+ * Each node in character-level trie keeps its children in one of
+ * four adaptive node kinds (Node4, Node16, Node48 and Node256). A
+ * node grows to the next kind when it is full, and shrinks to the
+ * previous one when enough children are removed.
+ */
+
+#ifndef AN_ADAPTIVE_H
+#define AN_ADAPTIVE_H
+
+#include "Bt_trie.h"
+
+// -- a kind shrinks to the previous one when this many children are left (see an_remove) -- //
+#ifndef AN_NODE16_SHRINK
+#define AN_NODE16_SHRINK  3
+#endif
+#ifndef AN_NODE48_SHRINK
+#define AN_NODE48_SHRINK  12
+#endif
+#ifndef AN_NODE256_SHRINK
+#define AN_NODE256_SHRINK 37
+#endif
+
+struct node_t** an_lookup (struct Bt_instance*, struct node_t*, char /*first_byte*/, bool print_flag);   // -- place of the child -- //
+struct node_t** an_insert (struct Bt_instance*, struct node_t*, char /*first_byte*/, bool print_flag);   // -- grow if it is full -- //
+int an_remove (struct Bt_instance*, struct node_t*, char /*first_byte*/);    // -- shrink (or free) if it is sparse -- //
+struct node_t* an_next (struct an_node_t*, int* /*walker*/);   // -- children in the order of their first bytes -- //
+struct an_node_t* an_alloc (int /*kind*/);
+int an_size (int /*kind*/);    // -- bytes of a kind -- //
+
+#endif /* -- end of AN_ADAPTIVE_H -- */
@@ -30,7 +30,8 @@
 
 void db_dfs (struct Bt_instance*, bool);
 int db_do_dfs (struct Bt_instance*, struct node_t* /*next_node*/, struct node_t* /*parent node*/, int /*height*/, struct t_stat*, signed int/*p_id*/, bool);
-void db_print_node (struct node_t*);
-void db_print_node_to_file (struct node_t* /*next_node*/, struct node_t* /*parent_node*/, signed int /*next_node id*/, signed int /*parent id*/);
+void db_print_node (struct Bt_instance*, struct node_t*);
+void db_print_node_to_file (struct Bt_instance*, struct node_t* /*next_node*/, struct node_t* /*parent_node*/, signed int /*next_node id*/, signed int /*parent id*/);
+long long db_mem (struct Bt_instance*, struct node_t*);   // -- bytes of a node and its subtrees -- //
 
 #endif /* -- db_DEBUG_H -- */
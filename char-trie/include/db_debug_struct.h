@@ -33,6 +33,9 @@
 #ifndef PDF_FILE_PATH
 #define PDF_FILE_PATH "./dot/graph.pdf"
 #endif
+#ifndef AN_NUM_OF_KINDS
+#define AN_NUM_OF_KINDS 4   // -- see Bt_trie.h -- //
+#endif
 
 struct t_stat {
     int max;    // -- branch with max length -- //
@@ -41,7 +44,9 @@ struct t_stat {
     struct linkedList_t* node;
     signed int id;     // -- dot_node id (increase by one after visiting a node) -- //
     int* width;        // -- number of nodes at each level -- //
-    long long ht_size; //-- sum of hash table sizes--// 
+    int kinds[AN_NUM_OF_KINDS];   // -- number of adaptive nodes of each kind -- //
+    long long an_size;  // -- sum of adaptive node sizes (bytes) -- //
+    long long mem;      // -- bytes of nodes, their contents and children -- //
 };
 
 struct linkedList_t {
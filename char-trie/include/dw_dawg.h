@@ -0,0 +1,89 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ * 
+ * Description:
+ * Minimized (DAWG) form of the character-level trie. Names often share
+ * their suffixes (e.g. segment and version components, or `/index.html`),
+ * while the trie shares just their prefixes. A built trie is turned into a
+ * minimal acyclic automaton by merging the nodes whose subtrees are equal,
+ * and names are looked up on the automaton. The automaton is read-only.
+ */
+
+#ifndef DW_DAWG_H
+#define DW_DAWG_H
+
+#include "Bt_trie.h"
+
+#ifndef DW_LINEAR_EDGES
+#define DW_LINEAR_EDGES 16        // -- edges of a state are scanned up to this number, otherwise binary searched -- //
+#endif
+#ifndef DW_SPLIT_COMPONENTS
+#define DW_SPLIT_COMPONENTS 0     // -- split the contents of the nodes before each SLASH (see dw_minimize) -- //
+#endif
+#define DW_EON 1U                 // -- flag of a state, see dw_dawg_t -- //
+
+/* ---------------------------------------------------------
+ * An edge of the automaton, i.e. the content of a node of
+ * the trie: its first byte, and the whole content in the
+ * label bytes of the automaton.
+ * --------------------------------------------------------- */
+struct dw_edge_t {
+    unsigned int offset;    // -- of the label in label_bytes -- //
+    unsigned int target;    // -- state at the end of the edge -- //
+    unsigned short len;     // -- bytes of the label -- //
+    unsigned char first;    // -- first byte of the label -- //
+};
+
+/* ---------------------------------------------------------
+ * Two nodes of the trie are equivalent when they have the
+ * same EON flag, and the same edges (i.e. the same contents
+ * of their children, which lead to equivalent nodes). Each
+ * class of equivalent nodes is a state of the automaton:
+ *
+ *    states:       (first edge << 1) | EON flag, for each
+ *                  state, and the number of edges at the
+ *                  end, i.e. the edges of state s are
+ *                  states[s] >> 1 .. states[s + 1] >> 1
+ *    edges:        edges of the states, one after another,
+ *                  in the order of their first bytes
+ *    label_bytes:  labels of the edges, each one once
+ *
+ * States are numbered children first, so the root is the
+ * last one.
+ * --------------------------------------------------------- */
+struct dw_dawg_t {
+    unsigned int* states;
+    struct dw_edge_t* edges;
+    char* label_bytes;
+    unsigned int root;
+    int num_of_states;
+    int num_of_edges;
+    long long num_of_label_bytes;
+    int num_of_nodes;             // -- of the trie -- //
+    long long num_of_content_bytes;   // -- of the trie (but the root) -- //
+};
+
+struct dw_dawg_t* dw_minimize (struct Bt_instance*);   // -- automaton of a trie (no writer should modify it meanwhile) -- //
+bool dw_lookup (const struct dw_dawg_t*, const char*);   // -- whether a name is in the automaton -- //
+long long dw_size (const struct dw_dawg_t*);           // -- bytes of the automaton -- //
+long long dw_flat_size (const struct dw_dawg_t*);      // -- bytes of the trie in the same layout, i.e. not minimized -- //
+void dw_free (struct dw_dawg_t*);
+
+#endif /* -- end of DW_DAWG_H -- */
@@ -0,0 +1,93 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ * 
+ * Description:
+ * Succinct (LOUDS-encoded) snapshot of the character-level trie. A built
+ * trie is frozen into a few bit vectors and byte arrays, with no pointer,
+ * and names are looked up directly on the encoding by rank and select.
+ * The snapshot is read-only.
+ */
+
+#ifndef LO_LOUDS_H
+#define LO_LOUDS_H
+
+#include "Bt_trie.h"
+
+#define LO_WORD_BITS 64
+#ifndef LO_BLOCK_WORDS
+#define LO_BLOCK_WORDS 8          // -- words of a block of the rank directory (i.e. 512 bits) -- //
+#endif
+#define LO_BLOCK_BITS (LO_BLOCK_WORDS * LO_WORD_BITS)
+#ifndef LO_SELECT_SAMPLE
+#define LO_SELECT_SAMPLE 512      // -- a select hint is kept for every this many ones (or zeros) -- //
+#endif
+#ifndef LO_LINEAR_LABELS
+#define LO_LINEAR_LABELS 16       // -- labels of a node are scanned up to this number, otherwise binary searched -- //
+#endif
+#define LO_HINTS_0 1              // -- the bit vector supports select0 -- //
+#define LO_HINTS_1 2              // -- the bit vector supports select1 -- //
+
+/* ---------------------------------------------------------
+ * A bit vector with a rank directory (ones before each
+ * block) and select hints (the block of every
+ * LO_SELECT_SAMPLE-th one or zero). A vector which is just
+ * read bit by bit has no directory.
+ * --------------------------------------------------------- */
+struct lo_bits_t {
+    unsigned long long* words;
+    long long num_of_bits;
+    unsigned int* ranks;      // -- ones before each block (and after the last one) -- //
+    unsigned int* hints0;     // -- block of every LO_SELECT_SAMPLE-th zero -- //
+    unsigned int* hints1;     // -- block of every LO_SELECT_SAMPLE-th one -- //
+    long long num_of_blocks;
+};
+
+/* ---------------------------------------------------------
+ * Snapshot of a trie. Nodes are numbered in BFS order (the
+ * root is ZERO), so the children of a node are numbered one
+ * after another, in the order of their first bytes:
+ *
+ *    louds:   1^(number of children) 0, for each node
+ *    labels:  first byte of each node (but the root)
+ *    tails:   0^(len - 1) 1, for each node (but the root),
+ *             i.e. where the content after the first byte
+ *             of each node ends in tail_bytes
+ *    eon:     EON flag of each node
+ *
+ * Children of node v start after the v-th zero of louds
+ * (select0), and the child at a given bit of louds is the
+ * number of ones up to that bit (rank1).
+ * --------------------------------------------------------- */
+struct lo_trie_t {
+    struct lo_bits_t louds;
+    struct lo_bits_t tails;
+    struct lo_bits_t eon;
+    unsigned char* labels;
+    char* tail_bytes;
+    int num_of_nodes;
+    long long num_of_tail_bytes;
+};
+
+struct lo_trie_t* lo_freeze (struct Bt_instance*);    // -- snapshot of a trie (no writer should modify it meanwhile) -- //
+bool lo_lookup (const struct lo_trie_t*, const char*);   // -- whether a name is in the snapshot -- //
+long long lo_size (const struct lo_trie_t*);           // -- bytes of the snapshot -- //
+void lo_free (struct lo_trie_t*);
+
+#endif /* -- end of LO_LOUDS_H -- */
@@ -30,9 +30,46 @@
 #ifndef MAX_NAME_LEN
 #define MAX_NAME_LEN 10000
 #endif
+// -- match microbenchmark (see bench_match) -- //
+#define MT_BENCH_LENS {4, 8, 16, 32, 64, 128, 256}
+#define MT_BENCH_MAX_LEN 256
+#define MT_BENCH_ALIGNS 64            // -- buffers start at different offsets -- //
+#define MT_BENCH_BYTES (1LL << 27)    // -- bytes matched per length and kernel -- //
+#define MT_CHECK_ALIGNS 16            // -- alignments of the buffers in check_match -- //
+// -- concurrent mixed workload (see bench_mixed) -- //
+#ifndef MW_DURATION_MS
+#define MW_DURATION_MS 250                     // -- duration of each run -- //
+#endif
+#define MW_THREADS {1, 2, 4, 8, 16, 32, 64}    // -- number of threads of the runs -- //
+#define MW_WRITES {0, 10, 50, 100}             // -- percent of updates (the rest are lookups) -- //
+#define MW_BATCH 64                            // -- operations between two checks of the stop flag -- //
+// -- succinct snapshot (see bench_louds) -- //
+#define LO_BENCH_ROUNDS 5                      // -- lookups of all names per measurement -- //
+// -- minimized automaton (see bench_dawg) -- //
+#define DW_BENCH_ROUNDS 5                      // -- lookups of all names per measurement -- //
+
+struct mw_arg_t {
+    struct Bt_instance* Bt;
+    char** names;
+    int num_of_names;
+    char* present;          // -- whether each name is in the trie (written by its owner only) -- //
+    int id;                 // -- a thread updates the names i where i % num_of_threads == id -- //
+    int num_of_threads;
+    int writes;             // -- percent of updates -- //
+    long long ops;          // -- number of lookups and updates -- //
+    long long errors;       // -- updates which did not match present -- //
+    volatile int* stop;     // -- set when the run is over -- //
+};
 
 void print_inst (char*);     // -- program help -- //
 void print_summary (struct Bt_instance*, double, double, double, bool, bool);   // -- summary of program after running -- //
 void warmup (struct Bt_instance*, bool, bool, bool);                            // -- a group of test cases -- //
+int check_match (void);                                                         // -- wrong results of the match kernels -- //
+void bench_match (void);                                                        // -- ns per matched byte of each match kernel -- //
+long long mw_elapsed_ns (const struct timespec*);
+void* mw_worker (void*);
+void bench_mixed (struct Bt_instance*, char**, int);                           // -- scaling of concurrent lookups and updates -- //
+void bench_louds (struct Bt_instance*, char**, int);                           // -- size and lookups of a snapshot vs. the live trie -- //
+void bench_dawg (struct Bt_instance*, char**, int);                            // -- states, size and lookups of the minimized trie vs. the live trie -- //
 void free_Bt (struct Bt_instance*);
 #endif /* MAIN_H */
@@ -0,0 +1,63 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ * 
+ * Description:
+ * Matching the content of a node against a name, many bytes at a
+ * time. The kernel (AVX2, SSE2 or scalar) is selected at runtime, once
+ * before main.
+ */
+
+#ifndef MT_MATCH_H
+#define MT_MATCH_H
+
+#ifndef MT_SHORT_LEN
+#define MT_SHORT_LEN 16
+#endif
+
+int mt_match_scalar (const char*, const char*, int);
+int mt_match_sse2 (const char*, const char*, int);
+int mt_match_avx2 (const char*, const char*, int);      // -- call only if mt_has_avx2 () -- //
+int mt_has_avx2 (void);
+const char* mt_kernel_name (void);                       // -- name of the selected kernel -- //
+
+extern int (*mt_kernel) (const char*, const char*, int);   // -- the selected kernel -- //
+
+/* ---------------------------------------------------------
+ * Method: mt_match (..)
+ *
+ * Description:
+ * Number of leading bytes of two buffers (of at least len
+ * bytes) which are equal, i.e. the offset of their first
+ * mismatch, or len. Contents shorter than MT_SHORT_LEN are
+ * matched in place, since a kernel call costs more there.
+ * --------------------------------------------------------- */
+static inline int
+mt_match (const char* a, const char* b, int len)
+{
+    int i = 0;
+
+    if (len >= MT_SHORT_LEN)
+        return mt_kernel (a, b, len);
+    while (i < len && a[i] == b[i])
+        i++;
+    return i;
+}
+
+#endif /* -- end of MT_MATCH_H -- */
@@ -0,0 +1,175 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ * 
+ * Description:
+ * Optimistic lock coupling. In concurrent mode each node of the
+ * character-level trie has a version word. Readers (and writers on
+ * their way down) do not lock anything: they read the version of a
+ * node, read the node, then validate that the version has not been
+ * changed meanwhile (otherwise they restart from the root). Writers
+ * lock only the nodes which they modify, from top to bottom.
+ */
+
+#ifndef OL_LOCK_H
+#define OL_LOCK_H
+
+#include <sched.h>
+#include "Bt_trie.h"
+
+/* ---------------------------------------------------------
+ * Version word of a node:
+ *
+ *    [ counter | LOCKED | OBSOLETE ]
+ *
+ * A writer sets LOCKED (by CAS) before it modifies a node,
+ * and adds LOCKED once more when it is done, i.e. the lock
+ * is released and the counter is increased at once. A node
+ * which is unlinked from the trie is marked as OBSOLETE, so
+ * a thread which has reached it restarts.
+ * --------------------------------------------------------- */
+#define OL_OBSOLETE 1UL
+#define OL_LOCKED   2UL
+#ifndef OL_SPINS
+#define OL_SPINS 64   // -- spins before a waiting thread yields the CPU -- //
+#endif
+
+/* ---------------------------------------------------------
+ * Method: ol_pause (..)
+ *
+ * Description:
+ * Wait a little for a locked node. The CPU is given up after
+ * OL_SPINS tries (e.g. the owner of the lock is preempted).
+ * --------------------------------------------------------- */
+static inline void
+ol_pause (int* spins)
+{
+    if (++(*spins) < OL_SPINS)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause ();
+#endif
+        return;
+    }
+    *spins = 0;
+    sched_yield ();
+}
+
+/* ---------------------------------------------------------
+ * Method: ol_read_lock (..)
+ *
+ * Description:
+ * Read the version of a node before reading the node. It
+ * waits while the node is locked.
+ *
+ * RETURN:
+ *     1:   RESTART (the node is obsolete)
+ *     0:   the version is set
+ * --------------------------------------------------------- */
+static inline int
+ol_read_lock (struct node_t* node, unsigned long* version)
+{
+    int spins = 0;
+    while ((*version = __atomic_load_n (&node->version, __ATOMIC_ACQUIRE)) & OL_LOCKED)
+        ol_pause (&spins);
+    return (*version & OL_OBSOLETE) != 0;
+}
+
+/* ---------------------------------------------------------
+ * Method: ol_check (..)
+ *
+ * Description:
+ * Validate what has been read from a node since its version
+ * was read (the reads are not moved after the check).
+ *
+ * RETURN:
+ *     1:   RESTART (the node has been changed)
+ *     0:   valid
+ * --------------------------------------------------------- */
+static inline int
+ol_check (struct node_t* node, unsigned long version)
+{
+    __atomic_thread_fence (__ATOMIC_ACQUIRE);
+    return __atomic_load_n (&node->version, __ATOMIC_RELAXED) != version;
+}
+
+/* ---------------------------------------------------------
+ * Method: ol_upgrade (..)
+ *
+ * Description:
+ * Lock a node which has been read, if it has not been
+ * changed since its version was read.
+ *
+ * RETURN:
+ *     1:   RESTART (the node has been changed)
+ *     0:   locked
+ * --------------------------------------------------------- */
+static inline int
+ol_upgrade (struct node_t* node, unsigned long version)
+{
+    return !__atomic_compare_exchange_n (&node->version, &version, version + OL_LOCKED, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+/* ---------------------------------------------------------
+ * Method: ol_write_lock (..)
+ *
+ * Description:
+ * Lock a node, waiting for the current owner if any. It is
+ * used for a child of a locked node, which cannot become
+ * obsolete meanwhile (see Bt_node_merge).
+ * --------------------------------------------------------- */
+static inline void
+ol_write_lock (struct node_t* node)
+{
+    unsigned long version;
+    int spins = 0;
+    while (1)
+    {
+        version = __atomic_load_n (&node->version, __ATOMIC_RELAXED);
+        if (!(version & OL_LOCKED) && !ol_upgrade (node, version))
+            return;
+        ol_pause (&spins);
+    }
+}
+
+/* ---------------------------------------------------------
+ * Method: ol_write_unlock (..)
+ *
+ * Description:
+ * Unlock a node, and publish the changes.
+ * --------------------------------------------------------- */
+static inline void
+ol_write_unlock (struct node_t* node)
+{
+    __atomic_fetch_add (&node->version, OL_LOCKED, __ATOMIC_RELEASE);
+}
+
+/* ---------------------------------------------------------
+ * Method: ol_write_unlock_obsolete (..)
+ *
+ * Description:
+ * Unlock a node which has been unlinked from the trie.
+ * --------------------------------------------------------- */
+static inline void
+ol_write_unlock_obsolete (struct node_t* node)
+{
+    __atomic_fetch_add (&node->version, OL_LOCKED | OL_OBSOLETE, __ATOMIC_RELEASE);
+}
+
+#endif /* -- end of OL_LOCK_H -- */
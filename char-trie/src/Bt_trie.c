@@ -26,25 +26,309 @@
 
 #include "Bt_trie.h"
 #include "db_debug.h"
-#include "ht_hashtable.h"
+#include "an_adaptive.h"
+#include "mt_match.h"
+#include "ol_lock.h"
+#include "ep_epoch.h"
 
 /* -----------------------------------------------------------------
- * Method: Bt_en_name (..)
+ * Method: Bt_leaf_name (..)
+ * Scope: Private
+ *
+ * Description:
+ * In optimistic mode, the name of an EON node at (or under) a given
+ * node. All names under a node share its content.
+ * ------------------------------------------------------------------ */
+static const char*
+Bt_leaf_name (struct node_t* node)
+{
+    int walker;
+    while (!node->EON_flag)
+    {
+        walker = 0;
+        node = an_next (node->children, &walker);
+    }
+    return node->bytes;
+} /* -- end of Bt_leaf_name (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: Bt_node_content (..)
  * Scope: Protected
  *
  * Description:
- * Add EON at end of each name.
+ * The whole content of a node, which starts at a given byte (depth)
+ * of the names under it. In optimistic mode, a content longer than
+ * BT_PREFIX_BYTES is not stored in the node, so it is taken from the
+ * name of an EON node under it.
  * ------------------------------------------------------------------ */
-char*
-Bt_en_name (const char* name, char** en_name)
+const char*
+Bt_node_content (struct Bt_instance* Bt, struct node_t* node, int depth)
 {
-    assert (name);
-    *en_name = realloc(*en_name, strlen(name) + 2);
-    memcpy (*en_name, name, strlen(name));
-    *(*en_name + strlen(name)) = (char)EON;
-    *(*en_name + strlen(name) + 1) = '\0';
-    return *en_name; 
-} /* -- end of Bt_en_name(..) -- */
+    if (!Bt->optimistic)
+        return node->bytes;
+    if (node->len <= BT_PREFIX_BYTES)
+        return node->prefix;
+    return Bt_leaf_name (node) + depth;
+} /* -- end of Bt_node_content (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: Bt_olc_insert (..)
+ * Scope: Private
+ *
+ * Description:
+ * Insert a name in concurrent mode (see ol_lock.h). The path is read
+ * optimistically, then just the node which gets a new child (or the
+ * EON flag), or the node to partition and its parent, are locked.
+ * The result is stored in ret.
+ *
+ * RETURN:
+ *     1:   RESTART
+ *     0:   DONE
+ * ------------------------------------------------------------------ */
+static int
+Bt_olc_insert (struct Bt_instance* Bt, const char* name, int len, bool print_flag, struct node_t** ret)
+{
+    int byte_walker = 1;           // -- index of the name (after SLASH) -- //
+    int matched;                   // -- bytes matched by mt_match -- //
+    struct node_t* node = &(Bt->root);
+    struct node_t* next_node;
+    struct node_t** child;
+    unsigned long version;         // -- version of node -- //
+    unsigned long next_version;    // -- version of next_node -- //
+    const char* bytes;
+    int next_len;
+    bool EON_flag;
+
+    if (ol_read_lock (node, &version))
+        return 1;
+    while (byte_walker < len)
+    {
+        child = an_lookup (Bt, node, name[byte_walker], print_flag);
+        next_node = child ? *child : 0;
+        if (ol_check (node, version))
+            return 1;
+        if (!next_node)
+        {
+            // -- none of the children match, so lock the node and INSERT it -- //
+            if (ol_upgrade (node, version))
+                return 1;
+            *ret = Bt_do_insert (Bt, node, name, len, byte_walker, print_flag);
+            ol_write_unlock (node);
+            return 0;
+        }
+        // -- the content is matched after its length and place are validated -- //
+        if (ol_read_lock (next_node, &next_version) || ol_check (node, version))
+            return 1;   // -- coupling: node is still the parent of next_node -- //
+        bytes = next_node->bytes;
+        next_len = next_node->len;
+        if (ol_check (next_node, next_version))
+            return 1;
+        matched = mt_match (bytes + 1, name + byte_walker + 1, MIN(next_len, len - byte_walker) - 1);
+        if (ol_check (next_node, next_version))
+            return 1;
+        if (1 + matched < next_len)
+        {
+            // -- partition: lock the parent (its child is replaced) and the node -- //
+            if (ol_upgrade (node, version))
+                return 1;
+            if (ol_upgrade (next_node, next_version))
+            {
+                ol_write_unlock (node);
+                return 1;
+            }
+            *ret = Bt_node_partition (Bt, child, name, len, byte_walker + 1 + matched, 1 + matched, print_flag);
+            ol_write_unlock (next_node);
+            ol_write_unlock (node);
+            return 0;
+        }
+        byte_walker += next_len;
+        node = next_node;
+        version = next_version;
+    }
+
+    // -- the name ends at the end of an existing node -- //
+    EON_flag = node->EON_flag;
+    if (ol_check (node, version))
+        return 1;
+    if (EON_flag)
+    {
+        // -- name is found -- //
+        if (print_flag)
+            printf ("Name is found:  %s\n", name);
+        *ret = 0;
+        return 0;
+    }
+    if (ol_upgrade (node, version))
+        return 1;
+    node->EON_flag = true;
+    ol_write_unlock (node);
+    *ret = node;
+    return 0;
+} /* -- end of Bt_olc_insert (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: Bt_olc_lookup (..)
+ * Scope: Private
+ *
+ * Description:
+ * Lookup a name in concurrent mode without any lock. The result (or
+ * NULL) is stored in ret.
+ *
+ * RETURN:
+ *     1:   RESTART
+ *     0:   DONE
+ * ------------------------------------------------------------------ */
+static int
+Bt_olc_lookup (struct Bt_instance* Bt, const char* name, int len, bool print_flag, struct node_t** ret)
+{
+    int byte_walker = 1;           // -- index of the name (after SLASH) -- //
+    struct node_t* node = &(Bt->root);
+    struct node_t* next_node;
+    struct node_t** child;
+    unsigned long version;         // -- version of node -- //
+    unsigned long next_version;    // -- version of next_node -- //
+    const char* bytes;
+    int next_len;
+    bool EON_flag;
+
+    *ret = 0;
+    if (ol_read_lock (node, &version))
+        return 1;
+    while (byte_walker < len)
+    {
+        child = an_lookup (Bt, node, name[byte_walker], print_flag);
+        next_node = child ? *child : 0;
+        if (ol_check (node, version))
+            return 1;
+        if (!next_node)
+            return 0;
+        if (ol_read_lock (next_node, &next_version) || ol_check (node, version))
+            return 1;   // -- coupling: node is still the parent of next_node -- //
+        bytes = next_node->bytes;
+        next_len = next_node->len;
+        if (ol_check (next_node, next_version))
+            return 1;
+        if (byte_walker + next_len > len || mt_match (bytes + 1, name + byte_walker + 1, next_len - 1) < next_len - 1)
+        {
+            // -- the name has been ended (or mismatched) at the middle of the node -- //
+            return ol_check (next_node, next_version);
+        }
+        byte_walker += next_len;
+        node = next_node;
+        version = next_version;
+    }
+    EON_flag = node->EON_flag;
+    if (ol_check (node, version))
+        return 1;
+    if (EON_flag)
+        *ret = node;
+    return 0;
+} /* -- end of Bt_olc_lookup (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: Bt_olc_remove (..)
+ * Scope: Private
+ *
+ * Description:
+ * Remove a name in concurrent mode. The path is read optimistically
+ * (the last two nodes are kept instead of visitedNodes), then the
+ * node of the name is locked, and its parent too if it is a leaf.
+ * Merging locks the only child which is merged (see Bt_node_merge).
+ * The result (see Bt_remove) is stored in ret.
+ *
+ * RETURN:
+ *     1:   RESTART
+ *     0:   DONE
+ * ------------------------------------------------------------------ */
+static int
+Bt_olc_remove (struct Bt_instance* Bt, const char* name, int len, bool print_flag, int* ret)
+{
+    int byte_walker = 1;           // -- index of the name (after SLASH) -- //
+    struct node_t* node = &(Bt->root);
+    struct node_t* parent = 0;
+    struct node_t* next_node;
+    struct node_t** child;
+    unsigned long version;         // -- version of node -- //
+    unsigned long parent_version = 0;
+    unsigned long next_version;    // -- version of next_node -- //
+    const char* bytes;
+    int next_len;
+    bool EON_flag;
+    bool leaf;
+
+    *ret = 1;
+    if (ol_read_lock (node, &version))
+        return 1;
+    while (byte_walker < len)
+    {
+        child = an_lookup (Bt, node, name[byte_walker], print_flag);
+        next_node = child ? *child : 0;
+        if (ol_check (node, version))
+            return 1;
+        if (!next_node)
+            return 0;
+        if (ol_read_lock (next_node, &next_version) || ol_check (node, version))
+            return 1;   // -- coupling: node is still the parent of next_node -- //
+        bytes = next_node->bytes;
+        next_len = next_node->len;
+        if (ol_check (next_node, next_version))
+            return 1;
+        if (byte_walker + next_len > len || mt_match (bytes + 1, name + byte_walker + 1, next_len - 1) < next_len - 1)
+            return ol_check (next_node, next_version);
+        byte_walker += next_len;
+        parent = node;
+        parent_version = version;
+        node = next_node;
+        version = next_version;
+    }
+    EON_flag = node->EON_flag;
+    leaf = !node->children;
+    if (ol_check (node, version))
+        return 1;
+    if (!EON_flag)
+        return 0;   // -- the name is just a prefix of other names -- //
+
+    /**
+     * Cases (see Bt_remove):
+     *     1- node has children  -> lock it, set EON to OFF (and merge)
+     *     2- node is a leaf     -> lock the parent and the node, remove
+     *                              the node (and merge the parent)
+     */
+    if (!leaf)
+    {
+        if (ol_upgrade (node, version))
+            return 1;
+        node->EON_flag = false;
+        if (node->children->used == 1)
+            Bt_node_merge (Bt, node);
+        ol_write_unlock (node);
+        *ret = 0;
+        return 0;
+    }
+    if (ol_upgrade (parent, parent_version))
+        return 1;
+    if (ol_upgrade (node, version))
+    {
+        ol_write_unlock (parent);
+        return 1;
+    }
+    if (an_remove (Bt, parent, node->bytes[0]))
+    {
+        fprintf (stderr, "[Bt_olc_remove] ERROR: An error has been occured while name removal.\n");
+        ol_write_unlock (node);
+        ol_write_unlock (parent);
+        *ret = 2;
+        return 0;
+    }
+    ol_write_unlock_obsolete (node);
+    ep_retire (&Bt->epoch, node, Bt_reclaim_node);
+    // -- for root we do not merge anything -- //
+    if (parent != &Bt->root && !parent->EON_flag && parent->children && parent->children->used == 1)
+        Bt_node_merge (Bt, parent);
+    ol_write_unlock (parent);
+    *ret = 0;
+    return 0;
+} /* -- end of Bt_olc_remove (..) -- */
 
 /* -----------------------------------------------------------------
  * Method: Bt_insert (..)
@@ -56,6 +340,9 @@ Bt_en_name (const char* name, char** en_name)
  * Otherwise, we inset the name (except the LPM) and finally
  * the leaf will be returned.  
  *
+ * The end of a name is not stored as a byte, but as the EON flag
+ * of the node where the name ends.
+ *
  * RETURN:
  *     0:   ERROR | Duplicate
  *     OTW: DONE
@@ -66,13 +353,15 @@ Bt_insert (struct Bt_instance* Bt, const char* name, bool print_flag)
     assert (Bt);
     assert (name);
 
+    int len = strlen(name);        // -- length of the name -- //
     int byte_walker = 0;           // -- index of the name -- //
     int node_byte_walker = 0;      // -- index of the working node's content -- //
+    int matched;                   // -- bytes matched by mt_match -- //
     struct node_t* node;           // -- node traverser -- // 
-    struct bucket_t* child = NULL; // -- child traverser -- //
-    char first_byte;               // -- change it when the working node changes -- //
+    struct node_t** child = NULL;  // -- child traverser -- //
+    int spins = 0;                 // -- restarts (concurrent mode) -- //
 
-    if (strlen(name) < 2)
+    if (len < 2)
     {
         // -- a name with length of ONE? -- //
         fprintf (stderr, "[trie_insert] ERROR: A name with len of ONE or ZERO.\n");
@@ -87,77 +376,51 @@ Bt_insert (struct Bt_instance* Bt, const char* name, bool print_flag)
         return 0;
     }
     byte_walker = 1;   // -- Assuming all names start with SLASH "/" -- //
-    
-    // -- Look up the name. If mismatch occured, insert remaining bytes one-by-one -- //
-    if (!(child = ht_lookup(Bt, node, name[byte_walker], print_flag)))
+    if (Bt->concurrent)
     {
-        // -- none of the children start with this byte -- //
-        return (Bt_do_insert (Bt, node, name, byte_walker, print_flag));
-    } 
+        // -- restart from the root until it is done -- //
+        while (Bt_olc_insert (Bt, name, len, print_flag, &node))
+            ol_pause (&spins);
+        return node;
+    }
 
-    while (byte_walker < strlen(name))
+    while (byte_walker < len)
     {
         // -- Look up the name. If mismatch occured, insert remaining bytes one-by-one -- //
-        if (!(child = ht_lookup(Bt, node, name[byte_walker], print_flag)))
+        if (!(child = an_lookup(Bt, node, name[byte_walker], print_flag)))
         {
             // -- none of the children match, so INSERT it -- //
-            return (Bt_do_insert (Bt, node, name, byte_walker, print_flag));
+            return (Bt_do_insert (Bt, node, name, len, byte_walker, print_flag));
         } 
         // -- child is set, now set the node -- //
-        node = child->next_node;
-        first_byte = (char)name[byte_walker];
-        if (!node)
-        {
-            fprintf (stderr, "[Bt_insert] ERROR: A null next_node.\n");
-            return 0;
-        }
-        // -- match the node content -- //
-        while (node_byte_walker < node->len && byte_walker < strlen(name))
-        {
-            if (node->bytes[node_byte_walker] == name[byte_walker])
-            {
-                byte_walker++;
-                node_byte_walker++;
-                continue;
-            }
-            if (!node_byte_walker)
-            {
-                // -- The previous child specified the first byte and now it does no match -- //
-                fprintf (stderr, "[Bt_insert] ERROR: The first byte of the node does match.\n");
-                return 0;
-            }
-            // -- search the children of this node for remaining bytes -- //
-            break;
-        } // -- end of content match -- //
-        if (byte_walker == strlen(name))
-        {
-            if (node_byte_walker == node->len)
-            {
-                // -- name is found -- //
-                if (print_flag)
-                    printf ("Name is found:  %s\n", name);
-                return 0;
-            }
-            else
-            {
-                // -- the name has been ended at the middle of the current node, so partition the node -- //
-                return (Bt_node_partition (Bt, child, name, first_byte, byte_walker, node_byte_walker, print_flag));
-            }
-        }
-        if (node_byte_walker == node->len)
-        {
-            // -- continue searching among the children of this node -- //
-            node_byte_walker = 0;
-            continue;
-        }
-        else
+        node = *child;
+        // -- match the node content (the first byte is matched by the child) -- //
+        matched = mt_match (Bt_node_content (Bt, node, byte_walker) + 1, name + byte_walker + 1, MIN(node->len, len - byte_walker) - 1);
+        node_byte_walker = 1 + matched;
+        byte_walker += 1 + matched;
+        if (node_byte_walker < node->len)
         {
-            // -- the name has been ended at the middle of the current node, so partition the node -- //
-            return (Bt_node_partition (Bt, child, name, first_byte, byte_walker, node_byte_walker, print_flag));
+            // -- the name has been ended (or mismatched) at the middle of the current node, so partition the node -- //
+            return (Bt_node_partition (Bt, child, name, len, byte_walker, node_byte_walker, print_flag));
         }
+        // -- continue searching among the children of this node -- //
     } // -- end of while loop -- //
-    fprintf (stderr, "[Bt_insert] WARNINIG: Unreachable part is acccessed.\n");
-    return 0;  
+
+    if (node->EON_flag)
+    {
+        // -- name is found -- //
+        if (print_flag)
+            printf ("Name is found:  %s\n", name);
+        return 0;
+    }
+    // -- the name ends at the end of an existing node -- //
+    node->EON_flag = true;
+    if (Bt->optimistic)
+    {
+        node->bytes = (char*)malloc(len + 1);
+        memcpy (node->bytes, name, len + 1);
+    }
+    return node;
 } /* -- end of Bt_insert(..) -- */
 
 
@@ -167,44 +430,50 @@ Bt_insert (struct Bt_instance* Bt, const char* name, bool print_flag)
  *
  * Description:
  * Insert the remaining components of a name (after doing LPM) in the
- * Byte-level trie (EON has been already added to the name).
+ * Byte-level trie, as a new EON leaf.
  * ------------------------------------------------------------------ */
 struct node_t*
-Bt_do_insert (struct Bt_instance* Bt, struct node_t* node, const char* name, int byte_walker, bool print_flag)
+Bt_do_insert (struct Bt_instance* Bt, struct node_t* node, const char* name, int len, int byte_walker, bool print_flag)
 {
     assert (Bt);
-    struct bucket_t* child;
-    // -- check whether we should be here or not -- //
-    if ((child=ht_lookup(Bt, node, name[byte_walker], print_flag)))
-    {
-        fprintf (stderr, "[Bt_do_insert] ERROR: The child is occupied.\n");
-        return 0;
-    }
+    struct node_t** child;
     
-    // -- create a new record in the ht and use the corresponded node to insert the remaining bytes -- // 
-    if (!(child=ht_insert(Bt, node, name[byte_walker], print_flag)))
+    // -- create a new child and use the corresponded node to insert the remaining bytes -- // 
+    if (!(child=an_insert(Bt, node, name[byte_walker], print_flag)))
     {
-        fprintf (stderr, "[Bt_do_insert] ERROR: HT insertion has been failed.\n");
+        fprintf (stderr, "[Bt_do_insert] ERROR: Child insertion has been failed.\n");
         return 0;
     }
     // -- use this child to insert the bytes -- //
-    child->next_node = (struct node_t*)malloc(sizeof(struct node_t));
-    child->next_node->len = strlen(name)-byte_walker;
-    child->next_node->bytes = (char*)malloc(child->next_node->len + 1);
-    child->next_node->parent = node;
-    // -- do not initialize the ht, until we need it -- // 
-    child->next_node->hash_table = 0;
+    *child = (struct node_t*)malloc(sizeof(struct node_t));
+    (*child)->len = len - byte_walker;
+    (*child)->EON_flag = true;
+    (*child)->parent = node;
+    (*child)->version = 0;
+    // -- do not initialize the children, until we need them -- // 
+    (*child)->children = 0;
  
-    // -- copy the remaining bytes -- //
-    memcpy(child->next_node->bytes, name + byte_walker, child->next_node->len);  
-    child->next_node->bytes[child->next_node->len] = '\0';
+    if (Bt->optimistic)
+    {
+        // -- keep the first bytes in the node, and the whole name once -- //
+        memcpy((*child)->prefix, name + byte_walker, MIN((*child)->len, BT_PREFIX_BYTES));
+        (*child)->bytes = (char*)malloc(len + 1);
+        memcpy((*child)->bytes, name, len + 1);
+    }
+    else
+    {
+        // -- copy the remaining bytes -- //
+        (*child)->bytes = (char*)malloc((*child)->len + 1);
+        memcpy((*child)->bytes, name + byte_walker, (*child)->len);  
+        (*child)->bytes[(*child)->len] = '\0';
+    }
  
     if (print_flag)
     {
         printf ("Inserted node:  ");
-        db_print_node (child->next_node);    
+        db_print_node (Bt, *child);    
     }
-    return child->next_node;
+    return *child;
 } /* -- end of Bt_do_insert (..) -- */
 
 /* -----------------------------------------------------------------
@@ -212,20 +481,24 @@ Bt_do_insert (struct Bt_instance* Bt, struct node_t* node, const char* name, int
  * Scope: Protected
  *
  * Description:
- * Lookup a given name.
+ * Lookup a given name. In exact_match mode the visited nodes (except
+ * the root) are stored in visitedNodes, followed by a NULL.
  * ------------------------------------------------------------------ */
 struct node_t* Bt_lookup (struct Bt_instance* Bt, const char* name, bool print_flag, bool exact_match, struct node_t** visitedNodes)
 {
     assert (Bt);
     assert (name);
 
+    int len = strlen(name);        // -- length of the name -- //
     int byte_walker = 0;           // -- index of the name -- //
     int node_byte_walker = 0;      // -- index of the working node's content -- //
+    int matched;                   // -- bytes matched by mt_match -- //
     struct node_t* node;           // -- node traverser -- // 
-    struct bucket_t* child = 0;    // -- child traverser -- //
+    struct node_t** child = 0;     // -- child traverser -- //
     int visited_walker = 0;        // -- index of visitedNodes -- //
+    int spins = 0;                 // -- restarts (concurrent mode) -- //
 
-    if (strlen(name) < 2)
+    if (len < 2)
     {
         // -- a name with length of ONE? -- //
         fprintf (stderr, "[Bt_lookup] ERROR: A name with len of ONE or ZERO.\n");
@@ -240,80 +513,75 @@ struct node_t* Bt_lookup (struct Bt_instance* Bt, const char* name, bool print_f
         return 0;
     }
     byte_walker = 1;   // -- Assuming all names start with SLASH "/" -- //
-    
-    // -- Look up the name. If mismatch occured, lookup fails -- //
-    if (!(child = ht_lookup(Bt, node, name[byte_walker], print_flag)))
+    if (Bt->concurrent)
     {
-        // -- none of the children start with this byte -- //
-        return 0;
-    } 
-
-    while (byte_walker < strlen(name))
+        if (exact_match)
+        {
+            fprintf (stderr, "[Bt_lookup] ERROR: Exact matching is not supported in concurrent mode.\n");
+            return 0;
+        }
+        while (Bt_olc_lookup (Bt, name, len, print_flag, &node))
+            ol_pause (&spins);
+        return node;
+    }
+    
+    while (byte_walker < len)
     {
-        // -- Look up the name. If mismatch occured, insert remaining bytes one-by-one -- //
-        if (!(child = ht_lookup(Bt, node, name[byte_walker], print_flag)))
+        // -- Look up the name. If mismatch occured, lookup fails -- //
+        if (!(child = an_lookup(Bt, node, name[byte_walker], print_flag)))
         {
-            // -- none of the children match, so INSERT it -- //
+            // -- none of the children match -- //
             return 0;
         } 
         // -- child is set, now set the node -- //
-        node = child->next_node;
-        if (!node)
-        {
-            fprintf (stderr, "[Bt_lookup] ERROR: A null next_node.\n");
-            return 0;
-        }
+        node = *child;
         if (exact_match)
         {
             // -- this array does not store root as a visited node -- //
+            if (visited_walker >= MAX_HEIGHT - 1)
+            {
+                fprintf (stderr, "[Bt_lookup] ERROR: MAX_HEIGHT is reached.\n");
+                return 0;
+            }
             visitedNodes[visited_walker] = node;
             visited_walker++;
         }
-        // -- match the node content -- //
-        while (node_byte_walker < node->len && byte_walker < strlen(name))
+        if (Bt->optimistic)
         {
-            if (node->bytes[node_byte_walker] == name[byte_walker])
-            {
-                byte_walker++;
-                node_byte_walker++;
-                continue;
-            }
-            if (!node_byte_walker)
-            {
-                // -- The previous child specified the first byte and now it does no match -- //
-                fprintf (stderr, "[Bt_lookup] ERROR: The first byte of the node did not match.\n");
+            // -- match the stored bytes only, and skip the rest (the name is verified at the end) -- //
+            if (byte_walker + node->len > len)
                 return 0;
-            }
-            // -- search the children of this node for remaining bytes -- //
-            break;
-        } // -- end of content match -- //
-        if (byte_walker == strlen(name))
-        {
-            if (node_byte_walker == node->len)
-            {
-                // -- name is found -- //
-                return node;
-            }
-            else
-            {
-                // -- the name has been ended at the middle of the current node, lookup failed -- //
+            matched = mt_match (node->prefix + 1, name + byte_walker + 1, MIN(node->len, BT_PREFIX_BYTES) - 1);
+            if (matched < MIN(node->len, BT_PREFIX_BYTES) - 1)
                 return 0;
-            }
-        }
-        if (node_byte_walker == node->len)
-        {
-            // -- continue searching among the children of this node -- //
-            node_byte_walker = 0;
+            byte_walker += node->len;
             continue;
         }
-        else
+        // -- match the node content (the first byte is matched by the child) -- //
+        matched = mt_match (node->bytes + 1, name + byte_walker + 1, MIN(node->len, len - byte_walker) - 1);
+        node_byte_walker = 1 + matched;
+        byte_walker += 1 + matched;
+        if (node_byte_walker < node->len)
         {
-            // -- the name has been ended at the middle of the current node, so partition the node -- //
+            // -- the name has been ended (or mismatched) at the middle of the current node, lookup failed -- //
             return 0;
         }
+        // -- continue searching among the children of this node -- //
     } // -- end of while loop -- //
-    fprintf (stderr, "[Bt_lookup] WARNINIG: Unreachable part is acccessed.\n");
-    return 0;  
+
+    if (!node->EON_flag)
+    {
+        // -- the name is just a prefix of other names -- //
+        return 0;
+    }
+    if (Bt->optimistic && memcmp (node->bytes, name, len))
+    {
+        // -- some skipped bytes did not match -- //
+        return 0;
+    }
+    if (exact_match)
+        visitedNodes[visited_walker] = 0;
+    return node;
 } /* -- end of Bt_lookup (..) -- */
 
 /* -----------------------------------------------------------------
@@ -324,16 +592,16 @@ struct node_t* Bt_lookup (struct Bt_instance* Bt, const char* name, bool print_f
  * Partition a name from a given point, so that its bytes will 
  * splitted into two parts (i.e. parent and first_child). Then the 
  * second part of splited node (i.e. first_child) and the remaining 
- * bytes of the name should be added to the parent, as children.
+ * bytes of the name (if any) should be added to the parent, as children.
  * ------------------------------------------------------------------ */
 struct node_t*
-Bt_node_partition (struct Bt_instance* Bt, struct bucket_t* child, const char* name, char first_byte, int byte_walker, int node_byte_walker, bool print_flag)
+Bt_node_partition (struct Bt_instance* Bt, struct node_t** child, const char* name, int len, int byte_walker, int node_byte_walker, bool print_flag)
 {
     assert (Bt);
     struct node_t* parent;
     struct node_t* first_node;
-    struct node_t* second_node;
-    struct bucket_t* in_ret;    // -- stores the returned value by insertion -- //
+    struct node_t** in_ret;     // -- stores the returned value by insertion -- //
+    const char* content;        // -- whole content of the node to partition -- //
     if (!node_byte_walker)
     {
         fprintf (stderr, "[Bt_node_partition] ERROR: node_byte_walker == 0.\n");
@@ -344,83 +612,76 @@ Bt_node_partition (struct Bt_instance* Bt, struct bucket_t* child, const char* n
     /**
      * Node partitioning:
      *    1- find the last matched byte 
-     *    2- we keep the previous node (with all children)
+     *    2- we keep the previous node (with all children) as the first node,
+     *       without the matched bytes
      *    3- a new node is created instead of the previous node
      *    4- this new node has two children:
      *        a) remaining bytes of the previous node 
-     *        b) the rest of input name
+     *        b) the rest of input name (if the name does not end here)
      */ 
-    // -- the current child should point to a new node, so store the "next_node" pointer of the current child -- //
-    struct node_t* next_node_tmp = (struct node_t*)malloc(sizeof(struct node_t));
-    *next_node_tmp = *(child->next_node);
-    free(child->next_node);
-    // -- partition the corresponded node into parent and first_node -- //
-    child->next_node = (struct node_t*)malloc(sizeof(struct node_t));
-
-    parent = child->next_node;  // -- agent is set -- //
-    parent->parent = next_node_tmp->parent;
-    parent->hash_table = 0;     // -- hash table will be initialized by ht_insert -- //
-    parent->len = node_byte_walker;
-    parent->bytes = (char*)malloc(parent->len + 1);
-    memcpy (parent->bytes, next_node_tmp->bytes, parent->len);
-    parent->bytes[parent->len] = '\0';
-    // -- parent has received its content, now we add its two children -- //
-
-    if (next_node_tmp->bytes[node_byte_walker] == name[byte_walker])
+    first_node = *child;
+    content = Bt_node_content (Bt, first_node, byte_walker - node_byte_walker);
+    if (byte_walker < len && content[node_byte_walker] == name[byte_walker])
     {
         // -- so why are we here!!? -- //
-        fprintf (stderr, "[Bt_node_merge] ERROR: Node merging has been failed.\n");
+        fprintf (stderr, "[Bt_node_partition] ERROR: Node partitioning has been failed.\n");
         return 0;
     }
 
-    // -- first node -- //
-    if (!(in_ret=ht_insert(Bt, parent, next_node_tmp->bytes[node_byte_walker], print_flag)))
+    // -- partition the corresponded node into parent and first_node -- //
+    parent = (struct node_t*)malloc(sizeof(struct node_t));
+    parent->parent = first_node->parent;
+    parent->children = 0;       // -- children will be initialized by an_insert -- //
+    parent->len = node_byte_walker;
+    parent->EON_flag = (byte_walker == len);
+    parent->version = 0;   // -- reachable by a locked node only, until the partition is done -- //
+    if (Bt->optimistic)
     {
-        fprintf (stderr, "[Bt_do_insert] ERROR: HT insertion has been failed.\n");
-        return 0;
+        memcpy (parent->prefix, content, MIN(parent->len, BT_PREFIX_BYTES));
+        parent->bytes = 0;
+        if (parent->EON_flag)
+        {
+            parent->bytes = (char*)malloc(len + 1);
+            memcpy (parent->bytes, name, len + 1);
+        }
     }
-    // -- use the return child to insert the bytes -- //
-    in_ret->next_node = (struct node_t*)malloc(sizeof(struct node_t));
-    first_node = in_ret->next_node;   // -- agent is set -- //
-    first_node->parent = parent;
-    first_node->len = next_node_tmp->len - node_byte_walker;
-    first_node->bytes = (char*)malloc(first_node->len + 1);
-    memcpy(first_node->bytes, next_node_tmp->bytes + node_byte_walker, first_node->len);
-    first_node->bytes[first_node->len] = '\0';
-    first_node->hash_table = next_node_tmp->hash_table;
-    // -- first node is DONE -- //
+    else
+    {
+        parent->bytes = (char*)malloc(parent->len + 1);
+        memcpy (parent->bytes, content, parent->len);
+        parent->bytes[parent->len] = '\0';
+    }
+    *child = parent;  // -- agent is set -- //
+    // -- parent has received its content, now we add its children -- //
 
-    // -- second node -- //
-    if (!(in_ret=ht_insert(Bt, parent, name[byte_walker], print_flag)))
+    // -- first node (keeps its children, EON flag and name) -- //
+    if (!(in_ret=an_insert(Bt, parent, content[node_byte_walker], print_flag)))
     {
-        fprintf (stderr, "[Bt_do_insert] ERROR: HT insertion has been failed.\n");
+        fprintf (stderr, "[Bt_node_partition] ERROR: Child insertion has been failed.\n");
         return 0;
     }
-    // -- use the return child to insert the bytes -- //
-    in_ret->next_node = (struct node_t*)malloc(sizeof(struct node_t));
-    second_node = in_ret->next_node;   // -- agent is set -- //
-    second_node->parent = parent;
-    second_node->len = strlen(name) - byte_walker;
-    second_node->bytes = (char*)malloc(second_node->len + 1);
-    memcpy(second_node->bytes, name + byte_walker, second_node->len);
-    second_node->bytes[second_node->len] = '\0';
-    second_node->hash_table = 0;
-    // -- second node is DONE -- // 
-
-    free(next_node_tmp->bytes);
-    next_node_tmp->len = 0;
-    next_node_tmp->parent = 0;
-    next_node_tmp->hash_table = 0;  // -- do not touch the children -- //
-    free(next_node_tmp);
+    first_node->len -= node_byte_walker;
+    if (Bt->optimistic)
+        memmove (first_node->prefix, content + node_byte_walker, MIN(first_node->len, BT_PREFIX_BYTES));
+    else
+        memmove (first_node->bytes, first_node->bytes + node_byte_walker, first_node->len + 1);
+    first_node->parent = parent;
+    *in_ret = first_node;
+    // -- first node is DONE -- //
 
-    if (print_flag)
+    if (parent->EON_flag)
     {
-        printf ("Inserted node: ");
-        db_print_node (second_node);
+        // -- the name ends at the parent -- //
+        if (print_flag)
+        {
+            printf ("Inserted node: ");
+            db_print_node (Bt, parent);
+        }
+        return parent;
     }
-    // -- second child is done -- //
+    // -- second node -- //
     // -- Partiotioning is DONE! END of insertion -- //
-    return second_node; 
+    return (Bt_do_insert (Bt, parent, name, len, byte_walker, print_flag));
 } /* -- end of trie_node_partition(..) -- */
 
 /* -----------------------------------------------------------------
@@ -430,21 +691,17 @@ Bt_node_partition (struct Bt_instance* Bt, struct bucket_t* child, const char* n
  * Description:
  * Remove a given name from the trie. To remove a name, we have to make
  * sure that the whole name exists. After finding the name, JUST the last
- * node will be removed. After removing the last node, maybe merging the 
- * parent and remaining node is necessary.
+ * node will be removed (or its EON flag will be turned OFF). After that,
+ * maybe merging the parent and remaining node is necessary.
  *
  * It is important to mention that there cannot be any node with one 
- * child, except the root. So, we have to merge some nodes if it is 
- * necessary.
+ * child, except the root or an EON node. So, we have to merge some nodes
+ * if it is necessary.
  *
  * Return:
  *     1: name is not found (Not removed)
  *     2: ERROR (Not remove)
  *     0: DONE! (removed)
- *
- * NOTE:
- *     Removing first child -> should be done from the node.
- *     Removing other children -> should be done by the previous child.
  * ------------------------------------------------------------------ */
 int
 Bt_remove (struct Bt_instance* Bt, const char* name, bool print_flag)
@@ -454,12 +711,20 @@ Bt_remove (struct Bt_instance* Bt, const char* name, bool print_flag)
    
     int visited_walker = 0;  // -- index of visitedNodes array -- //
     struct node_t* node;     // -- working node -- //
+    struct node_t* parent;   // -- parent of the working node -- //
     char first_byte;
-    struct bucket_t* lo_ret; // -- return value of ht_lookup -- //
+    int len = strlen(name);
+    int ret;                 // -- result in concurrent mode -- //
+    int spins = 0;           // -- restarts (concurrent mode) -- //
  
-    for (int i=0; i<MAX_HEIGHT; i++)
-        Bt->visitedNodes[i] = 0;
-
+    if (Bt->concurrent)
+    {
+        if (len < 2 || name[0] != (char)SLASH)
+            return 1;
+        while (Bt_olc_remove (Bt, name, len, print_flag, &ret))
+            ol_pause (&spins);
+        return ret;
+    }
     // -- start exact name lookup -- //
     if (!Bt_lookup (Bt, name, 0, 1, Bt->visitedNodes))
     {
@@ -481,107 +746,45 @@ Bt_remove (struct Bt_instance* Bt, const char* name, bool print_flag)
  
     // -- jumpt to the last visited child  -- //
     visited_walker-- ;
-    if (visited_walker < 0)
-    {
-        // -- something is wrong -- //
-        fprintf (stderr, "[Bt_remove] ERROR: An error has been occured while removing.\n");
-        return 2;
-    }
+    node = Bt->visitedNodes[visited_walker];
+    parent = (visited_walker > 0) ? Bt->visitedNodes[visited_walker-1] : &Bt->root;
 
-    if (Bt->visitedNodes[visited_walker]->hash_table != 0) 
+    /**
+     * Cases:
+     *     1- node has two or more children -> Set EON to OFF
+     *     2- node has one child            -> Merge (EON of the child is kept)
+     *     3- node is a leaf                -> Remove it, then
+     *        a) parent is the root or EON  -> Do nothing
+     *        b) parent has one child left  -> Merge
+     */
+    if (node->children)
     {
-        // -- exact lookup ended up with a non-leaf node -- //
-        fprintf (stderr, "[Bt_remove] ERROR: Exact lookup has been ended up with a non-leaf node.\n");
-        return 2;
-    }
-   
-
-    if (visited_walker == 0)
-    {       
-        // -- there is just one node (regardless of the root) to remove -- //
-        node = &Bt->root;
-        if (node->hash_table->used == 1)
+        node->EON_flag = false;
+        if (Bt->optimistic)
         {
-            // -- the last visited node is the last child of its parent, so just remove it -- //
-            first_byte = Bt->visitedNodes[visited_walker]->bytes[0];
-            Bt_free_node (Bt->visitedNodes[visited_walker]);
-            if (!(lo_ret=ht_lookup(Bt, &Bt->root, first_byte, print_flag)))
-            {
-                fprintf (stderr, "[Bt_remove] ERROR: An error has been occured while name removal.\n");
-                return 1;
-            }    
-            free(lo_ret->next_node);
-            lo_ret->next_node = 0;
-            lo_ret->first_byte = 0;
-            free(node->hash_table->buckets);
-            node->hash_table->size = 0;
-            node->hash_table->used = 0;
-            free(node->hash_table);
-            node->hash_table=0;
-        } 
-
-        else  // -- for root we do not merge anything -- //
-        {
-            // -- remove the corresponded node and bucket -- //
-            first_byte = Bt->visitedNodes[visited_walker]->bytes[0];
-            Bt_free_node (Bt->visitedNodes[visited_walker]);
-            if (!(lo_ret=ht_lookup(Bt, &Bt->root, first_byte, print_flag)))
-            {
-                fprintf (stderr, "[Bt_remove] ERROR: An error has been occured while name removal.\n");
-                return 1;
-            }    
-            free(lo_ret->next_node);
-            lo_ret->next_node = 0;
-            lo_ret->first_byte = 0;
-            node->hash_table->used--;
+            // -- the name is not kept here anymore -- //
+            free(node->bytes);
+            node->bytes = 0;
         }
+        if (node->children->used == 1)
+            Bt_node_merge (Bt, node);
         return 0;
     }
 
-    // -- the last node is not a root's leaf -- //
-    if (visited_walker > 0)
+    first_byte = Bt->optimistic ? node->prefix[0] : node->bytes[0];
+    Bt_free_node (node);
+    free(node);
+    if (an_remove(Bt, parent, first_byte))
     {
-        node = Bt->visitedNodes[visited_walker-1];
-        if (node->hash_table->used == 1)
-        {
-            // -- an intermediate node with just one node is not normal -- //
-            fprintf (stderr, "[Bt_remove] WARNING: An intermediate node with one child.\n"); 
-            return 1;
-        }
-        if (node->hash_table->used == 2)
-        { 
-            first_byte = Bt->visitedNodes[visited_walker]->bytes[0];
-            Bt_free_node (Bt->visitedNodes[visited_walker]);
-            if (!(lo_ret=ht_lookup(Bt, Bt->visitedNodes[visited_walker-1], first_byte, print_flag)))
-            {
-                fprintf (stderr, "[Bt_remove] ERROR: An error has been occured while name removal.\n");
-                return 1;
-            }    
-            free(lo_ret->next_node);
-            lo_ret->next_node = 0;
-            lo_ret->first_byte = 0;
-            node->hash_table->used--;
-
-            // -- now merge -- //
-            Bt_node_merge (Bt, node);
-            return 0;
-        }
-        else
-        {
-            first_byte = Bt->visitedNodes[visited_walker]->bytes[0];
-            Bt_free_node (Bt->visitedNodes[visited_walker]);
-            if (!(lo_ret=ht_lookup(Bt, Bt->visitedNodes[visited_walker-1], first_byte, print_flag)))
-            {
-                fprintf (stderr, "[Bt_remove] ERROR: An error has been occured while name removal.\n");
-                return 1;
-            }    
-            free(lo_ret->next_node);
-            lo_ret->next_node = 0;
-            lo_ret->first_byte = 0;
-            node->hash_table->used--;
-        }
+        fprintf (stderr, "[Bt_remove] ERROR: An error has been occured while name removal.\n");
+        return 2;
+    }    
+    // -- for root we do not merge anything -- //
+    if (parent != &Bt->root && !parent->EON_flag && parent->children && parent->children->used == 1)
+    { 
+        // -- now merge -- //
+        Bt_node_merge (Bt, parent);
     }
-    // -- unreachable part -- // 
     return 0;
 } /* -- end of Bt_remove(..) -- */
 
@@ -590,76 +793,85 @@ Bt_remove (struct Bt_instance* Bt, const char* name, bool print_flag)
  * Scope: Protected
  *
  * Description:
- * Merge a node with one of its leaves.
+ * Merge a node with its only child. The merged node takes the
+ * children and the EON flag of the child.
+ *
+ * In concurrent mode the node is locked by the caller, so the child
+ * cannot become obsolete until it is locked here. Readers may still
+ * read the old content and children, so they are released (i.e.
+ * retired) instead of being reallocated.
  * ------------------------------------------------------------------ */
 struct node_t*
 Bt_node_merge (struct Bt_instance* Bt, struct node_t* parent)
 {
     assert (Bt);
-    if (!parent || !parent->hash_table || !parent->hash_table->size || !parent->hash_table->used)
+    if (!parent || !parent->children || !parent->children->used)
     {
         fprintf (stderr, "[Bt_node_merge] ERROR: An error has been occured while merging.\n");
         return 0;
     }
 
-    int used = 0;
-    struct node_t* node_tmp = (struct node_t*)malloc(sizeof(struct node_t)); 
-    char* parent_byte;
-    int parent_len;
-    // -- check whether this node is elgible for merging, then copy the node to remove -- //
-    for (int i=0; i<parent->hash_table->size; i++)
-    {
-        if (parent->hash_table->buckets[i].first_byte != 0)
-        {
-            used++; 
-            // -- copy the node to remove -- // 
-            *node_tmp = *parent->hash_table->buckets[i].next_node;
-            free(parent->hash_table->buckets[i].next_node);
-        }
-    }
-    if (used > 1)
+    int walker = 0;
+    struct node_t* node_tmp;   // -- the child to merge -- //
+    struct node_t* next_node;
+    char* bytes;
+    // -- check whether this node is elgible for merging -- //
+    if (parent->children->used > 1)
     {
         // -- this node has more than one child -- //
         fprintf (stderr, "[Bt_node_merge] ERROR: Trying to merge a node with more than one child.\n");
         return 0;
     }
-    free(parent->hash_table->buckets);
-    parent->hash_table->buckets = 0;
-    parent->hash_table->size = 0;
-    parent->hash_table->used = 0;
-    free(parent->hash_table);
-    parent->hash_table = 0;
-
-    // -- copy the parent -- //
-    parent_byte = (char*)malloc(parent->len);
-    memcpy (parent_byte, parent->bytes, parent->len);
-    parent_len = parent->len;
-    // -- realloc parent bytes -- //
-    parent->len = parent->len + node_tmp->len;
-    parent->bytes = realloc(parent->bytes, parent->len + 1);
-    memcpy(parent->bytes, parent_byte, parent_len);
-    memcpy(parent->bytes + parent_len, node_tmp->bytes, node_tmp->len);
-    parent->bytes[parent->len] = '\0';
+    node_tmp = an_next (parent->children, &walker);
+    if (Bt->concurrent)
+        ol_write_lock (node_tmp);
+    Bt_release (Bt, parent->children);
+    parent->children = 0;
+
+    if (Bt->optimistic)
+    {
+        // -- fill the stored bytes, and take the name of the child (if any) -- //
+        if (parent->len < BT_PREFIX_BYTES)
+            memcpy(parent->prefix + parent->len, node_tmp->prefix, MIN(node_tmp->len, BT_PREFIX_BYTES - parent->len));
+        parent->len = parent->len + node_tmp->len;
+        free(parent->bytes);
+        parent->bytes = node_tmp->bytes;
+        node_tmp->bytes = 0;
+    }
+    else if (Bt->concurrent)
+    {
+        bytes = (char*)malloc(parent->len + node_tmp->len + 1);
+        memcpy(bytes, parent->bytes, parent->len);
+        memcpy(bytes + parent->len, node_tmp->bytes, node_tmp->len);
+        Bt_release (Bt, parent->bytes);
+        parent->bytes = bytes;
+        parent->len = parent->len + node_tmp->len;
+        parent->bytes[parent->len] = '\0';
+    }
+    else
+    {
+        // -- realloc parent bytes -- //
+        parent->bytes = realloc(parent->bytes, parent->len + node_tmp->len + 1);
+        memcpy(parent->bytes + parent->len, node_tmp->bytes, node_tmp->len);
+        parent->len = parent->len + node_tmp->len;
+        parent->bytes[parent->len] = '\0';
+    }
     // -- parent received its content -- //
-    parent->hash_table = node_tmp->hash_table;   
+    parent->children = node_tmp->children;   
+    parent->EON_flag = node_tmp->EON_flag;
     // -- change parent of children of node_tmp -- //
-    if (node_tmp->hash_table != 0 && 
-        node_tmp->hash_table->size != 0 && 
-        node_tmp->hash_table->used != 0)
+    walker = 0;
+    while ((next_node = an_next (node_tmp->children, &walker)))
+        next_node->parent = parent;
+    // -- free -- //
+    if (Bt->concurrent)
     {
-        for (int i=0; i < node_tmp->hash_table->size; i++)
-        {
-            if (node_tmp->hash_table->buckets[i].first_byte)
-                node_tmp->hash_table->buckets[i].next_node->parent = parent;
-        }   
+        ol_write_unlock_obsolete (node_tmp);
+        ep_retire (&Bt->epoch, node_tmp, Bt_reclaim_node);
+        return parent;
     }
-    // -- free -- //
     free(node_tmp->bytes);
-    node_tmp->bytes = 0;
-    node_tmp->len = 0;
-    node_tmp->parent = 0;
     free(node_tmp);
-    free(parent_byte);
     // -- do not touch parent's children -- //
     return parent;
 } /* -- end of Bt_node_merge(..) -- */
@@ -675,23 +887,19 @@ void
 Bt_free_node (struct node_t* node)
 {
     assert (node);
-    if (!node->hash_table)
+    int walker = 0;
+    struct node_t* next_node;
+
+    if (!node->children)
     {
         Bt_do_free_node (node);
         return;
     }
-    for (int i=0; i<node->hash_table->size; i++)
+    while ((next_node = an_next (node->children, &walker)))
     {
-        if (!node->hash_table->buckets[i].first_byte)
-            continue;
-        Bt_free_node(node->hash_table->buckets[i].next_node);
-        node->hash_table->buckets[i].first_byte = 0;
-        free(node->hash_table->buckets[i].next_node);
-        node->hash_table->buckets[i].next_node = 0;
-    }
-    free(node->hash_table->buckets);
-    node->hash_table->size=0;
-    node->hash_table->used=0;
+        Bt_free_node (next_node);
+        free(next_node);
+    }
     Bt_do_free_node (node);
     return;    
 } /* -- end of trie_free_node (..) -- */
@@ -711,11 +919,60 @@ Bt_do_free_node (struct node_t* node)
         fprintf (stderr, "[Bt_do_free_node] ERROR: A null node to free.\n");
         return;
     }
-    free(node->hash_table); 
-    node->hash_table = 0;
+    free(node->children); 
+    node->children = 0;
     free(node->bytes);
     node->bytes = 0;
     node->len = 0;
     node->parent = 0;
     return;
 } /* -- end of Bt_do_free_node (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: Bt_reclaim (..)
+ * Scope: Private
+ *
+ * Description:
+ * Free a retired object (see ep_retire).
+ * ------------------------------------------------------------------ */
+static void
+Bt_reclaim (void* Bt, void* ptr)
+{
+    free(ptr);
+} /* -- end of Bt_reclaim (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: Bt_release (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Free an object which is unlinked from the trie (e.g. a content or
+ * children). In concurrent mode other threads may still read it, so
+ * it is retired instead.
+ * ------------------------------------------------------------------ */
+void
+Bt_release (struct Bt_instance* Bt, void* ptr)
+{
+    if (!ptr)
+        return;
+    if (Bt->concurrent)
+        ep_retire (&Bt->epoch, ptr, Bt_reclaim);
+    else
+        free(ptr);
+} /* -- end of Bt_release (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: Bt_reclaim_node (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Free a retired node and its content. Its children (if any) have
+ * been taken by another node (see Bt_node_merge).
+ * ------------------------------------------------------------------ */
+void
+Bt_reclaim_node (void* Bt, void* ptr)
+{
+    struct node_t* node = (struct node_t*)ptr;
+    free(node->bytes);
+    free(node);
+} /* -- end of Bt_reclaim_node (..) -- */
@@ -0,0 +1,479 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "an_adaptive.h"
+#include "Bt_trie.h"
+
+/* ----------------------------------------------------------------
+ * Method: an_search (..)
+ * Scope: Private
+ *
+ * Description:
+ * Find the slot of a first byte among the keys of a Node4 or a
+ * Node16. All keys are compared at once, and the keys beyond the
+ * used ones are masked out.
+ *
+ * RETURN:
+ *     -1:  not found
+ *     OTW: slot of the key
+ * ---------------------------------------------------------------- */
+static inline int
+an_search (const unsigned char* keys, int used, int width, unsigned char first_byte)
+{
+#ifdef __SSE2__
+    __m128i key = _mm_set1_epi8((char)first_byte);
+    __m128i row;
+    int mask;
+
+    if (width == 16)
+        row = _mm_loadu_si128((const __m128i*)keys);
+    else
+    {
+        int four;
+        memcpy (&four, keys, sizeof(int));
+        row = _mm_cvtsi32_si128(four);
+    }
+    mask = _mm_movemask_epi8(_mm_cmpeq_epi8(row, key)) & ((1 << used) - 1);
+    return mask ? __builtin_ctz(mask) : -1;
+#else
+    for (int i=0; i<used; i++)
+    {
+        if (keys[i] == first_byte)
+            return i;
+    }
+    return -1;
+#endif
+} /* -- end of an_search (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: an_size (..)
+ * Scope: Global
+ *
+ * Description:
+ * Number of bytes of an adaptive node of a given kind.
+ * ---------------------------------------------------------------- */
+int
+an_size (int kind)
+{
+    switch (kind)
+    {
+        case AN_NODE4:
+            return sizeof(struct an_node4_t);
+        case AN_NODE16:
+            return sizeof(struct an_node16_t);
+        case AN_NODE48:
+            return sizeof(struct an_node48_t);
+        case AN_NODE256:
+            return sizeof(struct an_node256_t);
+    }
+    fprintf (stderr, "[an_size] ERROR: Unknown node kind %d.\n", kind);
+    return 0;
+} /* -- end of an_size (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: an_alloc (..)
+ * Scope: Global
+ *
+ * Description:
+ * Allocate an empty adaptive node of a given kind.
+ * ---------------------------------------------------------------- */
+struct an_node_t*
+an_alloc (int kind)
+{
+    struct an_node_t* an = (struct an_node_t*)calloc(1, an_size(kind));
+    if (!an)
+    {
+        fprintf (stderr, "[an_alloc] ERROR: Failed to allocate a node of kind %d.\n", kind);
+        return 0;
+    }
+    an->kind = kind;
+    an->used = 0;
+    return an;
+} /* -- end of an_alloc (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: an_lookup (..)
+ * Scope: Global
+ *
+ * Description:
+ * Lookup the children of a given node to find the child which starts
+ * with a given byte.
+ *
+ * RETURN:
+ *     0:   there is no such a child
+ *     OTW: place of the child (valid until the next insert or remove)
+ * ---------------------------------------------------------------- */
+struct node_t**
+an_lookup (struct Bt_instance* Bt, struct node_t* node, char first_byte, bool print_flag)
+{
+    assert (Bt);
+
+    struct an_node_t* an = node->children;
+    unsigned char key = (unsigned char)first_byte;
+    int slot;
+
+    if (!an)
+        return 0;
+    switch (an->kind)
+    {
+        case AN_NODE4:
+            slot = an_search (((struct an_node4_t*)an)->keys, an->used, 4, key);
+            return (slot < 0) ? 0 : &((struct an_node4_t*)an)->next_nodes[slot];
+        case AN_NODE16:
+            slot = an_search (((struct an_node16_t*)an)->keys, an->used, 16, key);
+            return (slot < 0) ? 0 : &((struct an_node16_t*)an)->next_nodes[slot];
+        case AN_NODE48:
+            slot = ((struct an_node48_t*)an)->index[key];
+            return (!slot) ? 0 : &((struct an_node48_t*)an)->next_nodes[slot - 1];
+        case AN_NODE256:
+            return (!((struct an_node256_t*)an)->next_nodes[key]) ? 0 : &((struct an_node256_t*)an)->next_nodes[key];
+    }
+    fprintf (stderr, "[an_lookup] ERROR: Unknown node kind %d.\n", an->kind);
+    return 0;
+} /* -- end of an_lookup (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: an_grow (..)
+ * Scope: Private
+ *
+ * Description:
+ * Move the children of a full node to a node of the next kind. The
+ * old node is released (see Bt_release), since in concurrent mode
+ * readers may still be reading it.
+ * ---------------------------------------------------------------- */
+static struct an_node_t*
+an_grow (struct Bt_instance* Bt, struct an_node_t* an)
+{
+    struct an_node_t* bigger = an_alloc (an->kind + 1);
+    if (!bigger)
+        return 0;
+
+    switch (an->kind)
+    {
+        case AN_NODE4:
+        {
+            struct an_node4_t* from = (struct an_node4_t*)an;
+            struct an_node16_t* to = (struct an_node16_t*)bigger;
+            memcpy (to->keys, from->keys, an->used);
+            memcpy (to->next_nodes, from->next_nodes, an->used * sizeof(struct node_t*));
+            break;
+        }
+        case AN_NODE16:
+        {
+            struct an_node16_t* from = (struct an_node16_t*)an;
+            struct an_node48_t* to = (struct an_node48_t*)bigger;
+            for (int i=0; i<an->used; i++)
+            {
+                to->index[from->keys[i]] = i + 1;
+                to->next_nodes[i] = from->next_nodes[i];
+            }
+            break;
+        }
+        case AN_NODE48:
+        {
+            struct an_node48_t* from = (struct an_node48_t*)an;
+            struct an_node256_t* to = (struct an_node256_t*)bigger;
+            for (int i=0; i<256; i++)
+            {
+                if (from->index[i])
+                    to->next_nodes[i] = from->next_nodes[from->index[i] - 1];
+            }
+            break;
+        }
+    }
+    bigger->used = an->used;
+    Bt_release (Bt, an);
+    return bigger;
+} /* -- end of an_grow (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: an_shrink (..)
+ * Scope: Private
+ *
+ * Description:
+ * Move the children of a sparse node to a node of the previous kind.
+ * The first bytes are visited in order, so Node4 and Node16 keep
+ * their keys sorted.
+ * ---------------------------------------------------------------- */
+static struct an_node_t*
+an_shrink (struct Bt_instance* Bt, struct an_node_t* an)
+{
+    struct an_node_t* smaller = an_alloc (an->kind - 1);
+    int slot = 0;
+    if (!smaller)
+        return 0;
+
+    switch (an->kind)
+    {
+        case AN_NODE16:
+        {
+            struct an_node16_t* from = (struct an_node16_t*)an;
+            struct an_node4_t* to = (struct an_node4_t*)smaller;
+            memcpy (to->keys, from->keys, an->used);
+            memcpy (to->next_nodes, from->next_nodes, an->used * sizeof(struct node_t*));
+            break;
+        }
+        case AN_NODE48:
+        {
+            struct an_node48_t* from = (struct an_node48_t*)an;
+            struct an_node16_t* to = (struct an_node16_t*)smaller;
+            for (int i=0; i<256; i++)
+            {
+                if (!from->index[i])
+                    continue;
+                to->keys[slot] = i;
+                to->next_nodes[slot] = from->next_nodes[from->index[i] - 1];
+                slot++;
+            }
+            break;
+        }
+        case AN_NODE256:
+        {
+            struct an_node256_t* from = (struct an_node256_t*)an;
+            struct an_node48_t* to = (struct an_node48_t*)smaller;
+            for (int i=0; i<256; i++)
+            {
+                if (!from->next_nodes[i])
+                    continue;
+                to->next_nodes[slot] = from->next_nodes[i];
+                slot++;
+                to->index[i] = slot;
+            }
+            break;
+        }
+    }
+    smaller->used = an->used;
+    Bt_release (Bt, an);
+    return smaller;
+} /* -- end of an_shrink (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: an_insert (..)
+ * Scope: Global
+ *
+ * Description:
+ * Insert a new first byte among the children of a node, and return
+ * the place of its (still NULL) child. The node grows to the next
+ * kind if it is full.
+ * ---------------------------------------------------------------- */
+struct node_t**
+an_insert (struct Bt_instance* Bt, struct node_t* node, char first_byte, bool print_flag)
+{
+    assert (Bt);
+
+    unsigned char key = (unsigned char)first_byte;
+    struct an_node_t* an;
+    int slot;
+
+    if (!key)
+    {
+        fprintf (stderr, "[an_insert] ERROR: A ZERO first byte.\n");
+        return 0;
+    }
+    if (!node->children && !(node->children = an_alloc(AN_NODE4)))
+        return 0;
+    if (an_lookup (Bt, node, first_byte, print_flag))
+    {
+        if (print_flag)
+            printf ("Trying to add duplicate key in the children.\n");
+        return 0;
+    }
+    an = node->children;
+    if ((an->kind == AN_NODE4 && an->used == 4) ||
+        (an->kind == AN_NODE16 && an->used == 16) ||
+        (an->kind == AN_NODE48 && an->used == 48))
+    {
+        if (!(an = an_grow (Bt, an)))
+            return 0;
+        node->children = an;
+    }
+
+    switch (an->kind)
+    {
+        case AN_NODE4:
+        case AN_NODE16:
+        {
+            // -- keep the keys sorted -- //
+            unsigned char* keys = (an->kind == AN_NODE4) ? ((struct an_node4_t*)an)->keys : ((struct an_node16_t*)an)->keys;
+            struct node_t** next_nodes = (an->kind == AN_NODE4) ? ((struct an_node4_t*)an)->next_nodes : ((struct an_node16_t*)an)->next_nodes;
+            for (slot = 0; slot < an->used && keys[slot] < key; slot++)
+                ;
+            memmove (keys + slot + 1, keys + slot, an->used - slot);
+            memmove (next_nodes + slot + 1, next_nodes + slot, (an->used - slot) * sizeof(struct node_t*));
+            keys[slot] = key;
+            next_nodes[slot] = 0;
+            an->used++;
+            return &next_nodes[slot];
+        }
+        case AN_NODE48:
+        {
+            // -- slots are kept dense by an_remove -- //
+            struct an_node48_t* an48 = (struct an_node48_t*)an;
+            slot = an->used;
+            an48->index[key] = slot + 1;
+            an48->next_nodes[slot] = 0;
+            an->used++;
+            return &an48->next_nodes[slot];
+        }
+        case AN_NODE256:
+            an->used++;
+            return &((struct an_node256_t*)an)->next_nodes[key];
+    }
+    fprintf (stderr, "[an_insert] ERROR: Unknown node kind %d.\n", an->kind);
+    return 0;
+} /* -- end of an_insert (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: an_remove (..)
+ * Scope: Global
+ *
+ * Description:
+ * Remove a first byte from the children of a node (the child itself
+ * is not touched). The node shrinks to the previous kind if it is
+ * sparse, and it is freed with its last child.
+ *
+ * RETURN:
+ *     1:   the first byte is not found
+ *     0:   DONE
+ * ---------------------------------------------------------------- */
+int
+an_remove (struct Bt_instance* Bt, struct node_t* node, char first_byte)
+{
+    assert (Bt);
+
+    struct an_node_t* an = node->children;
+    unsigned char key = (unsigned char)first_byte;
+    int slot;
+
+    if (!an)
+        return 1;
+    switch (an->kind)
+    {
+        case AN_NODE4:
+        case AN_NODE16:
+        {
+            unsigned char* keys = (an->kind == AN_NODE4) ? ((struct an_node4_t*)an)->keys : ((struct an_node16_t*)an)->keys;
+            struct node_t** next_nodes = (an->kind == AN_NODE4) ? ((struct an_node4_t*)an)->next_nodes : ((struct an_node16_t*)an)->next_nodes;
+            if ((slot = an_search (keys, an->used, (an->kind == AN_NODE4) ? 4 : 16, key)) < 0)
+                return 1;
+            memmove (keys + slot, keys + slot + 1, an->used - slot - 1);
+            memmove (next_nodes + slot, next_nodes + slot + 1, (an->used - slot - 1) * sizeof(struct node_t*));
+            break;
+        }
+        case AN_NODE48:
+        {
+            // -- move the last slot to the removed one -- //
+            struct an_node48_t* an48 = (struct an_node48_t*)an;
+            if (!(slot = an48->index[key]))
+                return 1;
+            an48->index[key] = 0;
+            slot--;
+            if (slot != an->used - 1)
+            {
+                an48->next_nodes[slot] = an48->next_nodes[an->used - 1];
+                for (int i=0; i<256; i++)
+                {
+                    if (an48->index[i] == an->used)
+                    {
+                        an48->index[i] = slot + 1;
+                        break;
+                    }
+                }
+            }
+            an48->next_nodes[an->used - 1] = 0;
+            break;
+        }
+        case AN_NODE256:
+            if (!((struct an_node256_t*)an)->next_nodes[key])
+                return 1;
+            ((struct an_node256_t*)an)->next_nodes[key] = 0;
+            break;
+        default:
+            fprintf (stderr, "[an_remove] ERROR: Unknown node kind %d.\n", an->kind);
+            return 1;
+    }
+    an->used--;
+
+    if (!an->used)
+    {
+        Bt_release (Bt, an);
+        node->children = 0;
+    }
+    else if ((an->kind == AN_NODE16 && an->used == AN_NODE16_SHRINK) ||
+             (an->kind == AN_NODE48 && an->used == AN_NODE48_SHRINK) ||
+             (an->kind == AN_NODE256 && an->used == AN_NODE256_SHRINK))
+    {
+        if ((an = an_shrink (Bt, an)))
+            node->children = an;
+    }
+    return 0;
+} /* -- end of an_remove (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: an_next (..)
+ * Scope: Global
+ *
+ * Description:
+ * Walk over the children of an adaptive node in the order of their
+ * first bytes. The walker should be ZERO at the beginning.
+ *
+ * RETURN:
+ *     0:   no more children
+ *     OTW: the next child
+ * ---------------------------------------------------------------- */
+struct node_t*
+an_next (struct an_node_t* an, int* walker)
+{
+    if (!an)
+        return 0;
+    switch (an->kind)
+    {
+        case AN_NODE4:
+            return (*walker < an->used) ? ((struct an_node4_t*)an)->next_nodes[(*walker)++] : 0;
+        case AN_NODE16:
+            return (*walker < an->used) ? ((struct an_node16_t*)an)->next_nodes[(*walker)++] : 0;
+        case AN_NODE48:
+            while (*walker < 256)
+            {
+                int slot = ((struct an_node48_t*)an)->index[(*walker)++];
+                if (slot)
+                    return ((struct an_node48_t*)an)->next_nodes[slot - 1];
+            }
+            return 0;
+        case AN_NODE256:
+            while (*walker < 256)
+            {
+                struct node_t* next_node = ((struct an_node256_t*)an)->next_nodes[(*walker)++];
+                if (next_node)
+                    return next_node;
+            }
+            return 0;
+    }
+    return 0;
+} /* -- end of an_next (..) -- */
@@ -32,8 +32,69 @@
 #include "Bt_trie.h"
 #include "db_debug.h"
 #include "db_debug_struct.h"
+#include "an_adaptive.h"
 
 
+/* -----------------------------------------------------------------------------------
+ * Method: db_fprint_content(..)
+ * Scope: private
+ * 
+ * Description:
+ * Print the content of a node. In optimistic mode, just the bytes which are kept
+ * in the node are printed (followed by ".." if there are more).
+ * ----------------------------------------------------------------------------------- */
+static void
+db_fprint_content (FILE* out, struct Bt_instance* Bt, struct node_t* node)
+{
+    const char* bytes = Bt->optimistic ? node->prefix : node->bytes;
+    int len = Bt->optimistic ? MIN(node->len, BT_PREFIX_BYTES) : node->len;
+
+    for (int i=0; i < len; i++)
+        fprintf (out, "%c", bytes[i]);
+    if (len < node->len)
+        fprintf (out, "..");
+    if (node->EON_flag)
+        fprintf (out, "<EON>");
+} /* -- end of db_fprint_content(..) -- */
+
+/* -----------------------------------------------------------------------------------
+ * Method: db_node_mem(..)
+ * Scope: private
+ * 
+ * Description:
+ * Bytes of a node, its content and its children (i.e. the adaptive node).
+ * ----------------------------------------------------------------------------------- */
+static long long
+db_node_mem (struct Bt_instance* Bt, struct node_t* node)
+{
+    long long mem = sizeof(struct node_t);
+    if (node->bytes)
+        mem += (Bt->optimistic ? strlen(node->bytes) : node->len) + 1;
+    if (node->children)
+        mem += an_size (node->children->kind);
+    return mem;
+} /* -- end of db_node_mem(..) -- */
+
+/* -----------------------------------------------------------------------------------
+ * Method: db_mem(..)
+ * Scope: private
+ * 
+ * Description:
+ * Bytes of a node and its subtrees, as in trie_stat->mem, without drawing the graph.
+ * ----------------------------------------------------------------------------------- */
+long long
+db_mem (struct Bt_instance* Bt, struct node_t* node)
+{
+    assert (Bt);
+    int walker = 0;
+    struct node_t* next_node;
+    long long mem = db_node_mem (Bt, node);
+
+    while ((next_node = an_next (node->children, &walker)))
+        mem += db_mem (Bt, next_node);
+    return mem;
+} /* -- end of db_mem(..) -- */
+
 /* -----------------------------------------------------------------------------------
  * Method: db_dfs(..)
  * Scope: private
@@ -49,10 +110,13 @@ db_dfs (struct Bt_instance* Bt, bool print_flag)
     Bt->trie_stat->sum = 0;
     Bt->trie_stat->num = 0;
     Bt->trie_stat->id = 0;
-    Bt->trie_stat->ht_size =0;
+    Bt->trie_stat->an_size = 0;
+    Bt->trie_stat->mem = 0;
+    for (int i=0; i<AN_NUM_OF_KINDS; i++)
+        Bt->trie_stat->kinds[i] = 0;
 
     // -- take the root and start -- //
-    if (Bt->root.hash_table == 0)
+    if (Bt->root.children == 0)
     {
         // -- the trie is empty -- //
         fprintf (stderr, "[db_dfs] WARNING: The trie is empty.\n");
@@ -116,6 +180,8 @@ db_do_dfs (struct Bt_instance* Bt, struct node_t* node, struct node_t* parent, i
     assert (Bt);
     assert (trie_stat);
     int id;
+    int walker = 0;
+    struct node_t* next_node;
     // -- claim your own id -- //
     trie_stat->id++;
     id = trie_stat->id;
@@ -125,24 +191,12 @@ db_do_dfs (struct Bt_instance* Bt, struct node_t* node, struct node_t* parent, i
     // -- if there is ONLY root in the trie -- //
     if (p_id == -1)
     {
-        if (!node->hash_table)
+        if (!node->children)
         {
             fprintf (dot, "\t{\"<%u>", p_id);
-            for (int i=0; i < node->len; i++)
-            {
-                if (node->bytes[i] == (char)EON)
-                    fprintf (dot, "<EON>");
-                else
-                    fprintf (dot, "%c", node->bytes[i]);
-            }
+            db_fprint_content (dot, Bt, node);
             fprintf (dot, "\" [label=\"");
-            for (int i=0; i < node->len; i++)
-            {
-                if (node->bytes[i] == (char)EON)
-                    fprintf (dot, "<EON>");
-                else
-                    fprintf (dot, "%c", node->bytes[i]);
-            }
+            db_fprint_content (dot, Bt, node);
             fprintf (dot, "\"]};");
             fclose (dot);
             return 0;
@@ -150,7 +204,7 @@ db_do_dfs (struct Bt_instance* Bt, struct node_t* node, struct node_t* parent, i
     }
     else
     {
-        db_print_node_to_file (node, parent, trie_stat->id, p_id);
+        db_print_node_to_file (Bt, node, parent, trie_stat->id, p_id);
     }
     fclose(dot);
 
@@ -160,8 +214,10 @@ db_do_dfs (struct Bt_instance* Bt, struct node_t* node, struct node_t* parent, i
         exit(0);
     }
     trie_stat->width[height] = trie_stat->width[height] + 1;
+    // -- memory of the node, its content and children -- //
+    trie_stat->mem += db_node_mem (Bt, node);
 
-    if (!node->hash_table)
+    if (!node->children)
     {
         // -- this is a leaf -- //
         trie_stat->max = (trie_stat->max < height) ? height : trie_stat->max;
@@ -171,22 +227,16 @@ db_do_dfs (struct Bt_instance* Bt, struct node_t* node, struct node_t* parent, i
     }
     else
     {
-        trie_stat->ht_size += node->hash_table->size; 
+        trie_stat->kinds[node->children->kind]++;
+        trie_stat->an_size += an_size (node->children->kind); 
     }
-    for (int i=0; i < node->hash_table->size; i++)
+    while ((next_node = an_next (node->children, &walker)))
     {
-        if (!node->hash_table->buckets[i].first_byte)
-            continue;
-        if (!node->hash_table->buckets[i].next_node)
-        {
-            fprintf (stderr, "[db_do_dfs] WARNING: A null active child.\n");
-            return 0;
-        }        
-        db_do_dfs (Bt, node->hash_table->buckets[i].next_node, node, height + 1, trie_stat, id, print_flag); 
+        db_do_dfs (Bt, next_node, node, height + 1, trie_stat, id, print_flag); 
         if (print_flag)
         {
             printf ("H:%u   ",height);
-            db_print_node (node->hash_table->buckets[i].next_node);
+            db_print_node (Bt, next_node);
         }
     }
     // -- this is not a leaf -- //
@@ -202,15 +252,9 @@ db_do_dfs (struct Bt_instance* Bt, struct node_t* node, struct node_t* parent, i
  * Print component(s) of node.
  * ----------------------------------------------------------------------------------- */
 void
-db_print_node (struct node_t* node)
+db_print_node (struct Bt_instance* Bt, struct node_t* node)
 {
-    for (int i=0; i < node->len; i++)
-    {
-        if (node->bytes[i] == (char)EON)
-            printf ("<EON>");
-        else
-            printf ("%c", node->bytes[i]);
-    }
+    db_fprint_content (stdout, Bt, node);
     printf ("\n");
     return;
 } /* -- end of db_print_node (..) -- */
@@ -224,48 +268,24 @@ db_print_node (struct node_t* node)
  * Print component(s) of node to dot file.
  * ----------------------------------------------------------------------------------- */
 void
-db_print_node_to_file (struct node_t* node, struct node_t* parent, signed int id, signed int p_id)
+db_print_node_to_file (struct Bt_instance* Bt, struct node_t* node, struct node_t* parent, signed int id, signed int p_id)
 {
     FILE* dot = fopen(DOT_FILE_PATH, "a");
 
     // -- add parent -- //
     fprintf (dot,"\t{\"<%u>", p_id);
-    for (int i=0; i < parent->len; i++)
-    {
-        if (parent->bytes[i] == (char)EON)
-            fprintf (dot, "<EON>");
-        else
-            fprintf (dot, "%c", parent->bytes[i]);
-    }
+    db_fprint_content (dot, Bt, parent);
     fprintf (dot, "\" ");
     fprintf (dot, "[label=\"");
-    for (int i=0; i < parent->len; i++)
-    {
-        if (parent->bytes[i] == (char)EON)
-            fprintf (dot, "<EON>");
-        else
-            fprintf (dot, "%c", parent->bytes[i]);
-    }
+    db_fprint_content (dot, Bt, parent);
     fprintf (dot, "\"]}");
 
     // -- add node -- //
     fprintf (dot, " -> {\"<%u>",id);
-    for (int i=0; i < node->len; i++)
-    {
-        if (node->bytes[i] == (char)EON)
-            fprintf (dot, "<EON>");
-        else
-            fprintf (dot, "%c", node->bytes[i]);
-    }
+    db_fprint_content (dot, Bt, node);
     fprintf (dot, "\" ");
     fprintf (dot, "[label=\"");
-    for (int i=0; i < node->len; i++)
-    {
-        if (node->bytes[i] == (char)EON)
-            fprintf (dot, "<EON>");
-        else
-            fprintf (dot, "%c", node->bytes[i]);
-    }
+    db_fprint_content (dot, Bt, node);
     fprintf (dot, "\"]};\n");
     fclose (dot);
     return;
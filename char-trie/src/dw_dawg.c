@@ -0,0 +1,466 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "dw_dawg.h"
+#include "Bt_trie.h"
+#include "an_adaptive.h"
+
+#define DW_FNV_OFFSET 14695981039346656037ULL
+#define DW_FNV_PRIME  1099511628211ULL
+#define DW_MIX(h, x) (((h) ^ (unsigned long long)(x)) * DW_FNV_PRIME)
+
+/* ---------------------------------------------------------
+ * Hash tables of a minimization (open addressing, with
+ * mask + 1 slots), to find equivalent states and equal
+ * labels.
+ * --------------------------------------------------------- */
+struct dw_build_t {
+    struct dw_dawg_t* dw;
+    unsigned int* states;         // -- state + 1 (ZERO: empty) -- //
+    unsigned int* labels;         // -- offset of a label + 1 (ZERO: empty) -- //
+    unsigned short* label_lens;   // -- length of the label of each slot -- //
+    unsigned long long mask;
+};
+
+/* ----------------------------------------------------------------
+ * Method: dw_hash_bytes (..)
+ * Scope: Private
+ *
+ * Description:
+ * FNV-1a hash of a label.
+ * ---------------------------------------------------------------- */
+static inline unsigned long long
+dw_hash_bytes (const char* bytes, int len)
+{
+    unsigned long long h = DW_FNV_OFFSET;
+
+    for (int i = 0; i < len; i++)
+        h = DW_MIX(h, (unsigned char)bytes[i]);
+    return h;
+} /* -- end of dw_hash_bytes (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: dw_hash_state (..)
+ * Scope: Private
+ *
+ * Description:
+ * Hash of a state, i.e. its EON flag and its edges. Labels are kept
+ * once, so two edges have the same label iff they have the same
+ * offset.
+ * ---------------------------------------------------------------- */
+static inline unsigned long long
+dw_hash_state (bool eon, const struct dw_edge_t* edges, int num_of_edges)
+{
+    unsigned long long h = DW_MIX(DW_FNV_OFFSET, eon);
+
+    for (int i = 0; i < num_of_edges; i++)
+    {
+        h = DW_MIX(h, edges[i].offset);
+        h = DW_MIX(h, edges[i].target);
+    }
+    return h;
+} /* -- end of dw_hash_state (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: dw_same_state (..)
+ * Scope: Private
+ *
+ * Description:
+ * Whether a state of the automaton has a given EON flag and given
+ * edges.
+ * ---------------------------------------------------------------- */
+static bool
+dw_same_state (const struct dw_dawg_t* dw, unsigned int state, bool eon, const struct dw_edge_t* edges, int num_of_edges)
+{
+    unsigned int first = dw->states[state] >> 1;
+
+    if ((dw->states[state] & DW_EON) != (unsigned int)eon || (dw->states[state + 1] >> 1) - first != (unsigned int)num_of_edges)
+        return false;
+    for (int i = 0; i < num_of_edges; i++)
+        if (dw->edges[first + i].offset != edges[i].offset || dw->edges[first + i].target != edges[i].target)
+            return false;
+    return true;
+} /* -- end of dw_same_state (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: dw_add_state (..)
+ * Scope: Private
+ *
+ * Description:
+ * State of a given EON flag and given edges: an equivalent state,
+ * if the automaton has it, otherwise a new one.
+ * ---------------------------------------------------------------- */
+static unsigned int
+dw_add_state (struct dw_build_t* build, bool eon, const struct dw_edge_t* edges, int num_of_edges)
+{
+    struct dw_dawg_t* dw = build->dw;
+    unsigned long long slot = dw_hash_state (eon, edges, num_of_edges) & build->mask;
+
+    while (build->states[slot] && !dw_same_state (dw, build->states[slot] - 1, eon, edges, num_of_edges))
+        slot = (slot + 1) & build->mask;
+    if (!build->states[slot])
+    {
+        dw->states[dw->num_of_states] = (dw->num_of_edges << 1) | (eon ? DW_EON : 0);
+        dw->states[dw->num_of_states + 1] = (dw->num_of_edges + num_of_edges) << 1;   // -- the end of its edges -- //
+        memcpy (dw->edges + dw->num_of_edges, edges, num_of_edges * sizeof(struct dw_edge_t));
+        dw->num_of_edges += num_of_edges;
+        build->states[slot] = ++dw->num_of_states;
+    }
+    return build->states[slot] - 1;
+} /* -- end of dw_add_state (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: dw_add_label (..)
+ * Scope: Private
+ *
+ * Description:
+ * Offset of a label in label_bytes: of an equal label, if the
+ * automaton has it, otherwise of a new one.
+ * ---------------------------------------------------------------- */
+static unsigned int
+dw_add_label (struct dw_build_t* build, const char* bytes, int len)
+{
+    struct dw_dawg_t* dw = build->dw;
+    unsigned long long slot = dw_hash_bytes (bytes, len) & build->mask;
+
+    while (build->labels[slot] && (build->label_lens[slot] != len || memcmp (dw->label_bytes + build->labels[slot] - 1, bytes, len)))
+        slot = (slot + 1) & build->mask;
+    if (!build->labels[slot])
+    {
+        memcpy (dw->label_bytes + dw->num_of_label_bytes, bytes, len);
+        build->labels[slot] = dw->num_of_label_bytes + 1;
+        build->label_lens[slot] = len;
+        dw->num_of_label_bytes += len;
+    }
+    return build->labels[slot] - 1;
+} /* -- end of dw_add_label (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: dw_find_edge (..)
+ * Scope: Private
+ *
+ * Description:
+ * Index of the edge of a given first byte among the (sorted) edges
+ * of a state, or -1. A few edges are scanned, more are binary
+ * searched.
+ * ---------------------------------------------------------------- */
+static inline int
+dw_find_edge (const struct dw_edge_t* edges, int num_of_edges, unsigned char first_byte)
+{
+    int low = 0;
+    int high = num_of_edges - 1;
+    int mid;
+
+    if (num_of_edges <= DW_LINEAR_EDGES)
+    {
+        for (int i = 0; i < num_of_edges; i++)
+        {
+            if (edges[i].first == first_byte)
+                return i;
+            if (edges[i].first > first_byte)
+                return -1;
+        }
+        return -1;
+    }
+    while (low <= high)
+    {
+        mid = (low + high) / 2;
+        if (edges[mid].first == first_byte)
+            return mid;
+        if (edges[mid].first < first_byte)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+    return -1;
+} /* -- end of dw_find_edge (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: dw_minimize (..)
+ * Scope: Global
+ *
+ * Description:
+ * Minimize a trie. The nodes are numbered in BFS order, then visited
+ * backward, so the children of a node are visited before it. Each
+ * node gets the state of its edges, and its content is the label of
+ * its edge from its parent.
+ *
+ * With DW_SPLIT_COMPONENTS, the content of each node is split before
+ * each SLASH (but the first byte), so equal components at the end of
+ * different contents (e.g. of leaves) lead to the same states: a node
+ * gets a state of a single edge for each piece of its content but
+ * the first one, which is the label of its edge. It takes fewer label
+ * bytes, but more states and edges.
+ * ---------------------------------------------------------------- */
+struct dw_dawg_t*
+dw_minimize (struct Bt_instance* Bt)
+{
+    assert (Bt);
+    int size = 1024;
+    struct node_t** queue = (struct node_t**)malloc(size * sizeof(struct node_t*));
+    int* depths = (int*)malloc(size * sizeof(int));     // -- where the content of each node starts in its names -- //
+    int* firsts = (int*)malloc(size * sizeof(int));     // -- number of the first child of each node -- //
+    struct node_t** new_queue;
+    int* new_depths;
+    int* new_firsts;
+    int tail = 1;
+    int walker;
+    int num_of_edges;
+    int end;
+    struct node_t* node;
+    struct node_t* next_node;
+    struct dw_dawg_t* dw = 0;
+    struct dw_build_t build = {0};
+    struct dw_edge_t edges[256];   // -- edges of the current node -- //
+    unsigned int* state_of = 0;    // -- state after the first piece of the content of each node -- //
+    unsigned int* label_of = 0;    // -- offset of the first piece in label_bytes -- //
+    unsigned short* len_of = 0;    // -- length of the first piece -- //
+    unsigned int state;
+    unsigned int* states;
+    struct dw_edge_t* kept_edges;
+    char* label_bytes;
+    bool ok = true;
+    const char* content;
+    long long num_of_content_bytes = 0;
+    long long num_of_pieces = 0;
+
+    if (!queue || !depths || !firsts)
+    {
+        fprintf (stderr, "[dw_minimize] ERROR: Failed to allocate the queue.\n");
+        free(queue);
+        free(depths);
+        free(firsts);
+        return 0;
+    }
+
+    // -- number the nodes in BFS order, and count the pieces of their contents -- //
+    queue[0] = &Bt->root;
+    depths[0] = 0;
+    for (int head = 0; ok && head < tail; head++)
+    {
+        walker = 0;
+        firsts[head] = tail;
+        while (ok && (next_node = an_next (queue[head]->children, &walker)))
+        {
+            if (tail == size)
+            {
+                size *= 2;
+                if ((new_queue = (struct node_t**)realloc(queue, size * sizeof(struct node_t*))))
+                    queue = new_queue;
+                if ((new_depths = (int*)realloc(depths, size * sizeof(int))))
+                    depths = new_depths;
+                if ((new_firsts = (int*)realloc(firsts, size * sizeof(int))))
+                    firsts = new_firsts;
+                if (!new_queue || !new_depths || !new_firsts)
+                {
+                    ok = false;
+                    break;
+                }
+            }
+            queue[tail] = next_node;
+            depths[tail] = depths[head] + queue[head]->len;
+            content = Bt_node_content (Bt, next_node, depths[tail]);
+            num_of_content_bytes += next_node->len;
+            num_of_pieces++;
+            for (int i = 1; DW_SPLIT_COMPONENTS && i < next_node->len; i++)
+                num_of_pieces += (content[i] == (char)SLASH);
+            tail++;
+        }
+    }
+
+    // -- at most a state per node and piece, an edge per piece, and the contents of the nodes -- //
+    for (build.mask = 1; build.mask < 2ULL * (tail + num_of_pieces); build.mask <<= 1)
+        ;
+    ok = ok && (dw = (struct dw_dawg_t*)calloc(1, sizeof(struct dw_dawg_t)))
+         && (dw->states = (unsigned int*)malloc((tail + num_of_pieces + 1) * sizeof(unsigned int)))
+         && (dw->edges = (struct dw_edge_t*)malloc((num_of_pieces + 1) * sizeof(struct dw_edge_t)))
+         && (dw->label_bytes = (char*)malloc(num_of_content_bytes + 1))
+         && (state_of = (unsigned int*)malloc(tail * sizeof(unsigned int)))
+         && (label_of = (unsigned int*)malloc(tail * sizeof(unsigned int)))
+         && (len_of = (unsigned short*)malloc(tail * sizeof(unsigned short)))
+         && (build.states = (unsigned int*)calloc(build.mask, sizeof(unsigned int)))
+         && (build.labels = (unsigned int*)calloc(build.mask, sizeof(unsigned int)))
+         && (build.label_lens = (unsigned short*)calloc(build.mask, sizeof(unsigned short)));
+    if (ok)
+    {
+        dw->num_of_nodes = tail;
+        dw->num_of_content_bytes = num_of_content_bytes;
+        build.dw = dw;
+    }
+    build.mask--;
+
+    for (int v = tail - 1; ok && v >= 0; v--)
+    {
+        node = queue[v];
+
+        // -- edges of the node, i.e. first pieces of its children -- //
+        num_of_edges = 0;
+        for (int c = firsts[v]; c < (v + 1 < tail ? firsts[v + 1] : tail); c++)
+        {
+            edges[num_of_edges].offset = label_of[c];
+            edges[num_of_edges].target = state_of[c];
+            edges[num_of_edges].len = len_of[c];
+            edges[num_of_edges].first = dw->label_bytes[label_of[c]];
+            num_of_edges++;
+        }
+        state = dw_add_state (&build, node->EON_flag, edges, num_of_edges);
+        if (!v)
+        {
+            dw->root = state;   // -- the root (i.e. SLASH) has no label -- //
+            break;
+        }
+
+        // -- pieces of the content, from the last one -- //
+        content = Bt_node_content (Bt, node, depths[v]);
+        end = node->len;
+        for (int i = end - 1; DW_SPLIT_COMPONENTS && i > 0; i--)
+        {
+            if (content[i] != (char)SLASH)
+                continue;
+            edges[0].offset = dw_add_label (&build, content + i, end - i);
+            edges[0].target = state;
+            edges[0].len = end - i;
+            edges[0].first = SLASH;
+            state = dw_add_state (&build, false, edges, 1);
+            end = i;
+        }
+        label_of[v] = dw_add_label (&build, content, end);
+        len_of[v] = end;
+        state_of[v] = state;
+    }
+
+    // -- keep just what is used (if a buffer cannot shrink, it is kept as it is) -- //
+    if (ok && (states = (unsigned int*)realloc(dw->states, (dw->num_of_states + 1) * sizeof(unsigned int))))
+        dw->states = states;
+    if (ok && (kept_edges = (struct dw_edge_t*)realloc(dw->edges, (dw->num_of_edges + 1) * sizeof(struct dw_edge_t))))
+        dw->edges = kept_edges;
+    if (ok && (label_bytes = (char*)realloc(dw->label_bytes, dw->num_of_label_bytes + 1)))
+        dw->label_bytes = label_bytes;
+
+    free(build.states);
+    free(build.labels);
+    free(build.label_lens);
+    free(state_of);
+    free(label_of);
+    free(len_of);
+    free(queue);
+    free(depths);
+    free(firsts);
+    if (!ok)
+    {
+        fprintf (stderr, "[dw_minimize] ERROR: Failed to allocate the automaton.\n");
+        dw_free (dw);
+        return 0;
+    }
+    return dw;
+} /* -- end of dw_minimize (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: dw_lookup (..)
+ * Scope: Global
+ *
+ * Description:
+ * Lookup a name in an automaton. At each state, the edge of the next
+ * byte is found among its edges, and its label is matched.
+ * ---------------------------------------------------------------- */
+bool
+dw_lookup (const struct dw_dawg_t* dw, const char* name)
+{
+    assert (dw);
+    assert (name);
+
+    int len = strlen(name);
+    int byte_walker = 1;        // -- Assuming all names start with SLASH "/" -- //
+    unsigned int state = dw->root;
+    unsigned int first;
+    const struct dw_edge_t* edge;
+    int i;
+
+    if (len < 2 || name[0] != (char)SLASH)
+        return false;
+    while (byte_walker < len)
+    {
+        first = dw->states[state] >> 1;
+        if ((i = dw_find_edge (dw->edges + first, (dw->states[state + 1] >> 1) - first, name[byte_walker])) < 0)
+            return false;
+        edge = dw->edges + first + i;
+        if (byte_walker + edge->len > len || memcmp (dw->label_bytes + edge->offset + 1, name + byte_walker + 1, edge->len - 1))
+            return false;
+        byte_walker += edge->len;
+        state = edge->target;
+    }
+    return dw->states[state] & DW_EON;
+} /* -- end of dw_lookup (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: dw_size (..)
+ * Scope: Global
+ *
+ * Description:
+ * Bytes of an automaton, i.e. its states, edges, and labels.
+ * ---------------------------------------------------------------- */
+long long
+dw_size (const struct dw_dawg_t* dw)
+{
+    assert (dw);
+    return sizeof(struct dw_dawg_t) + (dw->num_of_states + 1LL) * sizeof(unsigned int)
+           + (long long)dw->num_of_edges * sizeof(struct dw_edge_t) + dw->num_of_label_bytes;
+} /* -- end of dw_size (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: dw_flat_size (..)
+ * Scope: Global
+ *
+ * Description:
+ * Bytes of the trie in the layout of an automaton, i.e. a state per
+ * node, an edge per child, and the whole content of each node. The
+ * gap between this and dw_size is what the minimization saves.
+ * ---------------------------------------------------------------- */
+long long
+dw_flat_size (const struct dw_dawg_t* dw)
+{
+    assert (dw);
+    return sizeof(struct dw_dawg_t) + (dw->num_of_nodes + 1LL) * sizeof(unsigned int)
+           + (dw->num_of_nodes - 1LL) * sizeof(struct dw_edge_t) + dw->num_of_content_bytes;
+} /* -- end of dw_flat_size (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: dw_free (..)
+ * Scope: Global
+ *
+ * Description:
+ * Free an automaton.
+ * ---------------------------------------------------------------- */
+void
+dw_free (struct dw_dawg_t* dw)
+{
+    if (!dw)
+        return;
+    free(dw->states);
+    free(dw->edges);
+    free(dw->label_bytes);
+    free(dw);
+} /* -- end of dw_free (..) -- */
@@ -0,0 +1,555 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "lo_louds.h"
+#include "Bt_trie.h"
+#include "an_adaptive.h"
+
+// -- ones (or zeros) before a block -- //
+#define LO_BEFORE(bv, block, bit) ((bit) ? (long long)(bv)->ranks[block] : (long long)(block) * LO_BLOCK_BITS - (bv)->ranks[block])
+#define LO_WORD(bv, word, bit) ((bit) ? (bv)->words[word] : ~(bv)->words[word])
+
+/* ----------------------------------------------------------------
+ * Method: lo_popcount (..)
+ * Scope: Private
+ *
+ * Description:
+ * Number of ones of a word. Without POPCNT instruction, the builtin
+ * is a library call, so ones are counted in parallel (SWAR) here.
+ * ---------------------------------------------------------------- */
+static inline int
+lo_popcount (unsigned long long word)
+{
+#ifdef __POPCNT__
+    return __builtin_popcountll (word);
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((word * 0x0101010101010101ULL) >> 56);
+#endif
+} /* -- end of lo_popcount (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_bits_alloc (..)
+ * Scope: Private
+ *
+ * Description:
+ * Allocate a bit vector of ZEROs (padded to whole blocks).
+ *
+ * RETURN:
+ *     whether the words are allocated
+ * ---------------------------------------------------------------- */
+static bool
+lo_bits_alloc (struct lo_bits_t* bv, long long num_of_bits)
+{
+    bv->num_of_bits = num_of_bits;
+    bv->num_of_blocks = num_of_bits / LO_BLOCK_BITS + 1;
+    bv->words = (unsigned long long*)calloc(bv->num_of_blocks * LO_BLOCK_WORDS, sizeof(unsigned long long));
+    bv->ranks = 0;
+    bv->hints0 = 0;
+    bv->hints1 = 0;
+    return bv->words != 0;
+} /* -- end of lo_bits_alloc (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_bits_free (..)
+ * Scope: Private
+ *
+ * Description:
+ * Free a bit vector and its directory.
+ * ---------------------------------------------------------------- */
+static void
+lo_bits_free (struct lo_bits_t* bv)
+{
+    free(bv->words);
+    free(bv->ranks);
+    free(bv->hints0);
+    free(bv->hints1);
+    bv->words = 0;
+    bv->ranks = 0;
+    bv->hints0 = 0;
+    bv->hints1 = 0;
+} /* -- end of lo_bits_free (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_bits_size (..)
+ * Scope: Private
+ *
+ * Description:
+ * Bytes of a bit vector and its directory.
+ * ---------------------------------------------------------------- */
+static long long
+lo_bits_size (const struct lo_bits_t* bv)
+{
+    long long size = bv->num_of_blocks * LO_BLOCK_WORDS * sizeof(unsigned long long);
+    long long ones;
+
+    if (!bv->ranks)
+        return size;
+    ones = bv->ranks[bv->num_of_blocks];
+    size += (bv->num_of_blocks + 1) * sizeof(unsigned int);
+    if (bv->hints0)
+        size += ((bv->num_of_bits - ones) / LO_SELECT_SAMPLE + 2) * sizeof(unsigned int);
+    if (bv->hints1)
+        size += (ones / LO_SELECT_SAMPLE + 2) * sizeof(unsigned int);
+    return size;
+} /* -- end of lo_bits_size (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_set (..)
+ * Scope: Private
+ *
+ * Description:
+ * Set a bit to ONE.
+ * ---------------------------------------------------------------- */
+static inline void
+lo_set (struct lo_bits_t* bv, long long pos)
+{
+    bv->words[pos / LO_WORD_BITS] |= 1ULL << (pos % LO_WORD_BITS);
+} /* -- end of lo_set (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_get (..)
+ * Scope: Private
+ *
+ * Description:
+ * Value of a bit.
+ * ---------------------------------------------------------------- */
+static inline int
+lo_get (const struct lo_bits_t* bv, long long pos)
+{
+    return (bv->words[pos / LO_WORD_BITS] >> (pos % LO_WORD_BITS)) & 1;
+} /* -- end of lo_get (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_bits_hints (..)
+ * Scope: Private
+ *
+ * Description:
+ * Select hints of ones (or zeros): the block of every
+ * LO_SELECT_SAMPLE-th of them, and the last block at the end
+ * (NULL if they cannot be allocated).
+ * ---------------------------------------------------------------- */
+static unsigned int*
+lo_bits_hints (const struct lo_bits_t* bv, long long count, int bit)
+{
+    long long num_of_hints = count / LO_SELECT_SAMPLE + 2;
+    unsigned int* hints = (unsigned int*)malloc(num_of_hints * sizeof(unsigned int));
+    long long hint = 0;
+
+    if (!hints)
+        return 0;
+    for (long long block = 0; block < bv->num_of_blocks; block++)
+    {
+        // -- hints which fall into this block -- //
+        while (hint * LO_SELECT_SAMPLE < count && hint * LO_SELECT_SAMPLE < LO_BEFORE(bv, block + 1, bit))
+            hints[hint++] = block;
+    }
+    while (hint < num_of_hints)
+        hints[hint++] = bv->num_of_blocks - 1;
+    return hints;
+} /* -- end of lo_bits_hints (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_bits_index (..)
+ * Scope: Private
+ *
+ * Description:
+ * Build the rank directory of a bit vector, and its select hints
+ * (LO_HINTS_0 and/or LO_HINTS_1).
+ *
+ * RETURN:
+ *     whether the directory and the hints are allocated
+ * ---------------------------------------------------------------- */
+static bool
+lo_bits_index (struct lo_bits_t* bv, int hints)
+{
+    long long ones = 0;
+
+    bv->ranks = (unsigned int*)malloc((bv->num_of_blocks + 1) * sizeof(unsigned int));
+    if (!bv->ranks)
+        return false;
+    for (long long block = 0; block < bv->num_of_blocks; block++)
+    {
+        bv->ranks[block] = ones;
+        for (int w = 0; w < LO_BLOCK_WORDS; w++)
+            ones += lo_popcount (bv->words[block * LO_BLOCK_WORDS + w]);
+    }
+    bv->ranks[bv->num_of_blocks] = ones;
+    if (hints & LO_HINTS_0)
+        bv->hints0 = lo_bits_hints (bv, bv->num_of_bits - ones, 0);
+    if (hints & LO_HINTS_1)
+        bv->hints1 = lo_bits_hints (bv, ones, 1);
+    return !((hints & LO_HINTS_0) && !bv->hints0) && !((hints & LO_HINTS_1) && !bv->hints1);
+} /* -- end of lo_bits_index (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_rank1 (..)
+ * Scope: Private
+ *
+ * Description:
+ * Number of ones before a given bit.
+ * ---------------------------------------------------------------- */
+static inline long long
+lo_rank1 (const struct lo_bits_t* bv, long long pos)
+{
+    long long word = pos / LO_WORD_BITS;
+    long long rank = bv->ranks[pos / LO_BLOCK_BITS];
+
+    for (long long w = (pos / LO_BLOCK_BITS) * LO_BLOCK_WORDS; w < word; w++)
+        rank += lo_popcount (bv->words[w]);
+
+    if (pos % LO_WORD_BITS)
+        rank += lo_popcount (bv->words[word] << (LO_WORD_BITS - pos % LO_WORD_BITS));
+    return rank;
+} /* -- end of lo_rank1 (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_select_word (..)
+ * Scope: Private
+ *
+ * Description:
+ * Position of the k-th (ZERO-based) one of a word, which has more
+ * than k ones. Whole bytes are skipped first.
+ * ---------------------------------------------------------------- */
+static inline int
+lo_select_word (unsigned long long word, long long k)
+{
+    int shift = 0;
+    int ones;
+
+    while ((ones = lo_popcount (word & 0xFF)) <= k)
+    {
+        k -= ones;
+        word >>= 8;
+        shift += 8;
+    }
+    while (k || !(word & 1))
+    {
+        k -= word & 1;
+        word >>= 1;
+        shift++;
+    }
+    return shift;
+} /* -- end of lo_select_word (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_select (..)
+ * Scope: Private
+ *
+ * Description:
+ * Position of the k-th (ZERO-based) one (or zero) of a bit vector.
+ * The block is binary searched between two select hints.
+ * ---------------------------------------------------------------- */
+static inline long long
+lo_select (const struct lo_bits_t* bv, long long k, int bit)
+{
+    const unsigned int* hints = bit ? bv->hints1 : bv->hints0;
+    long long low = hints[k / LO_SELECT_SAMPLE];
+    long long high = hints[k / LO_SELECT_SAMPLE + 1];
+    long long mid;
+    long long word;
+    unsigned long long w;
+    int ones;
+
+    // -- the last block with at most k ones (zeros) before it -- //
+    while (low < high)
+    {
+        mid = (low + high + 1) / 2;
+        if (LO_BEFORE(bv, mid, bit) <= k)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+    k -= LO_BEFORE(bv, low, bit);
+    word = low * LO_BLOCK_WORDS;
+    while ((ones = lo_popcount (w = LO_WORD(bv, word, bit))) <= k)
+    {
+        k -= ones;
+        word++;
+    }
+    return word * LO_WORD_BITS + lo_select_word (w, k);
+} /* -- end of lo_select (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_next (..)
+ * Scope: Private
+ *
+ * Description:
+ * Position of the first one (or zero) at or after a given bit. The
+ * caller knows that there is such a bit.
+ * ---------------------------------------------------------------- */
+static inline long long
+lo_next (const struct lo_bits_t* bv, long long pos, int bit)
+{
+    long long word = pos / LO_WORD_BITS;
+    unsigned long long w = LO_WORD(bv, word, bit) >> (pos % LO_WORD_BITS);
+
+    if (w)
+        return pos + __builtin_ctzll (w);
+    while (!(w = LO_WORD(bv, ++word, bit)))
+        ;
+    return word * LO_WORD_BITS + __builtin_ctzll (w);
+} /* -- end of lo_next (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_find_label (..)
+ * Scope: Private
+ *
+ * Description:
+ * Find a first byte among the (sorted) labels of the children of a
+ * node.
+ *
+ * RETURN:
+ *     -1:  not found
+ *     OTW: index of the child
+ * ---------------------------------------------------------------- */
+static inline int
+lo_find_label (const unsigned char* labels, int num_of_labels, unsigned char first_byte)
+{
+    int low = 0;
+    int high = num_of_labels - 1;
+    int mid;
+
+    if (num_of_labels <= LO_LINEAR_LABELS)
+    {
+        for (int i = 0; i < num_of_labels && labels[i] <= first_byte; i++)
+        {
+            if (labels[i] == first_byte)
+                return i;
+        }
+        return -1;
+    }
+    while (low <= high)
+    {
+        mid = (low + high) / 2;
+        if (labels[mid] == first_byte)
+            return mid;
+        if (labels[mid] < first_byte)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+    return -1;
+} /* -- end of lo_find_label (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_freeze (..)
+ * Scope: Global
+ *
+ * Description:
+ * Encode a trie as a snapshot. The nodes are visited in BFS order,
+ * once to count them (and the bytes of their contents), and once to
+ * fill the bit vectors and the byte arrays.
+ * ---------------------------------------------------------------- */
+struct lo_trie_t*
+lo_freeze (struct Bt_instance* Bt)
+{
+    assert (Bt);
+    int size = 1024;
+    struct node_t** queue = (struct node_t**)malloc(size * sizeof(struct node_t*));
+    int* depths = (int*)malloc(size * sizeof(int));   // -- where the content of each node starts in its names -- //
+    struct node_t** new_queue;
+    int* new_depths;
+    int tail = 1;
+    int walker;
+    struct node_t* node;
+    struct node_t* next_node;
+    struct lo_trie_t* lo;
+    const char* content;
+    long long num_of_tail_bytes = 0;
+    long long louds_pos = 0;
+    long long tails_pos = 0;
+    long long tail_offset = 0;
+
+    if (!queue || !depths)
+    {
+        fprintf (stderr, "[lo_freeze] ERROR: Failed to allocate the queue.\n");
+        free(queue);
+        free(depths);
+        return 0;
+    }
+
+    // -- number the nodes in BFS order -- //
+    queue[0] = &Bt->root;
+    depths[0] = 0;
+    for (int head = 0; head < tail; head++)
+    {
+        walker = 0;
+        while ((next_node = an_next (queue[head]->children, &walker)))
+        {
+            if (tail == size)
+            {
+                size *= 2;
+                if ((new_queue = (struct node_t**)realloc(queue, size * sizeof(struct node_t*))))
+                    queue = new_queue;
+                if ((new_depths = (int*)realloc(depths, size * sizeof(int))))
+                    depths = new_depths;
+                if (!new_queue || !new_depths)
+                {
+                    fprintf (stderr, "[lo_freeze] ERROR: Failed to grow the queue.\n");
+                    free(queue);
+                    free(depths);
+                    return 0;
+                }
+            }
+            queue[tail] = next_node;
+            depths[tail] = depths[head] + queue[head]->len;
+            num_of_tail_bytes += next_node->len - 1;
+            tail++;
+        }
+    }
+
+    // -- unset members stay ZERO, so lo_free can free a part of them -- //
+    if (!(lo = (struct lo_trie_t*)calloc(1, sizeof(struct lo_trie_t)))
+        || !lo_bits_alloc (&lo->louds, 2LL * tail - 1)
+        || !lo_bits_alloc (&lo->tails, num_of_tail_bytes + tail - 1)
+        || !lo_bits_alloc (&lo->eon, tail)
+        || !(lo->labels = (unsigned char*)malloc(tail))
+        || !(lo->tail_bytes = (char*)malloc(num_of_tail_bytes + 1)))
+    {
+        fprintf (stderr, "[lo_freeze] ERROR: Failed to allocate the snapshot.\n");
+        lo_free (lo);
+        free(queue);
+        free(depths);
+        return 0;
+    }
+    lo->num_of_nodes = tail;
+    lo->num_of_tail_bytes = num_of_tail_bytes;
+
+    // -- encode the nodes in the same order -- //
+    for (int v = 0; v < tail; v++)
+    {
+        node = queue[v];
+        for (int i = 0; node->children && i < node->children->used; i++)
+            lo_set (&lo->louds, louds_pos++);
+        louds_pos++;
+        if (node->EON_flag)
+            lo_set (&lo->eon, v);
+        if (!v)
+            continue;   // -- the root (i.e. SLASH) has no label -- //
+        content = Bt_node_content (Bt, node, depths[v]);
+        lo->labels[v - 1] = content[0];
+        memcpy (lo->tail_bytes + tail_offset, content + 1, node->len - 1);
+        tail_offset += node->len - 1;
+        tails_pos += node->len - 1;
+        lo_set (&lo->tails, tails_pos++);
+    }
+    free(queue);
+    free(depths);
+    if (!lo_bits_index (&lo->louds, LO_HINTS_0) || !lo_bits_index (&lo->tails, LO_HINTS_1))
+    {
+        fprintf (stderr, "[lo_freeze] ERROR: Failed to allocate the rank directory.\n");
+        lo_free (lo);
+        return 0;
+    }
+    return lo;
+} /* -- end of lo_freeze (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_lookup (..)
+ * Scope: Global
+ *
+ * Description:
+ * Lookup a name in a snapshot. At each node, its children are found
+ * by select0 and rank1 on louds, the first byte among their labels,
+ * and the content of the child by select1 on tails.
+ * ---------------------------------------------------------------- */
+bool
+lo_lookup (const struct lo_trie_t* lo, const char* name)
+{
+    assert (lo);
+    assert (name);
+
+    int len = strlen(name);
+    int byte_walker = 1;        // -- Assuming all names start with SLASH "/" -- //
+    long long node = 0;         // -- the root -- //
+    long long start = 0;        // -- first bit of the children of the node in louds -- //
+    long long end;              // -- the ZERO after them -- //
+    long long first;            // -- number of the first child -- //
+    long long tail_start;       // -- bit of tails where the content of the node starts -- //
+    long long tail_len;
+    int child;
+
+    if (len < 2 || name[0] != (char)SLASH)
+        return false;
+    while (byte_walker < len)
+    {
+        end = lo_next (&lo->louds, start, 0);
+        if (start == end)
+            return false;   // -- a leaf -- //
+        first = lo_rank1 (&lo->louds, start) + 1;
+        if ((child = lo_find_label (lo->labels + first - 1, end - start, name[byte_walker])) < 0)
+            return false;
+        node = first + child;
+
+        // -- content of node (after its first byte): tails before it end with node - 1 ones -- //
+        tail_start = (node == 1) ? 0 : lo_select (&lo->tails, node - 2, 1) + 1;
+        tail_len = lo_next (&lo->tails, tail_start, 1) - tail_start;
+        if (byte_walker + 1 + tail_len > len || memcmp (lo->tail_bytes + tail_start - (node - 1), name + byte_walker + 1, tail_len))
+            return false;
+        byte_walker += 1 + tail_len;
+        start = lo_select (&lo->louds, node - 1, 0) + 1;
+    }
+    return lo_get (&lo->eon, node);
+} /* -- end of lo_lookup (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_size (..)
+ * Scope: Global
+ *
+ * Description:
+ * Bytes of a snapshot, i.e. its bit vectors (with directories) and
+ * byte arrays.
+ * ---------------------------------------------------------------- */
+long long
+lo_size (const struct lo_trie_t* lo)
+{
+    assert (lo);
+    return sizeof(struct lo_trie_t) + lo_bits_size (&lo->louds) + lo_bits_size (&lo->tails) + lo_bits_size (&lo->eon)
+           + lo->num_of_nodes + lo->num_of_tail_bytes + 1;
+} /* -- end of lo_size (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: lo_free (..)
+ * Scope: Global
+ *
+ * Description:
+ * Free a snapshot.
+ * ---------------------------------------------------------------- */
+void
+lo_free (struct lo_trie_t* lo)
+{
+    if (!lo)
+        return;
+    lo_bits_free (&lo->louds);
+    lo_bits_free (&lo->tails);
+    lo_bits_free (&lo->eon);
+    free(lo->labels);
+    free(lo->tail_bytes);
+    free(lo);
+} /* -- end of lo_free (..) -- */
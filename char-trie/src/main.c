@@ -26,14 +26,19 @@
 #include <unistd.h>
 #include <ctype.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "Bt_trie.h"
 #include "db_debug.h"
 #include "db_debug_struct.h"
 #include "main.h"
-#include "ht_hashtable.h"
+#include "an_adaptive.h"
+#include "mt_match.h"
+#include "ep_epoch.h"
+#include "lo_louds.h"
+#include "dw_dawg.h"
 
-char* _args = "intprxRhHe";
+char* _args = "intprxRhebocsd";
 /* --------------------------------------
  * Method: print_inst()
  * Scope: Public 
@@ -54,7 +59,11 @@ print_inst (char* prg)
     printf ("\t-R:   Generate trie statistical information and its final graph \n");
     printf ("\t-h:   Print help \n");
     printf ("\t-e:   speed evaluation mode (enter random names file) \n");
-    printf ("\t-H:   Initial size of hash tables \n");
+    printf ("\t-b:   benchmark the node-content match kernels (use this solely)\n");
+    printf ("\t-o:   optimistic path compression (nodes keep %d bytes, names are verified at the end)\n", BT_PREFIX_BYTES);
+    printf ("\t-c:   concurrent mixed workload of lookups and updates, from 1 to 64 threads \n");
+    printf ("\t-s:   freeze the trie into a succinct (LOUDS) snapshot, and compare it with the trie \n");
+    printf ("\t-d:   minimize the trie into an automaton (DAWG) which shares suffixes, and compare it with the trie \n");
 } /* -- end of print_inst () -- */
 
 /* ------------------------------------------------
@@ -97,7 +106,12 @@ print_summary (struct Bt_instance* Bt, double insert_time, double  lookup_time,
                 all_nodes += Bt->trie_stat->width[i];
             printf ("\tALL Nodes=    %d\n", all_nodes);
             printf ("\tAVE Width=    %f\n", (float)((float)(all_nodes-1)/(all_nodes-Bt->trie_stat->num)));
-            printf ("\tAVE Hash Table Size=   %f\n",(float)((float)Bt->trie_stat->ht_size / (float)(all_nodes-Bt->trie_stat->num)));
+            printf ("\tNODE4 Nodes=  %d\n", Bt->trie_stat->kinds[AN_NODE4]);
+            printf ("\tNODE16 Nodes= %d\n", Bt->trie_stat->kinds[AN_NODE16]);
+            printf ("\tNODE48 Nodes= %d\n", Bt->trie_stat->kinds[AN_NODE48]);
+            printf ("\tNODE256 Nodes=%d\n", Bt->trie_stat->kinds[AN_NODE256]);
+            printf ("\tAVE Children Size=   %f\n",(float)((float)Bt->trie_stat->an_size / (float)(all_nodes-Bt->trie_stat->num)));
+            printf ("\tMemory (bytes)=  %lld\n", Bt->trie_stat->mem);
         }
         printf (ANSI_COLOR_RED "\nTo see the final Patricia Trie run below command:\n");
         printf ("    $ bash render.sh");
@@ -123,14 +137,11 @@ warmup (struct Bt_instance* Bt, bool print_flag, bool remove_flag, bool dfs_flag
  
     char* names[] = {"/ndn/uofa/cs/department/pub","/ndn/uofa/cs/department","/ndn/uofa/ece/department","/ndn/uofa/cs/department/pub/icn/","/ndn/uofa/cs/icn/"};
     int num_of_names = 5;    
-    char* name = (char*)malloc(1);
-
     start = clock();
     for (int i=0; i<num_of_names; i++)
     {
         // -- insert some names -- //
-        Bt_en_name ((const char*)names[i], &name);
-        Bt_insert (Bt, (const char*)name, print_flag);
+        Bt_insert (Bt, (const char*)names[i], print_flag);
     }
     end = clock();
     insert_cpu_used = ((double) (end - start)) / CLOCKS_PER_SEC;
@@ -139,8 +150,7 @@ warmup (struct Bt_instance* Bt, bool print_flag, bool remove_flag, bool dfs_flag
     for (int i=0; i<num_of_names; i++)
     {
         // -- lookup some names -- //
-        Bt_en_name ((const char*)names[i], &name);
-        if (Bt_lookup(Bt, (const char*)name, print_flag, 0, 0))
+        if (Bt_lookup(Bt, (const char*)names[i], print_flag, 0, 0))
         {
             if (print_flag)
                 printf ("Name is found:   %s\n", names[i]);
@@ -160,8 +170,7 @@ warmup (struct Bt_instance* Bt, bool print_flag, bool remove_flag, bool dfs_flag
         for (int i=0; i<num_of_names; i++)
         {
             // -- remove some names -- // 
-            Bt_en_name ((const char*)names[i], &name);
-            if (Bt_remove(Bt, (const char*)name, print_flag) == 0)
+            if (Bt_remove(Bt, (const char*)names[i], print_flag) == 0)
             {
                 if (print_flag)
                     printf ("Name is removed:   %s\n", names[i]);
@@ -183,9 +192,501 @@ warmup (struct Bt_instance* Bt, bool print_flag, bool remove_flag, bool dfs_flag
     // -- summary -- //    
     print_summary (Bt, insert_cpu_used, lookup_cpu_used, remove_cpu_used, print_flag, dfs_flag);
     free_Bt(Bt);
-    free(name);
 } /* -- end of warmup(..) function -- */
 
+/* --------------------------------------------------------
+ * Method: check_match()
+ * Scope: Public 
+ *
+ * Description:
+ * Check every match kernel on buffers of each length (up to
+ * MT_BENCH_MAX_LEN, starting at different alignments) which
+ * differ at each offset, or not at all.
+ *
+ * RETURN:
+ *    number of wrong results
+ * --------------------------------------------------------- */
+int
+check_match (void)
+{
+    int (*kernels[]) (const char*, const char*, int) = {mt_match_scalar, mt_match_sse2, mt_match_avx2, mt_match};
+    int num_of_kernels = 4;
+    char* a = (char*)malloc(MT_BENCH_MAX_LEN + MT_CHECK_ALIGNS);
+    char* b = (char*)malloc(MT_BENCH_MAX_LEN + MT_CHECK_ALIGNS);
+    int errors = 0;
+
+    for (int i=0; i < MT_BENCH_MAX_LEN + MT_CHECK_ALIGNS; i++)
+        a[i] = b[i] = 'a' + i%26;
+    for (int k=0; k < num_of_kernels; k++)
+    {
+        if (k == 2 && !mt_has_avx2 ())
+            continue;
+        for (int s=0; s < MT_CHECK_ALIGNS; s++)
+        {
+            for (int len=1; len <= MT_BENCH_MAX_LEN; len++)
+            {
+                // -- a mismatch at each offset, then none (i.e. offset len) -- //
+                for (int i=0; i <= len; i++)
+                {
+                    if (i < len)
+                        b[s+i] ^= 1;
+                    if (kernels[k] (a + s, b + s, len) != i)
+                        errors++;
+                    if (i < len)
+                        b[s+i] ^= 1;
+                }
+            }
+        }
+    }
+    free(a);
+    free(b);
+    return errors;
+} /* -- end of check_match () -- */
+
+/* --------------------------------------------------------
+ * Method: bench_match()
+ * Scope: Public 
+ *
+ * Description:
+ * Microbenchmark of the kernels which match the content of a
+ * node against a name. Equal buffers of each length (starting
+ * at different alignments) are matched, and the time per
+ * matched byte is reported for each kernel.
+ * --------------------------------------------------------- */
+void
+bench_match (void)
+{
+    int lens[] = MT_BENCH_LENS;
+    int num_of_lens = sizeof(lens) / sizeof(int);
+    const char* labels[] = {"scalar", "sse2", "avx2", "selected"};
+    int (*kernels[]) (const char*, const char*, int) = {mt_match_scalar, mt_match_sse2, mt_match_avx2, mt_match};
+    int num_of_kernels = 4;
+    char* a = (char*)malloc(MT_BENCH_MAX_LEN + MT_BENCH_ALIGNS);
+    char* b = (char*)malloc(MT_BENCH_MAX_LEN + MT_BENCH_ALIGNS);
+    volatile long long matched = 0;   // -- keep the calls alive -- //
+    clock_t start, end;
+
+    for (int i=0; i < MT_BENCH_MAX_LEN + MT_BENCH_ALIGNS; i++)
+        a[i] = b[i] = 'a' + i%26;
+
+    printf ("Selected kernel:  %s\n", mt_kernel_name ());
+    printf ("Check:            %d mismatches\n", check_match ());
+    printf ("ns per matched byte:\n");
+    printf ("%8s", "len");
+    for (int k=0; k < num_of_kernels; k++)
+        printf ("%10s", labels[k]);
+    printf ("\n");
+    for (int l=0; l < num_of_lens; l++)
+    {
+        long long rounds = MT_BENCH_BYTES / lens[l];
+        printf ("%8d", lens[l]);
+        for (int k=0; k < num_of_kernels; k++)
+        {
+            if (k == 2 && !mt_has_avx2 ())
+            {
+                printf ("%10s", "-");
+                continue;
+            }
+            start = clock();
+            for (long long r=0; r < rounds; r++)
+                matched += kernels[k] (a + r%MT_BENCH_ALIGNS, b + (r*7)%MT_BENCH_ALIGNS, lens[l]);
+            end = clock();
+            printf ("%10.3f", ((double) (end - start)) / CLOCKS_PER_SEC * 1e9 / (double)(rounds * lens[l]));
+        }
+        printf ("\n");
+    }
+    free(a);
+    free(b);
+} /* -- end of bench_match () -- */
+
+/* ---------------------------------------------------
+ * Method: mw_elapsed_ns()
+ * Scope: Public 
+ * 
+ * Description:
+ * Wall-clock time (ns) since a given time.
+ * --------------------------------------------------- */
+long long
+mw_elapsed_ns (const struct timespec* since)
+{
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since->tv_sec) * 1000000000LL + (now.tv_nsec - since->tv_nsec);
+} /* -- end of mw_elapsed_ns (..) -- */
+
+/* ---------------------------------------------------
+ * Method: mw_worker()
+ * Scope: Public 
+ * 
+ * Description:
+ * Body of a thread in the mixed workload benchmark.
+ * Each operation picks a random name: an update
+ * removes one of the names of the thread if it is
+ * in the trie (otherwise inserts it), and a lookup
+ * looks up any name. Every operation is done in a
+ * read section of the epoch domain of the trie.
+ * --------------------------------------------------- */
+void*
+mw_worker (void* arg)
+{
+    struct mw_arg_t* mw = (struct mw_arg_t*)arg;
+    struct ep_record_t* rec;
+    unsigned long long seed = 0x9E3779B97F4A7C15ULL * (mw->id + 1);   // -- xorshift64 state -- //
+    int owned = (mw->num_of_names - mw->id + mw->num_of_threads - 1) / mw->num_of_threads;
+    int i;
+
+    if (!(rec = ep_register (&mw->Bt->epoch)))
+        return 0;
+    while (!__atomic_load_n (mw->stop, __ATOMIC_ACQUIRE))
+    {
+        for (int b=0; b<MW_BATCH; b++)
+        {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            ep_enter (&mw->Bt->epoch, rec);
+            if ((int)((seed >> 40) % 100) < mw->writes && owned > 0)
+            {
+                i = (int)(seed % owned) * mw->num_of_threads + mw->id;
+                if (mw->present[i])
+                {
+                    if (Bt_remove (mw->Bt, (const char*)mw->names[i], false))
+                        mw->errors++;
+                    mw->present[i] = 0;
+                }
+                else
+                {
+                    if (!Bt_insert (mw->Bt, (const char*)mw->names[i], false))
+                        mw->errors++;
+                    mw->present[i] = 1;
+                }
+            }
+            else
+                Bt_lookup (mw->Bt, (const char*)mw->names[seed % mw->num_of_names], false, 0, 0);
+            ep_exit (rec);
+        }
+        mw->ops += MW_BATCH;
+    }
+    ep_unregister (rec);
+    return 0;
+} /* -- end of mw_worker (..) -- */
+
+/* ---------------------------------------------------
+ * Method: bench_mixed()
+ * Scope: Public 
+ * 
+ * Description:
+ * Concurrent mixed workload benchmark. The (unique)
+ * names are inserted, then each number of threads
+ * in MW_THREADS runs lookups and updates for
+ * MW_DURATION_MS, at each percent of updates in
+ * MW_WRITES. Report throughput and speedup (over one
+ * thread) of each run. After the runs of each
+ * percent, all names are looked up to check that the
+ * trie has exactly the names which it should have.
+ * NOTE:
+ *     The trie should be in concurrent mode. Time is
+ *     wall-clock time (not CPU time).
+ * --------------------------------------------------- */
+void
+bench_mixed (struct Bt_instance* Bt, char** names, int num_of_names)
+{
+    assert (Bt);
+    int threads[] = MW_THREADS;
+    int writes[] = MW_WRITES;
+    int num_of_runs = sizeof(threads) / sizeof(int);
+    int num_of_writes = sizeof(writes) / sizeof(int);
+    int max_threads = 0;
+    char** unique;
+    char* present;
+    pthread_t* ids;
+    struct mw_arg_t* args;
+    struct ep_record_t* rec;
+    struct timespec start, pause;
+    volatile int stop;
+    double elapsed, base = 0;
+    long long ops, errors, mismatches;
+    int num_of_unique = 0;
+    int num_of_threads;
+
+    // -- before any allocation, so a failure leaks nothing -- //
+    if (!(rec = ep_register (&Bt->epoch)))
+        return;
+    unique = (char**)malloc(sizeof(char*) * num_of_names);
+    present = (char*)malloc(num_of_names);
+    assert (unique && present);
+    for (int r=0; r<num_of_runs; r++)
+        max_threads = (threads[r] > max_threads) ? threads[r] : max_threads;
+    ids = (pthread_t*)malloc(sizeof(pthread_t) * max_threads);
+    args = (struct mw_arg_t*)malloc(sizeof(struct mw_arg_t) * max_threads);
+    assert (ids && args);
+
+    // -- duplicate names are dropped, so each name has one owner -- //
+    ep_enter (&Bt->epoch, rec);
+    for (int i=0; i<num_of_names; i++)
+    {
+        if (Bt_insert (Bt, (const char*)names[i], false))
+        {
+            unique[num_of_unique] = names[i];
+            present[num_of_unique] = 1;
+            num_of_unique++;
+        }
+    }
+    ep_exit (rec);
+
+    printf ("\n------- MIXED WORKLOAD (%d names, %d ms per run) -------\n", num_of_unique, MW_DURATION_MS);
+    for (int w=0; w<num_of_writes; w++)
+    {
+        printf ("Updates: %d%%\n", writes[w]);
+        printf ("%10s%16s%12s%10s\n", "threads", "Mops/sec", "speedup", "errors");
+        for (int r=0; r<num_of_runs; r++)
+        {
+            stop = 0;
+            for (int i=0; i<threads[r]; i++)
+            {
+                args[i].Bt = Bt;
+                args[i].names = unique;
+                args[i].num_of_names = num_of_unique;
+                args[i].present = present;
+                args[i].id = i;
+                args[i].num_of_threads = threads[r];
+                args[i].writes = writes[w];
+                args[i].ops = 0;
+                args[i].errors = 0;
+                args[i].stop = &stop;
+            }
+            num_of_threads = 0;
+            clock_gettime (CLOCK_MONOTONIC, &start);
+            for (int i=0; i<threads[r]; i++)
+            {
+                if (pthread_create (&ids[i], 0, mw_worker, &args[i]))
+                {
+                    fprintf (stderr, "[bench_mixed] ERROR: Failed to create thread %d.\n", i);
+                    break;
+                }
+                num_of_threads++;
+            }
+            pause.tv_sec = MW_DURATION_MS / 1000;
+            pause.tv_nsec = (MW_DURATION_MS % 1000) * 1000000LL;
+            nanosleep (&pause, 0);
+            __atomic_store_n (&stop, 1, __ATOMIC_RELEASE);
+            for (int i=0; i<num_of_threads; i++)
+                pthread_join (ids[i], 0);
+            elapsed = mw_elapsed_ns (&start) / 1e9;
+
+            ops = 0;
+            errors = 0;
+            for (int i=0; i<num_of_threads; i++)
+            {
+                ops += args[i].ops;
+                errors += args[i].errors;
+            }
+            if (r == 0)
+                base = (double)ops / elapsed;
+            printf ("%10d%16.3f%12.2f%10lld\n", num_of_threads, (double)ops / elapsed / 1e6, base ? (double)ops / elapsed / base : 0, errors);
+        }
+
+        // -- the trie should have exactly the present names -- //
+        mismatches = 0;
+        ep_enter (&Bt->epoch, rec);
+        for (int i=0; i<num_of_unique; i++)
+        {
+            if ((Bt_lookup (Bt, (const char*)unique[i], false, 0, 0) != 0) != present[i])
+                mismatches++;
+        }
+        ep_exit (rec);
+        printf ("Check:  %lld mismatches\n", mismatches);
+    }
+    ep_unregister (rec);
+    free(args);
+    free(ids);
+    free(present);
+    free(unique);
+} /* -- end of bench_mixed (..) -- */
+
+/* ---------------------------------------------------
+ * Method: bench_louds()
+ * Scope: Public 
+ * 
+ * Description:
+ * Snapshot mode: insert the names, freeze the trie
+ * into a LOUDS snapshot, then report the size of both
+ * (bytes, and bits per node) and their lookup times.
+ * Each name and its prefix without the last byte (a
+ * name which may not be there) are looked up in both,
+ * and the answers should be the same.
+ * --------------------------------------------------- */
+void
+bench_louds (struct Bt_instance* Bt, char** names, int num_of_names)
+{
+    assert (Bt);
+    struct lo_trie_t* lo;
+    char** probes = (char**)malloc(sizeof(char*) * 2 * num_of_names);
+    int num_of_probes = 0;
+    int num_of_nodes;
+    long long live_size, lo_bytes;
+    long long found = 0, lo_found = 0, mismatches = 0;
+    double live_time, lo_time, freeze_time;
+    struct timespec start;
+    bool in_trie;
+
+    assert (probes);
+    for (int i=0; i<num_of_names; i++)
+        Bt_insert (Bt, (const char*)names[i], false);
+    // -- names, and names without their last byte -- //
+    for (int i=0; i<num_of_names; i++)
+    {
+        probes[num_of_probes++] = names[i];
+        probes[num_of_probes] = (char*)malloc(strlen(names[i]) + 1);
+        strcpy (probes[num_of_probes], names[i]);
+        probes[num_of_probes][strlen(names[i]) - 1] = '\0';
+        num_of_probes++;
+    }
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    lo = lo_freeze (Bt);
+    freeze_time = mw_elapsed_ns (&start) / 1e9;
+    if (!lo)
+    {
+        for (int i=1; i<num_of_probes; i+=2)
+            free(probes[i]);
+        free(probes);
+        return;
+    }
+    live_size = db_mem (Bt, &Bt->root);
+    lo_bytes = lo_size (lo);
+    num_of_nodes = lo->num_of_nodes;
+
+    for (int i=0; i<num_of_probes; i++)
+    {
+        in_trie = (Bt_lookup (Bt, (const char*)probes[i], false, 0, 0) != 0);
+        if (in_trie != lo_lookup (lo, (const char*)probes[i]))
+            mismatches++;
+    }
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    for (int r=0; r<LO_BENCH_ROUNDS; r++)
+        for (int i=0; i<num_of_probes; i++)
+            found += (Bt_lookup (Bt, (const char*)probes[i], false, 0, 0) != 0);
+    live_time = mw_elapsed_ns (&start) / 1e9;
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    for (int r=0; r<LO_BENCH_ROUNDS; r++)
+        for (int i=0; i<num_of_probes; i++)
+            lo_found += lo_lookup (lo, (const char*)probes[i]);
+    lo_time = mw_elapsed_ns (&start) / 1e9;
+
+    printf ("\n------- SNAPSHOT (%d names, %d nodes) -------\n", num_of_names, num_of_nodes);
+    printf ("%10s%16s%14s%16s%14s\n", "", "bytes", "bits/node", "lookups/sec", "ns/lookup");
+    printf ("%10s%16lld%14.2f%16.0f%14.1f\n", "trie", live_size, (double)live_size * 8 / num_of_nodes,
+            (double)num_of_probes * LO_BENCH_ROUNDS / live_time, live_time * 1e9 / ((double)num_of_probes * LO_BENCH_ROUNDS));
+    printf ("%10s%16lld%14.2f%16.0f%14.1f\n", "LOUDS", lo_bytes, (double)lo_bytes * 8 / num_of_nodes,
+            (double)num_of_probes * LO_BENCH_ROUNDS / lo_time, lo_time * 1e9 / ((double)num_of_probes * LO_BENCH_ROUNDS));
+    printf ("Content bytes (after the first byte of each node):  %lld\n", lo->num_of_tail_bytes);
+    printf ("Size ratio (trie/LOUDS):  %.2f    Lookup ratio (LOUDS/trie):  %.2f\n", (double)live_size / lo_bytes, lo_time / live_time);
+    printf ("Freeze time:  %f    Found:  %lld/%lld    Mismatches:  %lld\n", freeze_time, found / LO_BENCH_ROUNDS, (long long)num_of_probes, mismatches);
+    if (found != lo_found)
+        fprintf (stderr, "[bench_louds] ERROR: The snapshot found %lld names, the trie %lld.\n", lo_found, found);
+
+    lo_free (lo);
+    for (int i=1; i<num_of_probes; i+=2)
+        free(probes[i]);
+    free(probes);
+} /* -- end of bench_louds (..) -- */
+
+/* --------------------------------------------------------
+ * Method: bench_dawg()
+ * Scope: Public
+ *
+ * Description:
+ * Insert the names, minimize the trie, and compare the
+ * automaton with the trie: nodes vs. states, children vs.
+ * edges, bytes of contents vs. labels, memory, and speed of
+ * lookups of the names (and of the names without their
+ * last byte, which are mostly missing). Both should find
+ * the same names.
+ * --------------------------------------------------------- */
+void
+bench_dawg (struct Bt_instance* Bt, char** names, int num_of_names)
+{
+    assert (Bt);
+    struct dw_dawg_t* dw;
+    char** probes = (char**)malloc(sizeof(char*) * 2 * num_of_names);
+    int num_of_probes = 0;
+    long long live_size, dw_bytes;
+    long long found = 0, dw_found = 0, mismatches = 0;
+    double live_time, dw_time, minimize_time;
+    struct timespec start;
+    bool in_trie;
+
+    assert (probes);
+    for (int i=0; i<num_of_names; i++)
+        Bt_insert (Bt, (const char*)names[i], false);
+    // -- names, and names without their last byte -- //
+    for (int i=0; i<num_of_names; i++)
+    {
+        probes[num_of_probes++] = names[i];
+        probes[num_of_probes] = (char*)malloc(strlen(names[i]) + 1);
+        strcpy (probes[num_of_probes], names[i]);
+        probes[num_of_probes][strlen(names[i]) - 1] = '\0';
+        num_of_probes++;
+    }
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    dw = dw_minimize (Bt);
+    minimize_time = mw_elapsed_ns (&start) / 1e9;
+    if (!dw)
+    {
+        for (int i=1; i<num_of_probes; i+=2)
+            free(probes[i]);
+        free(probes);
+        return;
+    }
+    live_size = db_mem (Bt, &Bt->root);
+    dw_bytes = dw_size (dw);
+
+    for (int i=0; i<num_of_probes; i++)
+    {
+        in_trie = (Bt_lookup (Bt, (const char*)probes[i], false, 0, 0) != 0);
+        if (in_trie != dw_lookup (dw, (const char*)probes[i]))
+            mismatches++;
+    }
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    for (int r=0; r<DW_BENCH_ROUNDS; r++)
+        for (int i=0; i<num_of_probes; i++)
+            found += (Bt_lookup (Bt, (const char*)probes[i], false, 0, 0) != 0);
+    live_time = mw_elapsed_ns (&start) / 1e9;
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    for (int r=0; r<DW_BENCH_ROUNDS; r++)
+        for (int i=0; i<num_of_probes; i++)
+            dw_found += dw_lookup (dw, (const char*)probes[i]);
+    dw_time = mw_elapsed_ns (&start) / 1e9;
+
+    printf ("\n------- DAWG (%d names) -------\n", num_of_names);
+    printf ("%26s%16s%16s%10s\n", "", "trie", "DAWG", "ratio");
+    printf ("%26s%16d%16d%10.2f\n", "nodes / states", dw->num_of_nodes, dw->num_of_states,
+            (double)dw->num_of_nodes / dw->num_of_states);
+    printf ("%26s%16d%16d%10.2f\n", "children / edges", dw->num_of_nodes - 1, dw->num_of_edges,
+            (double)(dw->num_of_nodes - 1) / dw->num_of_edges);
+    printf ("%26s%16lld%16lld%10.2f\n", "content / label bytes", dw->num_of_content_bytes, dw->num_of_label_bytes,
+            (double)dw->num_of_content_bytes / dw->num_of_label_bytes);
+    printf ("%26s%16lld%16lld%10.2f\n", "memory (bytes)", live_size, dw_bytes, (double)live_size / dw_bytes);
+    printf ("%26s%16lld%16lld%10.2f\n", "same layout (bytes)", dw_flat_size (dw), dw_bytes, (double)dw_flat_size (dw) / dw_bytes);
+    printf ("%26s%16.1f%16.1f%10.2f\n", "ns/lookup", live_time * 1e9 / ((double)num_of_probes * DW_BENCH_ROUNDS),
+            dw_time * 1e9 / ((double)num_of_probes * DW_BENCH_ROUNDS), live_time / dw_time);
+    printf ("Minimize time:  %f    Found:  %lld/%lld    Mismatches:  %lld\n", minimize_time, found / DW_BENCH_ROUNDS, (long long)num_of_probes, mismatches);
+    if (found != dw_found)
+        fprintf (stderr, "[bench_dawg] ERROR: The automaton found %lld names, the trie %lld.\n", dw_found, found);
+
+    dw_free (dw);
+    for (int i=1; i<num_of_probes; i+=2)
+        free(probes[i]);
+    free(probes);
+} /* -- end of bench_dawg (..) -- */
+
 /* --------------------------------------------------------
  * Method: free_Bt()
  * Scope: Public 
@@ -200,6 +701,8 @@ free_Bt (struct Bt_instance* Bt)
     assert (Bt);
     Bt_free_node (&Bt->root);
     Bt->root.len = 0;
+    if (Bt->concurrent)
+        ep_destroy (&Bt->epoch);   // -- the retired objects -- //
     free(Bt->visitedNodes);
     free(Bt->trie_stat->width);
     free(Bt->trie_stat);
@@ -231,12 +734,15 @@ main (int argc, char** argv)
     bool to_mem_flag = false;
     bool dfs_flag = false;
     bool help_flag = false;
-    bool hash_init_size_flag = false;
-    int hash_init_size = 0;
     bool eval_flag = false;
+    bool match_flag = false;
+    bool optimistic_flag = false;
+    bool mixed_flag = false;
+    bool louds_flag = false;
+    bool dawg_flag = false;
     char* rand_file = NULL;
 
-    while ((sw = getopt (argc, argv, "ri:n:tpxRhH:e:")) != -1)
+    while ((sw = getopt (argc, argv, "ri:n:tpxRhe:bocsd")) != -1)
     switch (sw)
     {
         case 'i':
@@ -273,18 +779,23 @@ main (int argc, char** argv)
             eval_flag = true;
             rand_file = optarg;
             break;
-        case 'H':
-            ret = strtol (optarg, &rem, 10); 
-            if (ret < 1)
-            {
-                fprintf (stderr, "[main] ERROR: Option -%c requires an integer argument, greater than ZERO.\n", sw);
-                return 1;
-            }
-            hash_init_size = ret;
-            hash_init_size_flag = true;
+        case 'b':
+            match_flag = true;
+            break;
+        case 'o':
+            optimistic_flag = true;
+            break;
+        case 'c':
+            mixed_flag = true;
+            break;
+        case 's':
+            louds_flag = true;
+            break;
+        case 'd':
+            dawg_flag = true;
             break;
         case '?':
-            if (optopt=='i' || optopt=='n' || optopt=='p' || optopt=='t' || optopt=='r' || optopt=='x' || optopt=='R' || optopt=='h' || optopt=='H' || optopt=='e')
+            if (optopt=='i' || optopt=='n' || optopt=='p' || optopt=='t' || optopt=='r' || optopt=='x' || optopt=='R' || optopt=='h' || optopt=='e')
                 fprintf (stderr, "[main] ERROR: Option -%c requires an argument.\n", optopt);
             else if (isprint (optopt))
             {
@@ -315,29 +826,44 @@ main (int argc, char** argv)
         print_inst(argv[0]); 
         return 0;
     } 
+    if (match_flag)
+    {
+        bench_match ();
+        return 0;
+    }
+    if (mixed_flag && optimistic_flag)
+    {
+        fprintf (stderr, "[main] ERROR: Concurrent mode [-c] does not work with optimistic mode [-o].\n");
+        return 1;
+    }
     /* --------------------------- Begin Initialize ------------------------ */
     struct Bt_instance* Bt;
     Bt = (struct Bt_instance*)malloc(sizeof(struct Bt_instance));
     assert (Bt);
-    if (hash_init_size_flag)
-        Bt->ht_init_size = hash_init_size;
-    else
-        Bt->ht_init_size = HT_INIT_SIZE;
-    Bt->root.len = 2;  // -- SLASH & EON -- //
+    Bt->root.len = 1;  // -- SLASH -- //
     Bt->root.bytes = (char*)malloc(Bt->root.len + 1); // -- '\0' -- //
     Bt->root.bytes[0] = (char)SLASH;
-    Bt->root.bytes[1] = (char)EON;
-    Bt->root.bytes[2] = '\0';
+    Bt->root.bytes[1] = '\0';
+    Bt->root.EON_flag = false;
+    Bt->root.prefix[0] = (char)SLASH;
+    Bt->root.version = 0;
+    Bt->optimistic = optimistic_flag;
+    Bt->concurrent = mixed_flag;
+    if (Bt->concurrent)
+        ep_init (&Bt->epoch, Bt);
     
-    // -- initialize the hash table at the first use -- //
-    Bt->root.hash_table = 0;
+    // -- initialize the children at the first use -- //
+    Bt->root.children = 0;
     Bt->root.parent = 0;
     Bt->trie_stat = (struct t_stat*)malloc(sizeof(struct t_stat));
     Bt->trie_stat->max = 0;
     Bt->trie_stat->sum = 0;
     Bt->trie_stat->num = 0;
     Bt->trie_stat->id = 0;
-    Bt->trie_stat->ht_size = 0;
+    Bt->trie_stat->an_size = 0;
+    Bt->trie_stat->mem = 0;
+    for (int i=0; i<AN_NUM_OF_KINDS; i++)
+        Bt->trie_stat->kinds[i] = 0;
     Bt->visitedNodes = (struct node_t**)malloc(MAX_HEIGHT * sizeof(struct node_t*));
     for (int i=0; i<MAX_HEIGHT; i++)
         Bt->visitedNodes[i] = 0;
@@ -373,7 +899,33 @@ main (int argc, char** argv)
     double insert_cpu_used = 0;
     double lookup_cpu_used = 0;
     double remove_cpu_used = 0;
-    char* name = (char*)malloc(1);
+
+    if (mixed_flag || louds_flag || dawg_flag)
+    {
+        int num_of_names = 0;
+        char** all_input = (char**)malloc((sizeof(char*) * num_of_rec)); 
+        for (int i=0; i<num_of_rec; i++)
+        {
+            if (fscanf(input, "%s", str) == EOF)
+                break;
+            all_input[i] = (char*)malloc(strlen(str) + 1);
+            strcpy (all_input[i], str);
+            num_of_names++;
+        } 
+        fclose(input);
+        if (mixed_flag)
+            bench_mixed (Bt, all_input, num_of_names);
+        else if (louds_flag)
+            bench_louds (Bt, all_input, num_of_names);
+        else
+            bench_dawg (Bt, all_input, num_of_names);
+        free(str);
+        for (int i=0; i<num_of_names; i++)
+            free(all_input[i]);
+        free(all_input);
+        free_Bt(Bt);
+        return 0;
+    }
 
     /**
      * How this evaluation works:
@@ -436,8 +988,7 @@ main (int argc, char** argv)
         printf ("MASS INSERTION:\n");
         for (int i = 0; i < num_of_rec - rand_size; i++)
         {
-            Bt_en_name((const char*)all_input[i], &name);
-            if (!Bt_insert (Bt, (const char*)name, print_flag))
+            if (!Bt_insert (Bt, (const char*)all_input[i], print_flag))
             {
                 if (print_flag)
                     printf ("Duplicate name OR Insertion error.\n");
@@ -453,8 +1004,7 @@ main (int argc, char** argv)
         printf ("EVAL LOOKUP:\n");
         for (int i = 0; i < rand_size; i++)
         {
-            Bt_en_name((const char*)rand_input[i], &name);
-            if (!Bt_lookup (Bt, (const char*)name, print_flag, 0, 0)) 
+            if (!Bt_lookup (Bt, (const char*)rand_input[i], print_flag, 0, 0)) 
             {
                 if (print_flag)
                     printf ("Name is NOT found:\t%s\n", rand_input[i]);                 
@@ -473,8 +1023,7 @@ main (int argc, char** argv)
         printf ("EVAL INSERTION:\n");
         for (int i = 0; i < rand_size; i++)
         {
-            Bt_en_name((const char*)rand_input[i], &name);
-            if (!Bt_insert (Bt, (const char*)name, print_flag))
+            if (!Bt_insert (Bt, (const char*)rand_input[i], print_flag))
             {
                 if (print_flag)
                     printf ("Duplicate name OR Insertion error.\n");
@@ -494,8 +1043,7 @@ main (int argc, char** argv)
         printf ("EVAL REMOVE:\n");
         for (int i = 0; i < rand_size; i++)
         { 
-            Bt_en_name((const char*)rand_input[i], &name);
-            if (!Bt_remove (Bt, (const char*)name, print_flag)) 
+            if (!Bt_remove (Bt, (const char*)rand_input[i], print_flag)) 
             {
                 if (print_flag)
                     printf ("Name is removed:\t%s\n", rand_input[i]);                 
@@ -525,7 +1073,6 @@ main (int argc, char** argv)
             free(rand_input[i]);
         free(rand_input);
         free_Bt(Bt);
-        free(name);
         return 0; 
         // -- END OF EVAL PART -- //
     }
@@ -550,8 +1097,7 @@ main (int argc, char** argv)
         printf ("MASS INSERTION:\n");
         for (int i = 0; i < num_of_rec; i++)
         {
-            Bt_en_name((const char*)all_input[i], &name);
-            if (!Bt_insert (Bt, (const char*)name, print_flag))
+            if (!Bt_insert (Bt, (const char*)all_input[i], print_flag))
             {
                 if (print_flag)
                     printf ("Duplicate name OR Insertion error.\n");
@@ -566,8 +1112,7 @@ main (int argc, char** argv)
         printf ("MASS LOOKUP:\n");
         for (int i = 0; i < num_of_rec; i++)
         {
-            Bt_en_name((const char*)all_input[i], &name);
-            if (!Bt_lookup (Bt, (const char*)name, print_flag, 0, 0)) 
+            if (!Bt_lookup (Bt, (const char*)all_input[i], print_flag, 0, 0)) 
             {
                 if (print_flag)
                     printf ("Name is NOT found:\t%s\n", all_input[i]);                 
@@ -588,8 +1133,7 @@ main (int argc, char** argv)
             printf ("MASS REMOVE:\n");
             for (int i = num_of_rec-1; i >= 0; i--)
             { 
-                Bt_en_name((const char*)all_input[i], &name);
-                if (!Bt_remove (Bt, (const char*)name, print_flag)) 
+                if (!Bt_remove (Bt, (const char*)all_input[i], print_flag)) 
                 {
                     if (print_flag)
                         printf ("Name is removed:\t%s\n", all_input[i]);                 
@@ -616,7 +1160,6 @@ main (int argc, char** argv)
             free(all_input[i]);
         free(all_input);
         free_Bt(Bt);
-        free(name);
         return 0; 
         // -- END OF MASS PART -- //
     }
@@ -628,9 +1171,8 @@ main (int argc, char** argv)
     {
         if (fscanf (input, "%s", str) != EOF)
         {
-            Bt_en_name((const char*)str, &name); 
-            //printf ("Insert name: %s\n", name);
-            if (!Bt_insert (Bt, (const char*)name, print_flag))
+            //printf ("Insert name: %s\n", str);
+            if (!Bt_insert (Bt, (const char*)str, print_flag))
             {
                 if (print_flag)
                     printf ("Duplicate name OR Insertion error.\n");
@@ -655,8 +1197,7 @@ main (int argc, char** argv)
     {
         if (fscanf (input, "%s", str) != EOF)
         {
-            Bt_en_name((const char*)str, &name);
-            if (!Bt_lookup (Bt, (const char*)name, print_flag, 0, 0)) 
+            if (!Bt_lookup (Bt, (const char*)str, print_flag, 0, 0)) 
             {
                 if (print_flag)
                     printf ("Name is NOT found:\t%s\n", str);                 
@@ -688,8 +1229,7 @@ main (int argc, char** argv)
         {
             if (fscanf (input, "%s", str) != EOF)
             {
-                Bt_en_name((const char*)str, &name);
-                if (!Bt_remove (Bt, (const char*)name, print_flag)) 
+                if (!Bt_remove (Bt, (const char*)str, print_flag)) 
                 {
                     if (print_flag)
                         printf ("Name is removed:\t%s\n", str);                 
@@ -725,7 +1265,6 @@ main (int argc, char** argv)
     print_summary (Bt, insert_cpu_used, lookup_cpu_used, remove_cpu_used, print_flag, dfs_flag);
     /* ---------------------------  END Mass part ------------------------- */
     free(str);
-    free(name);
     free_Bt(Bt);
     return 0;
 } /* -- end of main(..) function -- */
@@ -0,0 +1,240 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MT_X86
+#endif
+
+#include "mt_match.h"
+
+// -- offset of the first different byte in a non-zero XOR of two words -- //
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define MT_FIRST_BYTE(diff, bits)  (__builtin_ctzll(diff) >> 3)
+#else
+#define MT_FIRST_BYTE(diff, bits)  ((__builtin_clzll(diff) - (64 - (bits))) >> 3)
+#endif
+
+// -- selected by mt_resolve before main, and fixed after that (concurrent threads read it) -- //
+int (*mt_kernel) (const char*, const char*, int) = mt_match_sse2;
+static const char* mt_kernel_label = "sse2";
+
+/* ----------------------------------------------------------------
+ * Method: mt_tail (..)
+ * Scope: Private
+ *
+ * Description:
+ * Match the last bytes (from a given offset) of two buffers of len
+ * bytes. Words of 8 (or 4) bytes are compared at once, and the last
+ * word overlaps the bytes which are already matched, so no byte beyond
+ * len is read.
+ * ---------------------------------------------------------------- */
+static inline __attribute__ ((always_inline)) int
+mt_tail (const char* a, const char* b, int i, int len)
+{
+    unsigned long long x, y;
+    unsigned int u, v;
+
+    if (len - i >= 8)
+    {
+        for (; i + 8 < len; i += 8)
+        {
+            memcpy (&x, a + i, 8);
+            memcpy (&y, b + i, 8);
+            if (x != y)
+                return i + MT_FIRST_BYTE(x ^ y, 64);
+        }
+        memcpy (&x, a + len - 8, 8);
+        memcpy (&y, b + len - 8, 8);
+        return (x != y) ? len - 8 + MT_FIRST_BYTE(x ^ y, 64) : len;
+    }
+    if (len - i >= 4)
+    {
+        memcpy (&u, a + i, 4);
+        memcpy (&v, b + i, 4);
+        if (u != v)
+            return i + MT_FIRST_BYTE((unsigned long long)(u ^ v), 32);
+        if (i + 4 == len)
+            return len;
+        memcpy (&u, a + len - 4, 4);
+        memcpy (&v, b + len - 4, 4);
+        return (u != v) ? len - 4 + MT_FIRST_BYTE((unsigned long long)(u ^ v), 32) : len;
+    }
+    while (i < len && a[i] == b[i])
+        i++;
+    return i;
+} /* -- end of mt_tail (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: mt_match_scalar (..)
+ * Scope: Global
+ *
+ * Description:
+ * Byte-by-byte kernel (the reference of the other kernels).
+ * ---------------------------------------------------------------- */
+int
+mt_match_scalar (const char* a, const char* b, int len)
+{
+    int i = 0;
+    while (i < len && a[i] == b[i])
+        i++;
+    return i;
+} /* -- end of mt_match_scalar (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: mt_sse2 (..)
+ * Scope: Private
+ *
+ * Description:
+ * Compare 16 bytes at a time (from a given offset), and find the
+ * first mismatch by movemask and ctz. The last 16 bytes overlap
+ * the matched ones.
+ * ---------------------------------------------------------------- */
+static inline __attribute__ ((always_inline)) int
+mt_sse2 (const char* a, const char* b, int i, int len)
+{
+#ifdef __SSE2__
+    unsigned int mask;
+
+    for (; i + 16 <= len; i += 16)
+    {
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i)),
+                                                _mm_loadu_si128((const __m128i*)(b + i))));
+        if (mask != 0xFFFF)
+            return i + __builtin_ctz(~mask);
+    }
+    if (i < len && len >= 16)
+    {
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + len - 16)),
+                                                _mm_loadu_si128((const __m128i*)(b + len - 16))));
+        return (mask != 0xFFFF) ? len - 16 + __builtin_ctz(~mask) : len;
+    }
+#endif
+    return mt_tail (a, b, i, len);
+} /* -- end of mt_sse2 (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: mt_match_sse2 (..)
+ * Scope: Global
+ *
+ * Description:
+ * SSE2 kernel (words of 8 bytes where SSE2 is not available).
+ * ---------------------------------------------------------------- */
+int
+mt_match_sse2 (const char* a, const char* b, int len)
+{
+    return mt_sse2 (a, b, 0, len);
+} /* -- end of mt_match_sse2 (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: mt_match_avx2 (..)
+ * Scope: Global
+ *
+ * Description:
+ * Compare 32 bytes at a time (the rest is left to SSE2).
+ * ---------------------------------------------------------------- */
+#ifdef MT_X86
+__attribute__ ((target ("avx2")))
+#endif
+int
+mt_match_avx2 (const char* a, const char* b, int len)
+{
+    int i = 0;
+#ifdef MT_X86
+    unsigned int mask;
+
+    for (; i + 32 <= len; i += 32)
+    {
+        mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(a + i)),
+                                                      _mm256_loadu_si256((const __m256i*)(b + i))));
+        if (mask != 0xFFFFFFFF)
+            return i + __builtin_ctz(~mask);
+    }
+    if (i < len && len >= 32)
+    {
+        mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(a + len - 32)),
+                                                      _mm256_loadu_si256((const __m256i*)(b + len - 32))));
+        return (mask != 0xFFFFFFFF) ? len - 32 + __builtin_ctz(~mask) : len;
+    }
+#endif
+    return mt_sse2 (a, b, i, len);
+} /* -- end of mt_match_avx2 (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: mt_has_avx2 (..)
+ * Scope: Global
+ *
+ * Description:
+ * Whether the running CPU supports AVX2.
+ * ---------------------------------------------------------------- */
+int
+mt_has_avx2 (void)
+{
+#ifdef MT_X86
+    __builtin_cpu_init ();
+    return __builtin_cpu_supports ("avx2");
+#else
+    return 0;
+#endif
+} /* -- end of mt_has_avx2 (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: mt_resolve (..)
+ * Scope: Private
+ *
+ * Description:
+ * Select the kernel of the running CPU. It runs once, before main
+ * (i.e. before any thread), so the kernel is never written while
+ * threads match by it.
+ * ---------------------------------------------------------------- */
+static void __attribute__ ((constructor))
+mt_resolve (void)
+{
+    if (mt_has_avx2 ())
+    {
+        mt_kernel_label = "avx2";
+        mt_kernel = mt_match_avx2;
+    }
+    else
+    {
+#ifdef __SSE2__
+        mt_kernel_label = "sse2";
+#else
+        mt_kernel_label = "words";
+#endif
+        mt_kernel = mt_match_sse2;
+    }
+} /* -- end of mt_resolve (..) -- */
+
+/* ----------------------------------------------------------------
+ * Method: mt_kernel_name (..)
+ * Scope: Global
+ *
+ * Description:
+ * Name of the selected kernel.
+ * ---------------------------------------------------------------- */
+const char*
+mt_kernel_name (void)
+{
+    return mt_kernel_label;
+} /* -- end of mt_kernel_name (..) -- */
@@ -0,0 +1,69 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * For list of authors, please see AUTHORS.md file.
+ *
+ * Description:
+ * Arena of a trie instance. Nodes, components and hash tables are carved out
+ * of big chunks, and released blocks are kept in a free list per size class.
+ */
+
+#ifndef AR_ARENA_H
+#define AR_ARENA_H
+
+#include <stddef.h>
+
+#ifndef AR_CHUNK_SIZE
+#define AR_CHUNK_SIZE (1 << 20)  // -- size of a regular chunk (1MB) -- //
+#endif
+#define AR_ALIGN 8                   // -- every block is aligned (and sized) to 8 bytes -- //
+#define AR_SMALL_MAX 256             // -- blocks up to this size have classes of 8 bytes -- //
+#define AR_NUM_OF_CLASSES 124        // -- 32 small classes, then 4 classes per power of two -- //
+#define AR_DEDICATED_MIN (AR_CHUNK_SIZE / 8)  // -- larger blocks get a chunk of their own -- //
+
+/* ----------------------------------------------------------------------------------------
+ * How it works:
+ *
+ *    - A block is taken from the free list of its size class, or else carved from the
+ *      current chunk (bump pointer). Very large blocks get a chunk of their own.
+ *    - The caller passes the size of a block when it releases it (no per-block header),
+ *      and the block is pushed to the free list of its class. Chunks are never returned
+ *      one by one; the whole arena is released at once (ar_destroy).
+ *    - Only one thread (i.e. the writer) may allocate or release blocks.
+ * ---------------------------------------------------------------------------------------- */
+
+struct ar_chunk_t {
+    struct ar_chunk_t* next;
+    size_t size;             // -- size of the chunk (including this header) -- //
+};
+
+struct ar_arena_t {
+    struct ar_chunk_t* chunks;                 // -- all chunks of the arena -- //
+    char* cur;                                 // -- bump pointer in the current chunk -- //
+    char* end;                                 // -- end of the current chunk -- //
+    void* free_list[AR_NUM_OF_CLASSES];        // -- released blocks of each size class -- //
+    size_t reserved;                           // -- bytes taken from the system -- //
+    size_t used;                               // -- bytes of live blocks (as requested) -- //
+    int num_of_chunks;
+};
+
+void ar_init (struct ar_arena_t*);
+void ar_destroy (struct ar_arena_t*);
+void* ar_alloc (struct ar_arena_t*, size_t);
+void ar_free (struct ar_arena_t*, void*, size_t /*size passed to ar_alloc*/);
+#endif /* -- end of AR_ARENA_H -- */
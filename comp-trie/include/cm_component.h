@@ -27,7 +27,34 @@
 #ifndef CM_COMPONENT_H
 #define CM_COMPONENT_H
 
-// -- extract all name components and put them in char**(i.e. extracted components) -- //
-int cm_extract_comps (const char*, char** /* provide the return array */, bool /*print out*/);   
+#define CM_EON_OFFSET -1   // -- offset of the EON component (it is not in the name) -- //
+
+// -- bytes of a component: the span points into the name, except for EON -- //
+#define CM_SPAN_BYTES(tok, span) ((span)->offset == CM_EON_OFFSET ? cm_eon : (tok)->name + (span)->offset)
+
+extern const char cm_eon[];
+
+/* ----------------------------------------------------------------------------------------
+ * A component is referred by its position in the caller's name buffer (i.e. span), so
+ * extracting components does not copy or allocate anything. Components are extracted on
+ * demand: the name is scanned only as far as the trie walk goes.
+ * ---------------------------------------------------------------------------------------- */
+struct cm_span_t {
+    int offset;   // -- index of the first byte of the component in the name -- //
+    int len;      // -- length of the component -- //
+    unsigned long long key;  // -- hash of the component, computed once while extracting it -- //
+    unsigned int id;         // -- ID of the component in the pool (CP_UNKNOWN until it is looked up) -- //
+};
+
+struct cm_tokenizer_t {
+    const char* name;
+    int pos;      // -- index of the next byte to scan (-1 after EON) -- //
+    int count;    // -- number of extracted components -- //
+};
+
+int cm_tokenizer_init (struct cm_tokenizer_t*, const char*, bool /*print out*/);
+// -- extract the next component; 1: extracted, 0: no more components, -1: ERROR -- //
+int cm_next_comp (struct cm_tokenizer_t*, struct cm_span_t*);
+void cm_print_comps (const char*);
 
 #endif /* cm_COMPONENT_H */
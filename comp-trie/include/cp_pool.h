@@ -0,0 +1,99 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * For list of authors, please see AUTHORS.md file.
+ *
+ * Description:
+ * Component pool of a trie instance. Every distinct component is stored once, and
+ * nodes refer to it by a 32-bit ID.
+ */
+
+#ifndef CP_POOL_H
+#define CP_POOL_H
+
+#ifndef CP_INIT_SIZE
+#define CP_INIT_SIZE 64           // -- initial number of IDs (and index slots) -- //
+#endif
+#define CP_NONE 0                 // -- no component has this ID (IDs start from one) -- //
+#define CP_UNKNOWN 0xFFFFFFFFu    // -- the ID of a component is not looked up yet -- //
+#define CP_DELETED 0xFFFFFFFEu    // -- tombstone of the index -- //
+
+#define CP_HASH(key) ((unsigned int)((key) >> 32))  // -- the index keeps 32 bits of the key -- //
+
+// -- bytes of a component, by its ID (the writer only) -- //
+#define CP_BYTES(pool, id) ((pool)->ids->strings[id]->bytes)
+
+/* ----------------------------------------------------------------------------------------
+ * How it works:
+ *
+ *    - A component is interned once per node which holds it, and released when the node
+ *      is freed. The string lives as long as there is a reference to it.
+ *    - The index is an open addressing table (keyed by the hash of components) of IDs;
+ *      the ID table maps an ID to its string. Both grow aside and are published with a
+ *      single pointer store, and a released string is retired (see ep_epoch.h), so that
+ *      concurrent readers can look up components while the writer changes the pool.
+ *    - The ID of a released string is reused only after the string is reclaimed.
+ * ---------------------------------------------------------------------------------------- */
+
+struct cp_string_t {
+    unsigned int hash;        // -- CP_HASH of the key of the component (see ht_keygen) -- //
+    unsigned int id;
+    int len;
+    int refs;                 // -- number of references (i.e. components of nodes) -- //
+    char bytes[];             // -- null terminated -- //
+};
+
+struct cp_slot_t {
+    unsigned int hash;
+    unsigned int id;          // -- CP_NONE: empty, CP_DELETED: tombstone -- //
+};
+
+struct cp_index_t {
+    int size;                 // -- number of slots (power of two) -- //
+    int used;
+    int deleted;
+    struct cp_slot_t slots[];
+};
+
+struct cp_ids_t {
+    unsigned int size;                // -- number of IDs -- //
+    struct cp_string_t* strings[];    // -- string of each ID (NULL if the ID is free) -- //
+};
+
+struct cp_pool_t {
+    struct cp_index_t* index;
+    struct cp_ids_t* ids;
+    unsigned int next_id;             // -- the first ID which is never taken -- //
+    unsigned int* free_ids;           // -- reclaimed IDs (room for ids->size IDs) -- //
+    unsigned int num_of_free_ids;
+    long long num_of_strings;         // -- distinct components -- //
+    long long num_of_refs;            // -- components of all nodes -- //
+    long long bytes;                  // -- bytes of distinct components -- //
+    long long ref_bytes;              // -- bytes of components of all nodes (i.e. without the pool) -- //
+};
+
+struct ct_instance;
+
+int cp_init (struct ct_instance*);
+unsigned int cp_lookup (struct ct_instance*, const char*, int /*len*/, unsigned long long /*key*/);  // -- CP_NONE if not interned -- //
+unsigned int cp_intern (struct ct_instance*, const char*, int /*len*/, unsigned long long /*key*/);  // -- take a reference -- //
+unsigned int cp_ref (struct ct_instance*, unsigned int /*id*/);
+void cp_release (struct ct_instance*, unsigned int /*id*/);
+void cp_reclaim_string (void*, void*);
+
+#endif /* -- end of CP_POOL_H -- */
@@ -23,6 +23,9 @@
  */
 
 #include "db_debug_struct.h"
+#include "ep_epoch.h"
+#include "ar_arena.h"
+#include "cp_pool.h"
 #ifndef CT_TRIE_H
 #define CT_TRIE_H
 
@@ -38,6 +41,21 @@
 #ifndef MAX_HEIGHT
 #define MAX_HEIGHT 100
 #endif
+#ifndef CT_SMALL_MAX
+#define CT_SMALL_MAX 4   // -- a node with up to this number of children keeps them inline -- //
+#endif
+#ifndef CT_SHRINK_MAX
+#define CT_SHRINK_MAX 2  // -- a hashed node shrinks to a small one at this number of children -- //
+#endif
+#if CT_SMALL_MAX < 2 || CT_SHRINK_MAX >= CT_SMALL_MAX
+#error "CT_SMALL_MAX must be at least 2, and greater than CT_SHRINK_MAX"
+#endif
+#ifndef CT_BATCH_MAX
+#define CT_BATCH_MAX 32  // -- max number of names walked in lockstep by trie_lookup_batch -- //
+#endif
+#ifndef CT_BATCH_WINDOW
+#define CT_BATCH_WINDOW 1024  // -- names of a batch looked up in one read-side critical section -- //
+#endif
 #define ANSI_COLOR_RED     "\x1b[31m"
 #define ANSI_COLOR_GREEN   "\x1b[32m"
 #define ANSI_COLOR_YELLOW  "\x1b[33m"
@@ -66,68 +84,110 @@ typedef int bool;
 /* ----------------------------------------------------------------------------------------
  * structure of hash tables
  *
- *     [HT] => [  b_0   |  b_1  |  b_2   |  b_3  | ... |  b_n  ] & [size] & [used]
- *                 \
- *              [next_bucket] & [key] & [next_node] ...
- *                  \
- *                [next_bucket] ..
+ *     [HT] => [size] & [used] & [deleted]
+ *             [tags]    => | t_0 | t_1 | ... | t_15 | t_16 | ... | t_n |   (1 byte per slot)
+ *             [buckets] => | b_0 | b_1 | ... | b_15 | b_16 | ... | b_n |   ([key] & [next_node])
+ *                          \_______ group 0 ______/ \____ group 1 ...
  *
  * NOTE:
- *     The first bucket is used JUST as a poitner, it means its next_node is always NULL, as
- *     it is not used for storing any info. We use it as the head of the linked list at each
- *     cell of this array (i.e. HT).
+ *     Collisions are resolved by open addressing. Slots are probed a group (16 slots) at a
+ *     time: the low 7 bits of the key are kept in the tag array as a fingerprint, and a
+ *     whole group of tags is compared against the fingerprint at once (SSE2). Only slots
+ *     whose tag matches are touched, so a lookup reads one tag group and, in the common
+ *     case, one bucket. The header, the buckets and the tags live in a single allocation.
  * ----------------------------------------------------------------------------------------- */
 
+/* ----------------------------------------------------------------------------------------
+ * kinds of nodes
+ *
+ *     [LEAF]   => no children (hash_table is NULL, num_of_children is 0)
+ *     [SMALL]  => up to CT_SMALL_MAX children, kept inline (sorted by key) right after the
+ *                 node, in the same memory block: | node | (key, next_node) | .. |
+ *     [HASHED] => children are in the hash table (num_of_children is 0)
+ *
+ * NOTE:
+ *     The inline children of a node never change (except the next_node pointers, which are
+ *     published in place). Adding or removing a child of a small node builds a new node and
+ *     replaces the old one. A small node grows into a hashed one beyond CT_SMALL_MAX children
+ *     and a hashed node shrinks back at CT_SHRINK_MAX children. The root is always hashed.
+ * ---------------------------------------------------------------------------------------- */
+#define CT_KIND_LEAF 0
+#define CT_KIND_SMALL 1
+#define CT_KIND_HASHED 2
+#define CT_NUM_OF_KINDS 3
+#define CT_NODE_KIND(node) ((node)->hash_table ? CT_KIND_HASHED : \
+                            (node)->num_of_children ? CT_KIND_SMALL : CT_KIND_LEAF)
+#define CT_NODE_SIZE(num_of_children) (sizeof(struct node_t) + sizeof(struct bucket_t) * (num_of_children))
+
+struct bucket_t {
+    struct node_t* next_node;    // -- the node which is pointed by this child (i.e. pointer) -- //
+    unsigned long long key;
+};
+
 struct node_t {
     struct comp_t* comps;    // -- context of a node (i.e. a given component) -- //
-    int num_of_comp;         // -- number of components which are included by this node -- //
-    struct ht_t* hash_table; // -- pointer to children -- //   
+    struct ht_t* hash_table; // -- pointer to children (hashed nodes) -- //   
     struct node_t* parent;
-    /**
-     * Optional fields
-     *    ...
-     */
+    int num_of_comp;         // -- number of components which are included by this node -- //
+    int num_of_children;     // -- number of inline children (small nodes) -- //
+    struct bucket_t children[]; // -- inline children (small nodes) -- //
 };
 
 struct ht_t {
-    struct bucket_t* buckets;
-    int size;
-    int used;
+    struct bucket_t* buckets; // -- slots (in the same block as the header) -- //
+    unsigned char* tags;      // -- fingerprint of each slot, padded to a whole group -- //
+    int size;                 // -- number of slots -- //
+    int used;                 // -- number of occupied slots -- //
+    int deleted;              // -- number of tombstones -- //
 };
 
 struct comp_t {
-    char* bytes;  // -- characters of this component -- //
-    int len;      // -- length of this component -- //
-};
-
-struct bucket_t {
-    struct node_t* next_node;    // -- the node which is pointed by this child (i.e. pointer) -- //
-    unsigned long long key;
-    // -- we use chaining for collision resolution -- //
-    struct bucket_t* next_bucket; 
-    struct bucket_t* pre_bucket;
-    bool head;
+    unsigned long long key;  // -- hash of this component (see ht_keygen) -- //
+    unsigned int id;         // -- the component in the pool of the trie (see cp_pool.h) -- //
+    int len;                 // -- length of this component -- //
 };
 
 struct ct_instance {
     struct node_t root;
     struct t_stat* trie_stat;
-    struct bucket_t** visitedChildren; // -- used by remove function -- //
-    char** comps_array;                // -- extracted name components (used by lookup) -- //
     int ht_init_size;                  // -- the initial size of hash tables -- //
+    struct ep_domain_t epoch;          // -- reclamation of what concurrent readers may still use -- //
+    struct ar_arena_t arena;           // -- memory of all nodes, components and hash tables -- //
+    struct cp_pool_t pool;             // -- distinct components (nodes keep their IDs) -- //
 };
 
+/* ----------------------------------------------------------------------------------------
+ * Scratch state of a single caller (e.g. a thread). Lookups do not write to the instance,
+ * so any number of callers can look up names in the same trie, each with its own context.
+ *
+ * A reader which runs while the (single) writer inserts or removes names, has to attach
+ * its context to the trie (trie_ctx_init(.., true)), so that nothing it reads is freed
+ * under its feet.
+ * ---------------------------------------------------------------------------------------- */
+struct ct_ctx {
+    struct bucket_t* visitedChildren[MAX_HEIGHT]; // -- filled by exact lookup (used by remove function) -- //
+    struct ep_record_t* reader;                   // -- epoch record of a concurrent reader (NULL otherwise) -- //
+};
+
+struct cm_tokenizer_t;
+struct cm_span_t;
+
 /* -------------- main functions ---------------*/
 struct node_t* trie_insert (struct ct_instance*, const char*, bool);   // -- insert a name if it is not already there -- //
-struct node_t* trie_do_insert (struct ct_instance*, struct node_t*, char**, int /*comp_walker*/, int /*all_comp*/, bool);
-struct node_t* trie_node_partition (struct ct_instance*, struct bucket_t* /*pointer to the node to partition*/, char**, int /*num of comps*/, int /*comp_walker*/, int/*node_comp_walker*/, bool);
+struct node_t* trie_do_insert (struct ct_instance*, struct bucket_t* /*pointer to the node (NULL for root)*/, struct node_t*, struct cm_tokenizer_t*, struct cm_span_t* /*current component*/, bool);
+struct node_t* trie_node_partition (struct ct_instance*, struct bucket_t* /*pointer to the node to partition*/, struct cm_tokenizer_t*, struct cm_span_t* /*current component*/, int/*node_comp_walker*/, bool);
+
+struct node_t* trie_node_merge (struct ct_instance*, struct bucket_t* /*child which points to the parent*/, struct bucket_t* /*child being removed (ignored)*/);
+struct node_t* trie_lookup (struct ct_instance*, struct ct_ctx* /*NULL if not exact_match*/, const char*, bool /*printf_flag*/, bool /*exact_match*/);   // -- lookup a given name -- //
+int trie_lookup_batch (struct ct_instance*, struct ct_ctx*, const char** /*names*/, int /*number of names*/, struct node_t** /*results*/, int /*group size*/);
+int trie_remove (struct ct_instance*, struct ct_ctx*, const char*, bool);   // -- remove a given name -- //
 
-struct node_t* trie_node_merge (struct ct_instance*, struct bucket_t* /*child which points to the parent*/);
-struct node_t* trie_lookup (struct ct_instance*, const char*, bool /*printf_flag*/, bool /*exact_match*/, struct bucket_t** /*visitedChildren*/);   // -- lookup a given name -- //
-int trie_remove (struct ct_instance*, const char*, bool);   // -- remove a given name -- //
+void trie_free_node (struct ct_instance*, struct node_t*);
+void trie_do_free_node (struct ct_instance*, struct node_t*);
+void trie_reclaim_node (void* /*trie instance*/, void* /*node*/);
 
-void trie_free_node (struct node_t*);
-void trie_do_free_node (struct node_t*);
+int trie_ctx_init (struct ct_instance*, struct ct_ctx*, bool /*concurrent reader*/);
+void trie_ctx_free (struct ct_ctx*);
 #endif /* ct_TRIE_H */
 
 
@@ -30,7 +30,7 @@
 
 void db_dfs (struct ct_instance*, bool);
 int db_do_dfs (struct ct_instance*, struct node_t* /*next_node*/, struct node_t* /*parent node*/, int /*height*/, struct t_stat*, signed int/*p_id*/, bool);
-void db_print_node (struct node_t*);
-void db_print_node_to_file (struct node_t* /*next_node*/, struct node_t* /*parent_node*/, signed int /*next_node id*/, signed int /*parent id*/);
+void db_print_node (struct ct_instance*, struct node_t*);
+void db_print_node_to_file (struct ct_instance*, struct node_t* /*next_node*/, struct node_t* /*parent_node*/, signed int /*next_node id*/, signed int /*parent id*/);
 
 #endif /* -- db_DEBUG_H -- */
@@ -43,6 +43,7 @@ struct t_stat {
     int* width;        // -- number of nodes at each level -- //
     float chain_length; // -- sum of lengths of chainis --//
     long long ht_size; //-- sum of hash table sizes--// 
+    int kinds[3];      // -- number of nodes of each kind (see CT_NODE_KIND) -- //
 };
 
 struct linkedList_t {
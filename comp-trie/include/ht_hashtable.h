@@ -31,9 +31,27 @@
 #ifndef HT_INIT_SIZE
 #define HT_INIT_SIZE 1
 #endif
+#define HT_GROUP_SIZE 16   // -- slots probed at once (width of an SSE2 register) -- //
 
-struct bucket_t* ht_lookup (struct ct_instance*, struct node_t*, char*, bool);
-struct bucket_t* ht_insert (struct ct_instance*, struct node_t*, char*, bool);
-unsigned long long ht_keygen (char*);
+// -- tags: a full slot keeps the low 7 bits of its key, the others have the high bit set -- //
+#define HT_EMPTY    0x80
+#define HT_DELETED  0xFE
+#define HT_SENTINEL 0xFF   // -- padding of tables smaller than a group -- //
+#define HT_IS_FULL(tag) (!((tag) & 0x80))
+
+struct bucket_t* ht_lookup (struct ct_instance*, struct node_t*, unsigned int /*id*/, unsigned long long /*key*/, bool);
+struct bucket_t* ht_lookup_key (struct ht_t*, unsigned long long /*key*/);   // -- the first component is NOT verified -- //
+void ht_prefetch (struct ht_t*, unsigned long long /*key*/);
+struct bucket_t* ht_small_lookup (struct node_t*, unsigned long long /*key*/, unsigned int /*id, CP_UNKNOWN: key only*/);
+struct bucket_t* ht_next_child (struct node_t*, int* /*position (start from 0)*/);   // -- iterate children of any kind -- //
+int ht_num_of_children (struct node_t*);
+struct ht_t* ht_build (struct ct_instance*, struct bucket_t* /*children*/, int /*number of children*/);
+struct bucket_t* ht_insert (struct ct_instance*, struct node_t*, unsigned int /*id*/, unsigned long long /*key*/, struct node_t* /*child*/, bool);
+void ht_delete (struct ht_t*, struct bucket_t*);
+unsigned long long ht_keygen (const char*, int /*len*/);
 void ht_rehash (struct ct_instance*, struct node_t*, bool);
+struct ht_t* ht_alloc (struct ct_instance*, int /*number of slots*/);
+void ht_free (struct ct_instance*, struct ht_t*);
+void ht_reclaim (void* /*trie instance*/, void* /*hash table*/);   // -- reclaim function of a retired table -- //
+int ht_probe_length (struct ht_t*, int /*slot*/);
 #endif /* -- end of ht_HASHTABLE_H -- */
@@ -34,4 +34,30 @@ void print_inst (char*);     // -- program help -- //
 void print_summary (struct ct_instance*, double, double, double, bool, bool);   // -- summary of program after running -- //
 void warmup (struct ct_instance*, bool, bool, bool);                            // -- a group of test cases -- //
 void free_ct (struct ct_instance*);
+void eval_threads (struct ct_instance*, char** /*names*/, int /*number of names*/, int /*max number of threads*/);
+void eval_rw (struct ct_instance*, char** /*names*/, int /*number of names*/, int /*number of readers*/);
+
+#define RW_BUCKET_NS 8          // -- width of a latency bucket (ns) -- //
+#define RW_NUM_OF_BUCKETS 8192  // -- the last bucket keeps all longer latencies -- //
+
+// -- work of a single thread in the multi-threaded lookup benchmark -- //
+struct mt_arg_t {
+    struct ct_instance* ct;
+    char** names;
+    int num_of_names;
+    int first;          // -- index of the first name to look up -- //
+    long long found;    // -- number of found names -- //
+};
+
+// -- work of a reader (or the writer) in the reader/writer benchmark -- //
+struct rw_arg_t {
+    struct ct_instance* ct;
+    char** names;
+    int num_of_names;
+    int first;              // -- index of the first name to look up -- //
+    long long found;        // -- number of found names (reader) -- //
+    long long updates;      // -- number of removals and insertions (writer) -- //
+    unsigned long long* hist;   // -- latency histogram (reader) -- //
+    volatile int* stop;     // -- set when all readers are done (writer) -- //
+};
 #endif /* MAIN_H */
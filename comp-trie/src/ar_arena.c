@@ -0,0 +1,196 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * For list of authors, please see AUTHORS.md file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#include "ar_arena.h"
+
+#define AR_HEADER_SIZE ((sizeof(struct ar_chunk_t) + AR_ALIGN - 1) & ~(size_t)(AR_ALIGN - 1))
+
+/* ---------------------------------------------------------------------
+ * Method: ar_class (..)
+ * Scope: Private
+ *
+ * Description:
+ * Find the size class of a block, and the size of the blocks of that
+ * class. Small blocks are rounded up to 8 bytes; larger ones to a
+ * quarter of their power of two (i.e. at most 25% is wasted).
+ * --------------------------------------------------------------------- */
+static inline int
+ar_class (size_t size, size_t* class_size)
+{
+    int p;
+    size_t step;
+    int sub;
+
+    if (!size)
+        size = 1;
+    if (size <= AR_SMALL_MAX)
+    {
+        *class_size = (size + AR_ALIGN - 1) & ~(size_t)(AR_ALIGN - 1);
+        return (int)(*class_size / AR_ALIGN) - 1;
+    }
+    p = 63 - __builtin_clzll ((unsigned long long)(size - 1));  // -- 2^p < size <= 2^(p+1) -- //
+    step = (size_t)1 << (p - 2);
+    sub = (int)((size - 1 - ((size_t)1 << p)) / step);
+    *class_size = ((size_t)1 << p) + (sub + 1) * step;
+    return AR_SMALL_MAX / AR_ALIGN + (p - 8) * 4 + sub;
+} /* -- end of ar_class (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ar_new_chunk (..)
+ * Scope: Private
+ *
+ * Description:
+ * Take a new chunk (with room for at least a given size) from the
+ * system, and link it to the arena.
+ * --------------------------------------------------------------------- */
+static struct ar_chunk_t*
+ar_new_chunk (struct ar_arena_t* ar, size_t size)
+{
+    struct ar_chunk_t* chunk = (struct ar_chunk_t*)malloc(AR_HEADER_SIZE + size);
+
+    if (!chunk)
+    {
+        fprintf (stderr, "[ar_new_chunk] ERROR: Memory allocation has been failed.\n");
+        return 0;
+    }
+    chunk->size = AR_HEADER_SIZE + size;
+    chunk->next = ar->chunks;
+    ar->chunks = chunk;
+    ar->reserved += chunk->size;
+    ar->num_of_chunks++;
+    return chunk;
+} /* -- end of ar_new_chunk (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ar_init (..)
+ * Scope: Global
+ *
+ * Description:
+ * Initialize an (empty) arena. No memory is taken before the first use.
+ * --------------------------------------------------------------------- */
+void
+ar_init (struct ar_arena_t* ar)
+{
+    assert (ar);
+
+    memset (ar, 0, sizeof(struct ar_arena_t));
+} /* -- end of ar_init (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ar_destroy (..)
+ * Scope: Global
+ *
+ * Description:
+ * Release all chunks of an arena at once. Every block which is taken
+ * from the arena is gone then.
+ * --------------------------------------------------------------------- */
+void
+ar_destroy (struct ar_arena_t* ar)
+{
+    assert (ar);
+    struct ar_chunk_t* chunk = ar->chunks;
+    struct ar_chunk_t* next;
+
+    while (chunk)
+    {
+        next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    ar_init (ar);
+} /* -- end of ar_destroy (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ar_alloc (..)
+ * Scope: Global
+ *
+ * Description:
+ * Take a block of a given size from the arena.
+ *
+ * RETURN:
+ *    the block (aligned to AR_ALIGN), or NULL if there is no memory.
+ * --------------------------------------------------------------------- */
+void*
+ar_alloc (struct ar_arena_t* ar, size_t size)
+{
+    assert (ar);
+    size_t class_size;
+    int class = ar_class (size, &class_size);
+    void* block;
+    struct ar_chunk_t* chunk;
+
+    assert (class < AR_NUM_OF_CLASSES);
+
+    // -- reuse a released block of the same class -- //
+    if ((block = ar->free_list[class]))
+    {
+        ar->free_list[class] = *(void**)block;
+        ar->used += size;
+        return block;
+    }
+    if (class_size >= AR_DEDICATED_MIN)
+    {
+        if (!(chunk = ar_new_chunk (ar, class_size)))
+            return 0;
+        ar->used += size;
+        return (char*)chunk + AR_HEADER_SIZE;
+    }
+    if ((size_t)(ar->end - ar->cur) < class_size)
+    {
+        // -- the rest of the current chunk is left unused -- //
+        if (!(chunk = ar_new_chunk (ar, AR_CHUNK_SIZE)))
+            return 0;
+        ar->cur = (char*)chunk + AR_HEADER_SIZE;
+        ar->end = (char*)chunk + chunk->size;
+    }
+    block = ar->cur;
+    ar->cur += class_size;
+    ar->used += size;
+    return block;
+} /* -- end of ar_alloc (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ar_free (..)
+ * Scope: Global
+ *
+ * Description:
+ * Give a block back to the arena. The size must be the one which has
+ * been passed to ar_alloc. The block is kept for reuse.
+ * --------------------------------------------------------------------- */
+void
+ar_free (struct ar_arena_t* ar, void* block, size_t size)
+{
+    assert (ar);
+    size_t class_size;
+    int class;
+
+    if (!block)
+        return;
+    class = ar_class (size, &class_size);
+    *(void**)block = ar->free_list[class];
+    ar->free_list[class] = block;
+    ar->used -= size;
+} /* -- end of ar_free (..) -- */
@@ -26,16 +26,17 @@
 #include <ctype.h>
 #include "cm_component.h"
 #include "ct_trie.h"
+#include "ht_hashtable.h"
+
+const char cm_eon[2] = {(char)EON, '\0'};
 
 /* --------------------------------------------------------------------------
- * Method: cm_extract_comps
+ * Method: cm_tokenizer_init
  * Scope: private
  *
  * Description:
- * This function extracts all components of a given name, where the delimiter
- * is SLASH. After extracting components, the component array will be ended 
- * with EON component (i.e. /0x01). So, all the names in this trie have this
- * component as their last component.
+ * Prepare a tokenizer to extract components of a given name, where the
+ * delimiter is SLASH. Nothing is extracted here (see cm_next_comp).
  *
  * NOTE:
  *    If you want to print the output, turn ON the flag!
@@ -45,79 +46,120 @@
  *    0: DONE!
  * -------------------------------------------------------------------------- */
 int
-cm_extract_comps (const char* name, char** comps_array, bool print_flag)
+cm_tokenizer_init (struct cm_tokenizer_t* tok, const char* name, bool print_flag)
 {
+    assert (tok);
     assert (name);
 
-    int comp_walker = 0;    // -- index of the current component (i.e. node) -- //
-    const char del[2] = "/";
-    char *token;
-    char *t_name;
-
-    if (strlen(name) < 2)
+    if (!name[0] || !name[1])
     {
         // -- a name with length of ONE? -- //
-        fprintf (stderr, "[cm_extract_comps] ERROR: A name with len of ONE or ZERO.\n");
+        fprintf (stderr, "[cm_tokenizer_init] ERROR: A name with len of ONE or ZERO.\n");
         return 1;
     }
-
-    // -- extracting components -- //
     if (name[0] != (char)SLASH)
     {
         // -- all names should start with SLASH -- //
-        fprintf (stderr, "[cm_extract_comps] ERROR: All names should start with slash:   %s\n", name);
+        fprintf (stderr, "[cm_tokenizer_init] ERROR: All names should start with slash:   %s\n", name);
         return 1;
     }
-    t_name = (char*)malloc(strlen(name) + 1);
-    strcpy (t_name, name);
+    tok->name = name;
+    tok->pos = 1;
+    tok->count = 0;
 
     if (print_flag)
-    { 
-        printf ("===============\n");
-        printf ("Name:   %s::", name);
-    }
+        cm_print_comps (name);
+    return 0;
+} /* -- end of cm_tokenizer_init (..) -- */
+
+/* --------------------------------------------------------------------------
+ * Method: cm_next_comp
+ * Scope: private
+ *
+ * Description:
+ * Extract the next component of the name. Empty components (i.e. repeated
+ * slashes) are skipped. After the last component, the EON component (i.e.
+ * /0x01) is extracted. So, all the names in this trie have this component
+ * as their last component. The length and the hash of the component are
+ * computed here, once, and the rest of the trie reuses them.
+ *
+ * RETURN:
+ *    1: a component is extracted
+ *    0: no more components
+ *   -1: ERROR
+ * -------------------------------------------------------------------------- */
+int
+cm_next_comp (struct cm_tokenizer_t* tok, struct cm_span_t* span)
+{
+    const char* name = tok->name;
+    int pos = tok->pos;
+
+    if (pos < 0)
+        return 0;  // -- EON is already extracted -- //
 
-    token = strtok (t_name, del);  
-    while (token != NULL)
+    while (name[pos] == (char)SLASH)
+        pos++;
+    if (!name[pos])
     {
-        comps_array[comp_walker] = (char*)realloc(comps_array[comp_walker], (strlen(token) + 1)); 
-        strcpy(comps_array[comp_walker], token);
-        comps_array[comp_walker][strlen(token)] = '\0'; 
-        comp_walker++;
-        if (comp_walker == MAX_NUM_OF_COMPS)
+        if (!tok->count)
         {
-            fprintf (stderr, "[cm_extract_comps] WARNING: Number of components is greater than set MAX.\n\t%s", t_name);
-            free(t_name);
-            return 1;
+            fprintf (stderr, "[cm_next_comp] WARNING: A name with no valid component.\n\t%s\n", name);
+            return -1;
         }
-        token = strtok(NULL, del); 
-    }      
-    if (!comp_walker)
-    {
-        fprintf (stderr, "[cm_extract_comps] WARNING: A name with no valid component.\n\t%s", t_name);
-        free(t_name);
+        // -- we add another component to all names to mark their ending -- //
+        span->offset = CM_EON_OFFSET;
+        span->len = 1;
+        span->key = ht_keygen (cm_eon, 1);
+        span->id = CP_UNKNOWN;
+        tok->pos = -1;
+        tok->count++;
         return 1;
     }
+    if (tok->count == MAX_NUM_OF_COMPS - 1)
+    {
+        fprintf (stderr, "[cm_next_comp] WARNING: Number of components is greater than set MAX.\n\t%s\n", name);
+        return -1;
+    }
 
-    // -- we add another component to all names to mark their ending -- //
-    comps_array[comp_walker] = (char*)realloc(comps_array[comp_walker], 2);
-    comps_array[comp_walker][0] = (char)EON;
-    comps_array[comp_walker][1] = '\0';
-    comp_walker++;
+    span->offset = pos;
+    while (name[pos] && name[pos] != (char)SLASH)
+        pos++;
+    span->len = pos - span->offset;
+    span->key = ht_keygen (name + span->offset, span->len);  // -- the only place a component is hashed -- //
+    span->id = CP_UNKNOWN;
+    tok->pos = pos;
+    tok->count++;
+    return 1;
+} /* -- end of cm_next_comp (..) -- */
 
-    if (print_flag)
-    { 
-        printf ("%u\n", comp_walker);
-        printf ("Comps:  ");
-        for (int i=0; i<comp_walker; i++)
-        {
-            if (isprint(comps_array[i][0]))
-                printf("<%s>", comps_array[i]);
-            else
-                printf ("<%u>", (int)comps_array[i][0]);
-        }
-        printf ("\n===============\n");
+/* --------------------------------------------------------------------------
+ * Method: cm_print_comps
+ * Scope: private
+ *
+ * Description:
+ * Print all components of a given name (only used in print mode).
+ * -------------------------------------------------------------------------- */
+void
+cm_print_comps (const char* name)
+{
+    struct cm_tokenizer_t tok;
+    struct cm_span_t span;
+    const char* bytes;
+
+    tok.name = name;
+    tok.pos = 1;
+    tok.count = 0;
+
+    printf ("===============\n");
+    printf ("Name:   %s\n", name);
+    printf ("Comps:  ");
+    while (cm_next_comp (&tok, &span) == 1)
+    {
+        bytes = CM_SPAN_BYTES(&tok, &span);
+        if (isprint(bytes[0]))
+            printf("<%.*s>", span.len, bytes);
+        else
+            printf ("<%u>", (int)bytes[0]);
     }
-    free(t_name);
-    return 0;
-} /* -- end of cm_extract_comps (..) -- */
+    printf ("\n===============\n");
+} /* -- end of cm_print_comps (..) -- */
@@ -0,0 +1,413 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * For list of authors, please see AUTHORS.md file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#include "cp_pool.h"
+#include "ct_trie.h"
+#include "ep_epoch.h"
+#include "ar_arena.h"
+
+#define CP_INDEX_SIZE(size) (sizeof(struct cp_index_t) + sizeof(struct cp_slot_t) * (size))
+#define CP_IDS_SIZE(size) (sizeof(struct cp_ids_t) + sizeof(struct cp_string_t*) * (size))
+#define CP_STRING_SIZE(len) (sizeof(struct cp_string_t) + (len) + 1)
+#define CP_LIMIT(size) ((size) - (size) / 4)  // -- max load of the index (3/4) -- //
+
+/* ---------------------------------------------------------------------
+ * Method: cp_index_alloc (..)
+ * Scope: Private
+ *
+ * Description:
+ * Allocate an empty index with a given number of slots (power of two).
+ * --------------------------------------------------------------------- */
+static struct cp_index_t*
+cp_index_alloc (struct ct_instance* ct, int size)
+{
+    struct cp_index_t* index = (struct cp_index_t*)ar_alloc(&ct->arena, CP_INDEX_SIZE(size));
+
+    if (!index)
+    {
+        fprintf (stderr, "[cp_index_alloc] ERROR: Memory allocation has been failed.\n");
+        return 0;
+    }
+    index->size = size;
+    index->used = 0;
+    index->deleted = 0;
+    memset (index->slots, 0, sizeof(struct cp_slot_t) * size);  // -- CP_NONE -- //
+    return index;
+} /* -- end of cp_index_alloc (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: cp_reclaim_index (..)
+ * Scope: Private
+ *
+ * Description:
+ * Release a retired index (see ep_retire).
+ * --------------------------------------------------------------------- */
+static void
+cp_reclaim_index (void* arg, void* ptr)
+{
+    struct ct_instance* ct = (struct ct_instance*)arg;
+
+    ar_free (&ct->arena, ptr, CP_INDEX_SIZE(((struct cp_index_t*)ptr)->size));
+} /* -- end of cp_reclaim_index (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: cp_reclaim_ids (..)
+ * Scope: Private
+ *
+ * Description:
+ * Release a retired ID table (see ep_retire).
+ * --------------------------------------------------------------------- */
+static void
+cp_reclaim_ids (void* arg, void* ptr)
+{
+    struct ct_instance* ct = (struct ct_instance*)arg;
+
+    ar_free (&ct->arena, ptr, CP_IDS_SIZE(((struct cp_ids_t*)ptr)->size));
+} /* -- end of cp_reclaim_ids (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: cp_find (..)
+ * Scope: Private
+ *
+ * Description:
+ * Probe an index for a given component. Readers may call it while the
+ * writer changes the pool: the ID of a slot is published after its hash,
+ * and the string of an ID is published before the ID.
+ *
+ * RETURN:
+ *    ID of the component, or CP_NONE if it is not interned.
+ * --------------------------------------------------------------------- */
+static unsigned int
+cp_find (struct ct_instance* ct, struct cp_index_t* index, const char* bytes, int len, unsigned long long key)
+{
+    unsigned int hash = CP_HASH(key);
+    unsigned int mask = (unsigned int)index->size - 1;
+    unsigned int slot = hash & mask;
+    unsigned int id;
+    struct cp_ids_t* ids;
+    struct cp_string_t* string;
+
+    for (int probe=0; probe < index->size; probe++)
+    {
+        id = EP_LOAD(index->slots[slot].id);
+        if (id == CP_NONE)
+            return CP_NONE;
+        if (id != CP_DELETED && EP_LOAD(index->slots[slot].hash) == hash)
+        {
+            // -- load the ID table after the ID, so the ID is in it -- //
+            ids = EP_LOAD(ct->pool.ids);
+            string = (id < ids->size) ? EP_LOAD(ids->strings[id]) : 0;
+            // -- keys may collide, so make sure contents are equal as well -- //
+            if (string && string->len == len && !memcmp (string->bytes, bytes, len))
+                return id;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return CP_NONE;
+} /* -- end of cp_find (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: cp_place (..)
+ * Scope: Private
+ *
+ * Description:
+ * Put an ID in the first free slot on the probing sequence of its hash.
+ * The caller makes sure the index is not full.
+ * --------------------------------------------------------------------- */
+static void
+cp_place (struct cp_index_t* index, unsigned int hash, unsigned int id)
+{
+    unsigned int mask = (unsigned int)index->size - 1;
+    unsigned int slot = hash & mask;
+
+    while (index->slots[slot].id != CP_NONE && index->slots[slot].id != CP_DELETED)
+        slot = (slot + 1) & mask;
+    if (index->slots[slot].id == CP_DELETED)
+        index->deleted--;
+    EP_PUBLISH(index->slots[slot].hash, hash);
+    EP_PUBLISH(index->slots[slot].id, id);
+    index->used++;
+} /* -- end of cp_place (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: cp_index_grow (..)
+ * Scope: Private
+ *
+ * Description:
+ * Rebuild the index aside (twice as large, unless it is mostly filled
+ * with tombstones), publish it, and retire the old one.
+ *
+ * RETURN:
+ *    0: DONE!
+ *    1: ERROR (no memory)
+ * --------------------------------------------------------------------- */
+static int
+cp_index_grow (struct ct_instance* ct)
+{
+    struct cp_index_t* old_index = ct->pool.index;
+    struct cp_index_t* new_index;
+    int new_size = (old_index->used + 1 > CP_LIMIT(old_index->size) / 2) ? old_index->size * 2 : old_index->size;
+
+    if (!(new_index = cp_index_alloc (ct, new_size)))
+        return 1;
+    for (int i=0; i < old_index->size; i++)
+    {
+        if (old_index->slots[i].id != CP_NONE && old_index->slots[i].id != CP_DELETED)
+            cp_place (new_index, old_index->slots[i].hash, old_index->slots[i].id);
+    }
+    EP_PUBLISH(ct->pool.index, new_index);
+    ep_retire (&ct->epoch, old_index, cp_reclaim_index);
+    return 0;
+} /* -- end of cp_index_grow (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: cp_ids_grow (..)
+ * Scope: Private
+ *
+ * Description:
+ * Double the ID table (aside) and the list of free IDs.
+ *
+ * RETURN:
+ *    0: DONE!
+ *    1: ERROR (no memory)
+ * --------------------------------------------------------------------- */
+static int
+cp_ids_grow (struct ct_instance* ct)
+{
+    struct cp_pool_t* pool = &ct->pool;
+    struct cp_ids_t* old_ids = pool->ids;
+    struct cp_ids_t* new_ids;
+    unsigned int* free_ids;
+    unsigned int new_size = old_ids->size * 2;
+
+    new_ids = (struct cp_ids_t*)ar_alloc(&ct->arena, CP_IDS_SIZE(new_size));
+    free_ids = (unsigned int*)ar_alloc(&ct->arena, sizeof(unsigned int) * new_size);
+    if (!new_ids || !free_ids)
+    {
+        fprintf (stderr, "[cp_ids_grow] ERROR: Memory allocation has been failed.\n");
+        ar_free (&ct->arena, new_ids, CP_IDS_SIZE(new_size));
+        ar_free (&ct->arena, free_ids, sizeof(unsigned int) * new_size);
+        return 1;
+    }
+    new_ids->size = new_size;
+    memcpy (new_ids->strings, old_ids->strings, sizeof(struct cp_string_t*) * old_ids->size);
+    memset (new_ids->strings + old_ids->size, 0, sizeof(struct cp_string_t*) * (new_size - old_ids->size));
+    // -- free IDs are the writer's, no reader sees them -- //
+    memcpy (free_ids, pool->free_ids, sizeof(unsigned int) * pool->num_of_free_ids);
+    ar_free (&ct->arena, pool->free_ids, sizeof(unsigned int) * old_ids->size);
+    pool->free_ids = free_ids;
+
+    EP_PUBLISH(pool->ids, new_ids);
+    ep_retire (&ct->epoch, old_ids, cp_reclaim_ids);
+    return 0;
+} /* -- end of cp_ids_grow (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: cp_init (..)
+ * Scope: Global
+ *
+ * Description:
+ * Initialize the (empty) component pool of a trie. The arena of the
+ * trie should be initialized beforehand.
+ *
+ * RETURN:
+ *    0: DONE!
+ *    1: ERROR (no memory)
+ * --------------------------------------------------------------------- */
+int
+cp_init (struct ct_instance* ct)
+{
+    assert (ct);
+    struct cp_pool_t* pool = &ct->pool;
+
+    memset (pool, 0, sizeof(struct cp_pool_t));
+    pool->next_id = CP_NONE + 1;
+    pool->index = cp_index_alloc (ct, CP_INIT_SIZE * 2);  // -- power of two -- //
+    pool->ids = (struct cp_ids_t*)ar_alloc(&ct->arena, CP_IDS_SIZE(CP_INIT_SIZE));
+    pool->free_ids = (unsigned int*)ar_alloc(&ct->arena, sizeof(unsigned int) * CP_INIT_SIZE);
+    if (!pool->index || !pool->ids || !pool->free_ids)
+    {
+        fprintf (stderr, "[cp_init] ERROR: Memory allocation has been failed.\n");
+        return 1;
+    }
+    pool->ids->size = CP_INIT_SIZE;
+    memset (pool->ids->strings, 0, sizeof(struct cp_string_t*) * CP_INIT_SIZE);
+    return 0;
+} /* -- end of cp_init (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: cp_lookup (..)
+ * Scope: Global
+ *
+ * Description:
+ * Find the ID of a given component (no reference is taken). Readers
+ * call it inside their read section.
+ *
+ * RETURN:
+ *    ID of the component, or CP_NONE if no node holds the component.
+ * --------------------------------------------------------------------- */
+unsigned int
+cp_lookup (struct ct_instance* ct, const char* bytes, int len, unsigned long long key)
+{
+    assert (ct);
+
+    return cp_find (ct, EP_LOAD(ct->pool.index), bytes, len, key);
+} /* -- end of cp_lookup (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: cp_intern (..)
+ * Scope: Global
+ *
+ * Description:
+ * Take a reference to a given component. The component is added to the
+ * pool, if it is not there.
+ *
+ * RETURN:
+ *    ID of the component, or CP_NONE if there is no memory.
+ * --------------------------------------------------------------------- */
+unsigned int
+cp_intern (struct ct_instance* ct, const char* bytes, int len, unsigned long long key)
+{
+    assert (ct);
+    struct cp_pool_t* pool = &ct->pool;
+    struct cp_string_t* string;
+    unsigned int id;
+
+    if ((id = cp_find (ct, pool->index, bytes, len, key)) != CP_NONE)
+        return cp_ref (ct, id);
+
+    // -- a new component -- //
+    if (pool->index->used + pool->index->deleted + 1 > CP_LIMIT(pool->index->size) && cp_index_grow (ct))
+        return CP_NONE;
+    if (!pool->num_of_free_ids && pool->next_id == pool->ids->size && cp_ids_grow (ct))
+        return CP_NONE;
+    if (!(string = (struct cp_string_t*)ar_alloc(&ct->arena, CP_STRING_SIZE(len))))
+    {
+        fprintf (stderr, "[cp_intern] ERROR: Memory allocation has been failed.\n");
+        return CP_NONE;
+    }
+    id = pool->num_of_free_ids ? pool->free_ids[--pool->num_of_free_ids] : pool->next_id++;
+    string->hash = CP_HASH(key);
+    string->id = id;
+    string->len = len;
+    string->refs = 1;
+    memcpy (string->bytes, bytes, len);
+    string->bytes[len] = '\0';
+
+    // -- the string is complete before its ID is published -- //
+    EP_PUBLISH(pool->ids->strings[id], string);
+    cp_place (pool->index, string->hash, id);
+
+    pool->num_of_strings++;
+    pool->num_of_refs++;
+    pool->bytes += len + 1;
+    pool->ref_bytes += len + 1;
+    return id;
+} /* -- end of cp_intern (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: cp_ref (..)
+ * Scope: Global
+ *
+ * Description:
+ * Take one more reference to an interned component (e.g. when the
+ * components of a node are copied to another node).
+ *
+ * RETURN:
+ *    the given ID.
+ * --------------------------------------------------------------------- */
+unsigned int
+cp_ref (struct ct_instance* ct, unsigned int id)
+{
+    assert (ct);
+    struct cp_string_t* string = ct->pool.ids->strings[id];
+
+    string->refs++;
+    ct->pool.num_of_refs++;
+    ct->pool.ref_bytes += string->len + 1;
+    return id;
+} /* -- end of cp_ref (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: cp_release (..)
+ * Scope: Global
+ *
+ * Description:
+ * Drop a reference to a component. The last reference takes the
+ * component out of the index, and retires its string.
+ * --------------------------------------------------------------------- */
+void
+cp_release (struct ct_instance* ct, unsigned int id)
+{
+    assert (ct);
+    struct cp_pool_t* pool = &ct->pool;
+    struct cp_string_t* string;
+    unsigned int mask;
+    unsigned int slot;
+
+    if (id == CP_NONE || id >= pool->ids->size || !(string = pool->ids->strings[id]))
+    {
+        fprintf (stderr, "[cp_release] ERROR: Component %u is not interned.\n", id);
+        return;
+    }
+    pool->num_of_refs--;
+    pool->ref_bytes -= string->len + 1;
+    if (--string->refs)
+        return;
+
+    // -- the last reference is gone -- //
+    mask = (unsigned int)pool->index->size - 1;
+    slot = string->hash & mask;
+    while (pool->index->slots[slot].id != id)
+        slot = (slot + 1) & mask;
+    EP_PUBLISH(pool->index->slots[slot].id, CP_DELETED);
+    pool->index->used--;
+    pool->index->deleted++;
+    pool->num_of_strings--;
+    pool->bytes -= string->len + 1;
+    ep_retire (&ct->epoch, string, cp_reclaim_string);
+} /* -- end of cp_release (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: cp_reclaim_string (..)
+ * Scope: Global
+ *
+ * Description:
+ * Release a retired string (see ep_retire; the argument is the trie
+ * instance). Its ID is free to take from now on.
+ * --------------------------------------------------------------------- */
+void
+cp_reclaim_string (void* arg, void* ptr)
+{
+    assert (arg);
+    assert (ptr);
+    struct ct_instance* ct = (struct ct_instance*)arg;
+    struct cp_string_t* string = (struct cp_string_t*)ptr;
+
+    EP_PUBLISH(ct->pool.ids->strings[string->id], 0);
+    ct->pool.free_ids[ct->pool.num_of_free_ids++] = string->id;
+    ar_free (&ct->arena, string, CP_STRING_SIZE(string->len));
+} /* -- end of cp_reclaim_string (..) -- */
@@ -29,6 +29,231 @@
 #include "db_debug.h"
 #include "ht_hashtable.h"
 
+/* -----------------------------------------------------------------
+ * Method: trie_span_id (..)
+ * Scope: Private
+ *
+ * Description:
+ * ID of a component of the input name in the pool. It is looked up
+ * once, at the first time it is needed.
+ *
+ * RETURN:
+ *    the ID, or CP_NONE if the component is not interned.
+ * ------------------------------------------------------------------ */
+static inline unsigned int
+trie_span_id (struct ct_instance* ct, struct cm_tokenizer_t* tok, struct cm_span_t* span)
+{
+    if (span->id == CP_UNKNOWN)
+        span->id = cp_lookup (ct, CM_SPAN_BYTES(tok, span), span->len, span->key);
+    return span->id;
+} /* -- end of trie_span_id (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: trie_comp_equal (..)
+ * Scope: Private
+ *
+ * Description:
+ * Compare a component of the input name with a component of a node.
+ * ------------------------------------------------------------------ */
+static inline bool
+trie_comp_equal (struct ct_instance* ct, struct cm_tokenizer_t* tok, struct cm_span_t* span, struct comp_t* comp)
+{
+    // -- reject on the hash before looking up the ID -- //
+    return span->key == comp->key && trie_span_id (ct, tok, span) == comp->id;
+} /* -- end of trie_comp_equal (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: trie_copy_comps (..)
+ * Scope: Private
+ *
+ * Description:
+ * Extract the remaining components of the input name (starting from
+ * the current one) and intern them for a given node. This is the only
+ * place where the bytes of the input name are copied (into the pool).
+ *
+ * RETURN:
+ *    0: DONE!
+ *    1: ERROR (nothing is allocated)
+ * ------------------------------------------------------------------ */
+static int
+trie_copy_comps (struct ct_instance* ct, struct cm_tokenizer_t* tok, struct cm_span_t* span, struct node_t* node)
+{
+    struct cm_span_t spans[MAX_NUM_OF_COMPS];
+    int num_of_comp = 1;
+    int ret;
+
+    spans[0] = *span;
+    while ((ret = cm_next_comp (tok, &spans[num_of_comp])) == 1)
+        num_of_comp++;
+    if (ret < 0)
+        return 1;
+
+    node->num_of_comp = num_of_comp;
+    node->comps = (struct comp_t*)ar_alloc(&ct->arena, sizeof(struct comp_t) * num_of_comp);
+    for (int i=0; i<num_of_comp; i++)
+    {
+        node->comps[i].len = spans[i].len;
+        node->comps[i].key = spans[i].key;
+        if (spans[i].id != CP_UNKNOWN && spans[i].id != CP_NONE)
+            node->comps[i].id = cp_ref (ct, spans[i].id);
+        else if ((node->comps[i].id = cp_intern (ct, CM_SPAN_BYTES(tok, &spans[i]), spans[i].len, spans[i].key)) == CP_NONE)
+        {
+            // -- give back what is taken so far -- //
+            while (i--)
+                cp_release (ct, node->comps[i].id);
+            ar_free (&ct->arena, node->comps, sizeof(struct comp_t) * num_of_comp);
+            node->comps = 0;
+            node->num_of_comp = 0;
+            return 1;
+        }
+    }
+    return 0;
+} /* -- end of trie_copy_comps (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: trie_new_node (..)
+ * Scope: Private
+ *
+ * Description:
+ * Allocate a node with room for a given number of inline children.
+ * Components of the node are set by the caller.
+ * ------------------------------------------------------------------ */
+static struct node_t*
+trie_new_node (struct ct_instance* ct, int num_of_children)
+{
+    struct node_t* node = (struct node_t*)ar_alloc(&ct->arena, CT_NODE_SIZE(num_of_children));
+
+    node->comps = 0;
+    node->num_of_comp = 0;
+    node->hash_table = 0;
+    node->parent = 0;
+    node->num_of_children = num_of_children;
+    return node;
+} /* -- end of trie_new_node (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: trie_adopt_children (..)
+ * Scope: Private
+ *
+ * Description:
+ * Make a node the parent of all its children.
+ * ------------------------------------------------------------------ */
+static void
+trie_adopt_children (struct node_t* node)
+{
+    struct bucket_t* child;
+    int pos = 0;
+
+    while ((child = ht_next_child (node, &pos)))
+        child->next_node->parent = node;
+} /* -- end of trie_adopt_children (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: trie_node_rebuild (..)
+ * Scope: Private
+ *
+ * Description:
+ * Build (aside) the replacement of a node whose children change: the
+ * given child is added, and/or the given child is dropped. The result
+ * is small or hashed, depending on its number of children. Components
+ * of the node are handed over to the replacement (not copied).
+ * ------------------------------------------------------------------ */
+static struct node_t*
+trie_node_rebuild (struct ct_instance* ct, struct node_t* node, struct bucket_t* add, struct bucket_t* skip)
+{
+    struct bucket_t children[CT_SMALL_MAX + 1];
+    struct bucket_t* child;
+    struct node_t* new_node;
+    int num_of_children = 0;
+    int pos = 0;
+
+    while ((child = ht_next_child (node, &pos)))
+    {
+        if (child == skip)
+            continue;
+        if (num_of_children == CT_SMALL_MAX + 1)
+        {
+            fprintf (stderr, "[trie_node_rebuild] ERROR: Too many children for a small node.\n");
+            return 0;
+        }
+        children[num_of_children++] = *child;
+    }
+    if (add)
+    {
+        // -- keep children sorted by their keys -- //
+        int i = num_of_children++;
+        for (; i > 0 && children[i-1].key > add->key; i--)
+            children[i] = children[i-1];
+        children[i] = *add;
+    }
+
+    if (num_of_children > CT_SMALL_MAX)
+    {
+        // -- grow into a hashed node -- //
+        new_node = trie_new_node (ct, 0);
+        if (!(new_node->hash_table = ht_build (ct, children, num_of_children)))
+        {
+            ar_free (&ct->arena, new_node, CT_NODE_SIZE(0));
+            return 0;
+        }
+    }
+    else
+    {
+        if (node->hash_table)
+        {
+            // -- the table is not sorted, and the new node is small -- //
+            for (int i=1; i<num_of_children; i++)
+            {
+                struct bucket_t tmp = children[i];
+                int j = i;
+                for (; j > 0 && children[j-1].key > tmp.key; j--)
+                    children[j] = children[j-1];
+                children[j] = tmp;
+            }
+        }
+        new_node = trie_new_node (ct, num_of_children);
+        memcpy (new_node->children, children, sizeof(struct bucket_t) * num_of_children);
+    }
+    new_node->comps = node->comps;
+    new_node->num_of_comp = node->num_of_comp;
+    new_node->parent = node->parent;
+    trie_adopt_children (new_node);
+    return new_node;
+} /* -- end of trie_node_rebuild (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: trie_reclaim_shell (..)
+ * Scope: Private
+ *
+ * Description:
+ * Reclaim a retired node whose components are handed over to another
+ * node (see trie_node_rebuild), i.e. only the node itself is freed.
+ * ------------------------------------------------------------------ */
+static void
+trie_reclaim_shell (void* arg, void* ptr)
+{
+    struct ct_instance* ct = (struct ct_instance*)arg;
+
+    ar_free (&ct->arena, ptr, CT_NODE_SIZE(((struct node_t*)ptr)->num_of_children));
+} /* -- end of trie_reclaim_shell (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: trie_node_replace (..)
+ * Scope: Private
+ *
+ * Description:
+ * Publish the replacement of a node (built by trie_node_rebuild) and
+ * retire the old node, and its hash table if it is not handed over.
+ * ------------------------------------------------------------------ */
+static void
+trie_node_replace (struct ct_instance* ct, struct bucket_t* pointer, struct node_t* node, struct node_t* new_node)
+{
+    EP_PUBLISH(pointer->next_node, new_node);
+    if (node->hash_table && node->hash_table != new_node->hash_table)
+        ep_retire (&ct->epoch, node->hash_table, ht_reclaim);
+    ep_retire (&ct->epoch, node, trie_reclaim_shell);
+} /* -- end of trie_node_replace (..) -- */
+
 /* -----------------------------------------------------------------
  * Method: trie_insert (..)
  * Scope: Protected
@@ -45,59 +270,26 @@ trie_insert (struct ct_instance* ct, const char* name, bool print_flag)
     assert (ct);
     assert (name);
 
-    int byte_walker = 0;       // -- index of the name -- //
-    int comp_walker = 0;       // -- index of the current component (i.e. node) -- //
-    int node_comp_walker = 0;  // -- index of node's component -- //
-    bool in_node = false;      // -- iterate through node's components, or search children? -- //
-    char* c_component;         // -- the current component -- //
-    struct node_t* node;       // -- node traverser -- // 
-    struct bucket_t* child;    // -- return value of ht_lookup -- //
-    int all_comp = 0;          // -- number of extracted components from the input name -- //
-    bool go_next = false;      // -- if a node was match, but more components need to be matched -- //
-
-    while (ct->comps_array[comp_walker])
-    {
-        free(ct->comps_array[comp_walker]);
-        ct->comps_array[comp_walker] = 0;
-        comp_walker++;
-    }
-    comp_walker = 0;
-    if (strlen(name) < 2)
-    {
-        // -- a name with length of ONE? -- //
-        fprintf (stderr, "[trie_insert] ERROR: A name with len of ONE or ZERO.\n");
-        return 0;
-    }
+    int node_comp_walker = 0;    // -- index of node's component -- //
+    bool in_node = false;        // -- iterate through node's components, or search children? -- //
+    struct cm_tokenizer_t tok;   // -- extracts components of the name on demand -- //
+    struct cm_span_t c_component;// -- the current component -- //
+    struct node_t* node;         // -- node traverser -- // 
+    struct bucket_t* child;      // -- return value of ht_lookup -- //
+    struct bucket_t* node_pointer = 0;  // -- the child which points to the node (NULL for root) -- //
+    int ret;
 
-    // -- extract all name components -- //
-    if (cm_extract_comps (name, ct->comps_array, print_flag))
-    {
-        fprintf (stderr, "[trie_insert] ERROR: A name with len of ONE or ZERO.\n");
-        return 0;
-    }
-    if (!ct->comps_array[0])
+    // -- extract the first component -- //
+    if (cm_tokenizer_init (&tok, name, print_flag) || cm_next_comp (&tok, &c_component) != 1)
     {
-        // -- no component -- //
         fprintf (stderr, "[trie_insert] WARNING: Bad input name:  %s\n", name);
         return 0;
     }
 
-    // -- figure out the number of components -- //
-    while (ct->comps_array[all_comp])
-    {
-        all_comp++; 
-    }
-    if (all_comp == MAX_NUM_OF_COMPS)
-    {
-        fprintf (stderr, "[trie_insert] WARNING: MAX_NUM_OF_COMPS is reached.\n");
-        return 0;
-    }
-    c_component = ct->comps_array[comp_walker];
-
     /* ----------- Welcome to loop party ----------- */
     node = &(ct->root);
     // -- Look up extracted components. If mismatch occured, insert them one-by-one -- //
-    while (c_component)
+    while (true)
     {
         // -- search node's components? -- //
         if (in_node)
@@ -108,41 +300,20 @@ trie_insert (struct ct_instance* ct, const char* name, bool print_flag)
                 fprintf (stderr, "[trie_insert] WARNING: in_node flag is wrongly ON.\n");
                 return 0;
             }
-            if (node_comp_walker >= child->next_node->num_of_comp)   
-            {
-                // -- something is wrong with the previous iteration -- //
-               fprintf (stderr, "[trie_insert] WARNING: node_comp_walker > # of comps.\n");
-               return 0;
-            }
 
             while (node_comp_walker < child->next_node->num_of_comp)
             {
-                // -- if their lengths are different, this cannot be a match -- //
-                if (strlen(c_component) != child->next_node->comps[node_comp_walker].len)
+                if (!trie_comp_equal (ct, &tok, &c_component, &child->next_node->comps[node_comp_walker]))
                 {
                     // -- get one step back to the last matched component -- //
-                    return (trie_node_partition (ct, child, ct->comps_array, all_comp, comp_walker, node_comp_walker, print_flag));
-                }
-
-                byte_walker = 0;
-                while (byte_walker < strlen(c_component))
-                {
-                    // -- [TODO] We can use memcmp -- //
-                    if (c_component[byte_walker] == child->next_node->comps[node_comp_walker].bytes[byte_walker])
-                    {
-                        byte_walker++;
-                    }
-                    else
-                    {
-                        // -- get one step back to the last matched component -- //
-                        return (trie_node_partition (ct, child, ct->comps_array, all_comp, comp_walker, node_comp_walker, print_flag));
-                    }
+                    return (trie_node_partition (ct, child, &tok, &c_component, node_comp_walker, print_flag));
                 } // -- this component was a match, go for the next component -- //
 
-                comp_walker++;
                 node_comp_walker++;
-                if (comp_walker >= all_comp)
+                if ((ret = cm_next_comp (&tok, &c_component)) != 1)
                 {
+                    if (ret < 0)
+                        return 0;
                     /**
                      * The input name is found, so this should be
                      * the last component of the current node. 
@@ -157,106 +328,57 @@ trie_insert (struct ct_instance* ct, const char* name, bool print_flag)
                         return 0;
                     } 
                 }
-                if (comp_walker == MAX_NUM_OF_COMPS)
-                {
-                    fprintf (stderr, "[trie_insert] WARNING: MAX_NUM_OF_COMPS is reached.\n");
-                    return 0;
-                }
-                c_component = ct->comps_array[comp_walker]; 
                 if (node_comp_walker >= child->next_node->num_of_comp)   
                 {
-                    // -- this was the last component of this name, continue with out_name search (children lookup) -- //
+                    // -- this was the last component of this node, continue with out_name search (children lookup) -- //
                     node = child->next_node; // -- now it's ready to get out of the loop -- //
+                    node_pointer = child;
                     in_node = false;
                     break;
                 }
-                else
-                    continue; // -- go to the inner while loop -- //
             } // -- end of inner while loop -- //
         } // -- end of if (in_node) -- //
  
         // -- search for this component among the children -- //
-        if (!(child=ht_lookup(ct, node, c_component, print_flag)))
+        if (!(child=ht_lookup(ct, node, trie_span_id (ct, &tok, &c_component), c_component.key, print_flag)))
         {
-            // -- no child is available, so run do_insert -- //
-            return (trie_do_insert (ct, node, ct->comps_array, comp_walker-1, all_comp, print_flag)); 
+            // -- none of the available children are the match, so insertion should be triggered -- //
+            return (trie_do_insert (ct, node_pointer, node, &tok, &c_component, print_flag)); 
         }
-        byte_walker = 0;
-        while (byte_walker < strlen(c_component))
-        {
-            if (strlen(c_component) != child->next_node->comps[0].len)
-            {
-                // -- this child is not a match, go for the next child -- //
-                break;
-            }
-            if (c_component[byte_walker] == child->next_node->comps[0].bytes[byte_walker])
-            {
-                byte_walker++;
-            }
-            else
-            {
-                // -- this child is not a match, go for the next child -- //
-                break;
-            }
-        }
-        if (byte_walker ==  strlen(c_component))
-        {
-            // -- we found the matched child. Jump to the corresponded node -- //
-            /**
-             * If there is more than one component in this node, check the
-             * rest of them. Maybe there are some other components which can
-             * be matched.
-             *
-             * NOTE:
-             *     Do not change the node, as if it comes to node partitionting,
-             *     we need to know the parent of this node.
-             */
-
-            // -- is this the last component of the name? -- //
-            comp_walker++;
-            if (comp_walker >= all_comp)
-            {
-                if (child->next_node->num_of_comp > 1)
-                {
-                    fprintf (stderr, "[trie_insert] WARNING: Found name does hit the end of the node.\n");
-                    return 0;
-                }
-                return child->next_node;
-            } 
+        // -- we found the matched child. Jump to the corresponded node -- //
+        /**
+         * If there is more than one component in this node, check the
+         * rest of them. Maybe there are some other components which can
+         * be matched.
+         *
+         * NOTE:
+         *     Do not change the node, as if it comes to node partitionting,
+         *     we need to know the parent of this node.
+         */
 
-            // -- this is NOT the last component of the input name -- //
-            if (comp_walker == MAX_NUM_OF_COMPS)
-            {
-                fprintf (stderr, "[trie_insert] WARNING: MAX_NUM_OF_COMPS is reached.\n");
+        // -- is this the last component of the name? -- //
+        if ((ret = cm_next_comp (&tok, &c_component)) != 1)
+        {
+            if (ret < 0)
                 return 0;
-            }
-            c_component = ct->comps_array[comp_walker]; 
             if (child->next_node->num_of_comp > 1)
             {
-                in_node = true;
-                go_next = false;
-            }
-            else
-            {
-                // -- the child->next_node was a match, but this is not the end, so jump to it and continue -- //
-                node = child->next_node;
-                go_next = true;
-                in_node = false;
+                fprintf (stderr, "[trie_insert] WARNING: Found name does hit the end of the node.\n");
+                return 0;
             }
-        }
-        else
-        {
-            // -- The node pointed by this child is not a match, so call do_insert(..) function -- //
-            go_next = false;
-            in_node = false;
+            return child->next_node;
         } 
-        // -- name is not found, yet -- //
-        if (in_node || go_next)
-           continue;   // -- go to the out while loop -- //
 
-        // -- none of the available children are the match, so insertion should be triggered -- //
-        return (trie_do_insert (ct, node, ct->comps_array, comp_walker-1, all_comp, print_flag));
-    } // -- end of while (c_component) -- */
+        // -- this is NOT the last component of the input name -- //
+        if (child->next_node->num_of_comp > 1)
+            in_node = true;
+        else
+        {
+            // -- the child->next_node was a match, but this is not the end, so jump to it and continue -- //
+            node = child->next_node;
+            node_pointer = child;
+        }
+    } // -- end of while (true) -- */
 
     // -- unreachable point -- //
     return 0;  
@@ -269,314 +391,445 @@ trie_insert (struct ct_instance* ct, const char* name, bool print_flag)
  *
  * Description:
  * Insert the remaining components of a name (after doing LPM) in the
- * trie (EON is added to the name when components were extracted).
+ * trie, starting from the current component (EON is added to the name
+ * by the tokenizer). A hashed node takes the new child in its table;
+ * any other node is replaced by a node with one more child.
  * ------------------------------------------------------------------ */
 struct node_t*
-trie_do_insert (struct ct_instance* ct, struct node_t* node, char** comps_array, int comp_walker, int all_comp, bool print_flag)
+trie_do_insert (struct ct_instance* ct, struct bucket_t* node_pointer, struct node_t* node, struct cm_tokenizer_t* tok, struct cm_span_t* c_component, bool print_flag)
 {
     assert (ct);
     struct bucket_t* child;
-    comp_walker++;
-    // -- check whether we should be here or not -- //
-    if ((child=ht_lookup(ct, node, comps_array[comp_walker], print_flag)) != 0)
+    struct bucket_t entry;
+    struct node_t* new_parent;
+    struct node_t* new_node = trie_new_node (ct, 0);
+
+    // -- insert the remaining components in a new node -- //
+    if (trie_copy_comps (ct, tok, c_component, new_node))
     {
-        // -- we could continue with insertion function -- //
-        fprintf (stderr, "[trie_do_insert] ERROR: do_insert should not have been called.\n");
+        ar_free (&ct->arena, new_node, CT_NODE_SIZE(0));
         return 0;
-    } 
-    if (!(child=ht_insert(ct, node, comps_array[comp_walker], print_flag)))
+    }
+    new_node->parent = node;
+    // -- the new node is complete before it is published -- //
+    if (node == &ct->root || node->hash_table)
     {
-        fprintf (stderr, "[trie_do_insert] ERROR: ht_lookup failed.\n");
-        return 0;
-    } 
- 
-    // -- insert the remaining components in the node pointed by this child -- //
-    child->next_node = (struct node_t*)malloc(sizeof(struct node_t));
-    child->next_node->num_of_comp = all_comp - comp_walker;
-    child->next_node->comps = (struct comp_t*)malloc(sizeof(struct comp_t) * (all_comp - comp_walker));
-    child->next_node->hash_table = 0;
-    child->next_node->parent = node;
-    for (int i=0; i<child->next_node->num_of_comp; i++)
+        if (!(child=ht_insert(ct, node, new_node->comps[0].id, new_node->comps[0].key, new_node, print_flag)))
+        {
+            // -- we could continue with insertion function -- //
+            fprintf (stderr, "[trie_do_insert] ERROR: do_insert should not have been called.\n");
+            trie_do_free_node (ct, new_node);
+            ar_free (&ct->arena, new_node, CT_NODE_SIZE(0));
+            return 0;
+        }
+    }
+    else
     {
-        if (comp_walker >= all_comp)
-        { 
-            // -- something is wrong here -- //
-            fprintf (stderr, "[trie_do_insert] WARNING: bad loop condition.\n");
-            return 0; 
+        entry.next_node = new_node;
+        entry.key = new_node->comps[0].key;
+        if (!node_pointer || !(new_parent = trie_node_rebuild (ct, node, &entry, 0)))
+        {
+            fprintf (stderr, "[trie_do_insert] ERROR: The node could not be replaced.\n");
+            trie_do_free_node (ct, new_node);
+            ar_free (&ct->arena, new_node, CT_NODE_SIZE(0));
+            return 0;
         }
-        child->next_node->comps[i].bytes = (char*)malloc(strlen(comps_array[comp_walker]) + 1);
-        child->next_node->comps[i].len = strlen(comps_array[comp_walker]);
-        memcpy (child->next_node->comps[i].bytes, comps_array[comp_walker], strlen (comps_array[comp_walker]) + 1); // -- copy null terminator -- //
-        comp_walker++;
+        trie_node_replace (ct, node_pointer, node, new_parent);
     }
     if (print_flag)
     {
         printf ("Inserted node:  ");
-        db_print_node (child->next_node);     
+        db_print_node (ct, new_node);     
     }
-    return child->next_node;
+    return new_node;
 } /* -- end of trie_do_insert (..) -- */
 
 /* -----------------------------------------------------------------
- * Method: trie_lookup (..)
- * Scope: Protected
+ * Method: trie_do_lookup (..)
+ * Scope: Private
  *
  * Description:
- * Lookup a given name.
+ * Lookup a given name. The trie is only read, and every pointer to a
+ * node is loaded once, so a lookup sees either the old or the new
+ * version of a node which is modified by the writer. In case of exact
+ * match the visited children are kept in the context of the caller.
  * ------------------------------------------------------------------ */
-struct node_t*
-trie_lookup (struct ct_instance* ct, const char* name, bool print_flag, bool exact_match, struct bucket_t** visitedChildren)
+static struct node_t*
+trie_do_lookup (struct ct_instance* ct, struct ct_ctx* ctx, const char* name, bool print_flag, bool exact_match)
 {
     assert (ct);
     assert (name);
 
-    int byte_walker = 0;       // -- index of the name -- //
-    int comp_walker = 0;       // -- index of the current component (i.e. node) -- //
-    int node_comp_walker = 0;  // -- index of node's component -- //
-    bool in_node = false;      // -- iterate through node's components, or search children? -- //
-    char* c_component;         // -- the current component -- //
-    struct node_t* node;       // -- node traverser -- // 
-    struct bucket_t* child;    // -- return value of ht_lookup -- //
-    int all_comp = 0;          // -- number of extracted components from the input name -- //
-    bool go_next = false;      // -- if a node was match, but more components need to be matched -- //
-    int visited_walker = 0;    // -- index of comps_array (in case of exact match) -- //
+    int node_comp_walker = 0;    // -- index of node's component -- //
+    bool in_node = false;        // -- iterate through node's components, or search children? -- //
+    struct cm_tokenizer_t tok;   // -- extracts components of the name on demand -- //
+    struct cm_span_t c_component;// -- the current component -- //
+    struct node_t* node;         // -- node traverser -- // 
+    struct bucket_t* child;      // -- return value of ht_lookup -- //
+    struct node_t* next;         // -- the node pointed by the child (loaded once) -- //
+    int visited_walker = 0;      // -- index of visitedChildren (in case of exact match) -- //
+    int ret;
 
     if (exact_match)
     {
-        if (!visitedChildren)
+        if (!ctx)
         {
-            fprintf (stderr, "[trie_lookup] ERROR: Exact match does not work without input array.\n");
+            fprintf (stderr, "[trie_do_lookup] ERROR: Exact match does not work without a context.\n");
             return 0;
         }
     }
 
-    while (ct->comps_array[comp_walker] != 0)
-    {
-        free(ct->comps_array[comp_walker]);
-        ct->comps_array[comp_walker] = 0;
-        comp_walker++;
-    }
-
-    comp_walker = 0;
-    if (strlen(name) < 2)
-    {
-        // -- a name with length of ONE? -- //
-        fprintf (stderr, "[trie_lookup] ERROR: A name with len of ONE or ZERO.\n");
-        return 0;
-    }
-
-    // -- extract all name components -- //
-    if (cm_extract_comps (name, ct->comps_array, print_flag))
+    // -- extract the first component -- //
+    if (cm_tokenizer_init (&tok, name, print_flag) || cm_next_comp (&tok, &c_component) != 1)
     {
-        fprintf (stderr, "[trie_lookup] ERROR: A name with len of ONE or ZERO.\n");
+        fprintf (stderr, "[trie_do_lookup] WARNING: Bad input name:  %s\n", name);
         return 0;
     }
 
-    if (!ct->comps_array[0])
-    {
-        // -- no component -- //
-        fprintf (stderr, "[trie_lookup] WARNING: Bad input name:  %s\n", name);
-        return 0;
-    }
-
-    // -- figure out the number of components -- //
-    while (ct->comps_array[all_comp])
-    {
-        all_comp++; 
-    }
-    if (all_comp == MAX_NUM_OF_COMPS)
-    {
-        fprintf (stderr, "[trie_lookup] WARNING: MAX_NUM_OF_COMPS is reached.\n");
-        return 0;
-    }
-    c_component = ct->comps_array[comp_walker];
-
     /* ----------- Welcome to loop party ----------- */
     node = &(ct->root);
-    // -- Look up extracted components. If mismatch occured, insert them one-by-one -- //
-    while (c_component)
+    // -- Look up extracted components. If mismatch occured, lookup failed -- //
+    while (true)
     {
         // -- search node's components? -- //
         if (in_node)
         {
             node_comp_walker = 1;  // -- zero is check beforehand -- //            
-            if (child->next_node->num_of_comp < 2)
+            if (next->num_of_comp < 2)
             {
-                fprintf (stderr, "[trie_lookup] WARNING: in_node flag is wrongly ON.\n");
+                fprintf (stderr, "[trie_do_lookup] WARNING: in_node flag is wrongly ON.\n");
                 return 0;
             }
-            if (node_comp_walker >= child->next_node->num_of_comp)   
-            {
-                // -- something is wrong with the previous iteration -- //
-               fprintf (stderr, "[trie_lookup] WARNING: node_comp_walker > # of comps.\n");
-               return 0;
-            }
 
-            while (node_comp_walker < child->next_node->num_of_comp)
+            while (node_comp_walker < next->num_of_comp)
             {
-                // -- if their lengths are different, this cannot be a match -- //
-                if (strlen(c_component) != child->next_node->comps[node_comp_walker].len)
+                if (!trie_comp_equal (ct, &tok, &c_component, &next->comps[node_comp_walker]))
                 {
                     // -- lookup failed -- //
                     return 0;
-                }
-
-                byte_walker = 0;
-                while (byte_walker < strlen(c_component))
-                {
-                    // -- [TODO] We can use memcmp -- //
-                    if (c_component[byte_walker] == child->next_node->comps[node_comp_walker].bytes[byte_walker])
-                    {
-                        byte_walker++;
-                    }
-                    else
-                    {
-                        // -- lookup failed -- //
-                        return 0;
-                    }
                 } // -- this component was a match, go for the next component -- //
 
                 node_comp_walker++;
-                comp_walker++;
-                if (comp_walker >= all_comp)
+                if ((ret = cm_next_comp (&tok, &c_component)) != 1)
                 {
+                    if (ret < 0)
+                        return 0;
                     /**
                      * The input name is found, so this should be
                      * the last component of the current node. 
                      */
-                    if (node_comp_walker == child->next_node->num_of_comp)
+                    if (node_comp_walker == next->num_of_comp)
                     {
                         if (exact_match)
                         {
-                            visitedChildren[visited_walker] = child;
+                            ctx->visitedChildren[visited_walker] = child;
                             visited_walker++;
                         }
-                        return child->next_node;
+                        return next;
                     }
                     else
                     {
-                        fprintf (stderr, "[trie_lookup] WARNING: Found name does not hit the end of the node.\n");
+                        fprintf (stderr, "[trie_do_lookup] WARNING: Found name does not hit the end of the node.\n");
                         return 0;
                     } 
                 }
-                if (comp_walker == MAX_NUM_OF_COMPS)
-                {
-                    fprintf (stderr, "[trie_lookup] WARNING: MAX_NUM_OF_COMPS is reached.\n");
-                    return 0;
-                }
-                c_component = ct->comps_array[comp_walker]; 
-                if (node_comp_walker >= child->next_node->num_of_comp)   
+                if (node_comp_walker >= next->num_of_comp)   
                 {
-                    // -- this was the last component of this name, continue with out_name search (children lookup) -- //
-                    node = child->next_node; // -- now it's ready to get out of the loop -- //
+                    // -- this was the last component of this node, continue with out_name search (children lookup) -- //
+                    node = next; // -- now it's ready to get out of the loop -- //
                     in_node = false;
                     break;
                 }
-                else
-                    continue; // -- go to the inner while loop -- //
             } // -- end of inner while loop -- //
         } // -- end of if (in_node) -- //
  
-        if (exact_match)
+        if (exact_match && node != &ct->root)
         { 
-            if (comp_walker != 0)
-            {
-                // -- remember all visited nodes, by the children which point them -- //
-                visitedChildren[visited_walker] = child;
-                visited_walker++;
-            }
+            // -- remember all visited nodes, by the children which point them -- //
+            ctx->visitedChildren[visited_walker] = child;
+            visited_walker++;
         }
         // -- search for this component among the children -- //
-        if (!(child=ht_lookup(ct, node, c_component, print_flag)))
+        if (!(child=ht_lookup(ct, node, trie_span_id (ct, &tok, &c_component), c_component.key, print_flag)))
         {
             // -- no child is available, so lookup failed -- //
             return 0;
         }
-        byte_walker = 0;
-        while (byte_walker < strlen(c_component))
+        next = EP_LOAD(child->next_node);
+        // -- we found the matched child. Jump to the corresponded node -- //
+        /**
+         * If there is more than one component in this node, check the
+         * rest of them. Maybe there are some other components which can
+         * be matched.
+         */
+
+        // -- is this the last component of the name? -- //
+        if ((ret = cm_next_comp (&tok, &c_component)) != 1)
         {
-            if (strlen(c_component) != child->next_node->comps[0].len)
+            if (ret < 0)
+                return 0;
+            if (next->num_of_comp > 1)
             {
-                // -- this child is not a match, go for the next child -- //
-                break;
+                fprintf (stderr, "[trie_do_lookup] WARNING: Found name does hit the end of the node.\n");
+                return 0;
             }
-            if (c_component[byte_walker] == child->next_node->comps[0].bytes[byte_walker])
+            if (exact_match)
             {
-                byte_walker++;
+                ctx->visitedChildren[visited_walker] = child;
+                visited_walker++;
             }
-            else
+            return next;
+        } 
+
+        // -- this is NOT the last component of the input name -- //
+        if (next->num_of_comp > 1)
+            in_node = true;
+        else
+        {
+            // -- the next was a match, but this is not the end, so jump to it and continue -- //
+            node = next;
+        }
+    } // -- end of while (true) -- */
+
+    // -- unreachable point -- //
+    return 0;  
+} /* -- end of trie_do_lookup (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: trie_lookup (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Lookup a given name. If the context is registered as a reader, the
+ * lookup is done inside a read-side critical section, so it can run
+ * concurrently with one writer (nodes are reclaimed by epochs).
+ * ------------------------------------------------------------------ */
+struct node_t*
+trie_lookup (struct ct_instance* ct, struct ct_ctx* ctx, const char* name, bool print_flag, bool exact_match)
+{
+    struct node_t* found;
+
+    if (!ctx || !ctx->reader)
+        return trie_do_lookup (ct, ctx, name, print_flag, exact_match);
+
+    ep_enter (&ct->epoch, ctx->reader);
+    found = trie_do_lookup (ct, ctx, name, print_flag, exact_match);
+    ep_exit (ctx->reader);
+    return found;
+} /* -- end of trie_lookup (..) -- */
+
+/* -----------------------------------------------------------------
+ * State of a single name in a batched lookup. The lookup is cut into
+ * stages, so that each stage only touches memory which has been
+ * prefetched by the previous stage of the same name.
+ * ------------------------------------------------------------------ */
+enum trie_stage_t {
+    TRIE_STAGE_TABLE,  // -- the node and its ht header are cached: prefetch the probed group (or find the inline child) -- //
+    TRIE_STAGE_PROBE,  // -- the group is cached: find the child and prefetch its node -- //
+    TRIE_STAGE_NODE,   // -- the node is cached: prefetch its components and ht header -- //
+    TRIE_STAGE_MATCH   // -- compare the components of the node, then go down -- //
+};
+
+struct trie_batch_t {
+    enum trie_stage_t stage;
+    int index;                   // -- index of the name (in names[]) -- //
+    struct cm_tokenizer_t tok;
+    struct cm_span_t c_component;
+    struct node_t* node;         // -- node whose children are looked up -- //
+    struct ht_t* ht;             // -- hash table of the node -- //
+    struct node_t* next;         // -- the matched child -- //
+};
+
+/* -----------------------------------------------------------------
+ * Method: trie_batch_step (..)
+ * Scope: Private
+ *
+ * Description:
+ * Run one stage of a batched lookup (see trie_do_lookup for the
+ * sequential version of the same walk).
+ *
+ * RETURN:
+ *    0: the lookup is not finished
+ *    1: the lookup is finished (the result is in *result)
+ * ------------------------------------------------------------------ */
+static int
+trie_batch_step (struct ct_instance* ct, struct trie_batch_t* st, struct node_t** result)
+{
+    struct bucket_t* child;
+    struct ht_t* ht;
+    int node_comp_walker;
+    int ret;
+
+    *result = 0;
+    switch (st->stage)
+    {
+        case TRIE_STAGE_TABLE:
+            if (!(st->ht = EP_LOAD(st->node->hash_table)))
             {
-                // -- this child is not a match, go for the next child -- //
-                break;
+                // -- inline children are already cached with the node -- //
+                if (!(child = ht_small_lookup (st->node, st->c_component.key, CP_UNKNOWN)))
+                    return 1;
+                st->next = EP_LOAD(child->next_node);
+                __builtin_prefetch (st->next);
+                st->stage = TRIE_STAGE_NODE;
+                return 0;
             }
-        }
-        if (byte_walker ==  strlen(c_component))
-        {
-            // -- we found the matched child. Jump to the corresponded node -- //
-            /**
-             * If there is more than one component in this node, check the
-             * rest of them. Maybe there are some other components which can
-             * be matched.
-             *
-             * NOTE:
-             *     Do not change the node, as if it comes to node partitionting,
-             *     we need to know the parent of this node.
-             */
+            ht_prefetch (st->ht, st->c_component.key);
+            st->stage = TRIE_STAGE_PROBE;
+            return 0;
+
+        case TRIE_STAGE_PROBE:
+            if (!(child = ht_lookup_key (st->ht, st->c_component.key)))
+                return 1;
+            st->next = EP_LOAD(child->next_node);
+            __builtin_prefetch (st->next);
+            st->stage = TRIE_STAGE_NODE;
+            return 0;
+
+        case TRIE_STAGE_NODE:
+            __builtin_prefetch (st->next->comps);
+            if ((ht = EP_LOAD(st->next->hash_table)))
+                __builtin_prefetch (ht);
+            st->stage = TRIE_STAGE_MATCH;
+            return 0;
 
+        case TRIE_STAGE_MATCH:
+            if (!trie_comp_equal (ct, &st->tok, &st->c_component, &st->next->comps[0]))
+            {
+                // -- two components with the same key, do the full lookup -- //
+                if (!(child = ht_lookup (ct, st->node, trie_span_id (ct, &st->tok, &st->c_component),
+                                         st->c_component.key, false)))
+                    return 1;
+                st->next = EP_LOAD(child->next_node);
+            }
             // -- is this the last component of the name? -- //
-            comp_walker++;
-            if (comp_walker >= all_comp)
+            if ((ret = cm_next_comp (&st->tok, &st->c_component)) != 1)
             {
-                if (child->next_node->num_of_comp > 1)
-                {
-                    fprintf (stderr, "[trie_lookup] WARNING: Found name does hit the end of the node.\n");
-                    return 0;
-                }
-                if (exact_match)
+                if (!ret && st->next->num_of_comp == 1)
+                    *result = st->next;
+                return 1;
+            }
+            // -- check the rest of components of the node -- //
+            for (node_comp_walker=1; node_comp_walker < st->next->num_of_comp; node_comp_walker++)
+            {
+                if (!trie_comp_equal (ct, &st->tok, &st->c_component, &st->next->comps[node_comp_walker]))
+                    return 1;
+                if ((ret = cm_next_comp (&st->tok, &st->c_component)) != 1)
                 {
-                    visitedChildren[visited_walker] = child;
-                    visited_walker++;
+                    if (!ret && node_comp_walker + 1 == st->next->num_of_comp)
+                        *result = st->next;
+                    return 1;
                 }
-                return child->next_node;
-            } 
-
-            // -- this is NOT the last component of the input name -- //
-            if (comp_walker == MAX_NUM_OF_COMPS)
-            {
-                fprintf (stderr, "[trie_lookup] WARNING: MAX_NUM_OF_COMPS is reached.\n");
-                return 0;
             }
-            c_component = ct->comps_array[comp_walker]; 
-            if (child->next_node->num_of_comp > 1)
+            // -- go down, the ht header of the node has been prefetched -- //
+            st->node = st->next;
+            st->stage = TRIE_STAGE_TABLE;
+            return 0;
+    }
+    return 1;
+} /* -- end of trie_batch_step (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: trie_do_lookup_batch (..)
+ * Scope: Private
+ *
+ * Description:
+ * Lookup a number of names. Up to group_size names are walked in
+ * lockstep: each name advances by one stage and prefetches what its
+ * next stage needs, then the other names advance, so the cache misses
+ * of different names overlap. A finished name is replaced by the next
+ * one. The node of each name (or NULL) is put in results.
+ *
+ * RETURN:
+ *    number of found names.
+ * ------------------------------------------------------------------ */
+static int
+trie_do_lookup_batch (struct ct_instance* ct, const char** names, int num_of_names, struct node_t** results, int group_size)
+{
+    struct trie_batch_t group[CT_BATCH_MAX];
+    int active = 0;      // -- number of names in the group -- //
+    int next_name = 0;   // -- index of the next name to join the group -- //
+    int found = 0;
+    int i;
+
+    while (active || next_name < num_of_names)
+    {
+        // -- fill the group -- //
+        while (active < group_size && next_name < num_of_names)
+        {
+            struct trie_batch_t* st = &group[active];
+
+            results[next_name] = 0;
+            if (cm_tokenizer_init (&st->tok, names[next_name], false) || cm_next_comp (&st->tok, &st->c_component) != 1)
             {
-                in_node = true;
-                go_next = false;
+                fprintf (stderr, "[trie_lookup_batch] WARNING: Bad input name:  %s\n", names[next_name]);
+                next_name++;
+                continue;
             }
-            else
+            st->index = next_name++;
+            st->node = &ct->root;
+            st->stage = TRIE_STAGE_TABLE;
+            active++;
+        }
+        // -- advance each name by one stage -- //
+        i = 0;
+        while (i < active)
+        {
+            if (trie_batch_step (ct, &group[i], &results[group[i].index]))
             {
-                // -- the child->next_node was a match, but this is not the end, so jump to it and continue -- //
-                node = child->next_node;
-                go_next = true;
-                in_node = false;
+                if (results[group[i].index])
+                    found++;
+                group[i] = group[--active];  // -- the name is done, take the last one -- //
+                continue;
             }
+            i++;
         }
-        else
-        {
-            // -- The node pointed by this child is not a match, so call lookup failed -- //
-            go_next = false;
-            in_node = false;
-        } 
-        // -- name is not found, yet -- //
-        if (in_node || go_next)
-           continue;   // -- go to the out while loop -- //
+    }
+    return found;
+} /* -- end of trie_do_lookup_batch (..) -- */
 
-        // -- none of the available children are the match, so lookup failed -- //
-        return 0;
-    } // -- end of while (c_component) -- */
+/* -----------------------------------------------------------------
+ * Method: trie_lookup_batch (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Lookup a number of names, group_size (up to CT_BATCH_MAX) names at
+ * a time (see trie_do_lookup_batch). If the context is registered as
+ * a reader, names are looked up in windows of CT_BATCH_WINDOW names,
+ * each in its own read-side critical section, so that a long batch
+ * does not hold back reclamation.
+ *
+ * RETURN:
+ *    number of found names.
+ * ------------------------------------------------------------------ */
+int
+trie_lookup_batch (struct ct_instance* ct, struct ct_ctx* ctx, const char** names, int num_of_names,
+                   struct node_t** results, int group_size)
+{
+    assert (ct);
+    assert (names);
+    assert (results);
 
-    // -- unreachable point -- //
-    return 0;  
-} /* -- end of trie_lookup (..) -- */
+    int found = 0;
+    int window;
+
+    if (group_size < 1)
+        group_size = 1;
+    if (group_size > CT_BATCH_MAX)
+        group_size = CT_BATCH_MAX;
+
+    if (!ctx || !ctx->reader)
+        return trie_do_lookup_batch (ct, names, num_of_names, results, group_size);
+
+    for (int i=0; i<num_of_names; i+=window)
+    {
+        window = (num_of_names - i < CT_BATCH_WINDOW) ? num_of_names - i : CT_BATCH_WINDOW;
+        ep_enter (&ct->epoch, ctx->reader);
+        found += trie_do_lookup_batch (ct, names + i, window, results + i, group_size);
+        ep_exit (ctx->reader);
+    }
+    return found;
+} /* -- end of trie_lookup_batch (..) -- */
 
 /* -----------------------------------------------------------------
  * Method: trie_node_partition (..)
@@ -589,10 +842,10 @@ trie_lookup (struct ct_instance* ct, const char* name, bool print_flag, bool exa
  * components of the name should be added to the parent.
  * ------------------------------------------------------------------ */
 struct node_t*
-trie_node_partition (struct ct_instance* ct, struct bucket_t* child, char** comps_array, int all_comp, int comp_walker, int node_comp_walker, bool print_flag)
+trie_node_partition (struct ct_instance* ct, struct bucket_t* child, struct cm_tokenizer_t* tok, struct cm_span_t* c_component, int node_comp_walker, bool print_flag)
 {
     assert (ct);
-    assert (comps_array);
+    assert (tok);
 
     if (node_comp_walker < 0)
     {
@@ -611,108 +864,88 @@ trie_node_partition (struct ct_instance* ct, struct bucket_t* child, char** comp
          *        a) the prvious node
          *        b) the rest of input name
          */ 
-        // -- the current child should point to a new node, so store the "next_node" pointer of the current child -- //
-        struct bucket_t* bucket_walker;
+        /**
+         * NOTE:
+         *     The node is not touched in place, as concurrent readers may be
+         *     visiting it. The parent and the first node are built aside and
+         *     published by a single pointer store; then the node is retired.
+         */
         struct node_t* parent;
         struct node_t* first_node;
-        struct node_t* second_node;
-        struct bucket_t* in_ret;   // -- store the returned value from ht_insert -- //
-        struct node_t* next_node_tmp = (struct node_t*)malloc(sizeof(struct node_t));
-        // -- [TODO] Do we need to copy these info??? Because maybe it gets lost after removing corresponded pointer -- //
-        *next_node_tmp = *(child->next_node);
-        free(child->next_node);
-        // -- partition the corresponded node into parent and first_node -- //
-        child->next_node = (struct node_t*)malloc(sizeof(struct node_t));
-        parent = child->next_node;  // -- agent is set -- //
+        struct node_t* second_node = trie_new_node (ct, 0);
+        struct node_t* next_node_tmp = child->next_node;  // -- the node to partition -- //
+
+        // -- the second node takes the rest of the input name -- //
+        if (trie_copy_comps (ct, tok, c_component, second_node))
+        {
+            ar_free (&ct->arena, second_node, CT_NODE_SIZE(0));
+            return 0;
+        }
+
+        // -- partition the corresponded node into parent (a small node with two children) and first_node -- //
+        parent = trie_new_node (ct, 2);
         parent->num_of_comp = node_comp_walker;  // -- at the parent we do not have EON -- //
-        parent->comps = (struct comp_t*)malloc(sizeof(struct comp_t) * parent->num_of_comp);
+        parent->comps = (struct comp_t*)ar_alloc(&ct->arena, sizeof(struct comp_t) * parent->num_of_comp);
         parent->parent = next_node_tmp->parent;
-        parent->hash_table = 0;
         for (int i=0; i<parent->num_of_comp; i++)
         { 
-            // -- copy each component to a new component in the new node -- //
-            parent->comps[i].bytes = (char*)malloc(next_node_tmp->comps[i].len + 1);
-            parent->comps[i].len = next_node_tmp->comps[i].len;
-            memcpy(parent->comps[i].bytes, next_node_tmp->comps[i].bytes, next_node_tmp->comps[i].len + 1); // -- copy null terminator -- //
+            // -- copy each component to a new component in the new node (the pool keeps the bytes) -- //
+            parent->comps[i] = next_node_tmp->comps[i];
+            cp_ref (ct, parent->comps[i].id);
         }
         // -- parent received its components -- //
 
         // -- for the first node -- //
-        if (!(in_ret=ht_insert(ct, parent, next_node_tmp->comps[node_comp_walker].bytes, print_flag)))
+        if (next_node_tmp->hash_table)
         {
-            fprintf (stderr, "[trie_node_partition] ERROR: HT insertion has been failed.\n");
-            return 0;
+            // -- children are shared with the old node (readers of the old node may still use them) -- //
+            first_node = trie_new_node (ct, 0);
+            first_node->hash_table = next_node_tmp->hash_table;
+        }
+        else
+        {
+            // -- inline children (if any) are copied -- //
+            first_node = trie_new_node (ct, next_node_tmp->num_of_children);
+            memcpy (first_node->children, next_node_tmp->children, CT_NODE_SIZE(first_node->num_of_children) - CT_NODE_SIZE(0));
         }
-        in_ret->next_node = (struct node_t*)malloc(sizeof(struct node_t));
-        first_node = in_ret->next_node;  // -- agent is set -- //
         first_node->num_of_comp = next_node_tmp->num_of_comp - node_comp_walker; // -- [TODO] check zero condition -- //
-        first_node->comps = (struct comp_t*)malloc(sizeof(struct comp_t) * first_node->num_of_comp);
+        first_node->comps = (struct comp_t*)ar_alloc(&ct->arena, sizeof(struct comp_t) * first_node->num_of_comp);
         first_node->parent = parent;
         for (int i=0; i<first_node->num_of_comp; i++)
         { 
             // -- copy each component to a new component in the new node -- //
-            first_node->comps[i].bytes = (char*)malloc(next_node_tmp->comps[node_comp_walker + i].len + 1);
-            first_node->comps[i].len = next_node_tmp->comps[node_comp_walker + i].len;
-            memcpy(first_node->comps[i].bytes, next_node_tmp->comps[node_comp_walker + i].bytes, next_node_tmp->comps[node_comp_walker + i].len + 1); // -- copy null terminator -- //
+            first_node->comps[i] = next_node_tmp->comps[node_comp_walker + i];
+            cp_ref (ct, first_node->comps[i].id);
         }
         // -- first node received its components -- //
-        if (!next_node_tmp->hash_table ||
-            !next_node_tmp->hash_table->size ||
-            !next_node_tmp->hash_table->used)
-        {
-            first_node->hash_table = 0;
-        }
-        else
-        {
-            first_node->hash_table = next_node_tmp->hash_table;
-            for (int i=0; i < first_node->hash_table->size; i++)
-            {
-                bucket_walker = &first_node->hash_table->buckets[i];
-                while (bucket_walker->next_bucket)
-                {
-                    bucket_walker = bucket_walker->next_bucket;
-                    if (bucket_walker->key) 
-                        bucket_walker->next_node->parent = first_node;
-                }
-            }
-        }
+        trie_adopt_children (first_node);
         // -- first node is DONE -- //
  
         // -- for the second node -- //
-        if (!(in_ret=ht_insert(ct, parent, comps_array[comp_walker], print_flag)))
-        {
-            fprintf (stderr, "[trie_node_partition] ERROR: HT insertion has been failed.\n");
-            return 0;
-        }
-        in_ret->next_node = (struct node_t*)malloc(sizeof(struct node_t));
-        second_node = in_ret->next_node;  // -- agent is set -- //
-        second_node->num_of_comp = all_comp - comp_walker;  
-        second_node->comps = (struct comp_t*)malloc(sizeof(struct comp_t) * second_node->num_of_comp);
-        second_node->hash_table = 0;
         second_node->parent = parent;
-        for (int i=0; i<second_node->num_of_comp; i++)
+        // -- children of the parent are sorted by their keys -- //
+        if (first_node->comps[0].key <= second_node->comps[0].key)
         {
-            second_node->comps[i].bytes = (char*)malloc(strlen(comps_array[comp_walker]) + 1);
-            second_node->comps[i].len = strlen(comps_array[comp_walker]);
-            memcpy (second_node->comps[i].bytes, comps_array[comp_walker], strlen(comps_array[comp_walker]) + 1);
-            comp_walker++;
+            parent->children[0].next_node = first_node;
+            parent->children[1].next_node = second_node;
         }
-
-        for (int i=0; i<next_node_tmp->num_of_comp; i++)
+        else
         {
-            free(next_node_tmp->comps[i].bytes);
-            next_node_tmp->comps[i].bytes = 0;
-            next_node_tmp->comps[i].len = 0;           
+            parent->children[0].next_node = second_node;
+            parent->children[1].next_node = first_node;
         }
-        free(next_node_tmp->comps);
-        next_node_tmp->comps = 0;
-        free(next_node_tmp);
+        parent->children[0].key = parent->children[0].next_node->comps[0].key;
+        parent->children[1].key = parent->children[1].next_node->comps[0].key;
+
+        // -- the parent is complete, publish it -- //
+        EP_PUBLISH(child->next_node, parent);
+        ep_retire (&ct->epoch, next_node_tmp, trie_reclaim_node);
         // -- do not touch the children -- //  
 
         if (print_flag)
         {
             printf ("Inserted node: ");
-            db_print_node (second_node);
+            db_print_node (ct, second_node);
         }
         // -- second child is done -- //
         // -- Partiotioning is DONE! END of insertion -- //
@@ -747,33 +980,34 @@ trie_node_partition (struct ct_instance* ct, struct bucket_t* child, char** comp
  *     Removing other children -> should be done by the previous child.
  * ------------------------------------------------------------------ */
 int
-trie_remove (struct ct_instance* ct, const char* name, bool print_flag)
+trie_remove (struct ct_instance* ct, struct ct_ctx* ctx, const char* name, bool print_flag)
 {
     assert (ct);
+    assert (ctx);
     assert (name);
    
     int visited_walker = 0; // -- index of visitedChildren array -- //
     struct bucket_t* child;
-    struct bucket_t* bucket_tmp = (struct bucket_t*)malloc(sizeof(struct bucket_t));
+    struct node_t* parent;  // -- the node which owns the child -- //
+    struct node_t* n_parent;  // -- replacement of the parent -- //
+    int num_of_children;
  
     for (int i=0; i<MAX_HEIGHT; i++)
-        ct->visitedChildren[i] = 0;
+        ctx->visitedChildren[i] = 0;
 
     // -- start exact name lookup -- //
-    if (!trie_lookup (ct, name, 0, 1, ct->visitedChildren))
+    if (!trie_lookup (ct, ctx, name, 0, 1))
     {
         // -- name is NOT found -- //
-        free(bucket_tmp);
         return 1; 
     }
-    if (!ct->visitedChildren[0]) 
+    if (!ctx->visitedChildren[0]) 
     {
         fprintf (stderr, "[trie_remove] ERROR: No node is visited while exact matching.\n");
-        free(bucket_tmp);
         return 2;
     }
     // -- number of visited nodes -- // 
-    while (ct->visitedChildren[visited_walker])
+    while (ctx->visitedChildren[visited_walker])
     {
         visited_walker++;
     }
@@ -786,119 +1020,71 @@ trie_remove (struct ct_instance* ct, const char* name, bool print_flag)
     {
         // -- something is wrong -- //
         fprintf (stderr, "[trie_remove] ERROR: An error has been occured while removing.\n");
-        free(bucket_tmp);
         return 2;
     }
 
-    if (ct->visitedChildren[visited_walker]->next_node->hash_table)
+    if (CT_NODE_KIND(ctx->visitedChildren[visited_walker]->next_node) != CT_KIND_LEAF)
     {
         // -- exact lookup ended up with a non-leaf node -- //
         fprintf (stderr, "[trie_remove] ERROR: Exact lookup has been ended up with a non-leaf node.\n");
-        free(bucket_tmp);
         return 2;
     }
 
+    child = ctx->visitedChildren[visited_walker];
+    parent = (visited_walker == 0) ? &ct->root : ctx->visitedChildren[visited_walker-1]->next_node;
+
     if (visited_walker == 0)
     {
         // -- there is just one node (regardless of the root) to remove -- //
-        child = ct->visitedChildren[visited_walker];
-        if (ct->root.hash_table->used == 1)
+        if (parent->hash_table->used == 1)
         {
-             // -- this the last child of the root, safely remove it and then remove the whole hash table -- //
-             trie_free_node(child->next_node);
-             free(child->next_node);
-             child->next_node = 0;
-             child->key = 0; 
-             if (child->next_bucket)
-                 free(child->next_bucket);
-             child->next_bucket = 0;
-             for (int i=0; i<ct->root.hash_table->size; i++)
-             {
-                 if (ct->root.hash_table->buckets[i].next_bucket)
-                     free(ct->root.hash_table->buckets[i].next_bucket);
-                 ct->root.hash_table->buckets[i].next_bucket = 0; 
-             }
-             free(ct->root.hash_table->buckets);
-             ct->root.hash_table->buckets = 0;
-             ct->root.hash_table->size = 0;
-             ct->root.hash_table->used = 0;
-             free(ct->root.hash_table);
-             ct->root.hash_table = 0;
-             free(bucket_tmp);
-             return 0;
-         }
-         else
-         {
-             // -- just remove the child, do not touch anything else -- //
-             trie_free_node(child->next_node);
-             free(child->next_node);
-             child->next_node = 0;
-             child->key = 0; 
-             *bucket_tmp = *child;
-             free(child->pre_bucket->next_bucket);  // -- child is deallocated -- //
-             bucket_tmp->pre_bucket->next_bucket = bucket_tmp->next_bucket;
-             if (bucket_tmp->next_bucket)
-                 bucket_tmp->next_bucket->pre_bucket = bucket_tmp->pre_bucket;
-             bucket_tmp->pre_bucket = 0;
-             bucket_tmp->next_bucket = 0;
-             ct->root.hash_table->used--;
-             // -- we do not care of merging at root -- //
-             free(bucket_tmp);
-             return 0;
-         }
+            // -- this the last child of the root, safely remove the whole hash table -- //
+            struct ht_t* ht = parent->hash_table;
+            EP_PUBLISH(parent->hash_table, 0);
+            ep_retire (&ct->epoch, child->next_node, trie_reclaim_node);
+            ep_retire (&ct->epoch, ht, ht_reclaim);
+            return 0;
+        }
+        // -- just remove the child, do not touch anything else -- //
+        ep_retire (&ct->epoch, child->next_node, trie_reclaim_node);
+        ht_delete (parent->hash_table, child);
+        // -- we do not care of merging at root -- //
+        return 0;
     }
          
     // -- the last node is not a root's leaf -- //
-    if (visited_walker > 0)
+    // -- check number of children of the second last visited node -- //
+    num_of_children = ht_num_of_children (parent);
+    if (num_of_children == 1)
     {
-        // -- get the child which points to the next node -- //
-        child = ct->visitedChildren[visited_walker];
-        // -- check number of children of the second last visited node -- //
-        if (ct->visitedChildren[visited_walker-1]->next_node->hash_table->used == 1)
-        {
-            // -- an intermediate node with just one node is not normal -- //
-            fprintf (stderr, "[trie_remove] WARNING: An intermediate node with one child.\n"); 
-            return 1;
-        }
-        if (ct->visitedChildren[visited_walker-1]->next_node->hash_table->used == 2)
-        {
-            trie_free_node(child->next_node);
-            free(child->next_node);
-            child->next_node = 0;
-            child->key = 0;
-            *bucket_tmp = *child;
-            free(child->pre_bucket->next_bucket);  // -- child is deallocated -- //
-            bucket_tmp->pre_bucket->next_bucket = bucket_tmp->next_bucket;
-            if (bucket_tmp->next_bucket)
-                bucket_tmp->next_bucket->pre_bucket = bucket_tmp->pre_bucket;
-            bucket_tmp->pre_bucket = 0;
-            bucket_tmp->next_bucket = 0;
-            ct->visitedChildren[visited_walker-1]->next_node->hash_table->used--;
-            // -- now merge -- // 
-            trie_node_merge (ct, ct->visitedChildren[visited_walker - 1]);
-            free(bucket_tmp);
+        // -- an intermediate node with just one node is not normal -- //
+        fprintf (stderr, "[trie_remove] WARNING: An intermediate node with one child.\n"); 
+        return 1;
+    }
+    // -- unlink the leaf first, readers which already hold it keep it until they leave -- //
+    ep_retire (&ct->epoch, child->next_node, trie_reclaim_node);
+    if (num_of_children == 2)
+    {
+        // -- now merge (the parent is replaced, so the child is not deleted) -- // 
+        trie_node_merge (ct, ctx->visitedChildren[visited_walker - 1], child);
+        return 0;
+    }
+    if (parent->hash_table)
+    {
+        ht_delete (parent->hash_table, child);
+        if (parent->hash_table->used > CT_SHRINK_MAX)
             return 0;
-        } 
-        else
-        {
-            trie_free_node(child->next_node);
-            free(child->next_node);
-            child->next_node = 0;
-            child->key = 0;
-            *bucket_tmp = *child;
-            free(child->pre_bucket->next_bucket);  // -- child is deallocated -- //
-            bucket_tmp->pre_bucket->next_bucket = bucket_tmp->next_bucket;
-            if (bucket_tmp->next_bucket)
-                bucket_tmp->next_bucket->pre_bucket = bucket_tmp->pre_bucket;
-            bucket_tmp->pre_bucket = 0;
-            bucket_tmp->next_bucket = 0;
-            ct->visitedChildren[visited_walker-1]->next_node->hash_table->used--;
-            free(bucket_tmp);
-            // -- do not merge -- //
-            return 0; 
-        }
+        // -- shrink into a small node -- //
+        child = 0;
     }
-    // -- unreachable part -- //
+    // -- a small node is replaced by a node without the child -- //
+    if (!(n_parent = trie_node_rebuild (ct, parent, 0, child)))
+    {
+        fprintf (stderr, "[trie_remove] ERROR: The parent could not be replaced.\n");
+        return 2;
+    }
+    trie_node_replace (ct, ctx->visitedChildren[visited_walker - 1], parent, n_parent);
+    // -- otherwise, do not merge -- //
     return 0;
 } /* -- end of trie_remove(..) -- */
 
@@ -907,124 +1093,84 @@ trie_remove (struct ct_instance* ct, const char* name, bool print_flag)
  * Scope: Protected
  *
  * Description:
- * Merge a node with one leaf with its child.
+ * Merge a node with its only child, i.e. the child which is left when
+ * the given child (the one being removed) is ignored.
  * ------------------------------------------------------------------ */
 struct node_t*
-trie_node_merge (struct ct_instance* ct, struct bucket_t* parent_pointer)
+trie_node_merge (struct ct_instance* ct, struct bucket_t* parent_pointer, struct bucket_t* skip)
 {
     assert (ct);
-    if (!parent_pointer || !parent_pointer->next_node || !parent_pointer->next_node->hash_table || 
-        !parent_pointer->next_node->hash_table->size || !parent_pointer->next_node->hash_table->used)
+    if (!parent_pointer || !parent_pointer->next_node ||
+        CT_NODE_KIND(parent_pointer->next_node) == CT_KIND_LEAF)
     {
         fprintf (stderr, "[trie_node_merge] ERROR: An error has been occured while merging.\n");
         return 0;
     }
 
     int used = 0;
-    struct node_t* parent = (struct node_t*)malloc(sizeof(struct node_t));
+    struct node_t* parent = parent_pointer->next_node;
     struct node_t* n_parent;  // -- new parent -- //
     int num_of_merged_comp = 0;
-    struct node_t* node_tmp = (struct node_t*)malloc(sizeof(struct node_t));
-    struct bucket_t* bucket_walker;
-    *parent = *(parent_pointer->next_node);
+    struct node_t* node_tmp = 0;  // -- the only child -- //
+    struct bucket_t* child;
+    int pos = 0;
    
-    for (int i=0; i < parent->hash_table->size; i++)
+    while ((child = ht_next_child (parent, &pos)))
     {
-        bucket_walker = &parent->hash_table->buckets[i];
-        while (bucket_walker->next_bucket)
-        {
-            bucket_walker = bucket_walker->next_bucket;
-            used++;
-            // -- copy the node to remove -- //
-            *node_tmp = *bucket_walker->next_node;
-            free(bucket_walker->next_node);
-        }
+        if (child == skip)
+            continue;
+        used++;
+        node_tmp = child->next_node;
     } 
-    if (used > 1)
+    if (used != 1)
     {
-        fprintf (stderr, "[trie_node_merge] ERROR: Trying to merge a node with more than one child.\n");
-        // -- [TODO] free -- //
+        fprintf (stderr, "[trie_node_merge] ERROR: Trying to merge a node without exactly one child.\n");
         return 0;
     }
-    for (int i=0; i < parent->hash_table->size; i++)
-    { 
-        if (parent->hash_table->buckets[i].next_bucket)
-            free(parent->hash_table->buckets[i].next_bucket);
-        parent->hash_table->buckets[i].next_bucket = 0;
-    }
-    free(parent->hash_table->buckets);
-    parent->hash_table->buckets = 0;
-    parent->hash_table->size = 0; 
-    parent->hash_table->used = 0;
-    free(parent->hash_table);
-    parent->hash_table = 0;
-
-    // -- copy the parent -- //
-    free(parent_pointer->next_node);
-    parent_pointer->next_node = (struct node_t*)malloc(sizeof(struct node_t));
-    n_parent = parent_pointer->next_node;
+
+    /**
+     * NOTE:
+     *     Neither the parent nor its child is modified in place, as readers
+     *     may be visiting them. The merged node is built aside, published
+     *     by a single pointer store, and then the old ones are retired.
+     */
+    // -- the merged node takes the children of the child (inline copy, or its hash table) -- //
+    n_parent = trie_new_node (ct, node_tmp->hash_table ? 0 : node_tmp->num_of_children);
 
     // -- ready to merge -- //
     num_of_merged_comp = parent->num_of_comp + node_tmp->num_of_comp; 
-    n_parent->comps = (struct comp_t*)malloc(sizeof(struct comp_t) * num_of_merged_comp);
+    n_parent->comps = (struct comp_t*)ar_alloc(&ct->arena, sizeof(struct comp_t) * num_of_merged_comp);
     n_parent->num_of_comp = num_of_merged_comp;
     n_parent->parent = parent->parent;
 
     // -- copy parent's components -- //
     for (int i=0; i<parent->num_of_comp; i++)
     {
-        n_parent->comps[i].bytes = (char*)malloc(parent->comps[i].len + 1);  // -- null terminator -- //
-        n_parent->comps[i].len = parent->comps[i].len;
-        memcpy (n_parent->comps[i].bytes, parent->comps[i].bytes, parent->comps[i].len + 1);
+        n_parent->comps[i] = parent->comps[i];
+        cp_ref (ct, n_parent->comps[i].id);
     }
     // -- copy next_node's components -- //
     for (int i=0; i<node_tmp->num_of_comp; i++)
     {
-        n_parent->comps[parent->num_of_comp + i].bytes = (char*)malloc(node_tmp->comps[i].len + 1);  // -- null terminator -- //
-        n_parent->comps[parent->num_of_comp + i].len = node_tmp->comps[i].len;
-        memcpy (n_parent->comps[parent->num_of_comp + i].bytes, node_tmp->comps[i].bytes, node_tmp->comps[i].len + 1);
+        n_parent->comps[parent->num_of_comp + i] = node_tmp->comps[i];
+        cp_ref (ct, node_tmp->comps[i].id);
     }
 
     // -- copy all children of the next_node (just point to the head!)-- //
-    if (node_tmp->hash_table && node_tmp->hash_table->size)
-    {
+    if (node_tmp->hash_table)
         n_parent->hash_table = node_tmp->hash_table;
-        for (int i=0; i<node_tmp->hash_table->size; i++)
-        {
-            bucket_walker = &node_tmp->hash_table->buckets[i];
-            while (bucket_walker->next_bucket)
-            { 
-                bucket_walker = bucket_walker->next_bucket;
-                if (bucket_walker->key)
-                    bucket_walker->next_node->parent = n_parent;
-            }
-        }
-    }
     else
-        n_parent->hash_table = 0;
+        memcpy (n_parent->children, node_tmp->children, CT_NODE_SIZE(n_parent->num_of_children) - CT_NODE_SIZE(0));
+    trie_adopt_children (n_parent);
 
-    // -- node merge is DONE!-- //
-    // -- free the parent, next_child, and its next_node (do not touch children of the next_node) -- //
-    for (int i=0; i<node_tmp->num_of_comp; i++)
-    {
-        free(node_tmp->comps[i].bytes);
-        node_tmp->comps[i].bytes = 0;
-        node_tmp->comps[i].len = 0;
-    }
-    free(node_tmp->comps);
-    node_tmp->num_of_comp = 0;
-    node_tmp->parent = 0;
-    // -- we did not touch children of node_tmp -- //
-    for (int i=0; i<parent->num_of_comp; i++)
-    {
-        free(parent->comps[i].bytes);
-        parent->comps[i].bytes = 0;
-        parent->comps[i].len = 0;
-    }
-    free(node_tmp);
-    free(parent->comps);
-    free(parent);
-    // -- do not touch parent's children -- //
+    // -- node merge is DONE, publish it -- //
+    EP_PUBLISH(parent_pointer->next_node, n_parent);
+
+    // -- retire the parent, its hash table, and the child (do not touch children of the child) -- //
+    if (parent->hash_table)
+        ep_retire (&ct->epoch, parent->hash_table, ht_reclaim);
+    ep_retire (&ct->epoch, parent, trie_reclaim_node);
+    ep_retire (&ct->epoch, node_tmp, trie_reclaim_node);
     return n_parent;
 } /* -- end of trie_node_merge(..) -- */
 
@@ -1036,42 +1182,25 @@ trie_node_merge (struct ct_instance* ct, struct bucket_t* parent_pointer)
  * This function deallocates a given node and its subtrees.
  * ------------------------------------------------------------------ */
 void
-trie_free_node (struct node_t* node)
+trie_free_node (struct ct_instance* ct, struct node_t* node)
 {
+    assert (ct);
     assert (node);
-    struct bucket_t* bucket_walker;
 
-    if (node->hash_table)
+    struct bucket_t* child;
+    int pos = 0;
+
+    if (node->hash_table && !node->hash_table->size)
+        fprintf (stderr, "[trie_free_node] WARNING: An initialized ht with size ZERO\n");
+    while ((child = ht_next_child (node, &pos)))
     {
-        if (!node->hash_table->size)
-            fprintf (stderr, "[trie_free_node] WARNING: An initialized ht with size ZERO\n");
-        for (int i=0; i<node->hash_table->size; i++)
-        {
-            bucket_walker = &node->hash_table->buckets[i];
-            while (bucket_walker->next_bucket)
-               bucket_walker = bucket_walker->next_bucket;
-            while (!bucket_walker->head)
-            {
-                trie_free_node(bucket_walker->next_node);
-                if (bucket_walker->next_bucket)
-	            free(bucket_walker->next_bucket);
-                bucket_walker->next_bucket = 0;
-                free(bucket_walker->next_node);
-                bucket_walker->next_node = 0;
-                bucket_walker->key = 0; 
-                bucket_walker = bucket_walker->pre_bucket;
-            }
-            if (bucket_walker->next_bucket)
-                free(bucket_walker->next_bucket);  // -- the head -- //
-            bucket_walker->next_bucket = 0;
-        }
-        free(node->hash_table->buckets);
-        node->hash_table->buckets = 0;
-        node->hash_table->size = 0;
-        node->hash_table->used = 0;
-        free(node->hash_table); 
+        trie_free_node(ct, child->next_node);
+        ar_free (&ct->arena, child->next_node, CT_NODE_SIZE(child->next_node->num_of_children));
+        child->next_node = 0;
     }
-    trie_do_free_node (node);
+    if (node->hash_table)
+        ht_free (ct, node->hash_table); 
+    trie_do_free_node (ct, node);
     return;    
 } /* -- end of trie_free_node (..) -- */
 
@@ -1083,21 +1212,92 @@ trie_free_node (struct node_t* node)
  * Freeing all memories allocated to a node and its elements.
  * ------------------------------------------------------------------ */
 void
-trie_do_free_node (struct node_t* node)
+trie_do_free_node (struct ct_instance* ct, struct node_t* node)
 {
+    assert (ct);
     assert (node);
 
     /* -- COMPS PART -- */
     for (int i=0; i<node->num_of_comp; i++)
     {
-        free (node->comps[i].bytes);
-        node->comps[i].bytes = 0;
+        cp_release (ct, node->comps[i].id);
+        node->comps[i].id = CP_NONE;
         node->comps[i].len = 0;
     }
-    free (node->comps);
+    ar_free (&ct->arena, node->comps, sizeof(struct comp_t) * node->num_of_comp);
     node->comps = 0;
     node->num_of_comp = 0;
     node->hash_table = 0;
     node->parent = 0;
     return;
 } /* -- end of trie_do_free_node (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: trie_reclaim_node (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Reclaim a retired node, when no reader can hold it any more (see
+ * ep_retire; the argument is the trie instance). The hash table of the
+ * node is not touched, since it is either retired separately or it is
+ * handed over to a new node.
+ * ------------------------------------------------------------------ */
+void
+trie_reclaim_node (void* arg, void* ptr)
+{
+    assert (arg);
+    assert (ptr);
+    struct ct_instance* ct = (struct ct_instance*)arg;
+
+    trie_do_free_node (ct, (struct node_t*)ptr);
+    ar_free (&ct->arena, ptr, CT_NODE_SIZE(((struct node_t*)ptr)->num_of_children));
+    return;
+} /* -- end of trie_reclaim_node (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: trie_ctx_init (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Initialize the context of a caller. A reader context (i.e. a context
+ * of a thread which does lookups concurrently with the writer) is
+ * registered in the epoch domain of the trie.
+ *
+ * RETURN:
+ *    0: DONE!
+ *    1: ERROR (no free reader record)
+ * ------------------------------------------------------------------ */
+int
+trie_ctx_init (struct ct_instance* ct, struct ct_ctx* ctx, bool reader)
+{
+    assert (ct);
+    assert (ctx);
+
+    for (int i=0; i<MAX_HEIGHT; i++)
+        ctx->visitedChildren[i] = 0;
+    ctx->reader = 0;
+    if (reader && !(ctx->reader = ep_register (&ct->epoch)))
+    {
+        fprintf (stderr, "[trie_ctx_init] ERROR: No reader record is available.\n");
+        return 1;
+    }
+    return 0;
+} /* -- end of trie_ctx_init (..) -- */
+
+/* -----------------------------------------------------------------
+ * Method: trie_ctx_free (..)
+ * Scope: Protected
+ *
+ * Description:
+ * Release the context of a caller (unregister the reader, if any).
+ * ------------------------------------------------------------------ */
+void
+trie_ctx_free (struct ct_ctx* ctx)
+{
+    assert (ctx);
+
+    if (ctx->reader)
+        ep_unregister (ctx->reader);
+    ctx->reader = 0;
+    return;
+} /* -- end of trie_ctx_free (..) -- */
@@ -33,6 +33,7 @@
 #include "cm_component.h"
 #include "db_debug.h"
 #include "db_debug_struct.h"
+#include "ht_hashtable.h"
 
 
 /* -----------------------------------------------------------------------------------
@@ -52,6 +53,8 @@ db_dfs (struct ct_instance* ct, bool print_flag)
     ct->trie_stat->id = 0;
     ct->trie_stat->chain_length = 0;
     ct->trie_stat->ht_size = 0;
+    for (int i=0; i<CT_NUM_OF_KINDS; i++)
+        ct->trie_stat->kinds[i] = 0;
 
     // -- take the root and start -- //
     if (ct->root.hash_table == 0)
@@ -118,7 +121,6 @@ db_do_dfs (struct ct_instance* ct, struct node_t* node, struct node_t* parent, i
     assert (ct);
     assert (trie_stat);
     int id;
-    struct bucket_t* bucket_walker;
 
     // -- claim your own id -- //
     trie_stat->id++;
@@ -131,14 +133,14 @@ db_do_dfs (struct ct_instance* ct, struct node_t* node, struct node_t* parent, i
     {
         if (!node->hash_table || !node->hash_table->size)
         {
-           fprintf (dot, "\t{\"<%u><%s>\" [label=\"<%s>\"]};", p_id, node->comps[0].bytes, node->comps[0].bytes);
+           fprintf (dot, "\t{\"<%u><%s>\" [label=\"<%s>\"]};", p_id, CP_BYTES(&ct->pool, node->comps[0].id), CP_BYTES(&ct->pool, node->comps[0].id));
            fclose (dot);
            return 0;
         } 
     }
     else
     {
-        db_print_node_to_file (node, parent, trie_stat->id, p_id);
+        db_print_node_to_file (ct, node, parent, trie_stat->id, p_id);
     }
     fclose(dot);
 
@@ -148,8 +150,9 @@ db_do_dfs (struct ct_instance* ct, struct node_t* node, struct node_t* parent, i
         exit(0);
     }
     trie_stat->width[height] = trie_stat->width[height] + 1;
+    trie_stat->kinds[CT_NODE_KIND(node)]++;
 
-    if (!node->hash_table)
+    if (CT_NODE_KIND(node) == CT_KIND_LEAF)
     {
         // -- this is a leaf -- //
         trie_stat->max = (trie_stat->max < height) ? height : trie_stat->max;
@@ -157,39 +160,32 @@ db_do_dfs (struct ct_instance* ct, struct node_t* node, struct node_t* parent, i
         trie_stat->sum += height;
         return height;
     }
-    else
+    else if (node->hash_table)
     {
         trie_stat->ht_size += node->hash_table->size;
-        // --here we calculate the avg length of chains (buckets with head=0 are not counted since they have chain length 0) -- //
-        int counter1 = 0; //-- number of all buckets --//
-        int counter2 = 0; //--number of chains --//
+        // -- here we calculate the avg length of chains (i.e. number of groups probed to reach each child) -- //
+        int counter1 = 0; //-- sum of probe lengths --//
+        int counter2 = 0; //-- number of children --//
         for (int i=0; i<node->hash_table->size; i++)
         {
-            bucket_walker = &node->hash_table->buckets[i];
-            if (bucket_walker->next_bucket !=0)
+            if (HT_IS_FULL(node->hash_table->tags[i]))
             {
-                counter2 += 1;    
-                while (bucket_walker->next_bucket)
-                {
-                    counter1 += 1;
-                    bucket_walker = bucket_walker->next_bucket;
-                }
-            }   
+                counter1 += ht_probe_length (node->hash_table, i);
+                counter2 += 1;
+            }
         }
-        trie_stat->chain_length += (float)((float)counter1) / counter2;
+        if (counter2)
+            trie_stat->chain_length += (float)((float)counter1) / counter2;
     }
-    for (int i=0; i<node->hash_table->size; i++)
+    struct bucket_t* child;
+    int pos = 0;
+    while ((child = ht_next_child (node, &pos)))
     {
-        bucket_walker=&node->hash_table->buckets[i];
-        while (bucket_walker->next_bucket) 
+        db_do_dfs (ct, child->next_node, node, height + 1, trie_stat, id, print_flag); 
+        if (print_flag)
         {
-            bucket_walker = bucket_walker->next_bucket;
-            db_do_dfs (ct, bucket_walker->next_node, node, height + 1, trie_stat, id, print_flag); 
-            if (print_flag)
-            {
-                printf ("H:%u   ",height);
-                db_print_node (bucket_walker->next_node);
-            }
+            printf ("H:%u   ",height);
+            db_print_node (ct, child->next_node);
         }
     }
     // -- this is not a leaf -- //
@@ -205,12 +201,12 @@ db_do_dfs (struct ct_instance* ct, struct node_t* node, struct node_t* parent, i
  * Print component(s) of node.
  * ----------------------------------------------------------------------------------- */
 void
-db_print_node (struct node_t* node)
+db_print_node (struct ct_instance* ct, struct node_t* node)
 {
     for (int i=0; i<node->num_of_comp; i++)
     {
-        if (isprint(node->comps[i].bytes[0]))
-            printf ("<%s>", node->comps[i].bytes);
+        if (isprint(CP_BYTES(&ct->pool, node->comps[i].id)[0]))
+            printf ("<%s>", CP_BYTES(&ct->pool, node->comps[i].id));
         else
         {
             if (node->comps[i].len > 1)
@@ -218,7 +214,7 @@ db_print_node (struct node_t* node)
                 fprintf (stderr, "[db_print_node] WARNING: Too long EON.\n");
                 return;
             }
-            printf ("<%u>", node->comps[i].bytes[0]);
+            printf ("<%u>", CP_BYTES(&ct->pool, node->comps[i].id)[0]);
         }
     }
     printf ("\n");
@@ -234,7 +230,7 @@ db_print_node (struct node_t* node)
  * Print component(s) of node to dot file.
  * ----------------------------------------------------------------------------------- */
 void
-db_print_node_to_file (struct node_t* node, struct node_t* parent, signed int id, signed int p_id)
+db_print_node_to_file (struct ct_instance* ct, struct node_t* node, struct node_t* parent, signed int id, signed int p_id)
 {
     FILE* dot = fopen(DOT_FILE_PATH, "a");
 
@@ -242,8 +238,8 @@ db_print_node_to_file (struct node_t* node, struct node_t* parent, signed int id
     fprintf (dot,"\t{\"<%u>", p_id);
     for (int i=0; i<parent->num_of_comp; i++)
     {
-        if (isprint(parent->comps[i].bytes[0]))
-            fprintf (dot, "<%s>", parent->comps[i].bytes);
+        if (isprint(CP_BYTES(&ct->pool, parent->comps[i].id)[0]))
+            fprintf (dot, "<%s>", CP_BYTES(&ct->pool, parent->comps[i].id));
         else
         {
             if (parent->comps[i].len > 1)
@@ -252,15 +248,15 @@ db_print_node_to_file (struct node_t* node, struct node_t* parent, signed int id
                 fclose(dot);
                 return;
             }
-            fprintf (dot, "<%u>", parent->comps[i].bytes[0]);
+            fprintf (dot, "<%u>", CP_BYTES(&ct->pool, parent->comps[i].id)[0]);
         }
     }
     fprintf (dot, "\" ");
     fprintf (dot, "[label=\"");
     for (int i=0; i<parent->num_of_comp; i++)
     {
-        if (isprint(parent->comps[i].bytes[0]))
-            fprintf (dot, "<%s>", parent->comps[i].bytes);
+        if (isprint(CP_BYTES(&ct->pool, parent->comps[i].id)[0]))
+            fprintf (dot, "<%s>", CP_BYTES(&ct->pool, parent->comps[i].id));
         else
         {
             if (parent->comps[i].len > 1)
@@ -269,7 +265,7 @@ db_print_node_to_file (struct node_t* node, struct node_t* parent, signed int id
                 fclose(dot);
                 return;
             }
-            fprintf (dot, "<%u>", parent->comps[i].bytes[0]);
+            fprintf (dot, "<%u>", CP_BYTES(&ct->pool, parent->comps[i].id)[0]);
         }
     }
     fprintf (dot, "\"]}");
@@ -278,8 +274,8 @@ db_print_node_to_file (struct node_t* node, struct node_t* parent, signed int id
     fprintf (dot, " -> {\"<%u>",id);
     for (int i=0; i<node->num_of_comp; i++)
     {
-        if (isprint(node->comps[i].bytes[0]))
-            fprintf (dot, "<%s>", node->comps[i].bytes);
+        if (isprint(CP_BYTES(&ct->pool, node->comps[i].id)[0]))
+            fprintf (dot, "<%s>", CP_BYTES(&ct->pool, node->comps[i].id));
         else
         {
             if (node->comps[i].len > 1)
@@ -288,15 +284,15 @@ db_print_node_to_file (struct node_t* node, struct node_t* parent, signed int id
                 fclose(dot);
                 return;
             }
-            fprintf (dot, "<%u>", node->comps[i].bytes[0]);
+            fprintf (dot, "<%u>", CP_BYTES(&ct->pool, node->comps[i].id)[0]);
         }
     }
     fprintf (dot, "\" ");
     fprintf (dot, "[label=\"");
     for (int i=0; i<node->num_of_comp; i++)
     {
-        if (isprint(node->comps[i].bytes[0]))
-            fprintf (dot, "<%s>", node->comps[i].bytes);
+        if (isprint(CP_BYTES(&ct->pool, node->comps[i].id)[0]))
+            fprintf (dot, "<%s>", CP_BYTES(&ct->pool, node->comps[i].id));
         else
         {
             if (node->comps[i].len > 1)
@@ -305,7 +301,7 @@ db_print_node_to_file (struct node_t* node, struct node_t* parent, signed int id
                 fclose(dot);
                 return;
             }
-            fprintf (dot, "<%u>", node->comps[i].bytes[0]);
+            fprintf (dot, "<%u>", CP_BYTES(&ct->pool, node->comps[i].id)[0]);
         }
     }
     fprintf (dot, "\"]};\n");
@@ -0,0 +1,326 @@
+/* -*- Mode:C; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018-2019
+ * Regents of the University of Arizona & University of Michigan.
+ *
+ * TrieGranularity is a free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later version.
+ *
+ * TrieGranularity source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received copies of the GNU General Public License and GNU Lesser
+ * General Public License along with TrieGranularity, e.g., in COPYING.md or LICENSE file.
+ * If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * For list of authors, please see AUTHORS.md file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+#include "ep_epoch.h"
+
+// -- a retired list which is taken out of the domain, to be reclaimed -- //
+struct ep_taken_t {
+    int list;
+    struct ep_retired_t* retired;
+    int num_of_retired;
+    int size_of_retired;
+};
+
+/* ---------------------------------------------------------------------
+ * Method: ep_init (..)
+ * Scope: Global
+ *
+ * Description:
+ * Initialize an epoch domain (i.e. one per trie). The given argument
+ * is passed to every reclaim function of the domain.
+ * --------------------------------------------------------------------- */
+void
+ep_init (struct ep_domain_t* ep, void* arg)
+{
+    assert (ep);
+
+    ep->epoch = 0;
+    ep->records = (struct ep_record_t*)calloc(EP_MAX_READERS, sizeof(struct ep_record_t));
+    for (int i=0; i<EP_NUM_OF_LISTS; i++)
+    {
+        ep->retired[i] = 0;
+        ep->num_of_retired[i] = 0;
+        ep->size_of_retired[i] = 0;
+    }
+    ep->since_advance = 0;
+    ep->arg = arg;
+    pthread_mutex_init (&ep->lock, 0);
+} /* -- end of ep_init (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ep_take_list (..)
+ * Scope: Private
+ *
+ * Description:
+ * Take a retired list out of the domain, to be reclaimed by
+ * ep_reclaim_list. The lock of the domain should be taken.
+ * --------------------------------------------------------------------- */
+static void
+ep_take_list (struct ep_domain_t* ep, int list, struct ep_taken_t* taken)
+{
+    taken->list = list;
+    taken->retired = ep->retired[list];
+    taken->num_of_retired = ep->num_of_retired[list];
+    taken->size_of_retired = ep->size_of_retired[list];
+    ep->retired[list] = 0;
+    ep->num_of_retired[list] = 0;
+    ep->size_of_retired[list] = 0;
+} /* -- end of ep_take_list (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ep_reclaim_list (..)
+ * Scope: Private
+ *
+ * Description:
+ * Free all objects of a list which is taken out of the domain. The lock
+ * of the domain should NOT be taken: a reclaim function may retire
+ * other objects (e.g. a node may drop the last reference to a pooled
+ * component).
+ * --------------------------------------------------------------------- */
+static void
+ep_reclaim_list (struct ep_domain_t* ep, struct ep_taken_t* taken)
+{
+    for (int i=0; i<taken->num_of_retired; i++)
+        taken->retired[i].reclaim (ep->arg, taken->retired[i].ptr);
+
+    // -- give the array back, unless the list has got a new one meanwhile -- //
+    pthread_mutex_lock (&ep->lock);
+    if (ep->retired[taken->list])
+        free(taken->retired);
+    else
+    {
+        ep->retired[taken->list] = taken->retired;
+        ep->size_of_retired[taken->list] = taken->size_of_retired;
+    }
+    pthread_mutex_unlock (&ep->lock);
+} /* -- end of ep_reclaim_list (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ep_destroy (..)
+ * Scope: Global
+ *
+ * Description:
+ * Free all retired objects and the domain itself. No reader should be
+ * in a read section anymore.
+ * --------------------------------------------------------------------- */
+void
+ep_destroy (struct ep_domain_t* ep)
+{
+    assert (ep);
+
+    struct ep_taken_t taken;
+    int done = 0;
+
+    // -- objects may be retired while others are reclaimed -- //
+    while (!done)
+    {
+        done = 1;
+        for (int i=0; i<EP_NUM_OF_LISTS; i++)
+        {
+            if (ep->num_of_retired[i])
+            {
+                pthread_mutex_lock (&ep->lock);
+                ep_take_list (ep, i, &taken);
+                pthread_mutex_unlock (&ep->lock);
+                ep_reclaim_list (ep, &taken);
+                done = 0;
+            }
+        }
+    }
+    for (int i=0; i<EP_NUM_OF_LISTS; i++)
+    {
+        free(ep->retired[i]);
+        ep->retired[i] = 0;
+        ep->size_of_retired[i] = 0;
+    }
+    free(ep->records);
+    ep->records = 0;
+    pthread_mutex_destroy (&ep->lock);
+} /* -- end of ep_destroy (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ep_register (..)
+ * Scope: Global
+ *
+ * Description:
+ * Take a free record for a new reader (thread safe).
+ *
+ * RETURN:
+ *    the record, or NULL if there are already EP_MAX_READERS readers.
+ * --------------------------------------------------------------------- */
+struct ep_record_t*
+ep_register (struct ep_domain_t* ep)
+{
+    assert (ep);
+    int expected;
+
+    for (int i=0; i<EP_MAX_READERS; i++)
+    {
+        expected = 0;
+        if (__atomic_compare_exchange_n (&ep->records[i].used, &expected, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+        {
+            __atomic_store_n (&ep->records[i].state, 0, __ATOMIC_RELEASE);
+            return &ep->records[i];
+        }
+    }
+    fprintf (stderr, "[ep_register] ERROR: Too many readers (max is %d).\n", EP_MAX_READERS);
+    return 0;
+} /* -- end of ep_register (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ep_unregister (..)
+ * Scope: Global
+ *
+ * Description:
+ * Give the record of a reader back.
+ * --------------------------------------------------------------------- */
+void
+ep_unregister (struct ep_record_t* rec)
+{
+    assert (rec);
+    __atomic_store_n (&rec->state, 0, __ATOMIC_RELEASE);
+    __atomic_store_n (&rec->used, 0, __ATOMIC_RELEASE);
+} /* -- end of ep_unregister (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ep_enter (..)
+ * Scope: Global
+ *
+ * Description:
+ * Start a read section: announce the global epoch. Nothing that is
+ * reachable from now on is freed before ep_exit(..).
+ * NOTE:
+ *     The store has to be visible to the writers before any pointer of
+ *     the trie is loaded (full fence).
+ * --------------------------------------------------------------------- */
+void
+ep_enter (struct ep_domain_t* ep, struct ep_record_t* rec)
+{
+    unsigned long epoch = __atomic_load_n (&ep->epoch, __ATOMIC_RELAXED);
+    __atomic_store_n (&rec->state, (epoch << 1) | 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+} /* -- end of ep_enter (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ep_exit (..)
+ * Scope: Global
+ *
+ * Description:
+ * End a read section.
+ * --------------------------------------------------------------------- */
+void
+ep_exit (struct ep_record_t* rec)
+{
+    __atomic_store_n (&rec->state, 0, __ATOMIC_RELEASE);
+} /* -- end of ep_exit (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ep_do_advance (..)
+ * Scope: Private
+ *
+ * Description:
+ * Try to advance the global epoch. It fails if an active reader has not
+ * announced the current epoch yet. When it succeeds, the list of objects
+ * retired two epochs ago is taken out of the domain, to be reclaimed
+ * (out of the lock). The lock of the domain should be taken.
+ *
+ * RETURN:
+ *    1: advanced
+ *    0: not advanced
+ * --------------------------------------------------------------------- */
+static int
+ep_do_advance (struct ep_domain_t* ep, struct ep_taken_t* taken)
+{
+    unsigned long epoch = ep->epoch;
+    unsigned long state;
+
+    ep->since_advance = 0;
+    __atomic_thread_fence (__ATOMIC_SEQ_CST);
+    for (int i=0; i<EP_MAX_READERS; i++)
+    {
+        if (!__atomic_load_n (&ep->records[i].used, __ATOMIC_ACQUIRE))
+            continue;
+        state = __atomic_load_n (&ep->records[i].state, __ATOMIC_SEQ_CST);
+        if ((state & 1) && (state >> 1) != epoch)
+            return 0;  // -- a reader is still in an older epoch -- //
+    }
+    __atomic_store_n (&ep->epoch, epoch + 1, __ATOMIC_SEQ_CST);
+    // -- the list of (epoch + 1 - 2) is reused by the next epoch -- //
+    ep_take_list (ep, (epoch + 2) % EP_NUM_OF_LISTS, taken);
+    return 1;
+} /* -- end of ep_do_advance (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ep_retire (..)
+ * Scope: Global
+ *
+ * Description:
+ * Hand an object, which is not reachable from the trie anymore, over to
+ * the domain. It is freed by the given function once no reader can hold
+ * a reference to it (thread safe).
+ * --------------------------------------------------------------------- */
+void
+ep_retire (struct ep_domain_t* ep, void* ptr, void (*reclaim) (void*, void*))
+{
+    assert (ep);
+    struct ep_taken_t taken;
+    int advanced = 0;
+    int list;
+
+    pthread_mutex_lock (&ep->lock);
+    list = ep->epoch % EP_NUM_OF_LISTS;
+    if (ep->num_of_retired[list] == ep->size_of_retired[list])
+    {
+        ep->size_of_retired[list] = ep->size_of_retired[list] ? ep->size_of_retired[list] * 2 : EP_ADVANCE_PERIOD;
+        ep->retired[list] = (struct ep_retired_t*)realloc(ep->retired[list], sizeof(struct ep_retired_t) * ep->size_of_retired[list]);
+    }
+    ep->retired[list][ep->num_of_retired[list]].ptr = ptr;
+    ep->retired[list][ep->num_of_retired[list]].reclaim = reclaim;
+    ep->num_of_retired[list]++;
+
+    if (++ep->since_advance >= EP_ADVANCE_PERIOD)
+        advanced = ep_do_advance (ep, &taken);
+    pthread_mutex_unlock (&ep->lock);
+    if (advanced)
+        ep_reclaim_list (ep, &taken);
+} /* -- end of ep_retire (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ep_advance (..)
+ * Scope: Global
+ *
+ * Description:
+ * Try to advance the global epoch, and free the objects retired two
+ * epochs ago if it succeeds (thread safe). See ep_do_advance.
+ *
+ * RETURN:
+ *    1: advanced
+ *    0: not advanced
+ * --------------------------------------------------------------------- */
+int
+ep_advance (struct ep_domain_t* ep)
+{
+    assert (ep);
+    struct ep_taken_t taken;
+    int advanced;
+
+    pthread_mutex_lock (&ep->lock);
+    advanced = ep_do_advance (ep, &taken);
+    pthread_mutex_unlock (&ep->lock);
+    if (advanced)
+        ep_reclaim_list (ep, &taken);
+    return advanced;
+} /* -- end of ep_advance (..) -- */
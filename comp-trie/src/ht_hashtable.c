@@ -23,81 +23,384 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "ht_hashtable.h"
 #include "ct_trie.h"
+#include "ep_epoch.h"
+#include "ar_arena.h"
 #include "xxhash.h"
 
+#define HT_HEADER_SIZE ((sizeof(struct ht_t) + 15) & ~(size_t)15)  // -- keep buckets 16-byte aligned -- //
+#define HT_NUM_OF_GROUPS(ht) ((ht)->size < HT_GROUP_SIZE ? 1 : (ht)->size / HT_GROUP_SIZE)
+#define HT_VALID_MASK(ht) ((ht)->size < HT_GROUP_SIZE ? (1u << (ht)->size) - 1 : 0xFFFFu)
+#define HT_NUM_OF_TAGS(slots) ((slots) < HT_GROUP_SIZE ? HT_GROUP_SIZE : (slots))
+#define HT_BLOCK_SIZE(slots) (HT_HEADER_SIZE + sizeof(struct bucket_t) * (slots) + HT_NUM_OF_TAGS(slots))
+#define HT_LIMIT(size) ((size) < HT_GROUP_SIZE ? (size) : (size) - (size) / 8)  // -- max load (7/8) -- //
 
 /* ---------------------------------------------------------------------
- * Method: ht_lookup (..)
+ * Method: ht_group_match (..)
+ * Scope: Private
+ *
+ * Description:
+ * Compare all tags of a group with the given tag. Bit i of the returned
+ * mask is set, if the i-th slot of the group holds that tag.
+ * --------------------------------------------------------------------- */
+static inline unsigned int
+ht_group_match (const unsigned char* tags, unsigned char tag)
+{
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128 ((const __m128i*)tags);
+    return (unsigned int)_mm_movemask_epi8 (_mm_cmpeq_epi8 (group, _mm_set1_epi8 ((char)tag)));
+#else
+    unsigned int mask = 0;
+    for (int i=0; i<HT_GROUP_SIZE; i++)
+    {
+        if (tags[i] == tag)
+            mask |= 1u << i;
+    }
+    return mask;
+#endif
+} /* -- end of ht_group_match (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_group_match_free (..)
+ * Scope: Private
+ *
+ * Description:
+ * Return the mask of the slots of a group which are not full (i.e. empty
+ * or deleted). The high bit of the tag says it all.
+ * --------------------------------------------------------------------- */
+static inline unsigned int
+ht_group_match_free (const unsigned char* tags)
+{
+#ifdef __SSE2__
+    return (unsigned int)_mm_movemask_epi8 (_mm_loadu_si128 ((const __m128i*)tags));
+#else
+    unsigned int mask = 0;
+    for (int i=0; i<HT_GROUP_SIZE; i++)
+    {
+        if (!HT_IS_FULL(tags[i]))
+            mask |= 1u << i;
+    }
+    return mask;
+#endif
+} /* -- end of ht_group_match_free (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_find_slot (..)
+ * Scope: Private
+ *
+ * Description:
+ * Probe the table group by group for a given component. Probing stops
+ * at the first group which has an empty slot.
+ *
+ * Components are compared by their IDs in the pool. If the ID is
+ * CP_UNKNOWN, the first slot with the same key is taken.
+ *
+ * RETURN:
+ *    index of the slot, or -1 if the component is not in the table.
+ * --------------------------------------------------------------------- */
+static int
+ht_find_slot (struct ht_t* ht, unsigned long long key, unsigned int id)
+{
+    unsigned int num_of_groups = HT_NUM_OF_GROUPS(ht);
+    unsigned int valid = HT_VALID_MASK(ht);
+    unsigned int group = (unsigned int)(key >> 7) & (num_of_groups - 1);
+    unsigned char tag = (unsigned char)(key & 0x7F);
+    unsigned int match;
+    struct bucket_t* bucket;
+    struct node_t* next_node;
+    int slot;
+
+    /**
+     * NOTE:
+     *     A group of tags is read by one (non-atomic) vector load, while the
+     *     writer may be publishing a tag of the group. A torn view is harmless:
+     *     a matched slot is verified through its (atomically loaded) bucket.
+     */
+    for (unsigned int probe=0; probe < num_of_groups; probe++)
+    {
+        match = ht_group_match (&ht->tags[group * HT_GROUP_SIZE], tag) & valid;
+        while (match)
+        {
+            slot = group * HT_GROUP_SIZE + __builtin_ctz (match);
+            bucket = &ht->buckets[slot];
+            __atomic_thread_fence (__ATOMIC_ACQUIRE);  // -- the tag is published after the bucket -- //
+            next_node = EP_LOAD(bucket->next_node);
+            // -- keys may collide, so make sure components are equal as well -- //
+            if (EP_LOAD(bucket->key) == key && (id == CP_UNKNOWN || next_node->comps[0].id == id))
+                return slot;
+            match &= match - 1;
+        }
+        if (ht_group_match (&ht->tags[group * HT_GROUP_SIZE], HT_EMPTY) & valid)
+            return -1;  // -- the name could not have been placed any further -- //
+        group = (group + probe + 1) & (num_of_groups - 1);  // -- triangular probing -- //
+    }
+    return -1;
+} /* -- end of ht_find_slot (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_place (..)
+ * Scope: Private
+ *
+ * Description:
+ * Take the first free slot on the probing sequence of a key. The caller
+ * makes sure the key is not in the table and the table is not full.
+ * NOTE:
+ *     The tag is published last, so a concurrent reader never matches a
+ *     slot whose bucket is not filled yet.
+ * --------------------------------------------------------------------- */
+static struct bucket_t*
+ht_place (struct ht_t* ht, unsigned long long key, struct node_t* next_node)
+{
+    unsigned int num_of_groups = HT_NUM_OF_GROUPS(ht);
+    unsigned int valid = HT_VALID_MASK(ht);
+    unsigned int group = (unsigned int)(key >> 7) & (num_of_groups - 1);
+    unsigned int match;
+    int slot;
+
+    for (unsigned int probe=0; probe < num_of_groups; probe++)
+    {
+        match = ht_group_match_free (&ht->tags[group * HT_GROUP_SIZE]) & valid;
+        if (match)
+        {
+            slot = group * HT_GROUP_SIZE + __builtin_ctz (match);
+            if (ht->tags[slot] == HT_DELETED)
+                ht->deleted--;
+            EP_PUBLISH(ht->buckets[slot].key, key);  // -- a reader may still be checking the old entry -- //
+            EP_PUBLISH(ht->buckets[slot].next_node, next_node);
+            EP_PUBLISH(ht->tags[slot], (unsigned char)(key & 0x7F));
+            ht->used++;
+            return &ht->buckets[slot];
+        }
+        group = (group + probe + 1) & (num_of_groups - 1);
+    }
+    return 0;
+} /* -- end of ht_place (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_alloc (..)
  * Scope: Global
- * 
+ *
  * Description:
- * Look up a given name, based on the first component of the nodes.
+ * Allocate an empty hash table (in the arena of the trie). The number of
+ * slots is rounded up to a power of two. Header, buckets, and tags share
+ * one memory block.
  * --------------------------------------------------------------------- */
-struct bucket_t*
-ht_lookup (struct ct_instance* ct, struct node_t* node, char* first_comp, bool print_flag)
+struct ht_t*
+ht_alloc (struct ct_instance* ct, int size)
 {
     assert (ct);
+    int slots = 1;
+    int num_of_tags;
+    struct ht_t* ht;
 
-    unsigned long long key = ht_keygen (first_comp);
-    unsigned int index;
-    struct bucket_t* bucket_walker; 
-    bool equal;
+    while (slots < size)
+        slots <<= 1;
+    num_of_tags = HT_NUM_OF_TAGS(slots);
 
-    if (!key)
+    ht = (struct ht_t*)ar_alloc(&ct->arena, HT_BLOCK_SIZE(slots));
+    if (!ht)
     {
-        fprintf (stderr, "[ht_lookup] ERROR: Key generating has been failed.\n");
+        fprintf (stderr, "[ht_alloc] ERROR: Memory allocation has been failed.\n");
         return 0;
     }
-    if (!node->hash_table || !node->hash_table->size)
-        return 0;
-    if (!node->hash_table->buckets)
+    ht->buckets = (struct bucket_t*)((char*)ht + HT_HEADER_SIZE);
+    ht->tags = (unsigned char*)(ht->buckets + slots);
+    ht->size = slots;
+    ht->used = 0;
+    ht->deleted = 0;
+    memset (ht->buckets, 0, sizeof(struct bucket_t) * slots);
+    memset (ht->tags, HT_EMPTY, slots);
+    memset (ht->tags + slots, HT_SENTINEL, num_of_tags - slots);
+    return ht;
+} /* -- end of ht_alloc (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_free (..)
+ * Scope: Global
+ *
+ * Description:
+ * Release a hash table. Nodes pointed by its buckets are not touched.
+ * --------------------------------------------------------------------- */
+void
+ht_free (struct ct_instance* ct, struct ht_t* ht)
+{
+    assert (ct);
+    ar_free (&ct->arena, ht, HT_BLOCK_SIZE(ht->size));
+} /* -- end of ht_free (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_reclaim (..)
+ * Scope: Global
+ *
+ * Description:
+ * Release a retired hash table (see ep_retire). The argument is the
+ * trie instance which owns the table.
+ * --------------------------------------------------------------------- */
+void
+ht_reclaim (void* ct, void* ht)
+{
+    ht_free ((struct ct_instance*)ct, (struct ht_t*)ht);
+} /* -- end of ht_reclaim (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_lookup (..)
+ * Scope: Global
+ * 
+ * Description:
+ * Look up a given name, based on the first component of the nodes. The
+ * key of the component is computed by the caller (see cm_next_comp), and
+ * so is its ID in the pool. Children of a small node are looked up in
+ * its inline array.
+ * --------------------------------------------------------------------- */
+struct bucket_t*
+ht_lookup (struct ct_instance* ct, struct node_t* node, unsigned int id, unsigned long long key, bool print_flag)
+{
+    assert (ct);
+
+    struct ht_t* ht = EP_LOAD(node->hash_table);  // -- the writer may replace it (see ht_rehash) -- //
+    int slot;
+
+    if (id == CP_NONE)
+        return 0;  // -- the component is not interned, so no node holds it -- //
+    if (!ht)
+        return ht_small_lookup (node, key, id);
+
+    // -- do not check ht->used, it is the writer's; an empty table has no match anyway -- //
+    if ((slot = ht_find_slot (ht, key, id)) < 0)
+        return 0;  // --NOT FOUND -- //
+    return &ht->buckets[slot];
+} /* -- end of ht_lookup(..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_small_lookup (..)
+ * Scope: Global
+ * 
+ * Description:
+ * Look up a given component among the inline children of a small node.
+ * Children are sorted by their keys, so the scan stops at the first
+ * greater key. If the ID is CP_UNKNOWN, the key is enough.
+ * --------------------------------------------------------------------- */
+struct bucket_t*
+ht_small_lookup (struct node_t* node, unsigned long long key, unsigned int id)
+{
+    struct node_t* next_node;
+
+    for (int i=0; i<node->num_of_children; i++)
     {
-        fprintf (stderr, "[ht_lookup] WARNING: An initialized ht without bucket.\n");
-        return 0;
+        if (node->children[i].key < key)
+            continue;
+        if (node->children[i].key > key)
+            return 0;
+        next_node = EP_LOAD(node->children[i].next_node);
+        if (id == CP_UNKNOWN || next_node->comps[0].id == id)
+            return &node->children[i];
     }
+    return 0;
+} /* -- end of ht_small_lookup (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_next_child (..)
+ * Scope: Global
+ * 
+ * Description:
+ * Iterate children of a node of any kind (only the writer may call it).
+ * Start with zero as the position.
+ *
+ * RETURN:
+ *    the next child, or NULL if there is no more child.
+ * --------------------------------------------------------------------- */
+struct bucket_t*
+ht_next_child (struct node_t* node, int* pos)
+{
+    struct ht_t* ht = node->hash_table;
 
-    index = key % node->hash_table->size;
-    bucket_walker = &node->hash_table->buckets[index];   
-    while (bucket_walker->next_bucket)
+    if (!ht)
+        return (*pos < node->num_of_children) ? &node->children[(*pos)++] : 0;
+    while (*pos < ht->size)
     {
-        bucket_walker = bucket_walker->next_bucket;
-        if (bucket_walker->key == key)
-        {
-            // -- keys are equal, make sure components are NOT equal before insertion -- //
-            equal = true;
-            if (bucket_walker->next_node->comps[0].len != strlen(first_comp))
-                equal = false;
-            if (equal)
-            { 
-                for (int i=0; i < strlen(first_comp); i++)
-                {
-                    if (bucket_walker->next_node->comps[0].bytes[i] != first_comp[i]) 
-                    {
-                        equal = false; 
-                        break;
-                    }
-                }
-            }
-            if (!equal)
-            {
-                // -- THIS IS WARNING [KEYs are equal BUT contents are different] -- //
-                fprintf (stderr, "[ht_lookup] WARNING: HT COLLISION, FIX IT.\n"); 
-                return 0;
-            }
-            else
-            {
-                // -- FOUND! -- //
-                return bucket_walker;
-            }
-        }
+        if (HT_IS_FULL(ht->tags[(*pos)++]))
+            return &ht->buckets[*pos - 1];
     }
-
-    // --NOT FOUND -- //
     return 0;
-} /* -- end of ht_lookup(..) -- */
+} /* -- end of ht_next_child (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_num_of_children (..)
+ * Scope: Global
+ * 
+ * Description:
+ * Number of children of a node of any kind.
+ * --------------------------------------------------------------------- */
+int
+ht_num_of_children (struct node_t* node)
+{
+    return node->hash_table ? node->hash_table->used : node->num_of_children;
+} /* -- end of ht_num_of_children (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_build (..)
+ * Scope: Global
+ * 
+ * Description:
+ * Build a hash table (aside) for a given group of children, e.g. when a
+ * small node grows. The table has room for at least one more child.
+ * --------------------------------------------------------------------- */
+struct ht_t*
+ht_build (struct ct_instance* ct, struct bucket_t* children, int num_of_children)
+{
+    assert (ct);
+    int size = (ct->ht_init_size > 0) ? ct->ht_init_size : 1;
+    struct ht_t* ht;
+
+    while (HT_LIMIT(size) < num_of_children + 1)
+        size <<= 1;
+    if (!(ht = ht_alloc (ct, size)))
+        return 0;
+    for (int i=0; i<num_of_children; i++)
+        ht_place (ht, children[i].key, children[i].next_node);
+    return ht;
+} /* -- end of ht_build (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_lookup_key (..)
+ * Scope: Global
+ * 
+ * Description:
+ * Look up a given key in a hash table, without touching the child nodes.
+ * The caller has to verify the first component of the returned child, as
+ * different components may have the same key (then use ht_lookup).
+ * --------------------------------------------------------------------- */
+struct bucket_t*
+ht_lookup_key (struct ht_t* ht, unsigned long long key)
+{
+    int slot;
+
+    if (!ht || (slot = ht_find_slot (ht, key, CP_UNKNOWN)) < 0)
+        return 0;
+    return &ht->buckets[slot];
+} /* -- end of ht_lookup_key (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_prefetch (..)
+ * Scope: Global
+ * 
+ * Description:
+ * Prefetch the first group (tags and buckets) which is probed for a given
+ * key. The header of the table should be in the cache already.
+ * --------------------------------------------------------------------- */
+void
+ht_prefetch (struct ht_t* ht, unsigned long long key)
+{
+    unsigned int group = (unsigned int)(key >> 7) & (HT_NUM_OF_GROUPS(ht) - 1);
+
+    __builtin_prefetch (&ht->tags[group * HT_GROUP_SIZE]);
+    __builtin_prefetch (&ht->buckets[group * HT_GROUP_SIZE]);
+} /* -- end of ht_prefetch (..) -- */
 
 
 /* ---------------------------------------------------------------------
@@ -105,152 +408,75 @@ ht_lookup (struct ct_instance* ct, struct node_t* node, char* first_comp, bool p
  * Scope: Global
  * 
  * Description:
- * Insert a new record to the hash table of the corresponded node.
+ * Insert a new record (pointing to a given child) to the hash table of
+ * the corresponded node.
  * NOTE:
  *     Duplicate records will not be added.
  * --------------------------------------------------------------------- */
 struct bucket_t*
-ht_insert (struct ct_instance* ct, struct node_t* node, char* first_comp, bool print_flag)
+ht_insert (struct ct_instance* ct, struct node_t* node, unsigned int id, unsigned long long key, struct node_t* next_node, bool print_flag)
 {
     assert (ct);
-    struct bucket_t* bucket_walker;
-
-    unsigned long long key = ht_keygen (first_comp);
-    unsigned int index;
-    bool equal;
-
-    if (!key)
-    {
-        fprintf (stderr, "[ht_insert] ERROR: Key generating has been failed.\n");
-        return 0;
-    }
+    struct ht_t* ht;
+    struct bucket_t* bucket;
 
-    // ** BEGIN - nothing is in the HT ** //
+    // -- nothing is in the HT -- //
     if (!node->hash_table)
     {
-        node->hash_table = (struct ht_t*)malloc(sizeof(struct ht_t));
-        node->hash_table->size = ct->ht_init_size;
-        node->hash_table->used = 0;
-        node->hash_table->buckets = (struct bucket_t*)malloc(sizeof(struct bucket_t) * node->hash_table->size);
-        for (int i=0; i<node->hash_table->size; i++)
-        {
-            node->hash_table->buckets[i].key = 1;  // -- key of head is one -- //
-            node->hash_table->buckets[i].next_node = 0;
-            node->hash_table->buckets[i].head = true;
-            node->hash_table->buckets[i].next_bucket = 0;
-            node->hash_table->buckets[i].pre_bucket = 0;
-        }
-        // -- insert -- //
-        index = key % node->hash_table->size;
-        node->hash_table->buckets[index].next_bucket = (struct bucket_t*)malloc(sizeof(struct bucket_t));
-        node->hash_table->buckets[index].next_bucket->key = key;
-        node->hash_table->buckets[index].next_bucket->next_node = 0;
-        node->hash_table->buckets[index].next_bucket->next_bucket = 0;
-        node->hash_table->buckets[index].next_bucket->pre_bucket = &node->hash_table->buckets[index];
-        node->hash_table->buckets[index].next_bucket->head = false;
-        node->hash_table->used++;
-        return node->hash_table->buckets[index].next_bucket;
-    }
-    if (!node->hash_table->size)
-    { 
-        //fprintf (stderr, "[ht_insert] ERROR: Hash table with size ZERO.\n");
-        node->hash_table->size = ct->ht_init_size;
-        node->hash_table->used = 0;
-        node->hash_table->buckets = (struct bucket_t*)malloc(sizeof(struct bucket_t) * node->hash_table->size);
-        for (int i=0; i<node->hash_table->size; i++)
-        {
-            node->hash_table->buckets[i].key = 1;  // -- key of head is one -- //
-            node->hash_table->buckets[i].next_node = 0;
-            node->hash_table->buckets[i].head = true;
-            node->hash_table->buckets[i].next_bucket = 0;
-            node->hash_table->buckets[i].pre_bucket = 0;
-        }
-        // -- insert -- //
-        index = key % node->hash_table->size;
-        node->hash_table->buckets[index].next_bucket = (struct bucket_t*)malloc(sizeof(struct bucket_t));
-        node->hash_table->buckets[index].next_bucket->key = key;
-        node->hash_table->buckets[index].next_bucket->next_node = 0;
-        node->hash_table->buckets[index].next_bucket->next_bucket = 0;
-        node->hash_table->buckets[index].next_bucket->pre_bucket = &node->hash_table->buckets[index];
-        node->hash_table->buckets[index].next_bucket->head = false;
-        node->hash_table->used++;
-        return node->hash_table->buckets[index].next_bucket;
+        if (!(ht = ht_alloc (ct, ct->ht_init_size)))
+            return 0;
+        bucket = ht_place (ht, key, next_node);
+        EP_PUBLISH(node->hash_table, ht);
+        return bucket;
     }
-    if (!node->hash_table->buckets) 
+    if (ht_find_slot (node->hash_table, key, id) >= 0)
     {
-        node->hash_table->buckets = (struct bucket_t*)malloc(sizeof(struct bucket_t) * node->hash_table->size); 
-        for (int i=0; i<node->hash_table->size; i++)
-        {
-            node->hash_table->buckets[i].key = 1;  // -- key of head is one -- //
-            node->hash_table->buckets[i].next_node = 0;
-            node->hash_table->buckets[i].head = true;
-            node->hash_table->buckets[i].next_bucket = 0;
-            node->hash_table->buckets[i].pre_bucket = 0;
-        }
-        // -- insert -- //
-        index = key % node->hash_table->size;
-        node->hash_table->buckets[index].next_bucket = (struct bucket_t*)malloc(sizeof(struct bucket_t));
-        node->hash_table->buckets[index].next_bucket->key = key;
-        node->hash_table->buckets[index].next_bucket->next_node = 0;
-        node->hash_table->buckets[index].next_bucket->next_bucket = 0;
-        node->hash_table->buckets[index].next_bucket->pre_bucket = &node->hash_table->buckets[index];
-        node->hash_table->buckets[index].next_bucket->head = false;
-        node->hash_table->used++;
-        return node->hash_table->buckets[index].next_bucket;
+        if (print_flag)
+            printf ("Trying to add duplicate key in the hash table.\n");
+        return 0;
     }
-    // ** END - HT is empty ** //
 
     // -- rehash if it is necessary -- //
-    if ((double)((double)node->hash_table->used/node->hash_table->size) > 0.5)
-    {
-        // -- increase the size of corresponded HT by TWO, before inserting the record -- //
+    if (node->hash_table->used + node->hash_table->deleted + 1 > HT_LIMIT(node->hash_table->size))
         ht_rehash(ct, node, print_flag);
+
+    return ht_place (node->hash_table, key, next_node);
+} /* -- end of ht_insert (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_delete (..)
+ * Scope: Global
+ *
+ * Description:
+ * Release the slot of a given bucket. If the group of the slot still has
+ * an empty slot, no probing sequence goes beyond it and the slot can be
+ * emptied; otherwise a tombstone is left behind.
+ * NOTE:
+ *     The bucket itself is not cleared, as a concurrent reader may have
+ *     matched its tag already.
+ * --------------------------------------------------------------------- */
+void
+ht_delete (struct ht_t* ht, struct bucket_t* bucket)
+{
+    assert (ht);
+
+    int slot = bucket - ht->buckets;
+    int base = slot & ~(HT_GROUP_SIZE - 1);
+
+    if (slot < 0 || slot >= ht->size || !HT_IS_FULL(ht->tags[slot]))
+    {
+        fprintf (stderr, "[ht_delete] ERROR: The bucket does not belong to this table.\n");
+        return;
     }
-    index = key % node->hash_table->size;
-    bucket_walker = &node->hash_table->buckets[index];   
-    while (bucket_walker->next_bucket)
+    if (ht_group_match (&ht->tags[base], HT_EMPTY) & HT_VALID_MASK(ht))
+        EP_PUBLISH(ht->tags[slot], HT_EMPTY);
+    else
     {
-        bucket_walker = bucket_walker->next_bucket;
-        if (bucket_walker->key == key)
-        {
-            // -- keys are equal, make sure components are NOT equal before insertion -- //
-            equal = true;
-            if (bucket_walker->next_node->comps[0].len != strlen(first_comp))
-                equal = false;
-            if (equal)
-            { 
-                for (int i=0; i < strlen(first_comp); i++)
-                {
-                    if (bucket_walker->next_node->comps[0].bytes[i] != first_comp[i]) 
-                    {
-                        equal = false; 
-                        break;
-                    }
-                }
-            }
-            if (!equal)
-            {
-                // -- THIS IS A WARNING [KEYs are equal BUT contents are different] -- //
-                fprintf (stderr, "[ht_insert] WARNING: HT COLLISION, FIX IT.\n");
-            }
-            else
-            {
-                if (print_flag)
-                    printf ("Trying to add duplicate key in the hash table.\n");
-                return 0;
-            }
-        }
+        EP_PUBLISH(ht->tags[slot], HT_DELETED);
+        ht->deleted++;
     }
-    // -- insert it here (at the end of linked list) -- // 
-    bucket_walker->next_bucket = (struct bucket_t*)malloc(sizeof(struct bucket_t));
-    bucket_walker->next_bucket->key = key;
-    bucket_walker->next_bucket->next_node = 0;
-    bucket_walker->next_bucket->pre_bucket = bucket_walker;
-    bucket_walker->next_bucket->next_bucket = 0;
-    bucket_walker->next_bucket->head = false; 
-    node->hash_table->used++;
-    return bucket_walker->next_bucket;
-} /* -- end of ht_insert (..) -- */
+    ht->used--;
+} /* -- end of ht_delete (..) -- */
 
 /* ---------------------------------------------------------------------
  * Method: ht_rehash (..)
@@ -258,100 +484,79 @@ ht_insert (struct ct_instance* ct, struct node_t* node, char* first_comp, bool p
  * 
  * Description:
  * Double the size of the hash table of the corresponded node and rearrange
- * the keys, consequently.
+ * the keys, consequently. If the table is mostly filled with tombstones,
+ * it is rebuilt with the same size instead.
+ * NOTE:
+ *     The new table is built aside and published with a single pointer
+ *     store. Concurrent readers may still use the old one, so it is
+ *     retired (see ep_epoch.h) rather than freed.
  * --------------------------------------------------------------------- */
 void
 ht_rehash (struct ct_instance* ct, struct node_t* node, bool print_falg)
 {
     assert (ct);
-    
-    unsigned long long key; 
-    unsigned int index;
-    struct bucket_t* bucket_walker_org;
-    struct bucket_t* bucket_walker_rehash;
 
-    if (!node->hash_table)
+    struct ht_t* old_ht = node->hash_table;
+    struct ht_t* new_ht;
+    int new_size;
+
+    if (!old_ht)
     {
         fprintf (stderr, "[ht_rehash] ERROR: HT is not initialized.\n");
         return;
     }
-    struct ht_t* hash_table_tmp = (struct ht_t*)malloc(sizeof(struct ht_t));
-
-    *hash_table_tmp = *node->hash_table;
-    free(node->hash_table);
-    node->hash_table = (struct ht_t*)malloc(sizeof(struct ht_t));
-    node->hash_table->size = hash_table_tmp->size * 2;
-    node->hash_table->used = hash_table_tmp->used;
-    //printf ("Rehash to size:  %u\n", node->hash_table->size);
-    node->hash_table->buckets = (struct bucket_t*)malloc(sizeof(struct bucket_t) * node->hash_table->size); 
-    for (int i=0; i < node->hash_table->size; i++)
-    {
-        node->hash_table->buckets[i].key = 0;
-        node->hash_table->buckets[i].next_node = 0;
-        node->hash_table->buckets[i].head = true;
-        node->hash_table->buckets[i].next_bucket = 0;
-        node->hash_table->buckets[i].pre_bucket = 0;
-    }
+    new_size = (old_ht->used + 1 > HT_LIMIT(old_ht->size) / 2) ? old_ht->size * 2 : old_ht->size;
+    if (!(new_ht = ht_alloc (ct, new_size)))
+        return;
 
-    // -- know rearrange the keys (here we are sure there is no duplicate key) --//
-    for (int i=0; i < hash_table_tmp->size; i++)
-    { 
-        bucket_walker_org = &hash_table_tmp->buckets[i];        
-        while (bucket_walker_org->next_bucket)
-        {
-            bucket_walker_org = bucket_walker_org->next_bucket;
-            key = bucket_walker_org->key;
-            index = key % node->hash_table->size;  // -- find the new location -- //
-            
-            bucket_walker_rehash = &node->hash_table->buckets[index];
-            // -- find an empty slot for this item -- //
-            while (bucket_walker_rehash->next_bucket)
-                bucket_walker_rehash = bucket_walker_rehash->next_bucket;
-            // -- insert it here -- //
-            bucket_walker_rehash->next_bucket = (struct bucket_t*)malloc(sizeof(struct bucket_t));
-            bucket_walker_rehash->next_bucket->key = bucket_walker_org->key;
-            bucket_walker_rehash->next_bucket->next_node = bucket_walker_org->next_node;
-            bucket_walker_rehash->next_bucket->next_bucket = 0; 
-            bucket_walker_rehash->next_bucket->pre_bucket = bucket_walker_rehash; 
-            bucket_walker_rehash->next_bucket->head = false;
-        }
-        // -- free -- // 
-        // -- we have reached the end of this linked list -- //
-        if (bucket_walker_org->head)
+    // -- now rearrange the keys (here we are sure there is no duplicate key) --//
+    for (int i=0; i < old_ht->size; i++)
+    {
+        if (!HT_IS_FULL(old_ht->tags[i]))
             continue;
-        while (!bucket_walker_org->head)
-        {
-            bucket_walker_org->key = 0;
-            if (bucket_walker_org->next_bucket)
-                free(bucket_walker_org->next_bucket);
-            bucket_walker_org->next_bucket = 0;
-            bucket_walker_org = bucket_walker_org->pre_bucket;           
-        }
-        // -- remove the head -- //
-        if (bucket_walker_org->next_bucket)
-            free(bucket_walker_org->next_bucket);
-        bucket_walker_org->next_bucket = 0;
+        ht_place (new_ht, old_ht->buckets[i].key, old_ht->buckets[i].next_node);
     }
     // -- do not touch the next_nodes -- //
-    free(hash_table_tmp->buckets);
-    hash_table_tmp->size = 0;
-    free(hash_table_tmp);
-}
+    EP_PUBLISH(node->hash_table, new_ht);
+    ep_retire (&ct->epoch, old_ht, ht_reclaim);
+} /* -- end of ht_rehash (..) -- */
+
+/* ---------------------------------------------------------------------
+ * Method: ht_probe_length (..)
+ * Scope: Global
+ *
+ * Description:
+ * Number of groups that are probed to reach a given (full) slot. This is
+ * what the length of a chain used to be in the chained table.
+ * --------------------------------------------------------------------- */
+int
+ht_probe_length (struct ht_t* ht, int slot)
+{
+    unsigned int num_of_groups = HT_NUM_OF_GROUPS(ht);
+    unsigned int group = (unsigned int)(ht->buckets[slot].key >> 7) & (num_of_groups - 1);
+    unsigned int target = slot / HT_GROUP_SIZE;
+
+    for (unsigned int probe=0; probe < num_of_groups; probe++)
+    {
+        if (group == target)
+            return probe + 1;
+        group = (group + probe + 1) & (num_of_groups - 1);
+    }
+    return num_of_groups;
+} /* -- end of ht_probe_length (..) -- */
 
 /* ---------------------------------------------------------------------
  * Method: ht_keygen (..)
  * Scope: Global
  * 
  * Description:
- * Generate a key based on xxhash hash function. The input is a string and
- * the output will be the key. This key will be devided by size of the ht
- * (not in this function) to figure out the corresponded bucket.
+ * Generate a key based on xxhash hash function. The input is a component
+ * (not null terminated) and the output will be the key. The key selects the first group to probe,
+ * and its low bits are kept as the tag of the slot (not in this function).
  * --------------------------------------------------------------------- */
 unsigned long long
-ht_keygen (char* comp)
+ht_keygen (const char* comp, int len)
 {
-    
-    int len=strlen(comp);
     unsigned long long seed=1234;
     unsigned long long key= XXH64 (comp, len, seed);
     //printf ("key:  %llu\n", key);
@@ -26,6 +26,7 @@
 #include <unistd.h>
 #include <ctype.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "ct_trie.h"
 #include "cm_component.h"
@@ -34,7 +35,7 @@
 #include "main.h"
 #include "ht_hashtable.h"
 
-char* _args = "intprxRhHe";
+char* _args = "intprxRhHeTWb";
 /* --------------------------------------
  * Method: print_inst()
  * Scope: Public 
@@ -56,6 +57,9 @@ print_inst (char* prg)
     printf ("\t-h:   Print help \n");
     printf ("\t-e:   speed evaluation mode (enter random names file) \n");
     printf ("\t-H:   Set the initial size of hash tables at nodes \n");
+    printf ("\t-T:   multi-threaded lookup evaluation (enter max number of threads) \n");
+    printf ("\t-W:   concurrent lookups with one writer (enter number of reader threads) \n");
+    printf ("\t-b:   batch size of lookups in speed evaluation mode (1..%d) \n", CT_BATCH_MAX);
 } /* -- end of print_inst () -- */
 
 /* ------------------------------------------------
@@ -73,6 +77,13 @@ print_summary (struct ct_instance* ct, double insert_time, double  lookup_time,
     printf ("Insertion time:    %f\n", insert_time);
     printf ("Lookup time:       %f\n", lookup_time);
     printf ("Removal time:      %f\n", remove_time);
+    printf ("------------ MEMORY ------------\n");
+    printf ("Arena reserved:    %zu bytes (%d chunks)\n", ct->arena.reserved, ct->arena.num_of_chunks);
+    printf ("Arena used:        %zu bytes\n", ct->arena.used);
+    printf ("Pooled components: %lld distinct / %lld in nodes\n", ct->pool.num_of_strings, ct->pool.num_of_refs);
+    if (ct->pool.num_of_strings)
+        printf ("Dedup ratio:       %.2f\n", (double)ct->pool.num_of_refs / (double)ct->pool.num_of_strings);
+    printf ("Bytes saved:       %lld bytes (%lld instead of %lld)\n", ct->pool.ref_bytes - ct->pool.bytes, ct->pool.bytes, ct->pool.ref_bytes);
     if (!dfs_flag)
     {
         printf (ANSI_COLOR_RED "\nTo see more statistical info of the final trie use [-R] tag\n");
@@ -98,8 +109,14 @@ print_summary (struct ct_instance* ct, double insert_time, double  lookup_time,
                 all_nodes += ct->trie_stat->width[i]; 
             printf ("\tALL Nodes=    %d\n", all_nodes);
             printf ("\tAVE Width=    %f\n", (float)((float)(all_nodes-1)/(all_nodes-ct->trie_stat->num)));
-            printf ("\tAVE Hash Table Size=   %f\n",(float)((float)ct->trie_stat->ht_size / (float)(all_nodes-ct->trie_stat->num)));
-            printf ("\tAVE Chain Length=      %f\n", (float)((float)ct->trie_stat->chain_length / (float)(all_nodes-ct->trie_stat->num)));
+            printf ("\tLEAF Nodes=   %d\n", ct->trie_stat->kinds[CT_KIND_LEAF]);
+            printf ("\tSMALL Nodes=  %d\n", ct->trie_stat->kinds[CT_KIND_SMALL]);
+            printf ("\tHASHED Nodes= %d\n", ct->trie_stat->kinds[CT_KIND_HASHED]);
+            if (ct->trie_stat->kinds[CT_KIND_HASHED])
+            {
+                printf ("\tAVE Hash Table Size=   %f\n",(float)((float)ct->trie_stat->ht_size / (float)ct->trie_stat->kinds[CT_KIND_HASHED]));
+                printf ("\tAVE Chain Length=      %f\n", (float)((float)ct->trie_stat->chain_length / (float)ct->trie_stat->kinds[CT_KIND_HASHED]));
+            }
         }    
         
         printf (ANSI_COLOR_RED "\nTo see the final Patricia Trie run below command:\n");
@@ -123,6 +140,9 @@ warmup (struct ct_instance* ct, bool print_flag, bool remove_flag, bool dfs_flag
     double insert_cpu_used = 0;
     double lookup_cpu_used = 0;
     double remove_cpu_used = 0;
+    struct ct_ctx ctx;
+
+    trie_ctx_init (ct, &ctx, false);
  
     char* names[] = {"/ndn/uofa/cs/department/pub","/ndn/uofa/cs/department","/ndn/uofa/ece/department","/ndn/uofa/cs/department/pub/icn/","/ndn/uofa/cs/icn/"};
     int num_of_names = 5;    
@@ -140,7 +160,7 @@ warmup (struct ct_instance* ct, bool print_flag, bool remove_flag, bool dfs_flag
     for (int i=0; i<num_of_names; i++)
     {
         // -- lookup some names -- //
-        if (trie_lookup(ct, (const char*)names[i], print_flag, 0, 0))
+        if (trie_lookup(ct, 0, (const char*)names[i], print_flag, 0))
         {
             if (print_flag)
                 printf ("Name is found:   %s\n", names[i]);
@@ -159,7 +179,7 @@ warmup (struct ct_instance* ct, bool print_flag, bool remove_flag, bool dfs_flag
         for (int i=0; i<num_of_names; i++)
         {
             // -- remove some names -- // 
-            if (trie_remove(ct, (const char*)names[i], print_flag) == 0)
+            if (trie_remove(ct, &ctx, (const char*)names[i], print_flag) == 0)
             {
                 if (print_flag)
                     printf ("Name is removed:   %s\n", names[i]);
@@ -184,6 +204,269 @@ warmup (struct ct_instance* ct, bool print_flag, bool remove_flag, bool dfs_flag
 } /* -- end of warmup(..) function -- */
 
 
+/* ---------------------------------------------------
+ * Method: mt_lookup()
+ * Scope: Public 
+ * 
+ * Description:
+ * Body of a lookup thread. Each thread looks up all
+ * names, starting from a different name, with its own
+ * (empty) context.
+ * --------------------------------------------------- */
+void*
+mt_lookup (void* arg)
+{
+    struct mt_arg_t* mt = (struct mt_arg_t*)arg;
+
+    for (int i=0; i<mt->num_of_names; i++)
+    {
+        if (trie_lookup (mt->ct, 0, (const char*)mt->names[(mt->first + i) % mt->num_of_names], false, false))
+            mt->found++;
+    }
+    return 0;
+} /* -- end of mt_lookup (..) -- */
+
+/* ---------------------------------------------------
+ * Method: eval_threads()
+ * Scope: Public 
+ * 
+ * Description:
+ * Look up names in one (frozen) trie from 1, 2, 4, ..
+ * up to max_threads threads and report the aggregate
+ * lookup throughput of each thread count.
+ * NOTE:
+ *     Time is wall-clock time (not CPU time).
+ * --------------------------------------------------- */
+void
+eval_threads (struct ct_instance* ct, char** names, int num_of_names, int max_threads)
+{
+    assert (ct);
+    pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t) * max_threads);
+    struct mt_arg_t* args = (struct mt_arg_t*)malloc(sizeof(struct mt_arg_t) * max_threads);
+    struct timespec start, end;
+    double elapsed;
+    long long found;
+    int num_of_threads = 1;
+
+    printf ("------- MULTI-THREADED LOOKUP -------\n");
+    while (true)
+    {
+        for (int i=0; i<num_of_threads; i++)
+        {
+            args[i].ct = ct;
+            args[i].names = names;
+            args[i].num_of_names = num_of_names;
+            args[i].first = (int)((long long)num_of_names * i / num_of_threads);
+            args[i].found = 0;
+        }
+        clock_gettime (CLOCK_MONOTONIC, &start);
+        for (int i=0; i<num_of_threads; i++)
+        {
+            if (pthread_create (&threads[i], 0, mt_lookup, &args[i]))
+            {
+                fprintf (stderr, "[eval_threads] ERROR: Failed to create thread %d.\n", i);
+                num_of_threads = i;
+                break;
+            }
+        }
+        for (int i=0; i<num_of_threads; i++)
+            pthread_join (threads[i], 0);
+        clock_gettime (CLOCK_MONOTONIC, &end);
+        elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+        found = 0;
+        for (int i=0; i<num_of_threads; i++)
+            found += args[i].found;
+        printf ("Threads: %3d   Lookups/sec: %14.2f   Per thread: %14.2f   Found: %lld/%lld\n",
+                num_of_threads, (double)num_of_names * num_of_threads / elapsed,
+                (double)num_of_names / elapsed, found, (long long)num_of_names * num_of_threads);
+
+        if (num_of_threads >= max_threads || !num_of_threads)
+            break;
+        num_of_threads = (num_of_threads * 2 > max_threads) ? max_threads : num_of_threads * 2;
+    }
+    free(args);
+    free(threads);
+} /* -- end of eval_threads (..) -- */
+
+/* ---------------------------------------------------
+ * Method: rw_reader()
+ * Scope: Public 
+ * 
+ * Description:
+ * Body of a reader thread in the reader/writer
+ * benchmark. The reader registers its context, looks
+ * up all names and records latency of each lookup.
+ * --------------------------------------------------- */
+void*
+rw_reader (void* arg)
+{
+    struct rw_arg_t* rw = (struct rw_arg_t*)arg;
+    struct ct_ctx ctx;
+    struct timespec start, end;
+    long long ns;
+
+    if (trie_ctx_init (rw->ct, &ctx, true))
+        return 0;
+    for (int i=0; i<rw->num_of_names; i++)
+    {
+        clock_gettime (CLOCK_MONOTONIC, &start);
+        if (trie_lookup (rw->ct, &ctx, (const char*)rw->names[(rw->first + i) % rw->num_of_names], false, false))
+            rw->found++;
+        clock_gettime (CLOCK_MONOTONIC, &end);
+        ns = (end.tv_sec - start.tv_sec) * 1000000000LL + (end.tv_nsec - start.tv_nsec);
+        ns /= RW_BUCKET_NS;
+        rw->hist[(ns < RW_NUM_OF_BUCKETS) ? ns : RW_NUM_OF_BUCKETS - 1]++;
+    }
+    trie_ctx_free (&ctx);
+    return 0;
+} /* -- end of rw_reader (..) -- */
+
+/* ---------------------------------------------------
+ * Method: rw_writer()
+ * Scope: Public 
+ * 
+ * Description:
+ * Body of the (single) writer thread in the reader/
+ * writer benchmark. The writer removes and inserts
+ * names back until the readers are done.
+ * --------------------------------------------------- */
+void*
+rw_writer (void* arg)
+{
+    struct rw_arg_t* rw = (struct rw_arg_t*)arg;
+    struct ct_ctx ctx;
+    int i = 0;
+
+    trie_ctx_init (rw->ct, &ctx, false);
+    while (!__atomic_load_n (rw->stop, __ATOMIC_ACQUIRE))
+    {
+        if (!trie_remove (rw->ct, &ctx, (const char*)rw->names[i], false))
+            rw->updates++;
+        if (trie_insert (rw->ct, (const char*)rw->names[i], false))
+            rw->updates++;
+        i = (i + 1) % rw->num_of_names;
+    }
+    return 0;
+} /* -- end of rw_writer (..) -- */
+
+/* ---------------------------------------------------
+ * Method: rw_percentile()
+ * Scope: Public 
+ * 
+ * Description:
+ * Return the given percentile (in ns) of a latency
+ * histogram with a total number of samples.
+ * --------------------------------------------------- */
+long long
+rw_percentile (unsigned long long* hist, unsigned long long total, double percentile)
+{
+    unsigned long long rank = (unsigned long long)(total * percentile);
+    unsigned long long seen = 0;
+
+    for (int i=0; i<RW_NUM_OF_BUCKETS; i++)
+    {
+        seen += hist[i];
+        if (seen > rank)
+            return (long long)(i + 1) * RW_BUCKET_NS;
+    }
+    return (long long)RW_NUM_OF_BUCKETS * RW_BUCKET_NS;
+} /* -- end of rw_percentile (..) -- */
+
+/* ---------------------------------------------------
+ * Method: eval_rw()
+ * Scope: Public 
+ * 
+ * Description:
+ * Look up names from a number of reader threads, once
+ * without and once with a writer which churns the trie
+ * (remove + insert). Report lookup throughput, lookup
+ * latency percentiles, and the writer throughput.
+ * NOTE:
+ *     Time is wall-clock time (not CPU time), and the
+ *     latency includes the cost of reading the clock.
+ * --------------------------------------------------- */
+void
+eval_rw (struct ct_instance* ct, char** names, int num_of_names, int num_of_readers)
+{
+    assert (ct);
+    pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t) * (num_of_readers + 1));
+    struct rw_arg_t* args = (struct rw_arg_t*)malloc(sizeof(struct rw_arg_t) * (num_of_readers + 1));
+    unsigned long long* hist = (unsigned long long*)malloc(sizeof(unsigned long long) * RW_NUM_OF_BUCKETS);
+    struct timespec start, end;
+    double elapsed;
+    unsigned long long total;
+    long long found;
+    volatile int stop;
+    int num_of_threads;
+
+    printf ("------- CONCURRENT LOOKUP (%d readers) -------\n", num_of_readers);
+    for (int with_writer=0; with_writer<2; with_writer++)
+    {
+        stop = 0;
+        for (int i=0; i<=num_of_readers; i++)
+        {
+            args[i].ct = ct;
+            args[i].names = names;
+            args[i].num_of_names = num_of_names;
+            args[i].first = (int)((long long)num_of_names * i / num_of_readers);
+            args[i].found = 0;
+            args[i].updates = 0;
+            args[i].hist = (unsigned long long*)calloc(RW_NUM_OF_BUCKETS, sizeof(unsigned long long));
+            args[i].stop = &stop;
+        }
+        num_of_threads = 0;
+        clock_gettime (CLOCK_MONOTONIC, &start);
+        if (with_writer && pthread_create (&threads[num_of_readers], 0, rw_writer, &args[num_of_readers]))
+        {
+            fprintf (stderr, "[eval_rw] ERROR: Failed to create the writer.\n");
+            with_writer = 0;
+        }
+        for (int i=0; i<num_of_readers; i++)
+        {
+            if (pthread_create (&threads[i], 0, rw_reader, &args[i]))
+            {
+                fprintf (stderr, "[eval_rw] ERROR: Failed to create thread %d.\n", i);
+                break;
+            }
+            num_of_threads++;
+        }
+        for (int i=0; i<num_of_threads; i++)
+            pthread_join (threads[i], 0);
+        clock_gettime (CLOCK_MONOTONIC, &end);
+        __atomic_store_n (&stop, 1, __ATOMIC_RELEASE);
+        if (with_writer)
+            pthread_join (threads[num_of_readers], 0);
+        elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+        found = 0;
+        total = 0;
+        for (int b=0; b<RW_NUM_OF_BUCKETS; b++)
+            hist[b] = 0;
+        for (int i=0; i<num_of_threads; i++)
+        {
+            found += args[i].found;
+            for (int b=0; b<RW_NUM_OF_BUCKETS; b++)
+                hist[b] += args[i].hist[b];
+        }
+        for (int b=0; b<RW_NUM_OF_BUCKETS; b++)
+            total += hist[b];
+
+        printf ("Writer: %-3s   Lookups/sec: %14.2f   Found: %lld/%lld\n", with_writer ? "ON" : "OFF",
+                (double)total / elapsed, found, (long long)total);
+        if (total)
+            printf ("\tLatency (ns):  p50= %lld   p99= %lld   p99.9= %lld\n", rw_percentile (hist, total, 0.5),
+                    rw_percentile (hist, total, 0.99), rw_percentile (hist, total, 0.999));
+        if (with_writer)
+            printf ("\tUpdates/sec:   %14.2f\n", (double)args[num_of_readers].updates / elapsed);
+        for (int i=0; i<=num_of_readers; i++)
+            free(args[i].hist);
+    }
+    free(hist);
+    free(args);
+    free(threads);
+} /* -- end of eval_rw (..) -- */
+
 /* ---------------------------------------------------
  * Method: main()
  * Scope: Public 
@@ -195,16 +478,11 @@ warmup (struct ct_instance* ct, bool print_flag, bool remove_flag, bool dfs_flag
 void free_ct (struct ct_instance* ct)
 {
     assert (ct);
-    trie_free_node (&ct->root);
-    free(ct->visitedChildren);
-    ct->visitedChildren = 0;
-    for (int i=0; i<MAX_NUM_OF_COMPS; i++)
-    {
-        free(ct->comps_array[i]); 
-        ct->comps_array[i] = 0;
-    }
-    free(ct->comps_array);
-    ct->comps_array = 0;
+    ep_destroy (&ct->epoch);  // -- reclaim retired nodes first -- //
+    // -- all nodes, components and hash tables are in the arena, so there is no need to walk the trie -- //
+    ar_destroy (&ct->arena);
+    ct->root.comps = 0;
+    ct->root.hash_table = 0;
     free(ct->trie_stat->width);
     free(ct->trie_stat);
     return; 
@@ -236,8 +514,11 @@ int main (int argc, char** argv)
     int hash_init_size = 0;
     bool eval_flag = false;
     char* rand_file = NULL;
+    int num_of_threads = 0;
+    int num_of_readers = 0;
+    int batch_size = 0;   // -- zero: look up names one by one -- //
     
-    while ((sw = getopt (argc, argv, "ri:n:tpxRhH:e:")) != -1)
+    while ((sw = getopt (argc, argv, "ri:n:tpxRhH:e:T:W:b:")) != -1)
     switch (sw)
     {
         case 'i':
@@ -284,8 +565,35 @@ int main (int argc, char** argv)
             hash_init_size = ret;
             hash_init_size_flag = true;
             break;
+        case 'T':
+            ret = strtol (optarg, &rem, 10); 
+            if (ret < 1)
+            {
+                fprintf (stderr, "[main] ERROR: Option -%c requires an integer argument, greater than ZERO.\n", sw);
+                return 1;
+            }
+            num_of_threads = (int)ret;
+            break;
+        case 'W':
+            ret = strtol (optarg, &rem, 10); 
+            if (ret < 1 || ret >= EP_MAX_READERS)
+            {
+                fprintf (stderr, "[main] ERROR: Option -%c requires an integer argument, greater than ZERO and less than %d.\n", sw, EP_MAX_READERS);
+                return 1;
+            }
+            num_of_readers = (int)ret;
+            break;
+        case 'b':
+            ret = strtol (optarg, &rem, 10); 
+            if (ret < 1 || ret > CT_BATCH_MAX)
+            {
+                fprintf (stderr, "[main] ERROR: Option -%c requires an integer argument, between 1 and %d.\n", sw, CT_BATCH_MAX);
+                return 1;
+            }
+            batch_size = (int)ret;
+            break;
         case '?':
-            if (optopt=='i' || optopt=='n' || optopt=='p' || optopt=='t' || optopt=='r' || optopt=='x' || optopt=='R' || optopt=='h' || optopt=='H' || optopt=='e')
+            if (optopt=='i' || optopt=='n' || optopt=='p' || optopt=='t' || optopt=='r' || optopt=='x' || optopt=='R' || optopt=='h' || optopt=='H' || optopt=='e' || optopt=='T' || optopt=='W' || optopt=='b')
                 fprintf (stderr, "[main] ERROR: Option -%c requires an argument.\n", optopt);
             else if (isprint (optopt))
             {
@@ -318,19 +626,25 @@ int main (int argc, char** argv)
     } 
     /* --------------------------- Begin Initialize ------------------------ */
     struct ct_instance* ct;
+    struct ct_ctx ctx;   // -- context of the main thread -- //
     ct = (struct ct_instance*)malloc(sizeof(struct ct_instance));
     assert (ct);
     if (hash_init_size_flag)
         ct->ht_init_size = hash_init_size;
     else
         ct->ht_init_size = HT_INIT_SIZE;
-    ct->root.comps = (struct comp_t*)malloc(sizeof(struct comp_t));
-    ct->root.comps[0].bytes = (char*)malloc(2);
-    ct->root.comps[0].bytes[0] = (char)SLASH;
-    ct->root.comps[0].bytes[1] = '\0';
+    ar_init (&ct->arena);
+    ep_init (&ct->epoch, ct);
+    if (cp_init (ct))
+        return 1;
+    char root_comp[2] = {(char)SLASH, '\0'};
+    ct->root.comps = (struct comp_t*)ar_alloc(&ct->arena, sizeof(struct comp_t));
     ct->root.comps[0].len = 1; 
+    ct->root.comps[0].key = ht_keygen (root_comp, 1);
+    ct->root.comps[0].id = cp_intern (ct, root_comp, 1, ct->root.comps[0].key);
     ct->root.num_of_comp = 1;
     ct->root.hash_table = 0;  // -- initialize it at the first use -- //
+    ct->root.num_of_children = 0;  // -- the root is always hashed -- //
     ct->root.parent = 0;
     ct->trie_stat = (struct t_stat*)malloc(sizeof(struct t_stat));
     ct->trie_stat->max = 0;
@@ -339,18 +653,10 @@ int main (int argc, char** argv)
     ct->trie_stat->id = 0;
     ct->trie_stat->chain_length = 0;
     ct->trie_stat->ht_size = 0;
-    ct->visitedChildren = (struct bucket_t**)malloc(MAX_HEIGHT * sizeof(struct bucekt_t*));
-    for (int i=0; i<MAX_HEIGHT; i++)
-        ct->visitedChildren[i] = 0;
-    ct->comps_array = (char**)malloc(MAX_NUM_OF_COMPS * sizeof(char*));  // -- [TODO] assume number of components in a name cannot exceed MAX_NUM_OF_COMPS -- // 
-    for (int i=0; i<MAX_NUM_OF_COMPS; i++)
-    {
-        //ct->comps_array[i] = (char*)malloc(1);
-        ct->comps_array[i] = 0;
-    }
     ct->trie_stat->width = (int*)malloc(MAX_HEIGHT * sizeof(int));
     for (int i=0; i<MAX_HEIGHT; i++)
         ct->trie_stat->width[i] = 0;
+    trie_ctx_init (ct, &ctx, false);  // -- the main thread is the writer -- //
     /* --------------------------- END Initialize ------------------------ */
 
     // -- warmup -- //
@@ -417,7 +723,10 @@ int main (int argc, char** argv)
                 strcpy (rand_input[i], str);
             }
             else 
+            {
+                rand_size = i;  // -- the file has less names -- //
                 break;
+            }
         } 
         fclose(rand_file_input);
 
@@ -435,23 +744,34 @@ int main (int argc, char** argv)
 
         // ============= EVAL PART =============== //
         // -- eval lookup speed -- //
+        int found = 0;
+        struct node_t** results = (struct node_t**)malloc(sizeof(struct node_t*) * (rand_size ? rand_size : 1));
         start = clock();
         printf ("EVAL LOOKUP:\n");
-        for (int i = 0; i < rand_size; i++)
+        if (batch_size)
         {
-            if (!trie_lookup (ct, (const char*)rand_input[i], print_flag, 0, 0)) 
-            {
-                if (print_flag)
-                    printf ("Name is NOT found:\t%s\n", rand_input[i]);                 
-            }
-            else
+            // -- names of a batch are looked up in lockstep -- //
+            found = trie_lookup_batch (ct, 0, (const char**)rand_input, rand_size, results, batch_size);
+        }
+        else
+        {
+            for (int i = 0; i < rand_size; i++)
             {
-                if (print_flag)
-                    printf ("Name is found:\t%s\n", rand_input[i]);
+                if ((results[i] = trie_lookup (ct, 0, (const char*)rand_input[i], false, 0)))
+                    found++;
             }
         }
         end = clock();
         lookup_cpu_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+        printf ("Batch size:  %d   Found:  %d/%d\n", batch_size ? batch_size : 1, found, rand_size);
+        for (int i = 0; print_flag && i < rand_size; i++)
+        {
+            if (!results[i])
+                printf ("Name is NOT found:\t%s\n", rand_input[i]);                 
+            else
+                printf ("Name is found:\t%s\n", rand_input[i]);
+        }
+        free(results);
 
         // -- eval insertion speed -- //
         start = clock();
@@ -477,7 +797,7 @@ int main (int argc, char** argv)
         printf ("EVAL REMOVE:\n");
         for (int i = 0; i < rand_size; i++)
         { 
-            if (!trie_remove (ct, (const char*)rand_input[i], print_flag)) 
+            if (!trie_remove (ct, &ctx, (const char*)rand_input[i], print_flag)) 
             {
                 if (print_flag)
                     printf ("Name is removed:\t%s\n", rand_input[i]);                 
@@ -512,6 +832,50 @@ int main (int argc, char** argv)
         // -- END OF MASS PART -- //
     }
 
+    if (num_of_threads || num_of_readers)
+    {
+        // -- names are copied in memory, inserted, and then looked up by many threads -- //
+        int num_of_names = 0;
+        char** all_input = (char**)malloc((sizeof(char*) * num_of_rec)); 
+        for (int i=0; i<num_of_rec; i++)
+        {
+            if (fscanf(input, "%s", str) == EOF)
+                break;
+            all_input[i] = (char*)malloc(strlen(str) + 1);
+            strcpy (all_input[i], str);
+            num_of_names++;
+        } 
+        fclose(input);
+
+        start = clock();
+        printf ("MASS INSERTION:\n");
+        for (int i = 0; i < num_of_names; i++)
+        {
+            if (!trie_insert (ct, (const char*)all_input[i], print_flag))
+            {
+                if (print_flag)
+                    printf ("Duplicate name OR Insertion error.\n");
+            }
+        }
+        end = clock();
+        insert_cpu_used = ((double) (end - start)) / CLOCKS_PER_SEC;
+        printf ("Insertion time:    %f\n", insert_cpu_used);
+
+        // -- the trie is not modified from here on (except by the writer of eval_rw) -- //
+        if (num_of_names && num_of_threads)
+            eval_threads (ct, all_input, num_of_names, num_of_threads);
+        if (num_of_names && num_of_readers)
+            eval_rw (ct, all_input, num_of_names, num_of_readers);
+
+        free(str);
+        for (int i=0; i<num_of_names; i++)
+            free(all_input[i]);
+        free(all_input);
+        free_ct(ct);
+        free(ct);
+        return 0; 
+    }
+
     if (to_mem_flag)
     {
         char** all_input = (char**)malloc((sizeof(char*) * num_of_rec)); 
@@ -542,7 +906,7 @@ int main (int argc, char** argv)
         printf ("MASS LOOKUP:\n");
         for (int i = 0; i < num_of_rec; i++)
         {
-            if (!trie_lookup (ct, (const char*)all_input[i], print_flag, 0, 0)) 
+            if (!trie_lookup (ct, 0, (const char*)all_input[i], print_flag, 0)) 
             {
                 if (print_flag)
                     printf ("Name is NOT found:\t%s\n", all_input[i]);                 
@@ -563,7 +927,7 @@ int main (int argc, char** argv)
             printf ("MASS REMOVE:\n");
             for (int i = num_of_rec-1; i >= 0; i--)
             {
-                if (!trie_remove (ct, (const char*)all_input[i], print_flag)) 
+                if (!trie_remove (ct, &ctx, (const char*)all_input[i], print_flag)) 
                 {
                     if (print_flag)
                         printf ("Name is removed:\t%s\n", all_input[i]);                 
@@ -628,7 +992,7 @@ int main (int argc, char** argv)
     {
         if (fscanf (input, "%s", str) != EOF)
         {
-            if (!trie_lookup (ct, (const char*)str, print_flag, 0, 0)) 
+            if (!trie_lookup (ct, 0, (const char*)str, print_flag, 0)) 
             {
                 if (print_flag)
                     printf ("Name is NOT found:\t%s\n", str);                 
@@ -659,7 +1023,7 @@ int main (int argc, char** argv)
         {
             if (fscanf (input, "%s", str) != EOF)
             {
-                if (!trie_remove (ct, (const char*)str, print_flag)) 
+                if (!trie_remove (ct, &ctx, (const char*)str, print_flag)) 
                 {
                     if (print_flag)
                         printf ("Name is removed:\t%s\n", str);                 